@@ -212,13 +212,25 @@ void AtomicBlock3D::executeInternalProcessors(plint level)
 
 void AtomicBlock3D::executeInternalProcessors(plint level, DataProcessorVector& processors)
 {
-    if (level<(plint)processors.size()) {
+    if (level<(plint)processors.size() && !processors[level].empty()) {
+        // The timer belongs to this block only, so that it can be used
+        //   while other blocks are processed concurrently.
+        processorTimer.start();
         for (pluint iProc=0; iProc<processors[level].size(); ++iProc) {
             processors[level][iProc] -> process();
         }
+        processorTimer.stop();
     }
 }
 
+double AtomicBlock3D::getProcessorTime() const {
+    return processorTimer.getTime();
+}
+
+void AtomicBlock3D::resetProcessorTime() {
+    processorTimer.reset();
+}
+
 DataSerializer* AtomicBlock3D::getBlockSerializer (
             Box3D const& domain, IndexOrdering::OrderingT ordering ) const
 {
@@ -30,6 +30,7 @@
 #include "core/blockIdentifiers.h"
 #include "core/block3D.h"
 #include "core/blockStatistics.h"
+#include "core/plbTimer.h"
 #include "core/geometry3D.h"
 #include "atomicBlock/dataProcessorWrapper3D.h"
 #include "atomicBlock/reductiveDataProcessorWrapper3D.h"
@@ -111,6 +112,14 @@ public:
     void executeInternalProcessors();
     /// Execute all internal dataProcessors at a given level.
     void executeInternalProcessors(plint level);
+    /// Time spent in the internal dataProcessors of this block since the
+    ///   last call to resetProcessorTime(), in seconds.
+    double getProcessorTime() const;
+    void resetProcessorTime();
+    /// Tell if the block can be left out of the time iterations. The
+    ///   data sent to its envelope is then discarded, except for changes
+    ///   of the data structure (see BlockLattice3D::isIdle()).
+    virtual bool isIdle() const { return false; }
     /// Add a dataProcessor, which is executed after each iteration.
     void integrateDataProcessor(DataProcessor3D* processor, plint level);
     /// Remove all data processors.
@@ -168,6 +177,7 @@ private:
     StatSubscriber3D statisticsSubscriber;
     DataProcessorVector explicitInternalProcessors;
     DataProcessorVector automaticInternalProcessors;
+    global::PlbTimer processorTimer; /// Cumulative execution time of the internal processors.
 };
 
 Dot3D computeRelativeDisplacement(AtomicBlock3D const& block1, AtomicBlock3D const& block2);
@@ -244,7 +244,7 @@ void BlockLattice2D<T,Descriptor>::collideAndStream(Box2D domain)
     PLB_PRECONDITION( contained(domain, this->getBoundingBox()) );
 
     global::profiler().start("collStream");
-    global::profiler().increment("collStreamCells", domain.nCells());
+    global::profiler().incrementCollStream(domain.nCells(), 2*Descriptor<T>::q*sizeof(T));
 
     static const plint vicinity = Descriptor<T>::vicinity;
 
@@ -34,15 +34,18 @@
 #include "atomicBlock/dataField3D.h"
 #include "core/blockLatticeBase3D.h"
 #include "atomicBlock/atomicBlock3D.h"
+#include "atomicBlock/dynamicsMap3D.h"
 #include "core/blockIdentifiers.h"
 #include <vector>
 #include <map>
+#include <typeinfo>
 
 /// All Palabos code is contained in this namespace.
 namespace plb {
 
 template<typename T, template<typename U> class Descriptor> struct Dynamics;
 template<typename T, template<typename U> class Descriptor> class BlockLattice3D;
+template<typename T, template<typename U> class Descriptor> class CollisionPolicy3D;
 
 
 template<typename T, template<typename U> class Descriptor>
@@ -91,9 +94,20 @@ private:
     void attribute_regenerate (
         Box3D toDomain, plint deltaX, plint deltaY, plint deltaZ,
         BlockLattice3D<T,Descriptor> const& from );
+
+    /// Add the dynamics of all cells of a domain to a map.
+    static void mapDynamics( BlockLattice3D<T,Descriptor> const& from, Box3D domain,
+                             DynamicsMap3D<T,Descriptor>& dynamicsMap );
+    /// Overwrite the content of the existing dynamics objects of a domain.
+    void assignDynamics(Box3D domain, DynamicsMap3D<T,Descriptor> const& dynamicsMap);
+    /// Attribute new dynamics objects to the cells of a domain.
+    void regenerateDynamics( Box3D domain, DynamicsMap3D<T,Descriptor> const& dynamicsMap,
+                             std::map<int,int> const* idIndirect=0 );
+    /// Unserialize the static data of a domain, starting at posInBuffer.
+    void receiveStaticData(Box3D domain, std::vector<char> const& buffer, pluint posInBuffer);
 private:
     BlockLattice3D<T,Descriptor>& lattice;
-template<typename T_, template<typename U_> class Descriptor_>
+template<typename T_, template<typename U_> class Descriptor_, class List_>
     friend class ExternalRhoJcollideAndStream3D;
 };
 
@@ -147,6 +161,67 @@ public:
     virtual void collideAndStream(Box3D domain);
     /// Apply first collision, then streaming step to the whole domain
     virtual void collideAndStream();
+    /// Select the scheme used by collideAndStream() to propagate populations
+    /** With propagation::aa, collideAndStream(domain) alternates between a
+     *  local collision step, after which the populations are stored in
+     *  reverted order and the streaming is pending, and a step which pulls
+     *  the populations from the neighbors, collides them, and pushes them
+     *  back. Every population is then read and written once per time step.
+     *  While the streaming is pending, the cell content must not be accessed
+     *  before calling completeStream(). Switching to propagation::swap
+     *  completes a pending streaming step.
+     **/
+    void setPropagationScheme(propagation::SchemeT scheme);
+    /// Get the scheme used by collideAndStream() to propagate populations
+    propagation::SchemeT getPropagationScheme() const { return propagationScheme; }
+    /// Tell if the streaming step of the AA-pattern is pending
+    bool hasPendingStream() const { return streamIsPending; }
+    /// Conclude a pending streaming step of the AA-pattern
+    void completeStream();
+    /// Apply collision and streaming to the outer shell of a 3D sub-box
+    /** With the swap scheme, all cells of domain at a distance smaller than
+     *  shellWidth-vicinity from its border reach the end of the time step.
+     *  The step is concluded by collideAndStreamInterior(domain, shellWidth),
+     *  and in between, these outer cells can be communicated to other blocks.
+     **/
+    void collideAndStreamShell(Box3D domain, plint shellWidth);
+    /// Conclude collideAndStreamShell() by processing the interior of the sub-box
+    void collideAndStreamInterior(Box3D domain, plint shellWidth);
+    /// Select the collision of the cells which are not handled by the vectorized kernel
+    /** The lattice takes ownership of the policy. With a null pointer, the
+     *  default, the collision goes through the virtual Dynamics::collide. A
+     *  DispatchedCollision3D calls the collision of a closed set of dynamics
+     *  classes non-virtually.
+     **/
+    void setCollisionPolicy(CollisionPolicy3D<T,Descriptor>* policy);
+    /// Get the collision policy, or a null pointer
+    CollisionPolicy3D<T,Descriptor> const* getCollisionPolicy() const { return collisionPolicy; }
+    /// Classify the cells of the lattice according to their dynamics
+    /** The classification is evaluated on demand. It is invalidated by
+     *  attributeDynamics(), and by any modification of the parameters of a
+     *  BGKdynamics or IncBGKdynamics object, also through
+     *  Cell::getDynamics(). Parameters of other dynamics do not enter the
+     *  classification.
+     **/
+    activity::ClassT getActivity() const;
+    /// Force the classification of the cells to be evaluated anew
+    void invalidateActivity() { activityIsValid = false; }
+    /// Restrict the test for inactive cells to a sub-domain of the lattice
+    /** Envelope cells which lie outside the domain of a multi-block are
+     *  excluded in this way: they keep the background dynamics, but are
+     *  not influenced by the rest of the lattice.
+     **/
+    void setActivityDomain(Box3D domain);
+    /// Tell if the lattice can be left out of the time iterations
+    /** This is the case once the lattice has been inactive during one
+     *  complete time step. Afterwards, the collision-streaming steps (and
+     *  ExternalRhoJcollideAndStream3D) are skipped, and the populations
+     *  of the lattice are left unchanged instead of being streamed between
+     *  the solid cells. The internal processors are still executed: an
+     *  inactive lattice can host data which is not related to its cells,
+     *  such as immersed-wall vertices close to its boundary.
+     **/
+    virtual bool isIdle() const;
     /// Increment time counter
     /** Warning: don't call this method manually. Instead, call incrementTime()
      *  on the multi-block lattice. Otherwise, the internal time of the multi-block
@@ -164,10 +239,43 @@ public:
     Dynamics<T,Descriptor>& getBackgroundDynamics();
     /// Get a const reference to the background dynamics
     Dynamics<T,Descriptor> const& getBackgroundDynamics() const;
+    /// Index of the class of the dynamics of a cell in the dictionary of the lattice
+    /** The dictionary lists the distinct classes of dynamics which have been
+     *  attributed to the lattice. Entries are never removed, so that an id
+     *  keeps its meaning for the lifetime of the lattice. Collision loops use
+     *  the ids to group cells by class without inspecting their dynamics.
+     **/
+    plint getDynamicsId(plint iX, plint iY, plint iZ) const {
+        PLB_PRECONDITION(iX<this->getNx());
+        PLB_PRECONDITION(iY<this->getNy());
+        PLB_PRECONDITION(iZ<this->getNz());
+        return dynamicsIds[(iX*this->getNy()+iY)*this->getNz()+iZ];
+    }
+    /// Ids of the cells (iX,iY,0) to (iX,iY,nz-1), which are contiguous like the cells
+    unsigned short const* getDynamicsIds(plint iX, plint iY) const {
+        PLB_PRECONDITION(iX<this->getNx());
+        PLB_PRECONDITION(iY<this->getNy());
+        return &dynamicsIds[(iX*this->getNy()+iY)*this->getNz()];
+    }
+    /// Number of entries in the dictionary of dynamics classes
+    plint getNumDynamicsIds() const { return (plint)dynamicsTypes.size(); }
+    /// Exact type of the dynamics objects of a dictionary entry
+    std::type_info const& getDynamicsType(plint id) const {
+        PLB_PRECONDITION(id>=0 && id<getNumDynamicsIds());
+        return *dynamicsTypes[id];
+    }
+    /// Tell if all cells of a dictionary entry are pure BGK cells with the same parameters
+    /** This is evaluated together with getActivity(), and it is invalidated
+     *  in the same way.
+     **/
+    bool isHomogeneousBGK(plint id) const;
     /// Apply streaming step to bulk (non-boundary) cells
     void bulkStream(Box3D domain);
     /// Apply streaming step to boundary cells
     void boundaryStream(Box3D bound, Box3D domain);
+    /// Apply streaming step to the links of boundary cells which stay within
+    ///   bound, and which lead either into the box inner, or out of it.
+    void shellStream(Box3D bound, Box3D inner, Box3D domain, bool intoInner);
     /// Apply collision and streaming step to bulk (non-boundary) cells
     void bulkCollideAndStream(Box3D domain);
 private:
@@ -176,11 +284,20 @@ private:
     /// Cache-efficient implementation of bulkCollideAndStream(domain)for
     ///   nearest-neighbor lattices.
     void blockwiseBulkCollideAndStream(Box3D domain);
+    /// Second step of the AA-pattern: pull, collide and push populations.
+    void pullCollideAndPush(Box3D domain);
+    /// Collide numCells consecutive cells of a line, whose dynamics ids are
+    ///   ids, with the vectorized kernel on the homogeneous entries.
+    void collideSegment(Cell<T,Descriptor>* cells, unsigned short const* ids, plint numCells);
+    /// Evaluate the classification returned by getActivity().
+    void classifyActivity() const;
 private:
     /// Helper method for memory allocation
     void allocateAndInitialize();
     /// Helper method for memory de-allocation
     void releaseMemory();
+    /// Dictionary entry of the class of a dynamics object, which is added if needed
+    unsigned short findDynamicsId(Dynamics<T,Descriptor> const& dynamics);
     void implementPeriodicity();
 private:
     void periodicDomain(Box3D domain);
@@ -188,10 +305,22 @@ private:
     Dynamics<T,Descriptor>* backgroundDynamics;
     Cell<T,Descriptor>     *rawData;
     Cell<T,Descriptor>   ***grid;
+    std::vector<unsigned short> dynamicsIds;
+    std::vector<std::type_info const*> dynamicsTypes;
     BlockLatticeDataTransfer3D<T,Descriptor> dataTransfer;
+    propagation::SchemeT propagationScheme;
+    bool streamIsPending;
+    Box3D pendingStreamDomain;
+    CollisionPolicy3D<T,Descriptor>* collisionPolicy;
+    Box3D activityDomain;
+    mutable activity::ClassT activityClass;
+    mutable bool activityIsValid;
+    mutable pluint activityRevision;
+    mutable std::vector<bool> homogeneousBGK;
+    mutable pluint inactiveSince;
 public:
     static CachePolicy3D& cachePolicy();
-template<typename T_, template<typename U_> class Descriptor_>
+template<typename T_, template<typename U_> class Descriptor_, class List_>
     friend class ExternalRhoJcollideAndStream3D;
 template<typename T_, template<typename U_> class Descriptor_>
     friend class PackedExternalRhoJcollideAndStream3D;
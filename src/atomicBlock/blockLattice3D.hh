@@ -36,7 +36,13 @@
 #include "core/util.h"
 #include "core/latticeStatistics.h"
 #include "core/dynamicsIdentifiers.h"
+#include "core/runTimeDiagnostics.h"
+#include "atomicBlock/dynamicsMap3D.hh"
 #include "core/plbProfiler.h"
+#include "basicDynamics/isoThermalDynamics.h"
+#include "basicDynamics/vectorizedCollision3D.h"
+#include "basicDynamics/dynamicsDispatch.h"
+#include "latticeBoltzmann/simdPack.h"
 #include <algorithm>
 #include <typeinfo>
 #include <cmath>
@@ -55,13 +61,22 @@ BlockLattice3D<T,Descriptor>::BlockLattice3D (
         Dynamics<T,Descriptor>* backgroundDynamics_ )
     : AtomicBlock3D(nx_, ny_, nz_),
       backgroundDynamics(backgroundDynamics_),
-      dataTransfer(*this)
+      dataTransfer(*this),
+      propagationScheme(propagation::swap),
+      streamIsPending(false),
+      collisionPolicy(0),
+      activityDomain(this->getBoundingBox()),
+      activityClass(activity::mixed),
+      activityIsValid(false),
+      activityRevision(0),
+      inactiveSince(0)
 {
     plint nx = this->getNx();
     plint ny = this->getNy();
     plint nz = this->getNz();
     // Allocate memory, and initialize dynamics.
     allocateAndInitialize();
+    dynamicsIds.assign(nx*ny*nz, findDynamicsId(*backgroundDynamics));
     for (plint iX=0; iX<nx; ++iX) {
         for (plint iY=0; iY<ny; ++iY) {
             for (plint iZ=0; iZ<nz; ++iZ) {
@@ -91,6 +106,7 @@ template<typename T, template<typename U> class Descriptor>
 BlockLattice3D<T,Descriptor>::~BlockLattice3D()
 {
     releaseMemory();
+    delete collisionPolicy;
 }
 
 /** The whole data of the lattice is duplicated. This includes
@@ -103,7 +119,18 @@ BlockLattice3D<T,Descriptor>::BlockLattice3D(BlockLattice3D<T,Descriptor> const&
     : BlockLatticeBase3D<T,Descriptor>(rhs),
       AtomicBlock3D(rhs),
       backgroundDynamics(rhs.backgroundDynamics->clone()),
-      dataTransfer(*this)
+      dynamicsIds(rhs.dynamicsIds),
+      dynamicsTypes(rhs.dynamicsTypes),
+      dataTransfer(*this),
+      propagationScheme(rhs.propagationScheme),
+      streamIsPending(rhs.streamIsPending),
+      pendingStreamDomain(rhs.pendingStreamDomain),
+      collisionPolicy(rhs.collisionPolicy ? rhs.collisionPolicy->clone() : 0),
+      activityDomain(rhs.activityDomain),
+      activityClass(activity::mixed),
+      activityIsValid(false),
+      activityRevision(0),
+      inactiveSince(0)
 {
     plint nx = this->getNx();
     plint ny = this->getNy();
@@ -153,6 +180,18 @@ void BlockLattice3D<T,Descriptor>::swap(BlockLattice3D& rhs) {
     std::swap(backgroundDynamics, rhs.backgroundDynamics);
     std::swap(rawData, rhs.rawData);
     std::swap(grid, rhs.grid);
+    dynamicsIds.swap(rhs.dynamicsIds);
+    dynamicsTypes.swap(rhs.dynamicsTypes);
+    std::swap(propagationScheme, rhs.propagationScheme);
+    std::swap(streamIsPending, rhs.streamIsPending);
+    std::swap(pendingStreamDomain, rhs.pendingStreamDomain);
+    std::swap(collisionPolicy, rhs.collisionPolicy);
+    std::swap(activityDomain, rhs.activityDomain);
+    std::swap(activityClass, rhs.activityClass);
+    std::swap(activityIsValid, rhs.activityIsValid);
+    std::swap(activityRevision, rhs.activityRevision);
+    homogeneousBGK.swap(rhs.homogeneousBGK);
+    std::swap(inactiveSince, rhs.inactiveSince);
 }
 
 template<typename T, template<typename U> class Descriptor>
@@ -176,8 +215,8 @@ void BlockLattice3D<T,Descriptor>::collide(Box3D domain) {
 
     for (plint iX=domain.x0; iX<=domain.x1; ++iX) {
         for (plint iY=domain.y0; iY<=domain.y1; ++iY) {
+            collideSegment(&grid[iX][iY][domain.z0], getDynamicsIds(iX,iY)+domain.z0, domain.getNz());
             for (plint iZ=domain.z0; iZ<=domain.z1; ++iZ) {
-                grid[iX][iY][iZ].collide(this->getInternalStatistics());
                 grid[iX][iY][iZ].revert();
             }
         }
@@ -253,9 +292,33 @@ template<typename T, template<typename U> class Descriptor>
 void BlockLattice3D<T,Descriptor>::collideAndStream(Box3D domain) {
     // Make sure domain is contained within current lattice
     PLB_PRECONDITION( contained(domain, this->getBoundingBox()) );
+    if (!streamIsPending && isIdle()) {
+        return;
+    }
 
     global::profiler().start("collStream");
-    global::profiler().increment("collStreamCells", domain.nCells());
+    global::profiler().incrementCollStream(domain.nCells(), 2*Descriptor<T>::q*sizeof(T));
+
+    if (propagationScheme==propagation::aa) {
+        // A streaming step that is pending on another domain is concluded
+        //   first, so that the present step starts from the natural order.
+        if (streamIsPending && !(pendingStreamDomain==domain)) {
+            completeStream();
+        }
+        if (streamIsPending) {
+            pullCollideAndPush(domain);
+            streamIsPending = false;
+        }
+        else {
+            // The collision leaves the populations in reverted order; the
+            //   streaming is concluded by the next step.
+            collide(domain);
+            streamIsPending = true;
+            pendingStreamDomain = domain;
+        }
+        global::profiler().stop("collStream");
+        return;
+    }
 
     static const plint vicinity = Descriptor<T>::vicinity;
 
@@ -317,6 +380,9 @@ void BlockLattice3D<T,Descriptor>::collideAndStream(Box3D domain) {
 template<typename T, template<typename U> class Descriptor>
 void BlockLattice3D<T,Descriptor>::collideAndStream() {
     collideAndStream(this->getBoundingBox());
+    // The implicit periodicity of a stand-alone block-lattice, as well as
+    //   the internal processors, require the populations in natural order.
+    completeStream();
 
     implementPeriodicity();
 
@@ -325,6 +391,279 @@ void BlockLattice3D<T,Descriptor>::collideAndStream() {
     this->incrementTime();
 }
 
+template<typename T, template<typename U> class Descriptor>
+void BlockLattice3D<T,Descriptor>::setPropagationScheme(propagation::SchemeT scheme) {
+    if (scheme==propagation::swap) {
+        completeStream();
+    }
+    propagationScheme = scheme;
+}
+
+/** After the collision step of the AA-pattern, the populations are stored
+ * in reverted order, exactly as after collide(Box3D). The pending streaming
+ * step is therefore the one of stream(Box3D).
+ */
+template<typename T, template<typename U> class Descriptor>
+void BlockLattice3D<T,Descriptor>::completeStream() {
+    if (streamIsPending) {
+        stream(pendingStreamDomain);
+        streamIsPending = false;
+    }
+}
+
+template<typename T, template<typename U> class Descriptor>
+void BlockLattice3D<T,Descriptor>::setCollisionPolicy(CollisionPolicy3D<T,Descriptor>* policy) {
+    delete collisionPolicy;
+    collisionPolicy = policy;
+}
+
+template<typename T, template<typename U> class Descriptor>
+activity::ClassT BlockLattice3D<T,Descriptor>::getActivity() const {
+    if ( !activityIsValid ||
+         activityRevision!=vectorizedCollision3D<T,Descriptor>::parameterRevision().load() )
+    {
+        classifyActivity();
+    }
+    return activityClass;
+}
+
+template<typename T, template<typename U> class Descriptor>
+void BlockLattice3D<T,Descriptor>::setActivityDomain(Box3D domain) {
+    activityDomain = domain;
+    activityIsValid = false;
+}
+
+template<typename T, template<typename U> class Descriptor>
+bool BlockLattice3D<T,Descriptor>::isIdle() const {
+    return getActivity()==activity::inactive &&
+           this->getTimeCounter().getTime() > inactiveSince;
+}
+
+/** Consecutive cells often share their dynamics object, in which case it
+ *  is inspected only once. A dictionary entry is homogeneous if all its
+ *  cells are pure BGK cells in the sense of vectorizedCollision3D, with the
+ *  same parameters. The lattice is uniform if all cells belong to a single
+ *  homogeneous entry. It is inactive if all cells of the activity domain
+ *  have NoDynamics, which is read from their dynamics ids.
+ */
+template<typename T, template<typename U> class Descriptor>
+void BlockLattice3D<T,Descriptor>::classifyActivity() const {
+    // Read before the cells, so that a concurrent modification leads to a new evaluation.
+    activityRevision = vectorizedCollision3D<T,Descriptor>::parameterRevision().load();
+    plint numIds = (plint)dynamicsTypes.size();
+    std::vector<bool> isNoDynamics(numIds), isUsed(numIds, false), hasParameters(numIds, false);
+    std::vector<PureBGKParameters<T> > firstParameters(numIds);
+    homogeneousBGK.assign(numIds, false);
+    for (plint id=0; id<numIds; ++id) {
+        isNoDynamics[id] = *dynamicsTypes[id]==typeid(NoDynamics<T,Descriptor>);
+        homogeneousBGK[id] = *dynamicsTypes[id]==typeid(BGKdynamics<T,Descriptor>) ||
+                             *dynamicsTypes[id]==typeid(IncBGKdynamics<T,Descriptor>);
+    }
+    bool allSolid = true;
+    PureBGKParameters<T> parameters;
+    Dynamics<T,Descriptor> const* previousDynamics = 0;
+    for (plint iX=0; iX<this->getNx(); ++iX) {
+        for (plint iY=0; iY<this->getNy(); ++iY) {
+            bool lineIsInDomain = iX>=activityDomain.x0 && iX<=activityDomain.x1 &&
+                                  iY>=activityDomain.y0 && iY<=activityDomain.y1;
+            unsigned short const* ids = getDynamicsIds(iX,iY);
+            for (plint iZ=0; iZ<this->getNz(); ++iZ) {
+                plint id = ids[iZ];
+                isUsed[id] = true;
+                if ( allSolid && lineIsInDomain &&
+                     iZ>=activityDomain.z0 && iZ<=activityDomain.z1 && !isNoDynamics[id] )
+                {
+                    allSolid = false;
+                }
+                Dynamics<T,Descriptor> const* dynamics = &grid[iX][iY][iZ].getDynamics();
+                if (!homogeneousBGK[id] || dynamics==previousDynamics) {
+                    continue;
+                }
+                previousDynamics = dynamics;
+                vectorizedCollision3D<T,Descriptor>::identifyPureBGK(*dynamics, parameters);
+                if (!hasParameters[id]) {
+                    firstParameters[id] = parameters;
+                    hasParameters[id] = true;
+                }
+                else if ( parameters.omega!=firstParameters[id].omega ||
+                          parameters.invRho0!=firstParameters[id].invRho0 )
+                {
+                    homogeneousBGK[id] = false;
+                }
+            }
+        }
+    }
+    plint numUsed = 0;
+    bool allUniform = true;
+    for (plint id=0; id<numIds; ++id) {
+        if (isUsed[id]) {
+            ++numUsed;
+            allUniform = allUniform && homogeneousBGK[id];
+        }
+    }
+    allUniform = allUniform && numUsed==1;
+    activity::ClassT newClass = allSolid ? activity::inactive :
+                                    (allUniform ? activity::uniform : activity::mixed);
+    // A lattice that becomes inactive is executed during one more time step.
+    if (newClass==activity::inactive && activityClass!=activity::inactive) {
+        inactiveSince = this->getTimeCounter().getTime();
+    }
+    activityClass = newClass;
+    activityIsValid = true;
+}
+
+template<typename T, template<typename U> class Descriptor>
+bool BlockLattice3D<T,Descriptor>::isHomogeneousBGK(plint id) const {
+    PLB_PRECONDITION(id>=0 && id<getNumDynamicsIds());
+    getActivity();
+    return homogeneousBGK[id];
+}
+
+/** The segment is cut into runs of consecutive cells with the same dynamics
+ *  id. The runs of a homogeneous entry (see classifyActivity()) are collided
+ *  by the vectorized BGK kernel, even though their cells point to different
+ *  copies of the dynamics object. The parameters are read once per run, on
+ *  its first cell, so that modifications which apply to the whole lattice
+ *  are accounted for. On a uniform lattice, the segment is a single run.
+ *  The other cells go through the collision policy, or Dynamics::collide.
+ */
+template<typename T, template<typename U> class Descriptor>
+void BlockLattice3D<T,Descriptor>::collideSegment (
+        Cell<T,Descriptor>* cells, unsigned short const* ids, plint numCells )
+{
+    BlockStatistics& statistics = this->getInternalStatistics();
+    bool vectorized = SimdPack<T>::vectorized;
+    if (vectorized) {
+        getActivity();
+    }
+    plint iCell = 0;
+    while (iCell<numCells) {
+        plint endOfRun = iCell+1;
+        PureBGKParameters<T> parameters;
+        if ( vectorized && homogeneousBGK[ids[iCell]] &&
+             vectorizedCollision3D<T,Descriptor>::identifyPureBGK(cells[iCell].getDynamics(), parameters) )
+        {
+            while (endOfRun<numCells && ids[endOfRun]==ids[iCell]) {
+                ++endOfRun;
+            }
+            vectorizedCollision3D<T,Descriptor>::bgkCollide (
+                    cells+iCell, endOfRun-iCell, parameters, statistics );
+        }
+        else {
+            while (endOfRun<numCells && !(vectorized && homogeneousBGK[ids[endOfRun]])) {
+                ++endOfRun;
+            }
+            if (collisionPolicy) {
+                collisionPolicy->collide(*this, cells+iCell, ids+iCell, endOfRun-iCell, statistics);
+            }
+            else {
+                for (plint iRun=iCell; iRun<endOfRun; ++iRun) {
+                    cells[iRun].collide(statistics);
+                }
+            }
+        }
+        iCell = endOfRun;
+    }
+}
+
+/** The shell is split from the interior in the same way as the boundary
+ *  envelope in collideAndStream(Box3D). The links between the shell and
+ *  the interior are streamed once the interior has collided.
+ */
+template<typename T, template<typename U> class Descriptor>
+void BlockLattice3D<T,Descriptor>::collideAndStreamShell(Box3D domain, plint shellWidth) {
+    PLB_PRECONDITION( contained(domain, this->getBoundingBox()) );
+    PLB_PRECONDITION( shellWidth>=Descriptor<T>::vicinity );
+    PLB_PRECONDITION( propagationScheme==propagation::swap );
+    if (isIdle()) {
+        return;
+    }
+
+    Box3D interior(domain.enlarge(-shellWidth));
+    if ( interior.x0>interior.x1 || interior.y0>interior.y1 || interior.z0>interior.z1 ) {
+        // The domain is too thin to have an interior.
+        collideAndStream(domain);
+        return;
+    }
+
+    static const plint vicinity = Descriptor<T>::vicinity;
+
+    global::profiler().start("collStream");
+    global::profiler().incrementCollStream(domain.nCells()-interior.nCells(), 2*Descriptor<T>::q*sizeof(T));
+    // As in collideAndStream(Box3D), the cells close to the border of the
+    //   domain collide first and stream at the end. So do the cells close to
+    //   the interior, whose links to the interior are left for later.
+    Box3D core(domain.enlarge(-vicinity));
+    Box3D rim(interior.enlarge(vicinity));
+    std::vector<Box3D> borderCells, rimCells;
+    if (contained(rim, core)) {
+        except(domain, core, borderCells);
+        except(rim, interior, rimCells);
+    }
+    else {
+        except(domain, interior, borderCells);
+    }
+    for (pluint iBox=0; iBox<borderCells.size(); ++iBox) {
+        collide(borderCells[iBox]);
+    }
+    for (pluint iBox=0; iBox<rimCells.size(); ++iBox) {
+        collide(rimCells[iBox]);
+    }
+
+    // In between, the cells are traversed in the same order as in
+    //   linearBulkCollideAndStream(), leaving out the rim and the interior.
+    if (!rimCells.empty()) {
+        for (plint iX=core.x0; iX<=core.x1; ++iX) {
+            for (plint iY=core.y0; iY<=core.y1; ++iY) {
+                bool crossesRim = contained(iX,iY,rim.z0, rim);
+                plint numSegments = crossesRim ? 2 : 1;
+                for (plint iSegment=0; iSegment<numSegments; ++iSegment) {
+                    plint z0 = (iSegment==0) ? core.z0 : rim.z1+1;
+                    plint z1 = (crossesRim && iSegment==0) ? rim.z0-1 : core.z1;
+                    collideSegment(&grid[iX][iY][z0], getDynamicsIds(iX,iY)+z0, z1-z0+1);
+                    for (plint iZ=z0; iZ<=z1; ++iZ) {
+                        latticeTemplates<T,Descriptor>::swapAndStream3D(grid, iX, iY, iZ);
+                    }
+                }
+            }
+        }
+    }
+
+    for (pluint iBox=0; iBox<borderCells.size(); ++iBox) {
+        shellStream(domain, interior, borderCells[iBox], false);
+    }
+    for (pluint iBox=0; iBox<rimCells.size(); ++iBox) {
+        shellStream(domain, interior, rimCells[iBox], false);
+    }
+    global::profiler().stop("collStream");
+}
+
+template<typename T, template<typename U> class Descriptor>
+void BlockLattice3D<T,Descriptor>::collideAndStreamInterior(Box3D domain, plint shellWidth) {
+    PLB_PRECONDITION( contained(domain, this->getBoundingBox()) );
+    if (isIdle()) {
+        return;
+    }
+
+    Box3D interior(domain.enlarge(-shellWidth));
+    if ( interior.x0>interior.x1 || interior.y0>interior.y1 || interior.z0>interior.z1 ) {
+        return;
+    }
+
+    global::profiler().start("collStream");
+    global::profiler().incrementCollStream(interior.nCells(), 2*Descriptor<T>::q*sizeof(T));
+    // The bulk algorithm streams the links of the interior cells towards the
+    //   shell; the remaining links start from the cells of the shell which
+    //   are adjacent to the interior.
+    bulkCollideAndStream(interior);
+    std::vector<Box3D> rim;
+    except(interior.enlarge(Descriptor<T>::vicinity), interior, rim);
+    for (pluint iBox=0; iBox<rim.size(); ++iBox) {
+        shellStream(domain, interior, rim[iBox], true);
+    }
+    global::profiler().stop("collStream");
+}
+
 template<typename T, template<typename U> class Descriptor>
 void BlockLattice3D<T,Descriptor>::incrementTime() {
     this->getTimeCounter().incrementTime();
@@ -381,6 +720,24 @@ void BlockLattice3D<T,Descriptor>::attributeDynamics (
         delete previousDynamics;
     }
     grid[iX][iY][iZ].attributeDynamics(dynamics);
+    dynamicsIds[(iX*this->getNy()+iY)*this->getNz()+iZ] = findDynamicsId(*dynamics);
+    activityIsValid = false;
+}
+
+/** The dictionary holds only a few entries, it is searched linearly. */
+template<typename T, template<typename U> class Descriptor>
+unsigned short BlockLattice3D<T,Descriptor>::findDynamicsId(Dynamics<T,Descriptor> const& dynamics) {
+    std::type_info const& type = typeid(dynamics);
+    for (pluint id=0; id<dynamicsTypes.size(); ++id) {
+        if (*dynamicsTypes[id]==type) {
+            return (unsigned short)id;
+        }
+    }
+    if (dynamicsTypes.size()>65535) {
+        plbLogicError("Too many classes of dynamics on one block-lattice.");
+    }
+    dynamicsTypes.push_back(&type);
+    return (unsigned short)(dynamicsTypes.size()-1);
 }
 
 template<typename T, template<typename U> class Descriptor>
@@ -426,6 +783,44 @@ void BlockLattice3D<T,Descriptor>::boundaryStream(Box3D bound, Box3D domain) {
     }
 }
 
+template<typename T, template<typename U> class Descriptor>
+void BlockLattice3D<T,Descriptor>::shellStream(Box3D bound, Box3D inner, Box3D domain, bool intoInner) {
+    PLB_PRECONDITION( contained(bound, this->getBoundingBox()) );
+    PLB_PRECONDITION( contained(domain, bound) );
+
+    // The cells are selected population by population, as the intersection
+    //   of domain with bound and inner shifted by the lattice vector.
+    std::vector<Box3D> sources;
+    for (plint iPop=1; iPop<=Descriptor<T>::q/2; ++iPop) {
+        plint cX = Descriptor<T>::c[iPop][0];
+        plint cY = Descriptor<T>::c[iPop][1];
+        plint cZ = Descriptor<T>::c[iPop][2];
+        Box3D source, innerSource;
+        sources.clear();
+        if (intersect(domain, bound.shift(-cX,-cY,-cZ), source)) {
+            if (intoInner) {
+                if (intersect(source, inner.shift(-cX,-cY,-cZ), innerSource)) {
+                    sources.push_back(innerSource);
+                }
+            }
+            else {
+                except(source, inner.shift(-cX,-cY,-cZ), sources);
+            }
+        }
+        for (pluint iSource=0; iSource<sources.size(); ++iSource) {
+            Box3D const& box = sources[iSource];
+            for (plint iX=box.x0; iX<=box.x1; ++iX) {
+                for (plint iY=box.y0; iY<=box.y1; ++iY) {
+                    for (plint iZ=box.z0; iZ<=box.z1; ++iZ) {
+                        std::swap(grid[iX][iY][iZ][iPop+Descriptor<T>::q/2],
+                                  grid[iX+cX][iY+cY][iZ+cZ][iPop]);
+                    }
+                }
+            }
+        }
+    }
+}
+
 /** This method is faster than boundaryStream(int,int,int,int,int,int), but it
  * is erroneous when applied to boundary cells.
  * \sa stream(int,int,int,int,int,int)
@@ -486,8 +881,10 @@ void BlockLattice3D<T,Descriptor>::linearBulkCollideAndStream(Box3D domain) {
 
     for (plint iX=domain.x0; iX<=domain.x1; ++iX) {
         for (plint iY=domain.y0; iY<=domain.y1; ++iY) {
+            // Collide the whole line first, then stream: the swap-operations
+            //   of a cell never modify the cells which follow it on the same line.
+            collideSegment(&grid[iX][iY][domain.z0], getDynamicsIds(iX,iY)+domain.z0, domain.getNz());
             for (plint iZ=domain.z0; iZ<=domain.z1; ++iZ) {
-                grid[iX][iY][iZ].collide(this->getInternalStatistics());
                 latticeTemplates<T,Descriptor>::swapAndStream3D(grid, iX, iY, iZ);
             }
         }
@@ -530,17 +927,18 @@ void BlockLattice3D<T,Descriptor>::blockwiseBulkCollideAndStream(Box3D domain) {
                         // Z-index is shifted in negative direction at each x-increment. and at each
                         //    y-increment, to ensure that only post-collision cells are accessed during
                         //    the swap-operation of the streaming.
-                        plint minZ = outerZ-dx-dy;
-                        plint maxZ = minZ+blockSize-1;
-                        for (plint innerZ=std::max(minZ,domain.z0);
-                             innerZ <= std::min(maxZ, domain.z1);
-                             ++innerZ)
-                        {
-                            // Collide the cell.
-                            grid[innerX][innerY][innerZ].collide (
-                                    this->getInternalStatistics() );
+                        plint minZ = std::max(outerZ-dx-dy, domain.z0);
+                        plint maxZ = std::min(outerZ-dx-dy+blockSize-1, domain.z1);
+                        // Collide the cells of the line segment. Homogeneous BGK
+                        //   runs are handled by a vectorized kernel.
+                        if (minZ<=maxZ) {
+                            collideSegment(&grid[innerX][innerY][minZ], getDynamicsIds(innerX,innerY)+minZ, maxZ-minZ+1);
+                        }
+                        for (plint innerZ=minZ; innerZ<=maxZ; ++innerZ) {
                             // Swap the populations on the cell, and then with post-collision
-                            //   neighboring cell, to perform the streaming step.
+                            //   neighboring cell, to perform the streaming step. The
+                            //   swap-operations of a cell never modify the cells which
+                            //   follow it on the same line, which have already collided.
                             latticeTemplates<T,Descriptor>::swapAndStream3D (
                                     grid, innerX, innerY, innerZ );
                         }
@@ -551,6 +949,121 @@ void BlockLattice3D<T,Descriptor>::blockwiseBulkCollideAndStream(Box3D domain) {
     }
 }
 
+/** When this method is invoked, the cells hold their post-collision
+ * populations of the previous step in reverted order (see collide(Box3D)).
+ * The population f_i of a cell is therefore read from the opposite slot of
+ * the neighbor at -c_i, and after collision it is written into slot i of
+ * the neighbor at +c_i. The locations read and written for a cell are the
+ * same, and they are disjoint from those of all other cells, which makes
+ * the update in-place. On the boundary of the domain, the populations that
+ * would be streamed outside are bounced back, as in boundaryStream(). The
+ * result is identical to that of two swap-based collision-streaming steps.
+ */
+template<typename T, template<typename U> class Descriptor>
+void BlockLattice3D<T,Descriptor>::pullCollideAndPush(Box3D domain) {
+    // Make sure domain is contained within current lattice
+    PLB_PRECONDITION( contained(domain, this->getBoundingBox()) );
+    if (domain.nCells()<=0) {
+        return;
+    }
+
+    static const plint vicinity = Descriptor<T>::vicinity;
+    static const plint q = Descriptor<T>::q;
+    // Distance in memory to the neighbor at c_i, and index of the opposite
+    //   population (the populations i and i+q/2 are opposite).
+    plint offset[q], opposite[q];
+    for (plint iPop=0; iPop<q; ++iPop) {
+        offset[iPop] = ( Descriptor<T>::c[iPop][0]*this->getNy() +
+                         Descriptor<T>::c[iPop][1] ) * this->getNz() + Descriptor<T>::c[iPop][2];
+        opposite[iPop] = iPop==0 ? 0 : (iPop<=q/2 ? iPop+q/2 : iPop-q/2);
+    }
+
+    // For cache efficiency, memory is traversed block-wise along y and z. The
+    //   order is arbitrary, because the cells are updated independently.
+    const plint blockSize = cachePolicy().getBlockSize();
+    // The populations of a line segment are gathered into scratch cells, so
+    //   that they can be collided together.
+    std::vector<Cell<T,Descriptor> > line(std::min(blockSize, domain.getNz()));
+    // Outer loops.
+    for (plint outerY=domain.y0; outerY<=domain.y1; outerY+=blockSize) {
+        for (plint outerZ=domain.z0; outerZ<=domain.z1; outerZ+=blockSize) {
+            plint maxY = std::min(outerY+blockSize-1, domain.y1);
+            plint minZ = outerZ;
+            plint maxZ = std::min(outerZ+blockSize-1, domain.z1);
+            // Inner loops.
+            for (plint iX=domain.x0; iX<=domain.x1; ++iX) {
+                for (plint iY=outerY; iY<=maxY; ++iY) {
+                    bool boundaryLine = iX<domain.x0+vicinity || iX>domain.x1-vicinity ||
+                                        iY<domain.y0+vicinity || iY>domain.y1-vicinity;
+                    // Pull.
+                    for (plint iZ=minZ; iZ<=maxZ; ++iZ) {
+                        Cell<T,Descriptor>* cell = &grid[iX][iY][iZ];
+                        Cell<T,Descriptor>& scratch = line[iZ-minZ];
+                        scratch.attributeDynamics(&cell->getDynamics());
+                        scratch.specifyStatisticsStatus(cell->takesStatistics());
+                        for (plint iExt=0; iExt<Descriptor<T>::ExternalField::numScalars; ++iExt) {
+                            *scratch.getExternal(iExt) = *cell->getExternal(iExt);
+                        }
+                        scratch[0] = (*cell)[0];
+                        if ( boundaryLine || iZ<domain.z0+vicinity || iZ>domain.z1-vicinity ) {
+                            for (plint iPop=1; iPop<q; ++iPop) {
+                                if ( contained(iX-Descriptor<T>::c[iPop][0], iY-Descriptor<T>::c[iPop][1],
+                                               iZ-Descriptor<T>::c[iPop][2], domain) )
+                                {
+                                    scratch[iPop] = (*(cell-offset[iPop]))[opposite[iPop]];
+                                }
+                                else {
+                                    // Bounce-back of the population that was not streamed.
+                                    scratch[iPop] = (*cell)[iPop];
+                                }
+                            }
+                        }
+                        else {
+                            // With compile-time population indices, the loop over
+                            //   pairs of opposite populations is considerably faster.
+                            for (plint iPop=1; iPop<=q/2; ++iPop) {
+                                scratch[iPop]     = (*(cell-offset[iPop]))[iPop+q/2];
+                                scratch[iPop+q/2] = (*(cell+offset[iPop]))[iPop];
+                            }
+                        }
+                    }
+
+                    // Collide.
+                    collideSegment(&line[0], getDynamicsIds(iX,iY)+minZ, maxZ-minZ+1);
+
+                    // Push.
+                    for (plint iZ=minZ; iZ<=maxZ; ++iZ) {
+                        Cell<T,Descriptor>* cell = &grid[iX][iY][iZ];
+                        Cell<T,Descriptor> const& scratch = line[iZ-minZ];
+                        for (plint iExt=0; iExt<Descriptor<T>::ExternalField::numScalars; ++iExt) {
+                            *cell->getExternal(iExt) = *scratch.getExternal(iExt);
+                        }
+                        (*cell)[0] = scratch[0];
+                        if ( boundaryLine || iZ<domain.z0+vicinity || iZ>domain.z1-vicinity ) {
+                            for (plint iPop=1; iPop<q; ++iPop) {
+                                if ( contained(iX+Descriptor<T>::c[iPop][0], iY+Descriptor<T>::c[iPop][1],
+                                               iZ+Descriptor<T>::c[iPop][2], domain) )
+                                {
+                                    (*(cell+offset[iPop]))[iPop] = scratch[iPop];
+                                }
+                                else {
+                                    (*cell)[opposite[iPop]] = scratch[iPop];
+                                }
+                            }
+                        }
+                        else {
+                            for (plint iPop=1; iPop<=q/2; ++iPop) {
+                                (*(cell+offset[iPop]))[iPop]     = scratch[iPop];
+                                (*(cell-offset[iPop]))[iPop+q/2] = scratch[iPop+q/2];
+                            }
+                        }
+                    }
+                }
+            }
+        }
+    }
+}
+
 template<typename T, template<typename U> class Descriptor>
 void BlockLattice3D<T,Descriptor>::implementPeriodicity() {
     static const plint vicinity = Descriptor<T>::vicinity;
@@ -693,31 +1206,42 @@ template<typename T, template<typename U> class Descriptor>
 void BlockLatticeDataTransfer3D<T,Descriptor>::send_dynamic (
         Box3D domain, std::vector<char>& buffer ) const
 {
+    DynamicsMap3D<T,Descriptor> dynamicsMap;
+    mapDynamics(lattice, domain, dynamicsMap);
+    dynamicsMap.serialize(buffer);
+}
+
+/** The dynamics of all cells are written first, as a DynamicsMap3D, followed
+ *  by the static data of all cells.
+ */
+template<typename T, template<typename U> class Descriptor>
+void BlockLatticeDataTransfer3D<T,Descriptor>::send_all (
+        Box3D domain, std::vector<char>& buffer ) const
+{
+    send_dynamic(domain, buffer);
+    plint cellSize = staticCellSize();
+    if (cellSize==0 || domain.nCells()==0) return;
+    pluint pos = buffer.size();
+    buffer.resize(pos+domain.nCells()*cellSize);
     for (plint iX=domain.x0; iX<=domain.x1; ++iX) {
         for (plint iY=domain.y0; iY<=domain.y1; ++iY) {
             for (plint iZ=domain.z0; iZ<=domain.z1; ++iZ) {
-                // The serialize function automatically reallocates memory for buffer.
-                serialize(lattice.get(iX,iY,iZ).getDynamics(), buffer);
+                lattice.get(iX,iY,iZ).serialize(&buffer[pos]);
+                pos += cellSize;
             }
         }
     }
 }
 
 template<typename T, template<typename U> class Descriptor>
-void BlockLatticeDataTransfer3D<T,Descriptor>::send_all (
-        Box3D domain, std::vector<char>& buffer ) const
+void BlockLatticeDataTransfer3D<T,Descriptor>::mapDynamics (
+        BlockLattice3D<T,Descriptor> const& from, Box3D domain,
+        DynamicsMap3D<T,Descriptor>& dynamicsMap )
 {
     for (plint iX=domain.x0; iX<=domain.x1; ++iX) {
         for (plint iY=domain.y0; iY<=domain.y1; ++iY) {
             for (plint iZ=domain.z0; iZ<=domain.z1; ++iZ) {
-                // 1. Send dynamic info (automaic allocation of buffer memory).
-                serialize(lattice.get(iX,iY,iZ).getDynamics(), buffer);
-                pluint pos = buffer.size();
-                // 2. Send static info (needs manual allocation of buffer memory).
-                if (staticCellSize()>0) {
-                    buffer.resize(pos+staticCellSize());
-                    lattice.get(iX,iY,iZ).serialize(&buffer[pos]);
-                }
+                dynamicsMap.add(from.get(iX,iY,iZ).getDynamics());
             }
         }
     }
@@ -781,67 +1305,90 @@ template<typename T, template<typename U> class Descriptor>
 void BlockLatticeDataTransfer3D<T,Descriptor>::receive_dynamic (
         Box3D domain, std::vector<char> const& buffer )
 {
-    pluint serializerPos = 0;
+    DynamicsMap3D<T,Descriptor> dynamicsMap;
+    dynamicsMap.unserialize(buffer, 0);
+    assignDynamics(domain, dynamicsMap);
+}
+
+template<typename T, template<typename U> class Descriptor>
+void BlockLatticeDataTransfer3D<T,Descriptor>::receive_all (
+        Box3D domain, std::vector<char> const& buffer )
+{
+    DynamicsMap3D<T,Descriptor> dynamicsMap;
+    pluint posInBuffer = dynamicsMap.unserialize(buffer, 0);
+    assignDynamics(domain, dynamicsMap);
+    receiveStaticData(domain, buffer, posInBuffer);
+}
+
+template<typename T, template<typename U> class Descriptor>
+void BlockLatticeDataTransfer3D<T,Descriptor>::receive_regenerate (
+        Box3D domain, std::vector<char> const& buffer, std::map<int,int> const& idIndirect )
+{
+    DynamicsMap3D<T,Descriptor> dynamicsMap;
+    pluint posInBuffer = dynamicsMap.unserialize(buffer, 0);
+    regenerateDynamics(domain, dynamicsMap, idIndirect.empty() ? 0 : &idIndirect);
+    receiveStaticData(domain, buffer, posInBuffer);
+}
+
+template<typename T, template<typename U> class Descriptor>
+void BlockLatticeDataTransfer3D<T,Descriptor>::receiveStaticData (
+        Box3D domain, std::vector<char> const& buffer, pluint posInBuffer )
+{
+    plint cellSize = staticCellSize();
+    if (cellSize==0) return;
+    PLB_ASSERT( posInBuffer+domain.nCells()*cellSize<=buffer.size() );
     for (plint iX=domain.x0; iX<=domain.x1; ++iX) {
         for (plint iY=domain.y0; iY<=domain.y1; ++iY) {
             for (plint iZ=domain.z0; iZ<=domain.z1; ++iZ) {
-                // No assert is included here, because incompatible types of
-                //   dynamics are detected by asserts inside HierarchicUnserializer.
-                serializerPos = 
-                    unserialize (
-                        lattice.get(iX,iY,iZ).getDynamics(), buffer, serializerPos );
+                lattice.get(iX,iY,iZ).unSerialize(&buffer[posInBuffer]);
+                posInBuffer += cellSize;
             }
         }
     }
 }
 
 template<typename T, template<typename U> class Descriptor>
-void BlockLatticeDataTransfer3D<T,Descriptor>::receive_all (
-        Box3D domain, std::vector<char> const& buffer )
+void BlockLatticeDataTransfer3D<T,Descriptor>::assignDynamics (
+        Box3D domain, DynamicsMap3D<T,Descriptor> const& dynamicsMap )
 {
-    pluint posInBuffer = 0;
-    plint cellSize = staticCellSize();
+    PLB_ASSERT( dynamicsMap.getNumCells()==domain.nCells() );
+    plint iCell = 0;
     for (plint iX=domain.x0; iX<=domain.x1; ++iX) {
         for (plint iY=domain.y0; iY<=domain.y1; ++iY) {
             for (plint iZ=domain.z0; iZ<=domain.z1; ++iZ) {
-                // 1. Unserialize dynamic data.
-                posInBuffer = 
-                    unserialize (
-                        lattice.get(iX,iY,iZ).getDynamics(), buffer, posInBuffer );
-                // 2. Unserialize static data.
-                if (staticCellSize()>0) {
-                    lattice.get(iX,iY,iZ).unSerialize(&buffer[posInBuffer]);
-                    posInBuffer += cellSize;
-                }
+                // No assert is included here, because incompatible types of
+                //   dynamics are detected by asserts inside HierarchicUnserializer.
+                dynamicsMap.assign(dynamicsMap.getId(iCell++), lattice.get(iX,iY,iZ).getDynamics());
             }
         }
     }
+    // The parameters of the dynamics are modified in place.
+    lattice.invalidateActivity();
 }
 
+/** Each entry of the map is unserialized only once. The first cell which
+ *  refers to it receives the generated object, and the other ones a clone.
+ */
 template<typename T, template<typename U> class Descriptor>
-void BlockLatticeDataTransfer3D<T,Descriptor>::receive_regenerate (
-        Box3D domain, std::vector<char> const& buffer, std::map<int,int> const& idIndirect )
+void BlockLatticeDataTransfer3D<T,Descriptor>::regenerateDynamics (
+        Box3D domain, DynamicsMap3D<T,Descriptor> const& dynamicsMap,
+        std::map<int,int> const* idIndirect )
 {
-    pluint posInBuffer = 0;
-    plint cellSize = staticCellSize();
+    PLB_ASSERT( dynamicsMap.getNumCells()==domain.nCells() );
+    std::vector<Dynamics<T,Descriptor>*> prototypes(dynamicsMap.getNumEntries(), 0);
+    plint iCell = 0;
     for (plint iX=domain.x0; iX<=domain.x1; ++iX) {
         for (plint iY=domain.y0; iY<=domain.y1; ++iY) {
             for (plint iZ=domain.z0; iZ<=domain.z1; ++iZ) {
-                // 1. Generate dynamics object, and unserialize dynamic data.
-                std::map<int,int> const* indirectPtr = idIndirect.empty() ? 0 : &idIndirect;
-                HierarchicUnserializer unserializer(buffer, posInBuffer, indirectPtr);
-                Dynamics<T,Descriptor>* newDynamics =
-                    meta::dynamicsRegistration<T,Descriptor>().generate(unserializer);
-                posInBuffer = unserializer.getCurrentPos();
-                lattice.attributeDynamics(iX,iY,iZ, newDynamics);
-
-                // 2. Unserialize static data.
-                if (staticCellSize()>0) {
-                    PLB_ASSERT( !buffer.empty() );
-                    PLB_ASSERT( posInBuffer+cellSize<=buffer.size() );
-                    lattice.get(iX,iY,iZ).unSerialize(&buffer[posInBuffer]);
-                    posInBuffer += cellSize;
+                plint id = dynamicsMap.getId(iCell++);
+                Dynamics<T,Descriptor>* newDynamics = 0;
+                if (prototypes[id]) {
+                    newDynamics = prototypes[id]->clone();
                 }
+                else {
+                    newDynamics = prototypes[id] = dynamicsMap.generate(id, idIndirect);
+                }
+                lattice.attributeDynamics(iX,iY,iZ, newDynamics);
             }
         }
     }
@@ -889,20 +1436,9 @@ void BlockLatticeDataTransfer3D<T,Descriptor>::attribute_dynamic (
         Box3D toDomain, plint deltaX, plint deltaY, plint deltaZ,
         BlockLattice3D<T,Descriptor> const& from )
 {
-    std::vector<char> serializedData;
-    for (plint iX=toDomain.x0; iX<=toDomain.x1; ++iX) {
-        for (plint iY=toDomain.y0; iY<=toDomain.y1; ++iY) {
-            for (plint iZ=toDomain.z0; iZ<=toDomain.z1; ++iZ) {
-                serializedData.clear();
-                serialize (
-                    from.get(iX+deltaX,iY+deltaY,iZ+deltaZ).getDynamics(),
-                    serializedData );
-                unserialize (
-                    lattice.get(iX,iY,iZ).getDynamics(),
-                    serializedData );
-            }
-        }
-    }
+    DynamicsMap3D<T,Descriptor> dynamicsMap;
+    mapDynamics(from, toDomain.shift(deltaX,deltaY,deltaZ), dynamicsMap);
+    assignDynamics(toDomain, dynamicsMap);
 }
 
 template<typename T, template<typename U> class Descriptor>
@@ -910,25 +1446,8 @@ void BlockLatticeDataTransfer3D<T,Descriptor>::attribute_all (
         Box3D toDomain, plint deltaX, plint deltaY, plint deltaZ,
         BlockLattice3D<T,Descriptor> const& from )
 {
-    std::vector<char> serializedData;
-    for (plint iX=toDomain.x0; iX<=toDomain.x1; ++iX) {
-        for (plint iY=toDomain.y0; iY<=toDomain.y1; ++iY) {
-            for (plint iZ=toDomain.z0; iZ<=toDomain.z1; ++iZ) {
-                // 1. Attribute dynamic content.
-                serializedData.clear();
-                serialize (
-                    from.get(iX+deltaX,iY+deltaY,iZ+deltaZ).getDynamics(),
-                    serializedData );
-                unserialize (
-                    lattice.get(iX,iY,iZ).getDynamics(),
-                    serializedData );
-
-                // 2. Attribute static content.
-                lattice.get(iX,iY,iZ).attributeValues (
-                        from.get(iX+deltaX,iY+deltaY,iZ+deltaZ) );
-            }
-        }
-    }
+    attribute_dynamic(toDomain, deltaX, deltaY, deltaZ, from);
+    attribute_static(toDomain, deltaX, deltaY, deltaZ, from);
 }
 
 template<typename T, template<typename U> class Descriptor>
@@ -936,26 +1455,10 @@ void BlockLatticeDataTransfer3D<T,Descriptor>::attribute_regenerate (
         Box3D toDomain, plint deltaX, plint deltaY, plint deltaZ,
         BlockLattice3D<T,Descriptor> const& from )
 {
-    std::vector<char> serializedData;
-    for (plint iX=toDomain.x0; iX<=toDomain.x1; ++iX) {
-        for (plint iY=toDomain.y0; iY<=toDomain.y1; ++iY) {
-            for (plint iZ=toDomain.z0; iZ<=toDomain.z1; ++iZ) {
-                // 1. Generate new dynamics and attribute dynamic content.
-                serializedData.clear();
-                serialize (
-                    from.get(iX+deltaX,iY+deltaY,iZ+deltaZ).getDynamics(),
-                    serializedData );
-                HierarchicUnserializer unserializer(serializedData, 0);
-                Dynamics<T,Descriptor>* newDynamics =
-                    meta::dynamicsRegistration<T,Descriptor>().generate(unserializer);
-                lattice.attributeDynamics(iX,iY,iZ, newDynamics);
-
-                // 2. Attribute static content.
-                lattice.get(iX,iY,iZ).attributeValues (
-                        from.get(iX+deltaX,iY+deltaY,iZ+deltaZ) );
-            }
-        }
-    }
+    DynamicsMap3D<T,Descriptor> dynamicsMap;
+    mapDynamics(from, toDomain.shift(deltaX,deltaY,deltaZ), dynamicsMap);
+    regenerateDynamics(toDomain, dynamicsMap);
+    attribute_static(toDomain, deltaX, deltaY, deltaZ, from);
 }
 
 template<typename T, template<typename U> class Descriptor>
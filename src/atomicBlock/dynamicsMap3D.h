@@ -0,0 +1,104 @@
+/* This file is part of the Palabos library.
+ *
+ * Copyright (C) 2011-2015 FlowKit Sarl
+ * Route d'Oron 2
+ * 1010 Lausanne, Switzerland
+ * E-mail contact: contact@flowkit.com
+ *
+ * The most recent release of Palabos can be downloaded at 
+ * <http://www.palabos.org/>
+ *
+ * The library Palabos is free software: you can redistribute it and/or
+ * modify it under the terms of the GNU Affero General Public License as
+ * published by the Free Software Foundation, either version 3 of the
+ * License, or (at your option) any later version.
+ *
+ * The library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+
+/** \file
+ * Compact representation of the dynamics of a 3D block domain -- header file.
+ */
+#ifndef DYNAMICS_MAP_3D_H
+#define DYNAMICS_MAP_3D_H
+
+#include "core/globalDefs.h"
+#include "core/plbDebug.h"
+#include <vector>
+#include <map>
+
+namespace plb {
+
+template<typename T, template<typename U> class Descriptor> struct Dynamics;
+
+/// Version of the layout of the dynamics in saved multi-block lattices.
+/** Version 1 serialized the dynamics object of every cell, version 2 writes
+ *  a DynamicsMap3D. Files with dynamic content are rejected if their version
+ *  differs.
+ */
+const int dynamicsFileFormat = 2;
+
+/// Dictionary of the distinct dynamics objects of a domain, plus one id per cell.
+/** Cells whose dynamics objects have the same serialized content share one
+ *  entry of the dictionary. In the serialized form, the ids are written with
+ *  1 byte if there are at most 256 entries, 2 bytes if there are at most
+ *  65536 entries, and 4 bytes otherwise. A homogeneous domain is therefore
+ *  represented by a single serialized dynamics object and one byte per cell.
+ *
+ *  This is the format in which the block-lattices transfer their dynamics
+ *  objects, in the communication of envelopes as well as in checkpoints.
+ */
+template<typename T, template<typename U> class Descriptor>
+class DynamicsMap3D {
+public:
+    DynamicsMap3D();
+    /// Append the dynamics of the next cell. Cells are added in the
+    ///   order in which they are traversed by the data transfer (z fastest).
+    void add(Dynamics<T,Descriptor> const& dynamics);
+    /// Number of cells added so far.
+    plint getNumCells() const { return (plint)ids.size(); }
+    /// Number of distinct entries in the dictionary.
+    plint getNumEntries() const { return (plint)entries.size(); }
+    /// Dictionary entry of a given cell.
+    plint getId(plint iCell) const {
+        PLB_PRECONDITION( iCell>=0 && iCell<getNumCells() );
+        return ids[iCell];
+    }
+    /// Serialized content of a dictionary entry.
+    std::vector<char> const& getEntry(plint id) const {
+        PLB_PRECONDITION( id>=0 && id<getNumEntries() );
+        return entries[id];
+    }
+    /// Number of bytes used per cell id in the serialized form.
+    int getIdSize() const;
+    /// Create a new dynamics object from a dictionary entry.
+    /** The dynamics ids contained in the entry can be re-mapped through
+     *  idIndirect, for data which was written by another program.
+     **/
+    Dynamics<T,Descriptor>* generate(plint id, std::map<int,int> const* idIndirect=0) const;
+    /// Overwrite the content of an existing dynamics object with a dictionary entry.
+    void assign(plint id, Dynamics<T,Descriptor>& dynamics) const;
+    /// Append the serialized map to buffer.
+    void serialize(std::vector<char>& buffer) const;
+    /// Replace the content of the map by the one serialized in buffer at
+    ///   position pos, and return the position which follows the map.
+    pluint unserialize(std::vector<char> const& buffer, pluint pos);
+private:
+    std::vector<std::vector<char> > entries;
+    std::vector<int> ids;
+    /// Lookup from the serialized content to the entry, while cells are added.
+    std::map<std::vector<char>,int> entryLookup;
+    /// The last added dynamics object; consecutive cells often share it.
+    Dynamics<T,Descriptor> const* lastDynamics;
+};
+
+}  // namespace plb
+
+#endif  // DYNAMICS_MAP_3D_H
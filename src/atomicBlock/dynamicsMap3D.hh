@@ -0,0 +1,193 @@
+/* This file is part of the Palabos library.
+ *
+ * Copyright (C) 2011-2015 FlowKit Sarl
+ * Route d'Oron 2
+ * 1010 Lausanne, Switzerland
+ * E-mail contact: contact@flowkit.com
+ *
+ * The most recent release of Palabos can be downloaded at 
+ * <http://www.palabos.org/>
+ *
+ * The library Palabos is free software: you can redistribute it and/or
+ * modify it under the terms of the GNU Affero General Public License as
+ * published by the Free Software Foundation, either version 3 of the
+ * License, or (at your option) any later version.
+ *
+ * The library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+
+/** \file
+ * Compact representation of the dynamics of a 3D block domain -- generic implementation.
+ */
+#ifndef DYNAMICS_MAP_3D_HH
+#define DYNAMICS_MAP_3D_HH
+
+#include "atomicBlock/dynamicsMap3D.h"
+#include "core/dynamics.h"
+#include "core/dynamicsIdentifiers.h"
+#include "core/hierarchicSerializer.h"
+#include "core/runTimeDiagnostics.h"
+#include <algorithm>
+#include <cstring>
+
+namespace plb {
+
+template<typename T, template<typename U> class Descriptor>
+DynamicsMap3D<T,Descriptor>::DynamicsMap3D()
+    : lastDynamics(0)
+{ }
+
+template<typename T, template<typename U> class Descriptor>
+void DynamicsMap3D<T,Descriptor>::add(Dynamics<T,Descriptor> const& dynamics) {
+    if (&dynamics==lastDynamics) {
+        ids.push_back(ids.back());
+        return;
+    }
+    std::vector<char> data;
+    plb::serialize(dynamics, data);
+    std::map<std::vector<char>,int>::const_iterator it = entryLookup.find(data);
+    if (it==entryLookup.end()) {
+        int id = (int)entries.size();
+        it = entryLookup.insert(std::make_pair(data, id)).first;
+        entries.push_back(data);
+    }
+    ids.push_back(it->second);
+    lastDynamics = &dynamics;
+}
+
+template<typename T, template<typename U> class Descriptor>
+int DynamicsMap3D<T,Descriptor>::getIdSize() const {
+    if (entries.size()<=256) {
+        return 1;
+    }
+    else if (entries.size()<=65536) {
+        return 2;
+    }
+    return 4;
+}
+
+template<typename T, template<typename U> class Descriptor>
+Dynamics<T,Descriptor>* DynamicsMap3D<T,Descriptor>::generate (
+        plint id, std::map<int,int> const* idIndirect ) const
+{
+    HierarchicUnserializer unserializer(getEntry(id), 0, idIndirect);
+    return meta::dynamicsRegistration<T,Descriptor>().generate(unserializer);
+}
+
+template<typename T, template<typename U> class Descriptor>
+void DynamicsMap3D<T,Descriptor>::assign(plint id, Dynamics<T,Descriptor>& dynamics) const {
+    plb::unserialize(dynamics, getEntry(id), 0);
+}
+
+/** Layout: number of entries, bytes per id, number of cells, then each entry
+ *  preceded by its size, and finally the ids of all cells.
+ */
+template<typename T, template<typename U> class Descriptor>
+void DynamicsMap3D<T,Descriptor>::serialize(std::vector<char>& buffer) const {
+    int numEntries = (int)entries.size();
+    int idSize = getIdSize();
+    plint numCells = getNumCells();
+    pluint numBytes = 2*sizeof(int) + sizeof(plint) + numCells*idSize;
+    for (pluint iEntry=0; iEntry<entries.size(); ++iEntry) {
+        numBytes += sizeof(pluint) + entries[iEntry].size();
+    }
+    pluint pos = buffer.size();
+    buffer.resize(pos+numBytes);
+    char* data = &buffer[pos];
+    memcpy(data, &numEntries, sizeof(int));  data += sizeof(int);
+    memcpy(data, &idSize, sizeof(int));      data += sizeof(int);
+    memcpy(data, &numCells, sizeof(plint));  data += sizeof(plint);
+    for (pluint iEntry=0; iEntry<entries.size(); ++iEntry) {
+        pluint entrySize = entries[iEntry].size();
+        memcpy(data, &entrySize, sizeof(pluint));  data += sizeof(pluint);
+        if (entrySize>0) {
+            memcpy(data, &entries[iEntry][0], entrySize);
+            data += entrySize;
+        }
+    }
+    for (plint iCell=0; iCell<numCells; ++iCell) {
+        if (idSize==1) {
+            *data = (char)(unsigned char)ids[iCell];
+        }
+        else if (idSize==2) {
+            unsigned short id = (unsigned short)ids[iCell];
+            memcpy(data, &id, 2);
+        }
+        else {
+            memcpy(data, &ids[iCell], 4);
+        }
+        data += idSize;
+    }
+}
+
+template<typename T, template<typename U> class Descriptor>
+pluint DynamicsMap3D<T,Descriptor>::unserialize(std::vector<char> const& buffer, pluint pos) {
+    entryLookup.clear();
+    lastDynamics = 0;
+    int numEntries, idSize;
+    plint numCells;
+    // The buffer comes from another process or from a file: its sizes are
+    //   checked against the end of the buffer before any access. The errors are
+    //   raised locally, as blocks are unserialized independently on each process.
+    if (pos > buffer.size() || buffer.size()-pos < 2*sizeof(int) + sizeof(plint)) {
+        plbIOError("Dynamics map truncated: incomplete header.");
+    }
+    char const* data = &buffer[pos];
+    char const* end = &buffer[0] + buffer.size();
+    memcpy(&numEntries, data, sizeof(int));  data += sizeof(int);
+    memcpy(&idSize, data, sizeof(int));      data += sizeof(int);
+    memcpy(&numCells, data, sizeof(plint));  data += sizeof(plint);
+    if (numEntries<0 || !(idSize==1 || idSize==2 || idSize==4) || numCells<0) {
+        plbIOError("Dynamics map corrupted: invalid header.");
+    }
+    entries.resize(numEntries);
+    for (int iEntry=0; iEntry<numEntries; ++iEntry) {
+        pluint entrySize;
+        if ((pluint)(end-data) < sizeof(pluint)) {
+            plbIOError("Dynamics map truncated: incomplete entry size.");
+        }
+        memcpy(&entrySize, data, sizeof(pluint));  data += sizeof(pluint);
+        if ((pluint)(end-data) < entrySize) {
+            plbIOError("Dynamics map truncated: incomplete entry.");
+        }
+        entries[iEntry].assign(data, data+entrySize);
+        data += entrySize;
+    }
+    if ((pluint)(end-data)/(pluint)idSize < (pluint)numCells) {
+        plbIOError("Dynamics map truncated: incomplete cell ids.");
+    }
+    ids.resize(numCells);
+    // An id out of range would make generate() and assign() read past the
+    //   dictionary; the unsigned maximum also catches negative 4-byte ids.
+    unsigned int maxId = 0;
+    for (plint iCell=0; iCell<numCells; ++iCell) {
+        if (idSize==1) {
+            ids[iCell] = (unsigned char)*data;
+        }
+        else if (idSize==2) {
+            unsigned short id;
+            memcpy(&id, data, 2);
+            ids[iCell] = id;
+        }
+        else {
+            memcpy(&ids[iCell], data, 4);
+        }
+        maxId = std::max(maxId, (unsigned int)ids[iCell]);
+        data += idSize;
+    }
+    if (numCells>0 && maxId>=(unsigned int)numEntries) {
+        plbIOError("Dynamics map corrupted: cell id out of range.");
+    }
+    return pos + (data-&buffer[pos]);
+}
+
+}  // namespace plb
+
+#endif  // DYNAMICS_MAP_3D_HH
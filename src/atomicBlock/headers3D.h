@@ -29,6 +29,7 @@
 #include "atomicBlock/atomicBlock3D.h"
 #include "atomicBlock/atomicContainerBlock3D.h"
 #include "atomicBlock/atomicBlockOperations3D.h"
+#include "atomicBlock/dynamicsMap3D.h"
 #include "atomicBlock/blockLattice3D.h"
 #include "atomicBlock/dataField3D.h"
 #include "atomicBlock/dataProcessor3D.h"
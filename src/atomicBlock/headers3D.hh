@@ -26,6 +26,7 @@
  * Groups all the 3D .hh headers of the directory atomicBlock.
  */
 
+#include "atomicBlock/dynamicsMap3D.hh"
 #include "atomicBlock/blockLattice3D.hh"
 #include "atomicBlock/dataField3D.hh"
 #include "atomicBlock/dataProcessingFunctional3D.hh"
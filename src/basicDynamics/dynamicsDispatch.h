@@ -0,0 +1,126 @@
+/* This file is part of the Palabos library.
+ *
+ * Copyright (C) 2011-2015 FlowKit Sarl
+ * Route d'Oron 2
+ * 1010 Lausanne, Switzerland
+ * E-mail contact: contact@flowkit.com
+ *
+ * The most recent release of Palabos can be downloaded at 
+ * <http://www.palabos.org/>
+ *
+ * The library Palabos is free software: you can redistribute it and/or
+ * modify it under the terms of the GNU Affero General Public License as
+ * published by the Free Software Foundation, either version 3 of the
+ * License, or (at your option) any later version.
+ *
+ * The library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+/** \file
+ * Compile-time dispatch of the collision on a list of dynamics types -- header file.
+ */
+#ifndef DYNAMICS_DISPATCH_H
+#define DYNAMICS_DISPATCH_H
+
+#include "core/globalDefs.h"
+#include "core/cell.h"
+#include "core/dynamics.h"
+#include "core/blockStatistics.h"
+#include <typeinfo>
+#include <vector>
+
+namespace plb {
+
+template<typename T, template<typename U> class Descriptor> class BlockLattice3D;
+
+/// A compile-time list of dynamics classes, used as a policy for DynamicsDispatch.
+template<class... DynamicsTypes>
+struct DynamicsList { };
+
+/// Collision through a switch on the position of the dynamics in a DynamicsList.
+/** The position of the exact type of a dynamics object in the list, its
+ *  "type index", is obtained with typeIndex(). The collision functions then
+ *  select the class with a chain of integer comparisons and call its collision
+ *  non-virtually, which lets the compiler inline the collision of each class
+ *  in the list. Dynamics which are not in the list (typeIndex() returns -1),
+ *  including classes derived from a class in the list, go through the usual
+ *  virtual call. With an empty list, the dispatch is purely virtual.
+ *
+ *  The type index is computed once per dynamics id of a block-lattice (see
+ *  BlockLattice3D::getDynamicsId()), as in ExternalRhoJcollideAndStream3D
+ *  and DispatchedCollision3D.
+ */
+template<typename T, template<typename U> class Descriptor, class List>
+struct DynamicsDispatch;
+
+template<typename T, template<typename U> class Descriptor>
+struct DynamicsDispatch<T,Descriptor,DynamicsList<> > {
+    static plint typeIndex(std::type_info const& type);
+    static plint typeIndex(Dynamics<T,Descriptor> const& dynamics);
+    static void collide( plint typeId, Dynamics<T,Descriptor>& dynamics,
+                         Cell<T,Descriptor>& cell, BlockStatistics& statistics );
+    static void collideExternal( plint typeId, Dynamics<T,Descriptor>& dynamics,
+                                 Cell<T,Descriptor>& cell, T rhoBar,
+                                 Array<T,Descriptor<T>::d> const& j, T thetaBar,
+                                 BlockStatistics& statistics );
+};
+
+template<typename T, template<typename U> class Descriptor, class Head, class... Tail>
+struct DynamicsDispatch<T,Descriptor,DynamicsList<Head,Tail...> > {
+    /// Position of a type in the list, or -1.
+    static plint typeIndex(std::type_info const& type);
+    /// Position of the exact type of dynamics in the list, or -1.
+    static plint typeIndex(Dynamics<T,Descriptor> const& dynamics);
+    /// Execute the collision step of dynamics, whose type index is typeId.
+    static void collide( plint typeId, Dynamics<T,Descriptor>& dynamics,
+                         Cell<T,Descriptor>& cell, BlockStatistics& statistics );
+    /// Execute the collision step of dynamics, whose type index is typeId,
+    ///   with externally computed rhoBar and j.
+    static void collideExternal( plint typeId, Dynamics<T,Descriptor>& dynamics,
+                                 Cell<T,Descriptor>& cell, T rhoBar,
+                                 Array<T,Descriptor<T>::d> const& j, T thetaBar,
+                                 BlockStatistics& statistics );
+private:
+    typedef DynamicsDispatch<T,Descriptor,DynamicsList<Tail...> > TailDispatch;
+};
+
+/// Collision of the cells of a BlockLattice3D which are not relaxed by a vectorized kernel.
+/** A block-lattice without policy calls the virtual Dynamics::collide. A
+ *  policy object belongs to one block-lattice, and may keep information
+ *  about its dynamics ids from one call to the next.
+ */
+template<typename T, template<typename U> class Descriptor>
+class CollisionPolicy3D {
+public:
+    virtual ~CollisionPolicy3D() { }
+    /// Collide numCells consecutive cells, whose dynamics ids (in lattice) are ids.
+    virtual void collide( BlockLattice3D<T,Descriptor> const& lattice,
+                          Cell<T,Descriptor>* cells, unsigned short const* ids,
+                          plint numCells, BlockStatistics& statistics ) =0;
+    virtual CollisionPolicy3D<T,Descriptor>* clone() const =0;
+};
+
+/// Collision policy with a compile-time dispatch on the classes of List.
+/** The type index of a dynamics id is computed the first time the id is
+ *  met, and reused afterwards: the dictionary of a block-lattice only grows.
+ */
+template<typename T, template<typename U> class Descriptor, class List>
+class DispatchedCollision3D : public CollisionPolicy3D<T,Descriptor> {
+public:
+    virtual void collide( BlockLattice3D<T,Descriptor> const& lattice,
+                          Cell<T,Descriptor>* cells, unsigned short const* ids,
+                          plint numCells, BlockStatistics& statistics );
+    virtual DispatchedCollision3D<T,Descriptor,List>* clone() const;
+private:
+    std::vector<plint> typeIndices;
+};
+
+}  // namespace plb
+
+#endif  // DYNAMICS_DISPATCH_H
@@ -0,0 +1,151 @@
+/* This file is part of the Palabos library.
+ *
+ * Copyright (C) 2011-2015 FlowKit Sarl
+ * Route d'Oron 2
+ * 1010 Lausanne, Switzerland
+ * E-mail contact: contact@flowkit.com
+ *
+ * The most recent release of Palabos can be downloaded at 
+ * <http://www.palabos.org/>
+ *
+ * The library Palabos is free software: you can redistribute it and/or
+ * modify it under the terms of the GNU Affero General Public License as
+ * published by the Free Software Foundation, either version 3 of the
+ * License, or (at your option) any later version.
+ *
+ * The library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+/** \file
+ * Compile-time dispatch of the collision on a list of dynamics types -- generic implementation.
+ */
+#ifndef DYNAMICS_DISPATCH_HH
+#define DYNAMICS_DISPATCH_HH
+
+#include "basicDynamics/dynamicsDispatch.h"
+#include "atomicBlock/blockLattice3D.h"
+#include <typeinfo>
+
+namespace plb {
+
+/* *************** Empty list: virtual dispatch ******************************* */
+
+template<typename T, template<typename U> class Descriptor>
+plint DynamicsDispatch<T,Descriptor,DynamicsList<> >::typeIndex (
+        std::type_info const& type )
+{
+    return -1;
+}
+
+template<typename T, template<typename U> class Descriptor>
+plint DynamicsDispatch<T,Descriptor,DynamicsList<> >::typeIndex (
+        Dynamics<T,Descriptor> const& dynamics )
+{
+    return -1;
+}
+
+template<typename T, template<typename U> class Descriptor>
+inline void DynamicsDispatch<T,Descriptor,DynamicsList<> >::collide (
+        plint typeId, Dynamics<T,Descriptor>& dynamics,
+        Cell<T,Descriptor>& cell, BlockStatistics& statistics )
+{
+    dynamics.collide(cell, statistics);
+}
+
+template<typename T, template<typename U> class Descriptor>
+inline void DynamicsDispatch<T,Descriptor,DynamicsList<> >::collideExternal (
+        plint typeId, Dynamics<T,Descriptor>& dynamics,
+        Cell<T,Descriptor>& cell, T rhoBar,
+        Array<T,Descriptor<T>::d> const& j, T thetaBar, BlockStatistics& statistics )
+{
+    dynamics.collideExternal(cell, rhoBar, j, thetaBar, statistics);
+}
+
+
+/* *************** Non-empty list ********************************************* */
+
+template<typename T, template<typename U> class Descriptor, class Head, class... Tail>
+plint DynamicsDispatch<T,Descriptor,DynamicsList<Head,Tail...> >::typeIndex (
+        std::type_info const& type )
+{
+    if (type==typeid(Head)) {
+        return 0;
+    }
+    plint tailIndex = TailDispatch::typeIndex(type);
+    return tailIndex<0 ? -1 : tailIndex+1;
+}
+
+template<typename T, template<typename U> class Descriptor, class Head, class... Tail>
+plint DynamicsDispatch<T,Descriptor,DynamicsList<Head,Tail...> >::typeIndex (
+        Dynamics<T,Descriptor> const& dynamics )
+{
+    // The exact type is required: derived classes may override the collision.
+    return typeIndex(typeid(dynamics));
+}
+
+template<typename T, template<typename U> class Descriptor, class Head, class... Tail>
+inline void DynamicsDispatch<T,Descriptor,DynamicsList<Head,Tail...> >::collide (
+        plint typeId, Dynamics<T,Descriptor>& dynamics,
+        Cell<T,Descriptor>& cell, BlockStatistics& statistics )
+{
+    if (typeId==0) {
+        // Qualified call: no virtual dispatch, the collision can be inlined.
+        static_cast<Head&>(dynamics).Head::collide(cell, statistics);
+    }
+    else {
+        TailDispatch::collide(typeId-1, dynamics, cell, statistics);
+    }
+}
+
+template<typename T, template<typename U> class Descriptor, class Head, class... Tail>
+inline void DynamicsDispatch<T,Descriptor,DynamicsList<Head,Tail...> >::collideExternal (
+        plint typeId, Dynamics<T,Descriptor>& dynamics,
+        Cell<T,Descriptor>& cell, T rhoBar,
+        Array<T,Descriptor<T>::d> const& j, T thetaBar, BlockStatistics& statistics )
+{
+    if (typeId==0) {
+        static_cast<Head&>(dynamics).Head::collideExternal(cell, rhoBar, j, thetaBar, statistics);
+    }
+    else {
+        TailDispatch::collideExternal(typeId-1, dynamics, cell, rhoBar, j, thetaBar, statistics);
+    }
+}
+
+
+/* *************** Class DispatchedCollision3D ******************************** */
+
+template<typename T, template<typename U> class Descriptor, class List>
+void DispatchedCollision3D<T,Descriptor,List>::collide (
+        BlockLattice3D<T,Descriptor> const& lattice,
+        Cell<T,Descriptor>* cells, unsigned short const* ids,
+        plint numCells, BlockStatistics& statistics )
+{
+    typedef DynamicsDispatch<T,Descriptor,List> Dispatch;
+    for (plint iCell=0; iCell<numCells; ++iCell) {
+        plint id = ids[iCell];
+        if (id >= (plint)typeIndices.size()) {
+            plint numKnownIds = (plint)typeIndices.size();
+            typeIndices.resize(lattice.getNumDynamicsIds());
+            for (plint newId=numKnownIds; newId<(plint)typeIndices.size(); ++newId) {
+                typeIndices[newId] = Dispatch::typeIndex(lattice.getDynamicsType(newId));
+            }
+        }
+        Cell<T,Descriptor>& cell = cells[iCell];
+        Dispatch::collide(typeIndices[id], cell.getDynamics(), cell, statistics);
+    }
+}
+
+template<typename T, template<typename U> class Descriptor, class List>
+DispatchedCollision3D<T,Descriptor,List>* DispatchedCollision3D<T,Descriptor,List>::clone() const {
+    return new DispatchedCollision3D<T,Descriptor,List>(*this);
+}
+
+}  // namespace plb
+
+#endif  // DYNAMICS_DISPATCH_HH
@@ -115,7 +115,8 @@ void ExternalRhoJcollideAndStream2D<T,Descriptor>::processGenericBlocks (
     Dot2D offset2 = computeRelativeDisplacement(lattice, jField);
 
     global::profiler().start("collStream");
-    global::profiler().increment("collStreamCells", extDomain.nCells());
+    global::profiler().incrementCollStream(extDomain.nCells(),
+            (2*Descriptor<T>::q+1+Descriptor<T>::d)*sizeof(T));
 
     // First, do the collision on cells within a boundary envelope of width
     // equal to the range of the lattice vectors (e.g. 1 for D2Q9)
@@ -28,29 +28,38 @@
 #include "core/globalDefs.h"
 #include "atomicBlock/dataProcessingFunctional3D.h"
 #include "core/dynamics.h"
+#include "basicDynamics/dynamicsDispatch.h"
 
 namespace plb {
 
 /* *************** Class ExternalRhoJcollideAndStream3D ******************* */
 
-template<typename T, template<typename U> class Descriptor>
+/// Collision-streaming with externally computed rhoBar and j.
+/** The optional DynamicsList names the dynamics classes expected on the
+ *  lattice: their collision is called through DynamicsDispatch, without
+ *  virtual call, and can be inlined. Other dynamics are handled as usual.
+ */
+template<typename T, template<typename U> class Descriptor, class List=DynamicsList<> >
 class ExternalRhoJcollideAndStream3D : public BoxProcessingFunctional3D
 {
 public:
     // Block 0: lattice; Block 1: rhoBar; Block 2: j.
     virtual void processGenericBlocks( Box3D domain,
                                        std::vector<AtomicBlock3D*> atomicBlocks );
-    virtual ExternalRhoJcollideAndStream3D<T,Descriptor>* clone() const;
+    virtual ExternalRhoJcollideAndStream3D<T,Descriptor,List>* clone() const;
     virtual void getTypeOfModification(std::vector<modif::ModifT>& modified) const;
 private:
     void collide (
             BlockLattice3D<T,Descriptor>& lattice, Box3D const& domain,
             ScalarField3D<T> const& rhoBarField, Dot3D const& offset1,
-            TensorField3D<T,3> const& jField, Dot3D const& offset2, BlockStatistics& stat );
+            TensorField3D<T,3> const& jField, Dot3D const& offset2,
+            std::vector<plint> const& typeIds, BlockStatistics& stat );
     void bulkCollideAndStream (
             BlockLattice3D<T,Descriptor>& lattice, Box3D const& domain,
             ScalarField3D<T> const& rhoBarField, Dot3D const& offset1,
-            TensorField3D<T,3> const& jField, Dot3D const& offset2, BlockStatistics& stat );
+            TensorField3D<T,3> const& jField, Dot3D const& offset2,
+            std::vector<plint> const& typeIds, std::vector<bool> const& bgkIds,
+            BlockStatistics& stat );
     void boundaryStream (
             BlockLattice3D<T,Descriptor>& lattice,
             Box3D const& bound, Box3D const& domain );
@@ -32,52 +32,88 @@
 #include "atomicBlock/blockLattice3D.h"
 #include "multiGrid/multiGridUtil.h"
 #include "core/plbProfiler.h"
+#include "parallelism/threadPool.h"
+#include "basicDynamics/dynamicsDispatch.hh"
+#include "basicDynamics/vectorizedCollision3D.h"
+#include "latticeBoltzmann/simdPack.h"
 
 namespace plb {
 
 /* ************* Class ExternalRhoJcollideAndStream3D ******************* */
 
-template<typename T, template<typename U> class Descriptor>
-void ExternalRhoJcollideAndStream3D<T,Descriptor>::collide (
+template<typename T, template<typename U> class Descriptor, class List>
+void ExternalRhoJcollideAndStream3D<T,Descriptor,List>::collide (
         BlockLattice3D<T,Descriptor>& lattice, Box3D const& domain,
         ScalarField3D<T> const& rhoBarField, Dot3D const& offset1,
-        TensorField3D<T,3> const& jField, Dot3D const& offset2, BlockStatistics& stat )
+        TensorField3D<T,3> const& jField, Dot3D const& offset2,
+        std::vector<plint> const& typeIds, BlockStatistics& stat )
 {
+    typedef DynamicsDispatch<T,Descriptor,List> Dispatch;
     for (plint iX=domain.x0; iX<=domain.x1; ++iX) {
         for (plint iY=domain.y0; iY<=domain.y1; ++iY) {
+            unsigned short const* ids = lattice.getDynamicsIds(iX,iY);
             for (plint iZ=domain.z0; iZ<=domain.z1; ++iZ) {
                 Cell<T,Descriptor>& cell = lattice.get(iX,iY,iZ);
                 T rhoBar            = rhoBarField.get(iX+offset1.x, iY+offset1.y, iZ+offset1.z);
                 Array<T,3> const& j = jField.get(iX+offset2.x, iY+offset2.y, iZ+offset2.z);
-                cell.getDynamics().collideExternal(cell, rhoBar, j, T(), stat);
+                Dispatch::collideExternal(typeIds[ids[iZ]], cell.getDynamics(), cell, rhoBar, j, T(), stat);
                 cell.revert();
             }
         }
     }
 }
 
-template<typename T, template<typename U> class Descriptor>
-void ExternalRhoJcollideAndStream3D<T,Descriptor>::bulkCollideAndStream (
+template<typename T, template<typename U> class Descriptor, class List>
+void ExternalRhoJcollideAndStream3D<T,Descriptor,List>::bulkCollideAndStream (
         BlockLattice3D<T,Descriptor>& lattice, Box3D const& domain,
         ScalarField3D<T> const& rhoBarField, Dot3D const& offset1,
-        TensorField3D<T,3> const& jField, Dot3D const& offset2, BlockStatistics& stat )
+        TensorField3D<T,3> const& jField, Dot3D const& offset2,
+        std::vector<plint> const& typeIds, std::vector<bool> const& bgkIds,
+        BlockStatistics& stat )
 {
+    typedef DynamicsDispatch<T,Descriptor,List> Dispatch;
+    typedef vectorizedCollision3D<T,Descriptor> Vectorized;
     for (plint iX=domain.x0; iX<=domain.x1; ++iX) {
         for (plint iY=domain.y0; iY<=domain.y1; ++iY) {
-            for (plint iZ=domain.z0; iZ<=domain.z1; ++iZ) {
+            unsigned short const* ids = lattice.getDynamicsIds(iX,iY);
+            plint iZ = domain.z0;
+            while (iZ<=domain.z1) {
                 Cell<T,Descriptor>& cell = lattice.get(iX,iY,iZ);
-                T rhoBar            = rhoBarField.get(iX+offset1.x, iY+offset1.y, iZ+offset1.z);
-                Array<T,3> const& j = jField.get(iX+offset2.x, iY+offset2.y, iZ+offset2.z);
-                cell.getDynamics().collideExternal(cell, rhoBar, j, T(), stat);
-                latticeTemplates<T,Descriptor>::swapAndStream3D(lattice.grid, iX, iY, iZ);
+                PureBGKParameters<T> parameters;
+                if ( !bgkIds[ids[iZ]] ||
+                     !Vectorized::identifyPureBGK(cell.getDynamics(), parameters) )
+                {
+                    T rhoBar            = rhoBarField.get(iX+offset1.x, iY+offset1.y, iZ+offset1.z);
+                    Array<T,3> const& j = jField.get(iX+offset2.x, iY+offset2.y, iZ+offset2.z);
+                    Dispatch::collideExternal(typeIds[ids[iZ]], cell.getDynamics(), cell, rhoBar, j, T(), stat);
+                    latticeTemplates<T,Descriptor>::swapAndStream3D(lattice.grid, iX, iY, iZ);
+                    ++iZ;
+                    continue;
+                }
+                // The run extends over all following cells with the same dynamics id,
+                //   whose parameters are all equal (see BlockLattice3D::isHomogeneousBGK()).
+                plint endOfRun = iZ+1;
+                while (endOfRun<=domain.z1 && ids[endOfRun]==ids[iZ]) {
+                    ++endOfRun;
+                }
+                // The moments are stored contiguously along z, like the cells.
+                Vectorized::bgkCollideExternal (
+                        &cell, endOfRun-iZ,
+                        &rhoBarField.get(iX+offset1.x, iY+offset1.y, iZ+offset1.z),
+                        &jField.get(iX+offset2.x, iY+offset2.y, iZ+offset2.z),
+                        parameters, stat );
+                // A cell exchanges populations only with neighbors which precede it
+                //   in memory order: the run is entirely collided before it is streamed.
+                for (; iZ<endOfRun; ++iZ) {
+                    latticeTemplates<T,Descriptor>::swapAndStream3D(lattice.grid, iX, iY, iZ);
+                }
             }
         }
     }
 }
 
-
-template<typename T, template<typename U> class Descriptor>
-void ExternalRhoJcollideAndStream3D<T,Descriptor>::boundaryStream (
+template<typename T, template<typename U> class Descriptor, class List>
+void ExternalRhoJcollideAndStream3D<T,Descriptor,List>::boundaryStream (
         BlockLattice3D<T,Descriptor>& lattice,
         Box3D const& bound, Box3D const& domain )
 {
@@ -103,13 +139,22 @@ void ExternalRhoJcollideAndStream3D<T,Descriptor>::boundaryStream (
     }
 }
 
-template<typename T, template<typename U> class Descriptor>
-void ExternalRhoJcollideAndStream3D<T,Descriptor>::processGenericBlocks (
+template<typename T, template<typename U> class Descriptor, class List>
+void ExternalRhoJcollideAndStream3D<T,Descriptor,List>::processGenericBlocks (
         Box3D domain, std::vector<AtomicBlock3D*> atomicBlocks )
 {
-    global::timer("collideAndStream").start();
     BlockLattice3D<T,Descriptor>& lattice =
         dynamic_cast<BlockLattice3D<T,Descriptor>&>(*atomicBlocks[0]);
+    // A lattice with NoDynamics only is left unchanged (see BlockLattice3D::isIdle()).
+    if (lattice.isIdle()) {
+        return;
+    }
+    // The global timers are not thread-safe: they are left aside when the blocks
+    //   are processed concurrently by the thread pool.
+    bool timed = !global::threadPool().isThreaded();
+    if (timed) {
+        global::timer("collideAndStream").start();
+    }
     ScalarField3D<T> const& rhoBarField =
         dynamic_cast<ScalarField3D<T> const&>(*atomicBlocks[1]);
     TensorField3D<T,3> const& jField =
@@ -123,8 +168,18 @@ void ExternalRhoJcollideAndStream3D<T,Descriptor>::processGenericBlocks (
     Dot3D offset1 = computeRelativeDisplacement(lattice, rhoBarField);
     Dot3D offset2 = computeRelativeDisplacement(lattice, jField);
 
+    // The type index, and the eligibility for the vectorized BGK kernel, are
+    //   computed once per dynamics id of the lattice.
+    std::vector<plint> typeIds(lattice.getNumDynamicsIds());
+    std::vector<bool> bgkIds(lattice.getNumDynamicsIds());
+    for (plint id=0; id<(plint)typeIds.size(); ++id) {
+        typeIds[id] = DynamicsDispatch<T,Descriptor,List>::typeIndex(lattice.getDynamicsType(id));
+        bgkIds[id] = SimdPack<T>::vectorized && lattice.isHomogeneousBGK(id);
+    }
+
     global::profiler().start("collStream");
-    global::profiler().increment("collStreamCells", extDomain.nCells());
+    global::profiler().incrementCollStream(extDomain.nCells(),
+            (2*Descriptor<T>::q+1+Descriptor<T>::d)*sizeof(T));
 
     // First, do the collision on cells within a boundary envelope of width
     // equal to the range of the lattice vectors (e.g. 1 for D2Q9)
@@ -132,32 +187,32 @@ void ExternalRhoJcollideAndStream3D<T,Descriptor>::processGenericBlocks (
             Box3D(extDomain.x0,extDomain.x0+vicinity-1,
                   extDomain.y0,extDomain.y1,
                   extDomain.z0,extDomain.z1),
-            rhoBarField, offset1, jField, offset2, stat);
+            rhoBarField, offset1, jField, offset2, typeIds, stat);
     collide(lattice,
             Box3D(extDomain.x1-vicinity+1,extDomain.x1,
                   extDomain.y0,extDomain.y1,
                   extDomain.z0,extDomain.z1),
-            rhoBarField, offset1, jField, offset2, stat);
+            rhoBarField, offset1, jField, offset2, typeIds, stat);
     collide(lattice,
             Box3D(extDomain.x0+vicinity,extDomain.x1-vicinity,
                   extDomain.y0,extDomain.y0+vicinity-1,
                   extDomain.z0,extDomain.z1),
-            rhoBarField, offset1, jField, offset2, stat);
+            rhoBarField, offset1, jField, offset2, typeIds, stat);
     collide(lattice,
             Box3D(extDomain.x0+vicinity,extDomain.x1-vicinity,
                   extDomain.y1-vicinity+1,extDomain.y1,
                   extDomain.z0,extDomain.z1),
-            rhoBarField, offset1, jField, offset2, stat);
+            rhoBarField, offset1, jField, offset2, typeIds, stat);
     collide(lattice,
             Box3D(extDomain.x0+vicinity,extDomain.x1-vicinity,
                   extDomain.y0+vicinity,extDomain.y1-vicinity,
                   extDomain.z0,extDomain.z0+vicinity-1),
-            rhoBarField, offset1, jField, offset2, stat);
+            rhoBarField, offset1, jField, offset2, typeIds, stat);
     collide(lattice,
             Box3D(extDomain.x0+vicinity,extDomain.x1-vicinity,
                   extDomain.y0+vicinity,extDomain.y1-vicinity,
                   extDomain.z1-vicinity+1,extDomain.z1),
-            rhoBarField, offset1, jField, offset2, stat);
+            rhoBarField, offset1, jField, offset2, typeIds, stat);
 
     // Then, do the efficient collideAndStream algorithm in the bulk,
     // excluding the envelope (this is efficient because there is no
@@ -167,7 +222,7 @@ void ExternalRhoJcollideAndStream3D<T,Descriptor>::processGenericBlocks (
                          Box3D(extDomain.x0+vicinity,extDomain.x1-vicinity,
                                extDomain.y0+vicinity,extDomain.y1-vicinity,
                                extDomain.z0+vicinity,extDomain.z1-vicinity),
-                         rhoBarField, offset1, jField, offset2, stat);
+                         rhoBarField, offset1, jField, offset2, typeIds, bgkIds, stat);
 
     // Finally, do streaming in the boundary envelope to conclude the
     // collision-stream cycle
@@ -190,18 +245,20 @@ void ExternalRhoJcollideAndStream3D<T,Descriptor>::processGenericBlocks (
                                              extDomain.y0+vicinity,extDomain.y1-vicinity,
                                              extDomain.z1-vicinity+1,extDomain.z1) );
     global::profiler().stop("collStream");
-    global::timer("collideAndStream").stop();
+    if (timed) {
+        global::timer("collideAndStream").stop();
+    }
 }
 
-template<typename T, template<typename U> class Descriptor>
-ExternalRhoJcollideAndStream3D<T,Descriptor>*
-    ExternalRhoJcollideAndStream3D<T,Descriptor>::clone() const
+template<typename T, template<typename U> class Descriptor, class List>
+ExternalRhoJcollideAndStream3D<T,Descriptor,List>*
+    ExternalRhoJcollideAndStream3D<T,Descriptor,List>::clone() const
 {
-    return new ExternalRhoJcollideAndStream3D<T,Descriptor>(*this);
+    return new ExternalRhoJcollideAndStream3D<T,Descriptor,List>(*this);
 }
 
-template<typename T, template<typename U> class Descriptor>
-void ExternalRhoJcollideAndStream3D<T,Descriptor>::getTypeOfModification (
+template<typename T, template<typename U> class Descriptor, class List>
+void ExternalRhoJcollideAndStream3D<T,Descriptor,List>::getTypeOfModification (
         std::vector<modif::ModifT>& modified) const
 {
     modified[0] = modif::staticVariables;
@@ -288,7 +345,16 @@ void PackedExternalRhoJcollideAndStream3D<T,Descriptor>::process (
         Box3D domain, BlockLattice3D<T,Descriptor>& lattice,
                       NTensorField3D<T>& rhoBarJfield )
 {
-    global::timer("collideAndStream").start();
+    // A lattice with NoDynamics only is left unchanged (see BlockLattice3D::isIdle()).
+    if (lattice.isIdle()) {
+        return;
+    }
+    // The global timers are not thread-safe: they are left aside when the blocks
+    //   are processed concurrently by the thread pool.
+    bool timed = !global::threadPool().isThreaded();
+    if (timed) {
+        global::timer("collideAndStream").start();
+    }
 
     PLB_ASSERT( rhoBarJfield.getNdim()==4 );
 
@@ -300,7 +366,8 @@ void PackedExternalRhoJcollideAndStream3D<T,Descriptor>::process (
     Dot3D offset = computeRelativeDisplacement(lattice, rhoBarJfield);
 
     global::profiler().start("collStream");
-    global::profiler().increment("collStreamCells", extDomain.nCells());
+    global::profiler().incrementCollStream(extDomain.nCells(),
+            (2*Descriptor<T>::q+1+Descriptor<T>::d)*sizeof(T));
 
     // First, do the collision on cells within a boundary envelope of width
     // equal to the range of the lattice vectors (e.g. 1 for D2Q9)
@@ -366,7 +433,9 @@ void PackedExternalRhoJcollideAndStream3D<T,Descriptor>::process (
                                              extDomain.y0+vicinity,extDomain.y1-vicinity,
                                              extDomain.z1-vicinity+1,extDomain.z1) );
     global::profiler().stop("collStream");
-    global::timer("collideAndStream").stop();
+    if (timed) {
+        global::timer("collideAndStream").stop();
+    }
 }
 
 template<typename T, template<typename U> class Descriptor>
@@ -486,9 +555,18 @@ template<typename T, template<typename U> class Descriptor>
 void OnLinkExternalRhoJcollideAndStream3D<T,Descriptor>::processGenericBlocks (
         Box3D domain, std::vector<AtomicBlock3D*> atomicBlocks )
 {
-    global::timer("collideAndStream").start();
     BlockLattice3D<T,Descriptor>& lattice =
         dynamic_cast<BlockLattice3D<T,Descriptor>&>(*atomicBlocks[0]);
+    // A lattice with NoDynamics only is left unchanged (see BlockLattice3D::isIdle()).
+    if (lattice.isIdle()) {
+        return;
+    }
+    // The global timers are not thread-safe: they are left aside when the blocks
+    //   are processed concurrently by the thread pool.
+    bool timed = !global::threadPool().isThreaded();
+    if (timed) {
+        global::timer("collideAndStream").start();
+    }
     ScalarField3D<T> const& rhoBarField =
         dynamic_cast<ScalarField3D<T> const&>(*atomicBlocks[1]);
     TensorField3D<T,3> const& jField =
@@ -503,7 +581,8 @@ void OnLinkExternalRhoJcollideAndStream3D<T,Descriptor>::processGenericBlocks (
     Dot3D offset2 = computeRelativeDisplacement(lattice, jField);
 
     global::profiler().start("collStream");
-    global::profiler().increment("collStreamCells", extDomain.nCells());
+    global::profiler().incrementCollStream(extDomain.nCells(),
+            (2*Descriptor<T>::q+1+Descriptor<T>::d)*sizeof(T));
 
     // First, do the collision on cells within a boundary envelope of width
     // equal to the range of the lattice vectors (e.g. 1 for D2Q9)
@@ -569,7 +648,9 @@ void OnLinkExternalRhoJcollideAndStream3D<T,Descriptor>::processGenericBlocks (
                                              extDomain.y0+vicinity,extDomain.y1-vicinity,
                                              extDomain.z1-vicinity+1,extDomain.z1) );
     global::profiler().stop("collStream");
-    global::timer("collideAndStream").stop();
+    if (timed) {
+        global::timer("collideAndStream").stop();
+    }
 }
 
 template<typename T, template<typename U> class Descriptor>
@@ -30,4 +30,6 @@
 #include "basicDynamics/thermalDynamics.h"
 #include "basicDynamics/externalForceDynamics.h"
 #include "basicDynamics/dynamicsProcessor3D.h"
+#include "basicDynamics/vectorizedCollision3D.h"
+#include "basicDynamics/dynamicsDispatch.h"
 
@@ -29,4 +29,6 @@
 #include "basicDynamics/thermalDynamics.hh"
 #include "basicDynamics/externalForceDynamics.hh"
 #include "basicDynamics/dynamicsProcessor3D.hh"
+#include "basicDynamics/vectorizedCollision3D.hh"
+#include "basicDynamics/dynamicsDispatch.hh"
 
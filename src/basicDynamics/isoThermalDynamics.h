@@ -138,6 +138,9 @@ public:
     /// Compute equilibrium distribution function
     virtual T computeEquilibrium(plint iPop, T rhoBar, Array<T,Descriptor<T>::d> const& j,
                                  T jSqr, T thetaBar=T()) const;
+
+    /// Set local relaxation parameter of the dynamics
+    virtual void setOmega(T omega_);
 private:
     virtual void decomposeOrder0(Cell<T,Descriptor> const& cell, std::vector<T>& rawData) const;
     virtual void recomposeOrder0(Cell<T,Descriptor>& cell, std::vector<T> const& rawData) const;
@@ -595,6 +598,9 @@ public:
     /// Set local value of any generic parameter.
     /// For the density rho0, use parameter 110.
     virtual void setParameter(plint whichParameter, T value);
+
+    /// Set local relaxation parameter of the dynamics
+    virtual void setOmega(T omega_);
 private:
     T invRho0;
 private:
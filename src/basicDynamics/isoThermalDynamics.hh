@@ -39,6 +39,7 @@
 #include "latticeBoltzmann/d3q13Templates.h"
 #include "latticeBoltzmann/geometricOperationTemplates.h"
 #include "core/latticeStatistics.h"
+#include "basicDynamics/vectorizedCollision3D.h"
 #include <algorithm>
 #include <limits>
 
@@ -345,6 +346,12 @@ T BGKdynamics<T,Descriptor>::computeEquilibrium(plint iPop, T rhoBar, Array<T,De
     return dynamicsTemplates<T,Descriptor>::bgk_ma2_equilibrium(iPop, rhoBar, invRho, j, jSqr);
 }
 
+template<typename T, template<typename U> class Descriptor>
+void BGKdynamics<T,Descriptor>::setOmega(T omega_) {
+    IsoThermalBulkDynamics<T,Descriptor>::setOmega(omega_);
+    ++vectorizedCollision3D<T,Descriptor>::parameterRevision();
+}
+
 template<typename T, template<typename U> class Descriptor>
 void BGKdynamics<T,Descriptor>::decomposeOrder0 (
         Cell<T,Descriptor> const& cell, std::vector<T>& rawData ) const
@@ -1457,12 +1464,19 @@ void IncBGKdynamics<T,Descriptor>::setParameter(plint whichParameter, T value)
 {
     if (whichParameter==110) {
         invRho0 = (T)1/value;
+        ++vectorizedCollision3D<T,Descriptor>::parameterRevision();
     }
     else {
         IsoThermalBulkDynamics<T,Descriptor>::setParameter(whichParameter, value);
     }
 }
 
+template<typename T, template<typename U> class Descriptor>
+void IncBGKdynamics<T,Descriptor>::setOmega(T omega_) {
+    IsoThermalBulkDynamics<T,Descriptor>::setOmega(omega_);
+    ++vectorizedCollision3D<T,Descriptor>::parameterRevision();
+}
+
 
 /* *************** Class ConstRhoBGKdynamics *************************************** */
 
@@ -0,0 +1,113 @@
+/* This file is part of the Palabos library.
+ *
+ * Copyright (C) 2011-2015 FlowKit Sarl
+ * Route d'Oron 2
+ * 1010 Lausanne, Switzerland
+ * E-mail contact: contact@flowkit.com
+ *
+ * The most recent release of Palabos can be downloaded at 
+ * <http://www.palabos.org/>
+ *
+ * The library Palabos is free software: you can redistribute it and/or
+ * modify it under the terms of the GNU Affero General Public License as
+ * published by the Free Software Foundation, either version 3 of the
+ * License, or (at your option) any later version.
+ *
+ * The library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+/** \file
+ * Vectorized collision of homogeneous runs of BGK cells -- header file.
+ */
+#ifndef VECTORIZED_COLLISION_3D_H
+#define VECTORIZED_COLLISION_3D_H
+
+#include "core/globalDefs.h"
+#include "core/cell.h"
+#include "core/blockStatistics.h"
+#include <atomic>
+
+namespace plb {
+
+/// Parameters of a pure BGK or incompressible BGK collision.
+template<typename T>
+struct PureBGKParameters {
+    PureBGKParameters()
+        : incompressible(false), omega(), invRho0((T)1)
+    { }
+    bool incompressible;
+    T omega;
+    T invRho0;
+};
+
+/// Fused collision of several cells per SIMD instruction.
+/** A run is a sequence of consecutive cells (in memory order) with the
+ *  same dynamics id (see BlockLattice3D::getDynamicsId()), whose entry is
+ *  homogeneous: all its cells are BGKdynamics or IncBGKdynamics objects
+ *  with the same relaxation parameters (see
+ *  BlockLattice3D::isHomogeneousBGK()). The cells are distinct copies of
+ *  the dynamics, but the parameters are read only once per run, on its first
+ *  cell. Such runs are collided SimdPack<T>::width cells at a time: the
+ *  populations are transposed into a small stack buffer, relaxed with SIMD
+ *  arithmetic, and written back. The remainder of a run goes through the
+ *  usual virtual Dynamics::collide. If no SIMD instruction set is available
+ *  (see SimdPack and the CMake option PLB_ENABLE_AVX2), the lattice collides
+ *  all cells through Dynamics::collide. The same kernel serves the collision
+ *  with external moments of ExternalRhoJcollideAndStream3D.
+ *
+ *  The statistics gathered are identical to the ones of the scalar
+ *  implementation. Results agree with the scalar templates up to round-off.
+ */
+template<typename T, template<typename U> class Descriptor>
+struct vectorizedCollision3D {
+    /// Returns true if the dynamics is exactly BGKdynamics or IncBGKdynamics,
+    ///   and extracts its parameters.
+    static bool identifyPureBGK(Dynamics<T,Descriptor> const& dynamics,
+                                PureBGKParameters<T>& parameters);
+    /// Counter which is incremented whenever the parameters of a BGKdynamics
+    ///   or IncBGKdynamics object are modified.
+    /** A BlockLattice3D evaluates its classification anew if the counter has
+     *  changed since the last evaluation (see BlockLattice3D::getActivity()).
+     **/
+    static std::atomic<pluint>& parameterRevision() {
+        static std::atomic<pluint> revision(0);
+        return revision;
+    }
+    /// Collide numCells consecutive BGK cells which all have the given parameters.
+    static void bgkCollide(Cell<T,Descriptor>* cells, plint numCells,
+                           PureBGKParameters<T> const& parameters,
+                           BlockStatistics& statistics);
+    /// Collide numCells consecutive BGK cells which all have the given parameters,
+    ///   with the externally computed moments rhoBar[i] and j[i] of cell i
+    ///   (see Dynamics::collideExternal()).
+    static void bgkCollideExternal(Cell<T,Descriptor>* cells, plint numCells,
+                                   T const* rhoBar, Array<T,3> const* j,
+                                   PureBGKParameters<T> const& parameters,
+                                   BlockStatistics& statistics);
+private:
+    /// Relax exactly SimdPack<T>::width cells, stored as one array per
+    ///   population, towards the equilibrium of the moments rhoBar and j
+    ///   (one array per component). The velocity norm reported to the
+    ///   statistics is written to uSqrData.
+    static void bgkRelaxPack(T* const* populations, T const* rhoBarData,
+                             T const* const* jData, PureBGKParameters<T> const& parameters,
+                             T* uSqrData);
+    /// Collide exactly SimdPack<T>::width cells.
+    static void bgkCollidePack(Cell<T,Descriptor>* cells,
+                               PureBGKParameters<T> const& parameters,
+                               BlockStatistics& statistics);
+    /// Collide exactly SimdPack<T>::width cells with external moments.
+    static void bgkCollideExternalPack(Cell<T,Descriptor>* cells,
+                                       T const* rhoBar, Array<T,3> const* j,
+                                       PureBGKParameters<T> const& parameters);
+};
+
+}  // namespace plb
+
+#endif  // VECTORIZED_COLLISION_3D_H
@@ -0,0 +1,219 @@
+/* This file is part of the Palabos library.
+ *
+ * Copyright (C) 2011-2015 FlowKit Sarl
+ * Route d'Oron 2
+ * 1010 Lausanne, Switzerland
+ * E-mail contact: contact@flowkit.com
+ *
+ * The most recent release of Palabos can be downloaded at 
+ * <http://www.palabos.org/>
+ *
+ * The library Palabos is free software: you can redistribute it and/or
+ * modify it under the terms of the GNU Affero General Public License as
+ * published by the Free Software Foundation, either version 3 of the
+ * License, or (at your option) any later version.
+ *
+ * The library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+/** \file
+ * Vectorized collision of homogeneous runs of BGK cells -- generic implementation.
+ */
+#ifndef VECTORIZED_COLLISION_3D_HH
+#define VECTORIZED_COLLISION_3D_HH
+
+#include "basicDynamics/vectorizedCollision3D.h"
+#include "basicDynamics/isoThermalDynamics.h"
+#include "latticeBoltzmann/simdPack.h"
+#include "core/latticeStatistics.h"
+#include <typeinfo>
+
+namespace plb {
+
+template<typename T, template<typename U> class Descriptor>
+bool vectorizedCollision3D<T,Descriptor>::identifyPureBGK (
+        Dynamics<T,Descriptor> const& dynamics, PureBGKParameters<T>& parameters )
+{
+    // The exact type is required: derived classes may override collide().
+    if (typeid(dynamics)==typeid(BGKdynamics<T,Descriptor>)) {
+        parameters.incompressible = false;
+        parameters.omega = dynamics.getOmega();
+        parameters.invRho0 = (T)1;
+        return true;
+    }
+    if (typeid(dynamics)==typeid(IncBGKdynamics<T,Descriptor>)) {
+        parameters.incompressible = true;
+        parameters.omega = dynamics.getOmega();
+        // Parameter 110 is rho0, see IncBGKdynamics::getParameter.
+        parameters.invRho0 = (T)1 / dynamics.getParameter(110);
+        return true;
+    }
+    return false;
+}
+
+template<typename T, template<typename U> class Descriptor>
+void vectorizedCollision3D<T,Descriptor>::bgkRelaxPack (
+        T* const* populations, T const* rhoBarData, T const* const* jData,
+        PureBGKParameters<T> const& parameters, T* uSqrData )
+{
+    typedef SimdPack<T> Pack;
+    enum { width = Pack::width, q = Descriptor<T>::q };
+
+    T invRhoData[width];
+    for (plint iCell=0; iCell<width; ++iCell) {
+        invRhoData[iCell] = parameters.incompressible ?
+                                parameters.invRho0 : Descriptor<T>::invRho(rhoBarData[iCell]);
+    }
+    Pack rhoBar = Pack::load(rhoBarData);
+    Pack jX = Pack::load(jData[0]);
+    Pack jY = Pack::load(jData[1]);
+    Pack jZ = Pack::load(jData[2]);
+    Pack invRho = Pack::load(invRhoData);
+    Pack jSqr = jX*jX + jY*jY + jZ*jZ;
+
+    const Pack omega = Pack::broadcast(parameters.omega);
+    const Pack oneMinusOmega = Pack::broadcast((T)1-parameters.omega);
+    const Pack invCs2 = Pack::broadcast(Descriptor<T>::invCs2);
+    const Pack kineticFactor = Pack::broadcast(Descriptor<T>::invCs2/(T)2) * invRho;
+    for (plint iPop=0; iPop<q; ++iPop) {
+        Pack c_j = Pack::broadcast(T());
+        if (Descriptor<T>::c[iPop][0]>0) c_j = c_j + jX; else if (Descriptor<T>::c[iPop][0]<0) c_j = c_j - jX;
+        if (Descriptor<T>::c[iPop][1]>0) c_j = c_j + jY; else if (Descriptor<T>::c[iPop][1]<0) c_j = c_j - jY;
+        if (Descriptor<T>::c[iPop][2]>0) c_j = c_j + jZ; else if (Descriptor<T>::c[iPop][2]<0) c_j = c_j - jZ;
+        // Same second-order equilibrium as dynamicsTemplatesImpl::bgk_ma2_equilibrium.
+        Pack fEq = Pack::broadcast(Descriptor<T>::t[iPop]) * (
+                       rhoBar + invCs2*c_j + kineticFactor*(invCs2*c_j*c_j - jSqr) );
+        Pack fPop = Pack::load(populations[iPop]);
+        (oneMinusOmega*fPop + omega*fEq).store(populations[iPop]);
+    }
+    // Like dynamicsTemplatesImpl::bgk_inc_collision, the incompressible
+    //   model reports j^2 instead of u^2.
+    if (parameters.incompressible) {
+        jSqr.store(uSqrData);
+    }
+    else {
+        (jSqr*invRho*invRho).store(uSqrData);
+    }
+}
+
+template<typename T, template<typename U> class Descriptor>
+void vectorizedCollision3D<T,Descriptor>::bgkCollidePack (
+        Cell<T,Descriptor>* cells, PureBGKParameters<T> const& parameters,
+        BlockStatistics& statistics )
+{
+    typedef SimdPack<T> Pack;
+    enum { width = Pack::width, q = Descriptor<T>::q };
+
+    // Transpose the populations of the cells into one array per population.
+    T f[q][width];
+    T* populations[q];
+    for (plint iPop=0; iPop<q; ++iPop) {
+        populations[iPop] = f[iPop];
+        for (plint iCell=0; iCell<width; ++iCell) {
+            f[iPop][iCell] = cells[iCell][iPop];
+        }
+    }
+
+    Pack rhoBar = Pack::load(f[0]);
+    Pack jX = Pack::broadcast(T());
+    Pack jY = Pack::broadcast(T());
+    Pack jZ = Pack::broadcast(T());
+    for (plint iPop=1; iPop<q; ++iPop) {
+        Pack fPop = Pack::load(f[iPop]);
+        rhoBar = rhoBar + fPop;
+        if (Descriptor<T>::c[iPop][0]>0) jX = jX + fPop; else if (Descriptor<T>::c[iPop][0]<0) jX = jX - fPop;
+        if (Descriptor<T>::c[iPop][1]>0) jY = jY + fPop; else if (Descriptor<T>::c[iPop][1]<0) jY = jY - fPop;
+        if (Descriptor<T>::c[iPop][2]>0) jZ = jZ + fPop; else if (Descriptor<T>::c[iPop][2]<0) jZ = jZ - fPop;
+    }
+    T rhoBarData[width], j[3][width], uSqrData[width];
+    T const* jData[3] = { j[0], j[1], j[2] };
+    rhoBar.store(rhoBarData);
+    jX.store(j[0]);
+    jY.store(j[1]);
+    jZ.store(j[2]);
+
+    bgkRelaxPack(populations, rhoBarData, jData, parameters, uSqrData);
+    for (plint iCell=0; iCell<width; ++iCell) {
+        for (plint iPop=0; iPop<q; ++iPop) {
+            cells[iCell][iPop] = f[iPop][iCell];
+        }
+        if (cells[iCell].takesStatistics()) {
+            gatherStatistics(statistics, rhoBarData[iCell], uSqrData[iCell]);
+        }
+    }
+}
+
+template<typename T, template<typename U> class Descriptor>
+void vectorizedCollision3D<T,Descriptor>::bgkCollideExternalPack (
+        Cell<T,Descriptor>* cells, T const* rhoBar, Array<T,3> const* j,
+        PureBGKParameters<T> const& parameters )
+{
+    enum { width = SimdPack<T>::width, q = Descriptor<T>::q };
+
+    T f[q][width];
+    T* populations[q];
+    for (plint iPop=0; iPop<q; ++iPop) {
+        populations[iPop] = f[iPop];
+        for (plint iCell=0; iCell<width; ++iCell) {
+            f[iPop][iCell] = cells[iCell][iPop];
+        }
+    }
+    T jTransposed[3][width], uSqrData[width];
+    T const* jData[3] = { jTransposed[0], jTransposed[1], jTransposed[2] };
+    for (plint iCell=0; iCell<width; ++iCell) {
+        for (plint iD=0; iD<3; ++iD) {
+            jTransposed[iD][iCell] = j[iCell][iD];
+        }
+    }
+
+    // As in Dynamics::collideExternal(), no statistics are taken.
+    bgkRelaxPack(populations, rhoBar, jData, parameters, uSqrData);
+    for (plint iCell=0; iCell<width; ++iCell) {
+        for (plint iPop=0; iPop<q; ++iPop) {
+            cells[iCell][iPop] = f[iPop][iCell];
+        }
+    }
+}
+
+template<typename T, template<typename U> class Descriptor>
+void vectorizedCollision3D<T,Descriptor>::bgkCollide (
+        Cell<T,Descriptor>* cells, plint numCells,
+        PureBGKParameters<T> const& parameters, BlockStatistics& statistics )
+{
+    const plint width = SimdPack<T>::width;
+    plint iCell = 0;
+    for (; iCell+width<=numCells; iCell+=width) {
+        bgkCollidePack(cells+iCell, parameters, statistics);
+    }
+    for (; iCell<numCells; ++iCell) {
+        cells[iCell].collide(statistics);
+    }
+}
+
+template<typename T, template<typename U> class Descriptor>
+void vectorizedCollision3D<T,Descriptor>::bgkCollideExternal (
+        Cell<T,Descriptor>* cells, plint numCells, T const* rhoBar, Array<T,3> const* j,
+        PureBGKParameters<T> const& parameters, BlockStatistics& statistics )
+{
+    const plint width = SimdPack<T>::width;
+    plint iCell = 0;
+    if (SimdPack<T>::vectorized) {
+        for (; iCell+width<=numCells; iCell+=width) {
+            bgkCollideExternalPack(cells+iCell, rhoBar+iCell, j+iCell, parameters);
+        }
+    }
+    for (; iCell<numCells; ++iCell) {
+        cells[iCell].getDynamics().collideExternal (
+                cells[iCell], rhoBar[iCell], j[iCell], T(), statistics );
+    }
+}
+
+}  // namespace plb
+
+#endif  // VECTORIZED_COLLISION_3D_HH
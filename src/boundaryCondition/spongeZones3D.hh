@@ -74,6 +74,8 @@ void ViscositySpongeZone<T,Descriptor>::processGenericBlocks(Box3D domain, std::
     PLB_ASSERT(blocks.size() == 1);
     BlockLattice3D<T,Descriptor> *lattice = dynamic_cast<BlockLattice3D<T,Descriptor>*>(blocks[0]);
     PLB_ASSERT(lattice);
+    // The relaxation parameters vary in space.
+    lattice->invalidateActivity();
 
     Dot3D offset = lattice->getLocation();
 
@@ -239,6 +241,8 @@ void MaskedViscositySpongeZone<T,Descriptor>::processGenericBlocks(Box3D domain,
     ScalarField3D<int> *flagMatrix = dynamic_cast<ScalarField3D<int>*>(blocks[1]);
     PLB_ASSERT(lattice);
     PLB_ASSERT(flagMatrix);
+    // The relaxation parameters vary in space.
+    lattice->invalidateActivity();
 
     Dot3D ofsFM = computeRelativeDisplacement(*lattice, *flagMatrix);
     Dot3D offset = lattice->getLocation();
@@ -415,6 +419,8 @@ void SmagorinskySpongeZone<T,Descriptor>::processGenericBlocks(Box3D domain, std
     PLB_ASSERT(blocks.size() == 1);
     BlockLattice3D<T,Descriptor> *lattice = dynamic_cast<BlockLattice3D<T,Descriptor>*>(blocks[0]);
     PLB_ASSERT(lattice);
+    // The relaxation parameters vary in space.
+    lattice->invalidateActivity();
 
     Dot3D offset = lattice->getLocation();
     plint whichParameter = dynamicParams::smagorinskyConstant;
@@ -586,6 +592,8 @@ void MaskedSmagorinskySpongeZone<T,Descriptor>::processGenericBlocks(Box3D domai
     ScalarField3D<int> *flagMatrix = dynamic_cast<ScalarField3D<int>*>(blocks[1]);
     PLB_ASSERT(lattice);
     PLB_ASSERT(flagMatrix);
+    // The relaxation parameters vary in space.
+    lattice->invalidateActivity();
 
     Dot3D ofsFM = computeRelativeDisplacement(*lattice, *flagMatrix);
     Dot3D offset = lattice->getLocation();
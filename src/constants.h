@@ -48,10 +48,11 @@ public:
 // Properties
 	static Object<T> obstacle, wall;
 	static Param<T> physical, lb;
-	static std::string parameterXmlFileName;
+	static std::string parameterXmlFileName, restartFile;
 	static plint testIter, ibIter, testRe, testTime, maxRe, minRe, maxGridLevel, margin,
-		borderWidth, extraLayer, blockSize, envelopeWidth;
-	static T initialTemperature, gravitationalAcceleration, epsilon, maxT, imageSave;
+		borderWidth, extraLayer, blockSize, envelopeWidth, numThreads, balanceInterval, outputQueue,
+		checkpointInterval, traceBuffer;
+	static T initialTemperature, gravitationalAcceleration, epsilon, maxT, imageSave, maxImbalance, warmStartTime;
 	static bool test;
 	static Precision precision;
 	static std::unique_ptr<Constants<T> > c;
@@ -77,6 +78,9 @@ Param<T> Constants<T>::lb;
 template<typename T>
 std::string Constants<T>::parameterXmlFileName= "";
 
+template<typename T>
+std::string Constants<T>::restartFile= "";
+
 template<typename T>
 plint Constants<T>::extraLayer= 0;
 
@@ -113,6 +117,27 @@ plint Constants<T>::testTime= 0;
 template<typename T>
 plint Constants<T>::blockSize= 0;
 
+template<typename T>
+plint Constants<T>::numThreads= 1;
+
+template<typename T>
+plint Constants<T>::balanceInterval= 0;
+
+template<typename T>
+plint Constants<T>::outputQueue= 2;
+
+template<typename T>
+plint Constants<T>::checkpointInterval= 0;
+
+template<typename T>
+plint Constants<T>::traceBuffer= 0;
+
+template<typename T>
+T Constants<T>::maxImbalance= 1.1;
+
+template<typename T>
+T Constants<T>::warmStartTime= 0;
+
 template<typename T>
 T Constants<T>::maxT= 0;
 
@@ -136,6 +136,36 @@ namespace plb{
 			r["simulation"]["imageSave"].read(this->imageSave);
 			r["simulation"]["testIter"].read(this->testIter);
 			r["simulation"]["ibIter"].read(this->ibIter);
+			// Shared-memory threads per MPI process (optional, defaults to 1)
+			try{ r["simulation"]["threads"].read(this->numThreads); }
+			catch(PlbIOException& e){ this->numThreads = 1; }
+			global::threadPool().setNumThreads(this->numThreads);
+			// Iterations between two load-balancing checks (optional, 0 disables them)
+			try{ r["simulation"]["balanceInterval"].read(this->balanceInterval); }
+			catch(PlbIOException& e){ this->balanceInterval = 0; }
+			try{ r["simulation"]["maxImbalance"].read(this->maxImbalance); }
+			catch(PlbIOException& e){ this->maxImbalance = 1.1; }
+			// Frames which may wait for the output thread before the simulation blocks (optional, defaults to 2)
+			try{ r["simulation"]["outputQueue"].read(this->outputQueue); }
+			catch(PlbIOException& e){ this->outputQueue = 2; }
+			// Iterations between two checkpoints (optional, 0 disables them), and checkpoint to restart from (optional)
+			try{ r["simulation"]["checkpointInterval"].read(this->checkpointInterval); }
+			catch(PlbIOException& e){ this->checkpointInterval = 0; }
+			// Events kept per thread by the tracer (optional, 0 disables tracing)
+			try{ r["simulation"]["trace"].read(this->traceBuffer); }
+			catch(PlbIOException& e){ this->traceBuffer = 0; }
+			try{ r["simulation"]["restart"].read(this->restartFile); }
+			catch(PlbIOException& e){ this->restartFile = ""; }
+			// Time at which a grid level hands its solution over to the next finer one (optional, 0 disables it)
+			try{ r["simulation"]["warmStartTime"].read(this->warmStartTime); }
+			catch(PlbIOException& e){ this->warmStartTime = 0; }
+			// Encoding of the vtk images: base64, raw or zlib (optional, defaults to base64)
+			std::string vtkEncodingName = "base64";
+			try{ r["simulation"]["vtkEncoding"].read(vtkEncodingName); }
+			catch(PlbIOException& e){ vtkEncodingName = "base64"; }
+			if(vtkEncodingName == "raw"){ global::IOpolicy().setVtkEncoding(vtkEncoding::raw); }
+			else if(vtkEncodingName == "zlib"){ global::IOpolicy().setVtkEncoding(vtkEncoding::zlib); }
+			else{ global::IOpolicy().setVtkEncoding(vtkEncoding::base64); }
 			int prec = 0;
 			r["simulation"]["precision"].read(prec);
 			r["simulation"]["initialTemperature"].read(this->initialTemperature);
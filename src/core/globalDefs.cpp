@@ -34,7 +34,8 @@ IOpolicyClass::IOpolicyClass()
       endianSwitchOnBase64in(false),
       stlLowerBoundFlag(false),
       stlLowerBound(-1.),
-      parallelIOflag(true)
+      parallelIOflag(true),
+      vtkEncodingType(vtkEncoding::base64)
 { }
 
 void IOpolicyClass::setIndexOrderingForStreams(IndexOrdering::OrderingT streamOrdering_) {
@@ -85,6 +86,14 @@ bool IOpolicyClass::useParallelIO() const {
     return parallelIOflag;
 }
 
+void IOpolicyClass::setVtkEncoding(vtkEncoding::EncodingT vtkEncoding_) {
+    vtkEncodingType = vtkEncoding_;
+}
+
+vtkEncoding::EncodingT IOpolicyClass::getVtkEncoding() const {
+    return vtkEncodingType;
+}
+
 /** Directories are default initialized to working directory.
  */
 Directories::Directories()
@@ -206,6 +206,37 @@ namespace modif {
     }
 }
 
+namespace propagation {
+
+    /// Indicates how a block-lattice propagates the populations
+    ///   between neighboring cells.
+    enum SchemeT {
+        swap  =0,  //< Swap populations with the neighbors after collision.
+        aa    =1   //< AA-pattern: alternate in-place and neighbor-to-neighbor steps.
+    };
+}
+
+namespace activity {
+
+    /// Classifies the cells of a block-lattice, including its envelope,
+    ///   according to the work done on them during a time step.
+    enum ClassT {
+        inactive =0,  //< All cells have NoDynamics.
+        uniform  =1,  //< All cells have BGK dynamics with the same parameters.
+        mixed    =2   //< Any other combination of dynamics.
+    };
+}
+
+namespace vtkEncoding {
+
+    /// Encoding of the binary data arrays in vtk xml files.
+    enum EncodingT {
+        base64 =0,  //< Inline base64 text (default).
+        raw    =1,  //< Raw binary in an appended section at the end of the file.
+        zlib   =2   //< zlib-compressed blocks in an appended section at the end of the file.
+    };
+}
+
 namespace global {
 
 class IOpolicyClass {
@@ -227,6 +258,9 @@ public:
 
     void activateParallelIO(bool activate);
     bool useParallelIO() const;
+
+    void setVtkEncoding(vtkEncoding::EncodingT vtkEncoding_);
+    vtkEncoding::EncodingT getVtkEncoding() const;
 private:
     IOpolicyClass();
 private:
@@ -236,6 +270,7 @@ private:
     bool stlLowerBoundFlag;
     double stlLowerBound;
     bool parallelIOflag;
+    vtkEncoding::EncodingT vtkEncodingType;
     friend IOpolicyClass& IOpolicy();
 };
     
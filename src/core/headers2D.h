@@ -41,6 +41,7 @@
 #include "core/block2D.h"
 #include "core/latticeStatistics.h"
 #include "core/plbTimer.h"
+#include "core/plbTracer.h"
 #include "core/plbRandom.h"
 #include "core/plbLogFiles.h"
 #include "core/indexUtil.h"
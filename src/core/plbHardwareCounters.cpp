@@ -0,0 +1,150 @@
+/* This file is part of the Palabos library.
+ *
+ * Copyright (C) 2011-2015 FlowKit Sarl
+ * Route d'Oron 2
+ * 1010 Lausanne, Switzerland
+ * E-mail contact: contact@flowkit.com
+ *
+ * The most recent release of Palabos can be downloaded at 
+ * <http://www.palabos.org/>
+ *
+ * The library Palabos is free software: you can redistribute it and/or
+ * modify it under the terms of the GNU Affero General Public License as
+ * published by the Free Software Foundation, either version 3 of the
+ * License, or (at your option) any later version.
+ *
+ * The library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+/** \file
+ * Hardware performance counters of the calling thread, read through the
+ * perf_event_open interface of Linux -- implementation file.
+ */
+#include "core/plbHardwareCounters.h"
+#include "parallelism/mpiManager.h"
+#include <vector>
+#include <algorithm>
+#include <chrono>
+
+#if defined(PLB_USE_POSIX) && defined(__linux__)
+#define PLB_PERF_EVENTS
+#include <linux/perf_event.h>
+#include <sys/syscall.h>
+#include <sys/ioctl.h>
+#include <unistd.h>
+#include <cstring>
+#endif
+
+namespace plb {
+
+namespace global {
+
+#ifdef PLB_PERF_EVENTS
+namespace {
+
+int openEvent(pluint type, pluint config, int groupLeader) {
+    perf_event_attr attr;
+    std::memset(&attr, 0, sizeof(attr));
+    attr.size = sizeof(attr);
+    attr.type = type;
+    attr.config = config;
+    attr.disabled = groupLeader<0 ? 1 : 0;
+    attr.exclude_kernel = 1;
+    attr.exclude_hv = 1;
+    attr.read_format = PERF_FORMAT_GROUP | PERF_FORMAT_TOTAL_TIME_ENABLED | PERF_FORMAT_TOTAL_TIME_RUNNING;
+    // Calling thread, any processor.
+    return (int)syscall(__NR_perf_event_open, &attr, 0, -1, groupLeader, 0);
+}
+
+}  // namespace
+#endif
+
+HardwareCounters::HardwareCounters()
+    : leader(-1)
+{
+    members[0] = -1;
+    members[1] = -1;
+}
+
+HardwareCounters::~HardwareCounters() {
+    close();
+}
+
+bool HardwareCounters::open() {
+    close();
+#ifdef PLB_PERF_EVENTS
+    leader = openEvent(PERF_TYPE_HARDWARE, PERF_COUNT_HW_CPU_CYCLES, -1);
+    if (leader<0) return false;
+    members[0] = openEvent(PERF_TYPE_HARDWARE, PERF_COUNT_HW_INSTRUCTIONS, leader);
+    members[1] = openEvent(PERF_TYPE_HARDWARE, PERF_COUNT_HW_CACHE_MISSES, leader);
+    if (members[0]<0 || members[1]<0) {
+        close();
+        return false;
+    }
+    ioctl(leader, PERF_EVENT_IOC_RESET, PERF_IOC_FLAG_GROUP);
+    ioctl(leader, PERF_EVENT_IOC_ENABLE, PERF_IOC_FLAG_GROUP);
+    return true;
+#else
+    return false;
+#endif
+}
+
+void HardwareCounters::close() {
+#ifdef PLB_PERF_EVENTS
+    for (int i=0; i<2; ++i) {
+        if (members[i]>=0) ::close(members[i]);
+        members[i] = -1;
+    }
+    if (leader>=0) ::close(leader);
+#endif
+    leader = -1;
+}
+
+HardwareCounterValues HardwareCounters::read() const {
+    HardwareCounterValues values;
+#ifdef PLB_PERF_EVENTS
+    if (leader<0) return values;
+    // Layout of PERF_FORMAT_GROUP: number of events, time enabled, time
+    //   running, and one value per event in the order they were opened.
+    pluint buffer[6];
+    if (::read(leader, buffer, sizeof(buffer)) != (ssize_t)sizeof(buffer)) {
+        return values;
+    }
+    double scale = buffer[2]>0 ? (double)buffer[1]/(double)buffer[2] : 1.;
+    values.cycles = (double)buffer[3]*scale;
+    values.instructions = (double)buffer[4]*scale;
+    values.llcMisses = (double)buffer[5]*scale;
+#endif
+    return values;
+}
+
+double measureStreamBandwidth() {
+    // Three arrays of 32 MB each, far beyond the caches of a single process.
+    const pluint size = 4*1024*1024;
+    const plint numRepeats = 5;
+    std::vector<double> a(size, 0.), b(size, 1.), c(size, 2.);
+    double s = 3.;
+    double bestTime = 0.;
+    for (plint iRepeat=0; iRepeat<numRepeats; ++iRepeat) {
+        global::mpi().barrier();
+        std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+        for (pluint i=0; i<size; ++i) {
+            a[i] = b[i]+s*c[i];
+        }
+        double time = std::chrono::duration<double>(std::chrono::steady_clock::now()-start).count();
+        if (iRepeat==0 || time<bestTime) bestTime = time;
+        // Prevent the compiler from removing the loop.
+        s = a[(pluint)iRepeat % size]*1.e-20 + 3.;
+    }
+    return 3.*(double)size*(double)sizeof(double)/bestTime;
+}
+
+}  // namespace global
+
+}  // namespace plb
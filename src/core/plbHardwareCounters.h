@@ -0,0 +1,102 @@
+/* This file is part of the Palabos library.
+ *
+ * Copyright (C) 2011-2015 FlowKit Sarl
+ * Route d'Oron 2
+ * 1010 Lausanne, Switzerland
+ * E-mail contact: contact@flowkit.com
+ *
+ * The most recent release of Palabos can be downloaded at 
+ * <http://www.palabos.org/>
+ *
+ * The library Palabos is free software: you can redistribute it and/or
+ * modify it under the terms of the GNU Affero General Public License as
+ * published by the Free Software Foundation, either version 3 of the
+ * License, or (at your option) any later version.
+ *
+ * The library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+/** \file
+ * Hardware performance counters of the calling thread, read through the
+ * perf_event_open interface of Linux -- header file.
+ */
+#ifndef PLB_HARDWARE_COUNTERS_H
+#define PLB_HARDWARE_COUNTERS_H
+
+#include "core/globalDefs.h"
+
+namespace plb {
+
+namespace global {
+
+/// Values of the hardware counters, or differences between two readings.
+struct HardwareCounterValues {
+    HardwareCounterValues()
+        : cycles(0.), instructions(0.), llcMisses(0.)
+    { }
+    HardwareCounterValues& operator+=(HardwareCounterValues const& rhs) {
+        cycles += rhs.cycles;
+        instructions += rhs.instructions;
+        llcMisses += rhs.llcMisses;
+        return *this;
+    }
+    HardwareCounterValues operator-(HardwareCounterValues const& rhs) const {
+        HardwareCounterValues result(*this);
+        result.cycles -= rhs.cycles;
+        result.instructions -= rhs.instructions;
+        result.llcMisses -= rhs.llcMisses;
+        return result;
+    }
+    /// Memory traffic estimated from the last-level cache misses; write-backs
+    ///   of modified lines and hardware prefetches are not counted, and the
+    ///   generic cache-miss event may include misses served by another cache.
+    double getEstimatedMemoryBytes() const {
+        return llcMisses*(double)cacheLineSize;
+    }
+    static const plint cacheLineSize = 64;
+    double cycles, instructions, llcMisses;
+};
+
+/// A group of user-space counters (cycles, instructions, last-level cache misses)
+///   attached to the thread which opens it.
+/** The counters are only available on Linux, with PLB_USE_POSIX defined, and
+ *  if the kernel allows it (perf_event_paranoid at most 2, and a processor or
+ *  virtual machine which exposes its performance monitoring unit). Otherwise
+ *  open() returns false and read() returns zeros. The values are scaled to
+ *  compensate for multiplexing, when the kernel shares the hardware counters
+ *  between several groups.
+ */
+class HardwareCounters {
+public:
+    HardwareCounters();
+    ~HardwareCounters();
+    bool open();
+    void close();
+    bool isOpen() const {
+        return leader>=0;
+    }
+    HardwareCounterValues read() const;
+private:
+    HardwareCounters(HardwareCounters const& rhs);
+    HardwareCounters& operator=(HardwareCounters const& rhs);
+private:
+    int leader;
+    int members[2];
+};
+
+/// Bandwidth of the STREAM triad a[i]=b[i]+s*c[i], in bytes per second, measured
+///   by all processes at once, so that processes which share a memory bus
+///   obtain their share of it.
+double measureStreamBandwidth();
+
+}  // namespace global
+
+}  // namespace plb
+
+#endif  // PLB_HARDWARE_COUNTERS_H
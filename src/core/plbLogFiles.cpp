@@ -66,8 +66,14 @@ void PlbLogFile::init(bool parallel_){
 	this->parallel = parallel_;
 	this->indentation=0;
 	this->indentSpaces="";
-	if (global::mpi().isMainProcessor()){this->fName=global::directories().getLogOutDir()+"Main.Log";}
-	else{this->fName = global::directories().getLogOutDir()+"Rank"+util::val2str(global::mpi().getRank())+".log";}
+	// The files are named after the rank in MPI_COMM_WORLD, which stays unique when the
+	// processes are split into groups with their own communicator.
+	int worldRank = global::mpi().getRank();
+#ifdef PLB_MPI_PARALLEL
+	MPI_Comm_rank(MPI_COMM_WORLD, &worldRank);
+#endif
+	if (worldRank == 0){this->fName=global::directories().getLogOutDir()+"Main.Log";}
+	else{this->fName = global::directories().getLogOutDir()+"Rank"+util::val2str(worldRank)+".log";}
 	if(exists(this->fName)){ remove(fName.c_str());}
 }
 
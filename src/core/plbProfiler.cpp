@@ -24,6 +24,7 @@
 
 #include "core/plbProfiler.h"
 #include "parallelism/mpiManager.h"
+#include "parallelism/threadPool.h"
 #include "core/runTimeDiagnostics.h"
 #include "algorithm/statistics.h"
 #include "libraryInterfaces/TINYXML_xmlIO.hh"
@@ -32,12 +33,20 @@ namespace plb {
 
 namespace global {
 
-Profiler::Profiler() {
+char const* const Profiler::regionNames[Profiler::numRegions] =
+    { "collStream", "dataProcessor", "envelope-update" };
+
+Profiler::Profiler()
+    : streamBandwidth(0.),
+      countersOnAllProcesses(false)
+{
+    std::fill(modelBytes, modelBytes+numRegions, 0.);
     turnOff();
     automaticCycling();
     setReportFile("plbProfile");
 
     validCounters.insert("collStreamCells");
+    validCounters.insert("collStreamBytes");
     validCounters.insert("iterations");
     validCounters.insert("mpiSendChar");
     validCounters.insert("mpiReceiveChar");
@@ -45,6 +54,7 @@ Profiler::Profiler() {
     validTimers.insert("collStream");
     validTimers.insert("cycle");
     validTimers.insert("dataProcessor");
+    validTimers.insert("envelope-update");
     validTimers.insert("mpiCommunication");
     validTimers.insert("io");
     validTimers.insert("totalTime");
@@ -59,6 +69,48 @@ void Profiler::turnOff() {
     profilingFlag = false;
 }
 
+void Profiler::suspend() {
+    profilingFlag = false;
+}
+
+void Profiler::resume() {
+    profilingFlag = true;
+}
+
+bool Profiler::turnOnHardwareCounters() {
+    // The counters follow the calling thread only: with a thread pool, they would
+    //   miss the work of the other threads.
+    bool threaded = global::threadPool().isThreaded();
+    bool available = !threaded && counters.open();
+    // The roofline report is collective, and contains the counters only if they
+    //   are available everywhere.
+    int numMissing = available ? 0 : 1;
+#ifdef PLB_MPI_PARALLEL
+    global::mpi().reduceAndBcast(numMissing, MPI_SUM);
+#endif
+    countersOnAllProcesses = numMissing==0;
+    plbWarning(threaded, "Hardware performance counters are disabled with more than one thread per process; "
+                         "the roofline report only contains the model bandwidth.");
+    plbWarning(!threaded && !available, "Hardware performance counters are not available (perf_event_open failed); "
+                                        "the roofline report only contains the model bandwidth.");
+    for (int region=0; region<numRegions; ++region) {
+        regionCounts[region] = HardwareCounterValues();
+    }
+    if (streamBandwidth<=0.) {
+        streamBandwidth = measureStreamBandwidth();
+    }
+    return available;
+}
+
+void Profiler::turnOffHardwareCounters() {
+    counters.close();
+    countersOnAllProcesses = false;
+}
+
+void Profiler::setStreamBandwidth(double bytesPerSecond) {
+    streamBandwidth = bytesPerSecond;
+}
+
 void Profiler::automaticCycling() {
     manualCycleFlag = false;
 }
@@ -97,6 +149,7 @@ void Profiler::writeReport() {
     addStatisticalValue(globalSection, "Relative_communication_time", t_mpiCommunication / t_cycle);
     addStatisticalValue(globalSection, "Total_io_time", t_io);
     addStatisticalValue(globalSection, "Relative_io_time", t_io / (t_cycle+t_io));
+    writeRoofline(writer["Roofline"]);
 
     writer.print(reportFile);
 }
@@ -116,6 +169,41 @@ void Profiler::addStatisticalValue(XMLwriter& writer, std::string name, double v
     writer[name]["Values"].set(allValues);
 }
 
+void Profiler::writeRoofline(XMLwriter& writer) {
+    const double giga = 1.e9;
+    // Threads may have been started after turnOnHardwareCounters().
+    int numThreaded = global::threadPool().isThreaded() ? 1 : 0;
+#ifdef PLB_MPI_PARALLEL
+    global::mpi().reduceAndBcast(numThreaded, MPI_SUM);
+#endif
+    bool useCounters = countersOnAllProcesses && numThreaded==0;
+    if (streamBandwidth>0.) {
+        addStatisticalValue(writer, "STREAM_GBs", streamBandwidth/giga);
+    }
+    for (int region=0; region<numRegions; ++region) {
+        XMLwriter& section = writer[regionNames[region]];
+        double time = getTimer(regionNames[region]);
+        HardwareCounterValues const& counts = regionCounts[region];
+        double estimatedBandwidth = time>0. ? counts.getEstimatedMemoryBytes()/time : 0.;
+        double modelBandwidth = time>0. ? modelBytes[region]/time : 0.;
+        addStatisticalValue(section, "Time", time);
+        if (useCounters) {
+            addStatisticalValue(section, "Cycles", counts.cycles);
+            addStatisticalValue(section, "Instructions", counts.instructions);
+            addStatisticalValue(section, "IPC", counts.cycles>0. ? counts.instructions/counts.cycles : 0.);
+            addStatisticalValue(section, "LLC_misses", counts.llcMisses);
+            addStatisticalValue(section, "Estimated_GBs_from_LLC_misses", estimatedBandwidth/giga);
+        }
+        addStatisticalValue(section, "Model_GBs", modelBandwidth/giga);
+        if (streamBandwidth>0.) {
+            if (useCounters) {
+                addStatisticalValue(section, "Estimated_fraction_of_STREAM", estimatedBandwidth/streamBandwidth);
+            }
+            addStatisticalValue(section, "Model_fraction_of_STREAM", modelBandwidth/streamBandwidth);
+        }
+    }
+}
+
 void Profiler::addMainProcValue(XMLwriter& writer, std::string name, plint value) {
     writer[name].set(value);
 }
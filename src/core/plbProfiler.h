@@ -27,10 +27,13 @@
 
 #include "core/globalDefs.h"
 #include "core/plbTimer.h"
+#include "core/plbHardwareCounters.h"
 #include "io/plbFiles.h"
 #include "libraryInterfaces/TINYXML_xmlIO.h"
 #include <string>
 #include <set>
+#include <vector>
+#include <cstring>
 
 namespace plb {
 
@@ -40,6 +43,7 @@ namespace global {
  * Counters:
  * =========
  * "collStreamCells":                Number of coll-stream cells.
+ * "collStreamBytes":                Bytes of populations read and written by coll-stream.
  * "iterations":                     Number of iterations.
  * "mpiSendChar":                    Number of bytes sent by MPI.
  * "mpiReceiveChar":                 Number of bytes received by MPI.
@@ -53,11 +57,28 @@ namespace global {
  * "mpiCommunication":               Total Time for MPI communication.
  * "io":                             Time spent for I/O operations.
  * "totalTime":                      Total time.
+ *
+ * Hardware counters:
+ * ==================
+ * With turnOnHardwareCounters(), the cycles, instructions and last-level cache
+ * misses of the calling thread are accumulated for the timers "collStream",
+ * "dataProcessor" and "envelope-update" (inclusive of the nested ones). The
+ * report then contains a roofline section: the bandwidth estimated from the
+ * cache misses, the bandwidth implied by the bytes-per-cell of the descriptor
+ * (for the region in which collision-streaming took place), and their fraction
+ * of the STREAM bandwidth. The counters only follow the calling thread, so they
+ * are disabled, and left out of the report, when the thread pool runs more
+ * than one thread.
 **/
 class Profiler {
 public:
     void turnOn();
     void turnOff();
+    /// Temporarily disable profiling, without touching the timers; used
+    ///   while shared-memory threads are running, as timers are not thread-safe.
+    void suspend();
+    /// Re-enable profiling after a call to suspend().
+    void resume();
     void automaticCycling();
     void manualCycling();
     void cycle();
@@ -71,14 +92,32 @@ public:
         if (doProfiling()) {
             verifyTimer(timer);
             plbTimer(timer).start();
+            int region = getRegion(timer);
+            if (region>=0) {
+                activeRegions.push_back(region);
+                if (counters.isOpen()) regionStart[region] = counters.read();
+            }
         }
     }
     void stop(char const* timer) {
         if (doProfiling()) {
             verifyTimer(timer);
+            int region = getRegion(timer);
+            if (region>=0) {
+                if (counters.isOpen()) regionCounts[region] += counters.read()-regionStart[region];
+                if (!activeRegions.empty()) activeRegions.pop_back();
+            }
             plbTimer(timer).stop();
         }
     }
+    /// Attach the hardware counters to the calling thread (collective); returns
+    ///   false, with a warning, if they are not available on some process, or
+    ///   if the thread pool has more than one thread.
+    bool turnOnHardwareCounters();
+    void turnOffHardwareCounters();
+    /// Reference bandwidth of a process, in bytes per second; it is measured by
+    ///   turnOnHardwareCounters() unless it was set before.
+    void setStreamBandwidth(double bytesPerSecond);
     void increment(char const* counter) {
         if (doProfiling()) {
             verifyCounter(counter);
@@ -91,6 +130,15 @@ public:
             plbCounter(counter).increment(value);
         }
     }
+    /// Count cells of a collision-streaming step, together with the bytes of
+    ///   populations they read and write (2*q*sizeof(T) per cell).
+    void incrementCollStream(plint numCells, plint bytesPerCell) {
+        if (doProfiling()) {
+            increment("collStreamCells", numCells);
+            increment("collStreamBytes", numCells*bytesPerCell);
+            modelBytes[activeRegions.empty() ? 0 : activeRegions.back()] += (double)numCells*(double)bytesPerCell;
+        }
+    }
     plint getCounter(char const* counter) {
         verifyCounter(counter);
         return plbCounter(counter).getCount();
@@ -106,6 +154,14 @@ private:
     void verifyCounter(std::string const& counter);
     void addStatisticalValue(XMLwriter& writer, std::string name, double value);
     void addMainProcValue(XMLwriter& writer, std::string name, plint value);
+    void writeRoofline(XMLwriter& writer);
+    /// Index of the timers which are followed by the hardware counters, or -1.
+    static int getRegion(char const* timer) {
+        for (int region=0; region<numRegions; ++region) {
+            if (std::strcmp(timer, regionNames[region])==0) return region;
+        }
+        return -1;
+    }
 
     Profiler();
 private:
@@ -114,6 +170,14 @@ private:
     FileName reportFile;
     std::set<std::string> validTimers;
     std::set<std::string> validCounters;
+    static const int numRegions = 3;
+    static char const* const regionNames[numRegions];
+    HardwareCounters counters;
+    HardwareCounterValues regionStart[numRegions], regionCounts[numRegions];
+    double modelBytes[numRegions];
+    std::vector<int> activeRegions;
+    double streamBandwidth;
+    bool countersOnAllProcesses;
 friend Profiler& profiler();
 };
 
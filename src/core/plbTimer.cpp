@@ -48,7 +48,7 @@ void PlbTimer::start() {
 #ifdef PLB_USE_POSIX
     timespec ts;
     clock_gettime(CLOCK_REALTIME, &ts);
-    startTime = (double) ts.tv_nsec * (double) 1.0e-9;
+    startTime = (double) ts.tv_sec + (double) ts.tv_nsec * (double) 1.0e-9;
 #else
     startClock = clock();
 #endif
@@ -79,7 +79,7 @@ double PlbTimer::getTime() const {
 #ifdef PLB_USE_POSIX
         timespec ts;
         clock_gettime(CLOCK_REALTIME, &ts);
-        double endTime = (double) ts.tv_nsec * (double) 1.0e-9;
+        double endTime = (double) ts.tv_sec + (double) ts.tv_nsec * (double) 1.0e-9;
         return cumulativeTime + endTime-startTime;
 #else
         return cumulativeTime + (double)(clock()-startClock)
@@ -0,0 +1,317 @@
+/* This file is part of the Palabos library.
+ *
+ * Copyright (C) 2011-2015 FlowKit Sarl
+ * Route d'Oron 2
+ * 1010 Lausanne, Switzerland
+ * E-mail contact: contact@flowkit.com
+ *
+ * The most recent release of Palabos can be downloaded at 
+ * <http://www.palabos.org/>
+ *
+ * The library Palabos is free software: you can redistribute it and/or
+ * modify it under the terms of the GNU Affero General Public License as
+ * published by the Free Software Foundation, either version 3 of the
+ * License, or (at your option) any later version.
+ *
+ * The library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+/** \file
+ * Hierarchical tracing of program regions, with export to the trace-event
+ * format of Chrome and Perfetto -- implementation file.
+ */
+#include "core/plbTracer.h"
+#include "parallelism/mpiManager.h"
+#include "core/plbDebug.h"
+#include <fstream>
+#include <sstream>
+#include <iomanip>
+#include <algorithm>
+#include <set>
+
+namespace plb {
+
+namespace global {
+
+namespace {
+
+// Region names are program literals; only the characters which would
+//   break the JSON string are escaped.
+std::string jsonEscape(std::string const& name) {
+    std::string escaped;
+    for (pluint i=0; i<name.size(); ++i) {
+        if (name[i]=='"' || name[i]=='\\') {
+            escaped += '\\';
+        }
+        escaped += name[i];
+    }
+    return escaped;
+}
+
+std::string joinLines(std::vector<std::string> const& lines) {
+    std::string joined;
+    for (pluint i=0; i<lines.size(); ++i) {
+        joined += lines[i];
+        joined += '\n';
+    }
+    return joined;
+}
+
+void splitLines(std::string const& joined, std::set<std::string>& lines) {
+    std::istringstream stream(joined);
+    std::string line;
+    while (std::getline(stream, line)) {
+        if (!line.empty()) {
+            lines.insert(line);
+        }
+    }
+}
+
+}  // namespace
+
+Tracer::Tracer()
+    : onFlag(false),
+      origin(0),
+      bufferCapacity(1<<16)
+{ }
+
+void Tracer::turnOn(pluint bufferCapacity_) {
+    PLB_ASSERT( bufferCapacity_>0 );
+    onFlag = false;
+    bufferCapacity = bufferCapacity_;
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        for (pluint iBuffer=0; iBuffer<buffers.size(); ++iBuffer) {
+            ThreadBuffer& buffer = *buffers[iBuffer];
+            buffer.depth = 0;
+            buffer.numRecorded = 0;
+            buffer.events.assign(bufferCapacity, Event());
+            buffer.totals.clear();
+        }
+    }
+    global::mpi().barrier();
+    origin = 0;
+    origin = now();
+    onFlag = true;
+}
+
+void Tracer::turnOff() {
+    onFlag = false;
+}
+
+plint Tracer::registerRegion(char const* name) {
+    std::lock_guard<std::mutex> lock(mutex);
+    std::map<std::string,plint>::const_iterator it = regionIds.find(name);
+    if (it!=regionIds.end()) {
+        return it->second;
+    }
+    plint region = (plint)regionNames.size();
+    regionNames.push_back(name);
+    regionIds[name] = region;
+    return region;
+}
+
+Tracer::ThreadBuffer& Tracer::getLocalBuffer() {
+    // The buffers are never deleted, so that the pointer cached by a thread
+    //   remains valid when tracing is turned on again.
+    static thread_local ThreadBuffer* localBuffer = 0;
+    if (!localBuffer) {
+        std::lock_guard<std::mutex> lock(mutex);
+        buffers.push_back(std::unique_ptr<ThreadBuffer>(new ThreadBuffer));
+        localBuffer = buffers.back().get();
+        localBuffer->threadId = (plint)buffers.size()-1;
+        localBuffer->depth = 0;
+        localBuffer->numRecorded = 0;
+        localBuffer->events.assign(bufferCapacity, Event());
+    }
+    return *localBuffer;
+}
+
+std::string Tracer::serializeEvents() const {
+    int rank = global::mpi().getRank();
+    std::ostringstream out;
+    out << std::fixed << std::setprecision(3);
+    out << ",\n{\"name\":\"process_name\",\"ph\":\"M\",\"pid\":" << rank
+        << ",\"args\":{\"name\":\"rank " << rank << "\"}}";
+    out << ",\n{\"name\":\"process_sort_index\",\"ph\":\"M\",\"pid\":" << rank
+        << ",\"args\":{\"sort_index\":" << rank << "}}";
+    for (pluint iBuffer=0; iBuffer<buffers.size(); ++iBuffer) {
+        ThreadBuffer const& buffer = *buffers[iBuffer];
+        out << ",\n{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":" << rank
+            << ",\"tid\":" << buffer.threadId
+            << ",\"args\":{\"name\":\"thread " << buffer.threadId << "\"}}";
+        pluint capacity = buffer.events.size();
+        pluint numEvents = std::min(buffer.numRecorded, capacity);
+        pluint first = buffer.numRecorded - numEvents;
+        for (pluint iEvent=first; iEvent<buffer.numRecorded; ++iEvent) {
+            Event const& event = buffer.events[iEvent % capacity];
+            out << ",\n{\"name\":\"" << jsonEscape(regionNames[event.region])
+                << "\",\"ph\":\"X\",\"pid\":" << rank << ",\"tid\":" << buffer.threadId
+                << ",\"ts\":" << (double)event.begin*1.e-3
+                << ",\"dur\":" << (double)(event.end-event.begin)*1.e-3
+                << ",\"args\":{\"depth\":" << event.depth << "}}";
+        }
+    }
+    return out.str();
+}
+
+void Tracer::writeTrace(FileName traceFile) const {
+    traceFile.defaultPath(directories().getOutputDir());
+    traceFile.defaultExt("json");
+    std::string localEvents = serializeEvents();
+    if (global::mpi().isMainProcessor()) {
+        std::ofstream file(traceFile.get().c_str());
+        file << "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[\n";
+        // Skip the separator in front of the very first event.
+        file << localEvents.substr(2);
+#ifdef PLB_MPI_PARALLEL
+        for (int iProc=1; iProc<global::mpi().getSize(); ++iProc) {
+            int length = 0;
+            global::mpi().receive(&length, 1, iProc);
+            std::vector<char> events(length);
+            if (length>0) {
+                global::mpi().receive(&events[0], length, iProc);
+            }
+            file.write(events.empty() ? 0 : &events[0], length);
+        }
+#endif
+        file << "\n]}\n";
+    }
+#ifdef PLB_MPI_PARALLEL
+    else {
+        int length = (int)localEvents.size();
+        global::mpi().send(&length, 1, 0);
+        if (length>0) {
+            global::mpi().send(&localEvents[0], length, 0);
+        }
+    }
+#endif
+}
+
+std::vector<std::string> Tracer::getLocalRegions() const {
+    std::vector<std::string> names;
+    for (plint region=0; region<(plint)regionNames.size(); ++region) {
+        for (pluint iBuffer=0; iBuffer<buffers.size(); ++iBuffer) {
+            std::vector<RegionTotal> const& totals = buffers[iBuffer]->totals;
+            if (region<(plint)totals.size() && totals[region].numCalls>0) {
+                names.push_back(regionNames[region]);
+                break;
+            }
+        }
+    }
+    return names;
+}
+
+void Tracer::writeSummary(FileName summaryFile) const {
+    summaryFile.defaultPath(directories().getOutputDir());
+    summaryFile.defaultExt("dat");
+
+    // 1. Agree on the names of all regions which were entered by some process,
+    //    since the identifiers depend on the order in which regions are first used.
+    std::string allNames = joinLines(getLocalRegions());
+#ifdef PLB_MPI_PARALLEL
+    if (global::mpi().isMainProcessor()) {
+        std::set<std::string> names;
+        splitLines(allNames, names);
+        for (int iProc=1; iProc<global::mpi().getSize(); ++iProc) {
+            int length = 0;
+            global::mpi().receive(&length, 1, iProc);
+            std::string remoteNames(length, ' ');
+            if (length>0) {
+                global::mpi().receive(&remoteNames[0], length, iProc);
+            }
+            splitLines(remoteNames, names);
+        }
+        allNames = joinLines(std::vector<std::string>(names.begin(), names.end()));
+    }
+    else {
+        int length = (int)allNames.size();
+        global::mpi().send(&length, 1, 0);
+        if (length>0) {
+            global::mpi().send(&allNames[0], length, 0);
+        }
+    }
+    global::mpi().bCast(allNames);
+#endif
+    std::set<std::string> nameSet;
+    splitLines(allNames, nameSet);
+    std::vector<std::string> names(nameSet.begin(), nameSet.end());
+
+    // 2. Time and number of calls of the regions on this process, summed over its threads.
+    pluint numRegions = names.size();
+    std::vector<double> minTime(numRegions, 0.), maxTime, sumTime;
+    std::vector<long> numCalls(numRegions, 0);
+    long numDropped = 0;
+    for (pluint iName=0; iName<numRegions; ++iName) {
+        std::map<std::string,plint>::const_iterator it = regionIds.find(names[iName]);
+        if (it==regionIds.end()) continue;
+        plint region = it->second;
+        for (pluint iBuffer=0; iBuffer<buffers.size(); ++iBuffer) {
+            std::vector<RegionTotal> const& totals = buffers[iBuffer]->totals;
+            if (region<(plint)totals.size()) {
+                minTime[iName] += (double)totals[region].time*1.e-9;
+                numCalls[iName] += (long)totals[region].numCalls;
+            }
+        }
+    }
+    for (pluint iBuffer=0; iBuffer<buffers.size(); ++iBuffer) {
+        ThreadBuffer const& buffer = *buffers[iBuffer];
+        if (buffer.numRecorded>buffer.events.size()) {
+            numDropped += (long)(buffer.numRecorded-buffer.events.size());
+        }
+    }
+    maxTime = minTime;
+    sumTime = minTime;
+    std::vector<long> dropped(1, numDropped);
+#ifdef PLB_MPI_PARALLEL
+    if (numRegions>0) {
+        global::mpi().allReduceVect(minTime, MPI_MIN);
+        global::mpi().allReduceVect(maxTime, MPI_MAX);
+        global::mpi().allReduceVect(sumTime, MPI_SUM);
+        global::mpi().allReduceVect(numCalls, MPI_SUM);
+    }
+    global::mpi().allReduceVect(dropped, MPI_SUM);
+#endif
+
+    // 3. The regions with the largest maximum time come first.
+    if (global::mpi().isMainProcessor()) {
+        double numProcs = (double)global::mpi().getSize();
+        std::vector<pluint> order(numRegions);
+        for (pluint iName=0; iName<numRegions; ++iName) order[iName] = iName;
+        std::sort(order.begin(), order.end(),
+                  [&maxTime](pluint a, pluint b) { return maxTime[a]>maxTime[b]; });
+        pluint nameWidth = 6;
+        for (pluint iName=0; iName<numRegions; ++iName) {
+            nameWidth = std::max(nameWidth, (pluint)names[iName].size());
+        }
+        std::ofstream file(summaryFile.get().c_str());
+        file << "# Time spent in every traced region, in seconds, over " << global::mpi().getSize()
+             << " processes (summed over the threads of each process).\n";
+        file << "# Events dropped from the ring buffers: " << dropped[0] << "\n";
+        file << std::left << std::setw(nameWidth) << "#region" << std::right
+             << std::setw(12) << "calls" << std::setw(14) << "min" << std::setw(14) << "mean"
+             << std::setw(14) << "max" << std::setw(10) << "max/mean" << "\n";
+        file << std::scientific << std::setprecision(5);
+        for (pluint i=0; i<numRegions; ++i) {
+            pluint iName = order[i];
+            double mean = sumTime[iName]/numProcs;
+            file << std::left << std::setw(nameWidth) << names[iName] << std::right
+                 << std::setw(12) << numCalls[iName]
+                 << std::setw(14) << minTime[iName] << std::setw(14) << mean
+                 << std::setw(14) << maxTime[iName];
+            file << std::fixed << std::setprecision(3) << std::setw(10)
+                 << (mean>0. ? maxTime[iName]/mean : 1.) << "\n";
+            file << std::scientific << std::setprecision(5);
+        }
+    }
+}
+
+}  // namespace global
+
+}  // namespace plb
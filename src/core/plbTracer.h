@@ -0,0 +1,190 @@
+/* This file is part of the Palabos library.
+ *
+ * Copyright (C) 2011-2015 FlowKit Sarl
+ * Route d'Oron 2
+ * 1010 Lausanne, Switzerland
+ * E-mail contact: contact@flowkit.com
+ *
+ * The most recent release of Palabos can be downloaded at 
+ * <http://www.palabos.org/>
+ *
+ * The library Palabos is free software: you can redistribute it and/or
+ * modify it under the terms of the GNU Affero General Public License as
+ * published by the Free Software Foundation, either version 3 of the
+ * License, or (at your option) any later version.
+ *
+ * The library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+/** \file
+ * Hierarchical tracing of program regions, with export to the trace-event
+ * format of Chrome and Perfetto -- header file.
+ */
+#ifndef PLB_TRACER_H
+#define PLB_TRACER_H
+
+#include "core/globalDefs.h"
+#include "io/plbFiles.h"
+#include <string>
+#include <vector>
+#include <map>
+#include <mutex>
+#include <memory>
+#include <chrono>
+#include <cstdint>
+
+namespace plb {
+
+namespace global {
+
+/// Records the begin and end of named program regions, for every MPI
+///   process and every shared-memory thread.
+/** Regions are opened and closed by the scoped macro PLB_TRACE_SCOPE("name"),
+ *  which interns the name once per call site: afterwards a disabled tracer
+ *  costs one test of a flag per scope, and an enabled one two reads of the
+ *  clock and one write into a buffer which belongs to the calling thread.
+ *  Defining PLB_NO_TRACING at compile time removes the scopes altogether.
+ *
+ *  Each thread owns a ring buffer of events, so that the most recent events
+ *  are kept when a long run overflows it. Independently of the buffer, the
+ *  number of calls and the cumulative time of every region are accumulated
+ *  per thread, and are therefore exact for the whole run.
+ *
+ *  The timestamps of all processes are measured from a common origin, taken
+ *  after a barrier in turnOn(). turnOn(), turnOff(), writeTrace() and
+ *  writeSummary() are collective, and must be called by the main thread
+ *  while no task of the thread pool is running.
+ */
+class Tracer {
+public:
+    struct Event {
+        std::int64_t begin, end;  // Nanoseconds since the origin.
+        plint region;
+        plint depth;
+    };
+    struct RegionTotal {
+        RegionTotal() : numCalls(0), time(0) { }
+        plint numCalls;
+        std::int64_t time;        // Nanoseconds.
+    };
+    struct ThreadBuffer {
+        plint threadId;
+        plint depth;
+        pluint numRecorded;
+        std::vector<Event> events;
+        std::vector<RegionTotal> totals;
+    };
+public:
+    /// Start recording, after discarding all previous events; every thread keeps
+    ///   up to bufferCapacity events.
+    void turnOn(pluint bufferCapacity = 1<<16);
+    void turnOff();
+    bool isOn() const {
+        return onFlag;
+    }
+    /// Return the identifier of a region, registering it on its first use.
+    plint registerRegion(char const* name);
+    std::string const& getRegionName(plint region) const {
+        return regionNames[region];
+    }
+    std::int64_t now() const {
+        return std::chrono::duration_cast<std::chrono::nanoseconds> (
+                   std::chrono::steady_clock::now().time_since_epoch() ).count() - origin;
+    }
+    ThreadBuffer& getLocalBuffer();
+    void record(ThreadBuffer& buffer, plint region, std::int64_t begin, std::int64_t end, plint depth) {
+        Event& event = buffer.events[buffer.numRecorded % buffer.events.size()];
+        event.begin = begin;
+        event.end = end;
+        event.region = region;
+        event.depth = depth;
+        ++buffer.numRecorded;
+        if ((plint)buffer.totals.size() <= region) {
+            buffer.totals.resize(region+1);
+        }
+        ++buffer.totals[region].numCalls;
+        buffer.totals[region].time += end-begin;
+    }
+    /// Write the events of all processes into a single trace-event (JSON) file,
+    ///   which is opened by chrome://tracing or https://ui.perfetto.dev. The
+    ///   events are sent to the main process one process at a time.
+    void writeTrace(FileName traceFile) const;
+    /// Write, for every region, the minimum, mean and maximum over all processes
+    ///   of the time spent in the region, and the ratio of maximum to mean.
+    void writeSummary(FileName summaryFile) const;
+private:
+    Tracer();
+    std::string serializeEvents() const;
+    std::vector<std::string> getLocalRegions() const;
+private:
+    bool onFlag;
+    std::int64_t origin;
+    pluint bufferCapacity;
+    std::vector<std::string> regionNames;
+    std::map<std::string,plint> regionIds;
+    std::vector<std::unique_ptr<ThreadBuffer> > buffers;
+    mutable std::mutex mutex;
+friend Tracer& tracer();
+};
+
+inline Tracer& tracer() {
+    static Tracer instance;
+    return instance;
+}
+
+/// Records the region from its construction to its destruction, if the
+///   tracer is on at construction.
+class TraceScope {
+public:
+    explicit TraceScope(plint region_)
+        : buffer(0)
+    {
+        Tracer& t = tracer();
+        if (t.isOn()) {
+            region = region_;
+            buffer = &t.getLocalBuffer();
+            depth = buffer->depth++;
+            begin = t.now();
+        }
+    }
+    ~TraceScope() {
+        if (buffer) {
+            Tracer& t = tracer();
+            t.record(*buffer, region, begin, t.now(), depth);
+            --buffer->depth;
+        }
+    }
+private:
+    TraceScope(TraceScope const& rhs);
+    TraceScope& operator=(TraceScope const& rhs);
+private:
+    Tracer::ThreadBuffer* buffer;
+    plint region, depth;
+    std::int64_t begin;
+};
+
+}  // namespace global
+
+}  // namespace plb
+
+#define PLB_TRACE_CONCAT_IMPL(a,b) a##b
+#define PLB_TRACE_CONCAT(a,b) PLB_TRACE_CONCAT_IMPL(a,b)
+
+#ifdef PLB_NO_TRACING
+#define PLB_TRACE_SCOPE(name)
+#else
+/// Trace the enclosing scope under the given name (a string literal).
+#define PLB_TRACE_SCOPE(name) \
+    static const ::plb::plint PLB_TRACE_CONCAT(plbTraceRegion_,__LINE__) = \
+        ::plb::global::tracer().registerRegion(name); \
+    ::plb::global::TraceScope PLB_TRACE_CONCAT(plbTraceScope_,__LINE__) \
+        (PLB_TRACE_CONCAT(plbTraceRegion_,__LINE__))
+#endif
+
+#endif  // PLB_TRACER_H
@@ -722,6 +722,7 @@ template<typename T, template<typename U> class Descriptor>
 void AssignOmegaFunctional3D<T,Descriptor>::process (
         Box3D domain, BlockLattice3D<T,Descriptor>& lattice )
 {
+    lattice.invalidateActivity();
     // Define dimensions of a viscosity.
     int dimDx = 2;
     int dimDt = -1;
@@ -771,6 +772,7 @@ template<typename T, template<typename U> class Descriptor>
 void AssignScalarFieldOmegaFunctional3D<T,Descriptor>::process (
         Box3D domain, BlockLattice3D<T,Descriptor>& lattice, ScalarField3D<T> &omega )
 {
+    lattice.invalidateActivity();
     // Define dimensions of a viscosity.
     int dimDx = 2;
     int dimDt = -1;
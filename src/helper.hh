@@ -76,6 +76,11 @@ namespace plb{
 		{
 			constants.initialize(fileName);
 		}
+		if(Obstacle<T,BoundaryType,SurfaceData,Descriptor>::objCount == 1)
+		{
+			// The obstacle mesh is broadcast while the wall mesh is being set up.
+			obstacle.loadMesh();
+		}
 		if(Wall<T,BoundaryType,SurfaceData,Descriptor>::objCount == 1)
 		{
 			wall.initialize();
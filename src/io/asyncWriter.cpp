@@ -0,0 +1,194 @@
+/* This file is part of the Palabos library.
+ *
+ * Copyright (C) 2011-2015 FlowKit Sarl
+ * Route d'Oron 2
+ * 1010 Lausanne, Switzerland
+ * E-mail contact: contact@flowkit.com
+ *
+ * The most recent release of Palabos can be downloaded at 
+ * <http://www.palabos.org/>
+ *
+ * The library Palabos is free software: you can redistribute it and/or
+ * modify it under the terms of the GNU Affero General Public License as
+ * published by the Free Software Foundation, either version 3 of the
+ * License, or (at your option) any later version.
+ *
+ * The library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+/** \file
+ * Background writer with a bounded pool of staging buffers -- implementation file.
+ */
+
+#include "io/asyncWriter.h"
+#include "parallelism/mpiManager.h"
+#include "core/plbDebug.h"
+
+namespace plb {
+
+/* *************** Class BufferWriter ******************************** */
+
+/// Sink which appends the serialized data to a buffer.
+class BufferWriter : public SerializedWriter {
+public:
+    BufferWriter(std::vector<char>& buffer_)
+        : buffer(buffer_)
+    { }
+    virtual BufferWriter* clone() const {
+        return new BufferWriter(*this);
+    }
+    virtual void writeHeader(pluint dataSize) {
+        buffer.clear();
+        buffer.reserve(dataSize);
+    }
+    virtual void writeData(char const* dataBuffer, pluint bufferSize) {
+        buffer.insert(buffer.end(), dataBuffer, dataBuffer+bufferSize);
+    }
+private:
+    std::vector<char>& buffer;
+};
+
+void serializerToBuffer(DataSerializer const* serializer, std::vector<char>& buffer)
+{
+    buffer.clear();
+    serializerToSink(serializer, new BufferWriter(buffer));
+}
+
+
+/* *************** Class AsyncWriter ******************************** */
+
+AsyncWriter::AsyncWriter(plint numBuffers_)
+    : numBuffers(numBuffers_),
+      threaded(global::mpi().isMainProcessor()),
+      busy(false),
+      shutdown(false)
+{
+    PLB_PRECONDITION( numBuffers>=1 );
+    for (plint iBuffer=0; iBuffer<numBuffers; ++iBuffer) {
+        buffers.push_back(new std::vector<char>);
+    }
+    freeBuffers = buffers;
+    if (threaded) {
+        writer = std::thread(&AsyncWriter::writerLoop, this);
+    }
+}
+
+AsyncWriter::~AsyncWriter() {
+    if (threaded) {
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            shutdown = true;
+        }
+        taskCondition.notify_all();
+        writer.join();
+    }
+    for (pluint iBuffer=0; iBuffer<buffers.size(); ++iBuffer) {
+        delete buffers[iBuffer];
+    }
+}
+
+std::vector<char>& AsyncWriter::acquireBuffer() {
+    std::unique_lock<std::mutex> lock(mutex);
+    while (freeBuffers.empty()) {
+        releaseCondition.wait(lock);
+    }
+    std::vector<char>* buffer = freeBuffers.back();
+    freeBuffers.pop_back();
+    return *buffer;
+}
+
+void AsyncWriter::submit(std::vector<char>& buffer, Job const& job) {
+    rethrow();
+    if (!threaded) {
+        job(buffer);
+        std::lock_guard<std::mutex> lock(mutex);
+        freeBuffers.push_back(&buffer);
+        return;
+    }
+    Task task;
+    task.buffer = &buffer;
+    task.job = job;
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        tasks.push_back(task);
+    }
+    taskCondition.notify_one();
+}
+
+void AsyncWriter::submit(Job const& job) {
+    rethrow();
+    if (!threaded) {
+        job(emptyBuffer);
+        return;
+    }
+    Task task;
+    task.buffer = 0;
+    task.job = job;
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        tasks.push_back(task);
+    }
+    taskCondition.notify_one();
+}
+
+void AsyncWriter::flush() {
+    {
+        std::unique_lock<std::mutex> lock(mutex);
+        while (!tasks.empty() || busy) {
+            releaseCondition.wait(lock);
+        }
+    }
+    rethrow();
+}
+
+void AsyncWriter::rethrow() {
+    std::exception_ptr exception;
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        exception = firstException;
+        firstException = std::exception_ptr();
+    }
+    if (exception) {
+        std::rethrow_exception(exception);
+    }
+}
+
+void AsyncWriter::writerLoop() {
+    std::unique_lock<std::mutex> lock(mutex);
+    while (true) {
+        while (tasks.empty() && !shutdown) {
+            taskCondition.wait(lock);
+        }
+        // The pending tasks are completed before shutting down.
+        if (tasks.empty()) {
+            return;
+        }
+        Task task = tasks.front();
+        tasks.pop_front();
+        busy = true;
+        lock.unlock();
+        try {
+            task.job(task.buffer ? *task.buffer : emptyBuffer);
+        }
+        catch (...) {
+            std::lock_guard<std::mutex> exceptionLock(mutex);
+            if (!firstException) {
+                firstException = std::current_exception();
+            }
+        }
+        lock.lock();
+        if (task.buffer) {
+            freeBuffers.push_back(task.buffer);
+        }
+        busy = false;
+        releaseCondition.notify_all();
+    }
+}
+
+}  // namespace plb
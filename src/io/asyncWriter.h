@@ -0,0 +1,113 @@
+/* This file is part of the Palabos library.
+ *
+ * Copyright (C) 2011-2015 FlowKit Sarl
+ * Route d'Oron 2
+ * 1010 Lausanne, Switzerland
+ * E-mail contact: contact@flowkit.com
+ *
+ * The most recent release of Palabos can be downloaded at 
+ * <http://www.palabos.org/>
+ *
+ * The library Palabos is free software: you can redistribute it and/or
+ * modify it under the terms of the GNU Affero General Public License as
+ * published by the Free Software Foundation, either version 3 of the
+ * License, or (at your option) any later version.
+ *
+ * The library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+/** \file
+ * Background writer with a bounded pool of staging buffers -- header file.
+ */
+
+#ifndef ASYNC_WRITER_H
+#define ASYNC_WRITER_H
+
+#include "core/globalDefs.h"
+#include "core/serializer.h"
+#include <vector>
+#include <deque>
+#include <functional>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <exception>
+
+namespace plb {
+
+/// Gather the data of a serializer into a contiguous buffer on the main processor.
+/** This is a collective operation. On the other processors, the buffer is left empty.
+ *  The capacity of the buffer is kept, so that a recycled buffer is not re-allocated.
+ */
+void serializerToBuffer(DataSerializer const* serializer, std::vector<char>& buffer);
+
+/// Execute file-output jobs on a background thread, while the simulation goes on.
+/** A job is handed over with the data it writes, which is copied beforehand into
+ *  a staging buffer obtained from acquireBuffer(). The number of these buffers is
+ *  fixed: when all of them are waiting to be written, acquireBuffer() blocks until
+ *  the writer thread releases one. This bounds the memory used by the frames in
+ *  flight, and slows the simulation down to the speed of the file system if needed.
+ *
+ *  Only the main processor, which does the file I/O, starts a writer thread. The
+ *  other processors execute the jobs right away, so that the state of the writers
+ *  is the same on all processors. Jobs are executed in the order of submission,
+ *  and must not use MPI communication nor the profiler, which are not thread-safe.
+ */
+class AsyncWriter {
+public:
+    typedef std::function<void(std::vector<char> const&)> Job;
+public:
+    explicit AsyncWriter(plint numBuffers_=2);
+    /// Write all pending jobs, then stop the writer thread.
+    ~AsyncWriter();
+    /// Get a free staging buffer, waiting for one if necessary. The buffer must
+    ///   then be handed back with submit().
+    std::vector<char>& acquireBuffer();
+    /// Queue a job, which writes the data of a buffer obtained from acquireBuffer().
+    ///   The buffer returns to the pool once the job is done.
+    void submit(std::vector<char>& buffer, Job const& job);
+    /// Queue a job which needs no data, for example to open or close a file.
+    void submit(Job const& job);
+    /// Return once all queued jobs are done. If a job threw an exception, the
+    ///   first one is re-thrown here (or by the next call to submit()).
+    void flush();
+    plint getNumBuffers() const {
+        return numBuffers;
+    }
+    bool isThreaded() const {
+        return threaded;
+    }
+private:
+    AsyncWriter(AsyncWriter const& rhs);
+    AsyncWriter& operator=(AsyncWriter const& rhs);
+    void writerLoop();
+    void rethrow();
+private:
+    struct Task {
+        std::vector<char>* buffer;
+        Job job;
+    };
+    plint numBuffers;
+    bool threaded;
+    std::vector<std::vector<char>*> buffers;
+    std::vector<std::vector<char>*> freeBuffers;
+    std::vector<char> emptyBuffer;
+    std::deque<Task> tasks;
+    std::thread writer;
+    std::mutex mutex;
+    std::condition_variable taskCondition;
+    std::condition_variable releaseCondition;
+    bool busy;
+    bool shutdown;
+    std::exception_ptr firstException;
+};
+
+}  // namespace plb
+
+#endif  // ASYNC_WRITER_H
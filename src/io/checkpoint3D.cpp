@@ -0,0 +1,493 @@
+/* This file is part of the Palabos library.
+ *
+ * Copyright (C) 2011-2015 FlowKit Sarl
+ * Route d'Oron 2
+ * 1010 Lausanne, Switzerland
+ * E-mail contact: contact@flowkit.com
+ *
+ * The most recent release of Palabos can be downloaded at 
+ * <http://www.palabos.org/>
+ *
+ * The library Palabos is free software: you can redistribute it and/or
+ * modify it under the terms of the GNU Affero General Public License as
+ * published by the Free Software Foundation, either version 3 of the
+ * License, or (at your option) any later version.
+ *
+ * The library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+/** \file
+ * Collective checkpoint/restart of multi-blocks and global state in a single file -- implementation file.
+ */
+
+#include "io/checkpoint3D.h"
+#include "io/multiBlockWriter3D.h"
+#include "io/multiBlockReader3D.h"
+#include "parallelism/mpiManager.h"
+#include "core/runTimeDiagnostics.h"
+#include "core/multiBlockIdentifiers3D.h"
+#include "core/util.h"
+#include "core/plbProfiler.h"
+#include "multiBlock/nonLocalTransfer3D.h"
+#include "multiBlock/multiBlockManagement3D.h"
+#include "multiBlock/threadAttribution.h"
+#include <cstdio>
+#include <memory>
+
+namespace plb {
+
+namespace parallelIO {
+
+namespace {
+    /// The file starts with the magic string, the position and size of the index,
+    ///   and the number of entries. The last character of the magic string is the
+    ///   version of the format; version 2 stores the dynamics as a DynamicsMap3D.
+    const char checkpointMagic[8] = {'P','L','B','C','K','P','T','2'};
+    const pluint checkpointHeaderSize = 8 + 3*sizeof(pluint);
+    enum EntryKind { multiBlockEntry=0, recordEntry=1 };
+    /// MPI-IO takes the size of the data as an int.
+    const pluint maxChunkSize = 1000000000; // 1 GB.
+}
+
+/* *************** Struct CheckpointFile ******************************** */
+
+struct CheckpointFile {
+#ifdef PLB_MPI_PARALLEL
+    MPI_File handle;
+#else
+    FILE* handle;
+#endif
+};
+
+namespace {
+
+CheckpointFile* openCheckpoint(std::string const& name, bool writeMode)
+{
+    CheckpointFile* file = new CheckpointFile;
+    bool ioError = false;
+#ifdef PLB_MPI_PARALLEL
+    std::vector<char> nameBuf(name.begin(), name.end());
+    nameBuf.push_back('\0');
+    int mode = writeMode ? (MPI_MODE_CREATE|MPI_MODE_WRONLY) : MPI_MODE_RDONLY;
+    int err = MPI_File_open( global::mpi().getGlobalCommunicator(), &nameBuf[0],
+                             mode, MPI_INFO_NULL, &file->handle );
+    ioError = err != MPI_SUCCESS;
+    if (!ioError && writeMode) {
+        // Truncate an existing file.
+        ioError = MPI_File_set_size(file->handle, 0) != MPI_SUCCESS;
+    }
+#else
+    file->handle = fopen(name.c_str(), writeMode ? "wb" : "rb");
+    ioError = !file->handle;
+#endif
+    if (ioError) {
+        delete file;
+    }
+    plbIOError(ioError, "Could not open checkpoint file "+name);
+    return file;
+}
+
+void closeCheckpoint(CheckpointFile* file)
+{
+#ifdef PLB_MPI_PARALLEL
+    MPI_File_close(&file->handle);
+#else
+    fclose(file->handle);
+#endif
+    delete file;
+}
+
+/// Independent write of size bytes at the given position; returns false on error.
+bool writeAt(CheckpointFile* file, pluint offset, char const* data, pluint size)
+{
+    while (size>0) {
+        pluint chunk = std::min(size, maxChunkSize);
+#ifdef PLB_MPI_PARALLEL
+        MPI_Status status;
+        if ( MPI_File_write_at(file->handle, (MPI_Offset)offset, const_cast<char*>(data),
+                               (int)chunk, MPI_CHAR, &status) != MPI_SUCCESS )
+        {
+            return false;
+        }
+#else
+#if defined PLB_MAC_OS_X || defined PLB_BSD
+        if (fseek(file->handle, (long int)offset, SEEK_SET) != 0) return false;
+#else
+        if (fseeko64(file->handle, offset, SEEK_SET) != 0) return false;
+#endif
+        if (fwrite(data, 1, chunk, file->handle) != chunk) return false;
+#endif
+        offset += chunk;
+        data += chunk;
+        size -= chunk;
+    }
+    return true;
+}
+
+/// Independent read of size bytes at the given position; returns false on error.
+bool readAt(CheckpointFile* file, pluint offset, char* data, pluint size)
+{
+    while (size>0) {
+        pluint chunk = std::min(size, maxChunkSize);
+#ifdef PLB_MPI_PARALLEL
+        MPI_Status status;
+        if ( MPI_File_read_at(file->handle, (MPI_Offset)offset, data,
+                              (int)chunk, MPI_CHAR, &status) != MPI_SUCCESS )
+        {
+            return false;
+        }
+        int count = 0;
+        MPI_Get_count(&status, MPI_CHAR, &count);
+        if ((pluint)count != chunk) return false;
+#else
+#if defined PLB_MAC_OS_X || defined PLB_BSD
+        if (fseek(file->handle, (long int)offset, SEEK_SET) != 0) return false;
+#else
+        if (fseeko64(file->handle, offset, SEEK_SET) != 0) return false;
+#endif
+        if (fread(data, 1, chunk, file->handle) != chunk) return false;
+#endif
+        offset += chunk;
+        data += chunk;
+        size -= chunk;
+    }
+    return true;
+}
+
+/// Broadcast a buffer from the main processor, including its size.
+void bCastBuffer(std::vector<char>& data)
+{
+    plint size = (plint)data.size();
+    global::mpi().bCast(&size, 1);
+    data.resize(size);
+    if (size>0) {
+        global::mpi().bCast(&data[0], (int)size);
+    }
+}
+
+}  // namespace
+
+
+/* *************** Class CheckpointWriter ******************************** */
+
+CheckpointWriter::CheckpointWriter(FileName fName_)
+    : fName(fName_),
+      file(0),
+      pos(checkpointHeaderSize),
+      numEntries(0)
+{
+    fName.defaultPath(global::directories().getOutputDir());
+    fName.defaultExt("chk");
+    tmpName = fName.get()+".tmp";
+    file = openCheckpoint(tmpName, true);
+}
+
+CheckpointWriter::~CheckpointWriter()
+{
+    // Closing an MPI file is collective, and the destructor may run during the stack
+    //   unwinding of a single process.
+    if (file) {
+#ifdef PLB_MPI_PARALLEL
+        delete file;
+#else
+        closeCheckpoint(file);
+#endif
+    }
+}
+
+void CheckpointWriter::close()
+{
+    PLB_PRECONDITION( file );
+    bool ioError = false;
+    if (global::mpi().isMainProcessor()) {
+        std::vector<char> const& indexData = index.getData();
+        CheckpointRecord header;
+        pluint indexOffset = pos;
+        pluint indexSize = indexData.size();
+        plint entries = numEntries;
+        header.add(indexOffset);
+        header.add(indexSize);
+        header.add(entries);
+        std::vector<char> headerData(checkpointMagic, checkpointMagic+8);
+        headerData.insert(headerData.end(), header.getData().begin(), header.getData().end());
+        ioError = !writeAt(file, 0, &headerData[0], headerData.size()) ||
+                  (indexSize>0 && !writeAt(file, indexOffset, &indexData[0], indexSize));
+    }
+    closeCheckpoint(file);
+    file = 0;
+    if (global::mpi().isMainProcessor() && !ioError) {
+        ioError = std::rename(tmpName.c_str(), fName.get().c_str()) != 0;
+    }
+    plbIOError(ioError, "Unsuccessful writing of checkpoint file "+fName.get());
+}
+
+void CheckpointWriter::addEntry(std::string const& name, int kind, pluint size, CheckpointRecord const& info)
+{
+    index.add(name);
+    index.add(kind);
+    index.add(pos);
+    index.add(size);
+    index.add(info.getData());
+    ++numEntries;
+    pos += size;
+}
+
+void CheckpointWriter::write(std::string const& name, MultiBlock3D& multiBlock, bool dynamicContent)
+{
+    PLB_PRECONDITION( file );
+    global::profiler().start("io");
+    MultiBlockManagement3D const& management = multiBlock.getMultiBlockManagement();
+    std::vector<plint> offset;
+    std::vector<plint> myBlockIds;
+    std::vector<std::vector<char> > data;
+    dumpData(multiBlock, dynamicContent, offset, myBlockIds, data);
+
+    // dumpData() numbers the atomic-blocks contiguously, in the order of their ids, and
+    //   offset[i] is the end of the data of block i. The components of the info record
+    //   below are stored in the same order.
+    PLB_ASSERT( offset.size() == management.getSparseBlockStructure().getBulks().size() );
+    bool ioError = false;
+    for (pluint iBlock=0; iBlock<myBlockIds.size() && !ioError; ++iBlock) {
+        plint blockId = myBlockIds[iBlock];
+        PLB_ASSERT( blockId>=0 && blockId<(plint)offset.size() );
+        pluint blockOffset = blockId==0 ? 0 : offset[blockId-1];
+        if (!data[iBlock].empty()) {
+            ioError = !writeAt(file, pos+blockOffset, &data[iBlock][0], data[iBlock].size());
+        }
+    }
+    plbIOError(ioError, "Unsuccessful writing into checkpoint file "+tmpName);
+
+    // Everything which is needed to rebuild the block structure on another number of processes.
+    std::map<plint,Box3D> const& bulks = management.getSparseBlockStructure().getBulks();
+    std::vector<std::string> typeInfo = multiBlock.getTypeInfo();
+    PLB_ASSERT( !typeInfo.empty() );
+    CheckpointRecord info;
+    info.add(multiBlock.getBoundingBox());
+    info.add(management.getEnvelopeWidth());
+    info.add(management.getRefinementLevel());
+    info.add(typeInfo[0]);
+    info.add(typeInfo.size()>1 ? typeInfo[1] : std::string("NA"));
+    info.add(multiBlock.getBlockName());
+    info.add((int)dynamicContent);
+    std::vector<Box3D> components;
+    for (std::map<plint,Box3D>::const_iterator it = bulks.begin(); it != bulks.end(); ++it) {
+        components.push_back(it->second);
+    }
+    info.add(components);
+    info.add(offset);
+    std::map<std::string,int> dynamicsDict;
+    if (dynamicContent) {
+        multiBlock.getDynamicsDict(multiBlock.getBoundingBox(), dynamicsDict);
+    }
+    info.add((pluint)dynamicsDict.size());
+    for (std::map<std::string,int>::const_iterator it = dynamicsDict.begin(); it != dynamicsDict.end(); ++it) {
+        info.add(it->first);
+        info.add(it->second);
+    }
+    addEntry(name, multiBlockEntry, offset.empty() ? 0 : offset.back(), info);
+    global::profiler().stop("io");
+}
+
+void CheckpointWriter::write(std::string const& name, CheckpointRecord const& record)
+{
+    PLB_PRECONDITION( file );
+    std::vector<char> const& data = record.getData();
+    plint size = (plint)data.size();
+    global::mpi().bCast(&size, 1);
+    bool ioError = false;
+    if (global::mpi().isMainProcessor() && size>0) {
+        ioError = !writeAt(file, pos, &data[0], size);
+    }
+    plbIOError(ioError, "Unsuccessful writing into checkpoint file "+tmpName);
+    addEntry(name, recordEntry, size, CheckpointRecord());
+}
+
+
+/* *************** Class CheckpointReader ******************************** */
+
+CheckpointReader::CheckpointReader(FileName fName_)
+    : fName(fName_),
+      file(0)
+{
+    fName.defaultPath(global::directories().getInputDir());
+    fName.defaultExt("chk");
+    file = openCheckpoint(fName.get(), false);
+
+    bool ioError = false;
+    std::vector<char> indexData;
+    plint numEntries = 0;
+    if (global::mpi().isMainProcessor()) {
+        std::vector<char> headerData(checkpointHeaderSize);
+        ioError = !readAt(file, 0, &headerData[0], checkpointHeaderSize) ||
+                  !std::equal(checkpointMagic, checkpointMagic+8, headerData.begin());
+        if (!ioError) {
+            CheckpointRecord header(std::vector<char>(headerData.begin()+8, headerData.end()));
+            pluint indexOffset, indexSize;
+            header.get(indexOffset);
+            header.get(indexSize);
+            header.get(numEntries);
+            indexData.resize(indexSize);
+            ioError = indexSize>0 && !readAt(file, indexOffset, &indexData[0], indexSize);
+        }
+    }
+    if (ioError) {
+        closeCheckpoint(file);
+    }
+    plbIOError(ioError, "File "+fName.get()+" is not a valid checkpoint");
+    bCastBuffer(indexData);
+    global::mpi().bCast(&numEntries, 1);
+
+    CheckpointRecord index(indexData);
+    for (plint iEntry=0; iEntry<numEntries; ++iEntry) {
+        std::string name;
+        Entry entry;
+        index.get(name);
+        index.get(entry.kind);
+        index.get(entry.offset);
+        index.get(entry.size);
+        index.get(entry.info);
+        entries[name] = entry;
+    }
+}
+
+CheckpointReader::~CheckpointReader()
+{
+    closeCheckpoint(file);
+}
+
+bool CheckpointReader::contains(std::string const& name) const
+{
+    return entries.find(name) != entries.end();
+}
+
+CheckpointReader::Entry const& CheckpointReader::getEntry(std::string const& name, int kind) const
+{
+    std::map<std::string,Entry>::const_iterator it = entries.find(name);
+    if (it==entries.end() || it->second.kind != kind) {
+        plbIOError("No entry "+name+" of the right type in checkpoint file "+fName.get());
+    }
+    return it->second;
+}
+
+void CheckpointReader::read(std::string const& name, MultiBlock3D& intoBlock)
+{
+    std::unique_ptr<MultiBlock3D> savedBlock(read(name));
+    global::profiler().start("io");
+    Entry const& entry = getEntry(name, multiBlockEntry);
+    CheckpointRecord info(entry.info);
+    Box3D boundingBox;
+    plint envelopeWidth, gridLevel;
+    std::string dataType, descriptor, family;
+    int dynamicContent;
+    info.get(boundingBox);
+    info.get(envelopeWidth);
+    info.get(gridLevel);
+    info.get(dataType);
+    info.get(descriptor);
+    info.get(family);
+    info.get(dynamicContent);
+    modif::ModifT typeOfVariables = dynamicContent ? modif::dataStructure : modif::staticVariables;
+    copy_generic( *savedBlock, savedBlock->getBoundingBox(),
+                  intoBlock, intoBlock.getBoundingBox(), typeOfVariables );
+    global::profiler().stop("io");
+}
+
+std::unique_ptr<MultiBlock3D> CheckpointReader::read(std::string const& name)
+{
+    global::profiler().start("io");
+    Entry const& entry = getEntry(name, multiBlockEntry);
+    CheckpointRecord info(entry.info);
+    Box3D boundingBox;
+    plint envelopeWidth, gridLevel;
+    std::string dataType, descriptor, family;
+    int dynamicContent;
+    std::vector<Box3D> components;
+    std::vector<plint> offset;
+    info.get(boundingBox);
+    info.get(envelopeWidth);
+    info.get(gridLevel);
+    info.get(dataType);
+    info.get(descriptor);
+    info.get(family);
+    info.get(dynamicContent);
+    info.get(components);
+    info.get(offset);
+    pluint numDynamics;
+    info.get(numDynamics);
+    std::map<int,std::string> foreignIds;
+    for (pluint iDynamics=0; iDynamics<numDynamics; ++iDynamics) {
+        std::string dynamicsName;
+        int dynamicsId;
+        info.get(dynamicsName);
+        info.get(dynamicsId);
+        foreignIds[dynamicsId] = dynamicsName;
+    }
+
+    // The blocks are numbered contiguously, as in CheckpointWriter::write().
+    plbIOError(offset.size() != components.size(), "Inconsistent entry "+name+" in checkpoint file "+fName.get());
+
+    // The saved atomic-blocks are distributed evenly over the present processes, as in load3D().
+    SparseBlockStructure3D blockStructure(boundingBox);
+    for (plint iComponent=0; iComponent<(plint)components.size(); ++iComponent) {
+        blockStructure.addBlock(components[iComponent], iComponent);
+    }
+    ExplicitThreadAttribution* threadAttribution = new ExplicitThreadAttribution;
+    std::vector<plint> myBlockIds;
+    plint numBlocks = components.size();
+    if (numBlocks>0) {
+        std::vector<std::pair<plint,plint> > blockRanges;
+        plint numRanges = std::min(numBlocks, (plint)global::mpi().getSize());
+        util::linearRepartition(0, numBlocks-1, numRanges, blockRanges);
+        for (plint iThread=0; iThread<(plint)blockRanges.size(); ++iThread) {
+            for (plint iBlock=blockRanges[iThread].first; iBlock<=blockRanges[iThread].second; ++iBlock) {
+                threadAttribution->addBlock(iBlock, iThread);
+                if (iThread==global::mpi().getRank()) {
+                    myBlockIds.push_back(iBlock);
+                }
+            }
+        }
+    }
+    MultiBlockManagement3D management(blockStructure, threadAttribution, envelopeWidth, gridLevel);
+    std::unique_ptr<MultiBlock3D> savedBlock (
+            meta::multiBlockRegistration3D().generate(dataType, descriptor, family, management) );
+    PLB_ASSERT( savedBlock.get() );
+
+    std::vector<std::vector<char> > data(myBlockIds.size());
+    bool ioError = false;
+    for (pluint iBlock=0; iBlock<myBlockIds.size() && !ioError; ++iBlock) {
+        plint blockId = myBlockIds[iBlock];
+        pluint blockOffset = blockId==0 ? 0 : offset[blockId-1];
+        data[iBlock].resize(offset[blockId]-blockOffset);
+        if (!data[iBlock].empty()) {
+            ioError = !readAt(file, entry.offset+blockOffset, &data[iBlock][0], data[iBlock].size());
+        }
+    }
+    plbIOError(ioError, "Unsuccessful reading from checkpoint file "+fName.get());
+
+    dumpRestoreData(*savedBlock, dynamicContent, myBlockIds, data, foreignIds);
+    global::profiler().stop("io");
+    return savedBlock;
+}
+
+void CheckpointReader::read(std::string const& name, CheckpointRecord& record)
+{
+    Entry const& entry = getEntry(name, recordEntry);
+    std::vector<char> data(entry.size);
+    bool ioError = false;
+    if (global::mpi().isMainProcessor() && entry.size>0) {
+        ioError = !readAt(file, entry.offset, &data[0], entry.size);
+    }
+    plbIOError(ioError, "Unsuccessful reading from checkpoint file "+fName.get());
+    bCastBuffer(data);
+    record = CheckpointRecord(data);
+}
+
+}  // namespace parallelIO
+
+}  // namespace plb
@@ -0,0 +1,171 @@
+/* This file is part of the Palabos library.
+ *
+ * Copyright (C) 2011-2015 FlowKit Sarl
+ * Route d'Oron 2
+ * 1010 Lausanne, Switzerland
+ * E-mail contact: contact@flowkit.com
+ *
+ * The most recent release of Palabos can be downloaded at 
+ * <http://www.palabos.org/>
+ *
+ * The library Palabos is free software: you can redistribute it and/or
+ * modify it under the terms of the GNU Affero General Public License as
+ * published by the Free Software Foundation, either version 3 of the
+ * License, or (at your option) any later version.
+ *
+ * The library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+/** \file
+ * Collective checkpoint/restart of multi-blocks and global state in a single file -- header file.
+ */
+#ifndef CHECKPOINT_3D_H
+#define CHECKPOINT_3D_H
+
+#include "core/globalDefs.h"
+#include "core/plbDebug.h"
+#include "multiBlock/multiBlock3D.h"
+#include "io/plbFiles.h"
+#include <string>
+#include <vector>
+#include <map>
+#include <memory>
+#include <cstring>
+
+namespace plb {
+
+namespace parallelIO {
+
+/// Sequence of plain values, stored as one record of a checkpoint.
+/** Values are read back with get() in the order in which they were added.
+ *  Only trivially copyable types and strings can be stored.
+ */
+class CheckpointRecord {
+public:
+    CheckpointRecord()
+        : pos(0)
+    { }
+    CheckpointRecord(std::vector<char> const& data_)
+        : data(data_), pos(0)
+    { }
+    template<typename T> void add(T const& value) {
+        char const* begin = (char const*)&value;
+        data.insert(data.end(), begin, begin+sizeof(T));
+    }
+    template<typename T> void add(std::vector<T> const& values) {
+        add((pluint)values.size());
+        if (!values.empty()) {
+            char const* begin = (char const*)&values[0];
+            data.insert(data.end(), begin, begin+values.size()*sizeof(T));
+        }
+    }
+    void add(std::string const& value) {
+        add((pluint)value.size());
+        data.insert(data.end(), value.begin(), value.end());
+    }
+    template<typename T> void get(T& value) {
+        PLB_PRECONDITION( pos+sizeof(T) <= data.size() );
+        std::memcpy((void*)&value, &data[pos], sizeof(T));
+        pos += sizeof(T);
+    }
+    template<typename T> void get(std::vector<T>& values) {
+        pluint size;
+        get(size);
+        PLB_PRECONDITION( pos+size*sizeof(T) <= data.size() );
+        values.resize(size);
+        if (size>0) {
+            std::memcpy((void*)&values[0], &data[pos], size*sizeof(T));
+        }
+        pos += size*sizeof(T);
+    }
+    void get(std::string& value) {
+        pluint size;
+        get(size);
+        PLB_PRECONDITION( pos+size <= data.size() );
+        value.assign(data.begin()+pos, data.begin()+pos+size);
+        pos += size;
+    }
+    std::vector<char> const& getData() const { return data; }
+private:
+    std::vector<char> data;
+    pluint pos;
+};
+
+struct CheckpointFile;
+
+/// Write multi-blocks and global records collectively into a single file.
+/** The file starts with a fixed-size header which points to an index at the
+ *  end of the file. The index holds the name, position and size of each entry,
+ *  and the block structure of each multi-block, so that the checkpoint can be
+ *  read back on any number of processes. The atomic-blocks are written by the
+ *  processes which own them, with MPI-IO in parallel programs. The file is
+ *  written under a temporary name and renamed by close(), so that a crash
+ *  during the checkpoint leaves the previous one intact. All methods except
+ *  the destructor are collective.
+ */
+class CheckpointWriter {
+public:
+    CheckpointWriter(FileName fName_);
+    /// Abandon the temporary file if close() was not called. Not collective:
+    ///   in parallel programs, the file handle is then left open.
+    ~CheckpointWriter();
+    /// Write the index, close the file and rename it to its final name.
+    ///   Throws a PlbIOException on all processes if any of them failed.
+    void close();
+    /// Write the content of a multi-block, with its dynamics objects if dynamicContent is true.
+    void write(std::string const& name, MultiBlock3D& multiBlock, bool dynamicContent=false);
+    /// Write a record; only the value on the main processor is used.
+    void write(std::string const& name, CheckpointRecord const& record);
+private:
+    void addEntry(std::string const& name, int kind, pluint size, CheckpointRecord const& info);
+    CheckpointWriter(CheckpointWriter const& rhs);
+    CheckpointWriter& operator=(CheckpointWriter const& rhs);
+private:
+    FileName fName;
+    std::string tmpName;
+    CheckpointFile* file;
+    pluint pos;
+    CheckpointRecord index;
+    plint numEntries;
+};
+
+/// Read a checkpoint written by CheckpointWriter. All methods are collective.
+class CheckpointReader {
+public:
+    CheckpointReader(FileName fName_);
+    ~CheckpointReader();
+    bool contains(std::string const& name) const;
+    /// Read a multi-block into intoBlock, which may have a different parallel
+    ///   distribution, or be distributed over a different number of processes.
+    void read(std::string const& name, MultiBlock3D& intoBlock);
+    /// Read a multi-block with the block structure under which it was saved,
+    ///   its blocks distributed evenly over the present processes.
+    std::unique_ptr<MultiBlock3D> read(std::string const& name);
+    /// Read a record, and broadcast it to all processes.
+    void read(std::string const& name, CheckpointRecord& record);
+private:
+    struct Entry {
+        int kind;
+        pluint offset, size;
+        std::vector<char> info;
+    };
+    Entry const& getEntry(std::string const& name, int kind) const;
+    CheckpointReader(CheckpointReader const& rhs);
+    CheckpointReader& operator=(CheckpointReader const& rhs);
+private:
+    FileName fName;
+    CheckpointFile* file;
+    std::map<std::string,Entry> entries;
+};
+
+}  // namespace parallelIO
+
+}  // namespace plb
+
+#endif  // CHECKPOINT_3D_H
@@ -28,6 +28,7 @@
 
 #include "io/base64.h"
 #include "io/serializerIO.h"
+#include "io/asyncWriter.h"
 #include "io/serializerIO_2D.h"
 #include "io/vtkDataOutput.h"
 #include "io/vtkStructuredDataOutput.h"
@@ -28,6 +28,7 @@
 
 #include "io/base64.h"
 #include "io/serializerIO.h"
+#include "io/asyncWriter.h"
 #include "io/serializerIO_3D.h"
 #include "io/vtkDataOutput.h"
 #include "io/vtkStructuredDataOutput.h"
@@ -38,6 +39,7 @@
 #include "io/plbFiles.h"
 #include "io/multiBlockReader3D.h"
 #include "io/multiBlockWriter3D.h"
+#include "io/checkpoint3D.h"
 #include "io/utilIO_3D.h"
 #include "io/transientStatistics3D.h"
 
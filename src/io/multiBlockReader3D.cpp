@@ -37,6 +37,7 @@
 #include "core/multiBlockIdentifiers3D.h"
 #include "core/processorIdentifiers3D.h"
 #include "multiBlock/nonLocalTransfer3D.h"
+#include "atomicBlock/dynamicsMap3D.h"
 #include "multiBlock/multiBlockOperations3D.h"
 #include "io/plbFiles.h"
 #include <numeric>
@@ -157,6 +158,20 @@ void readXmlSpec (
     }
     reader["Block3D"]["General"]["cellDim"].read(cellDim);
     reader["Block3D"]["General"]["dynamicContent"].read(dynamicContent);
+    // The dynamics of a lattice have changed layout; files written before
+    //   the format was recorded have version 1.
+    if (dynamicContent && family=="BlockLattice3D") {
+        int dynamicsFormat = 1;
+        try {
+            reader["Block3D"]["General"]["dynamicsFormat"].read(dynamicsFormat);
+        }
+        catch(PlbIOException const&) { }
+        if (dynamicsFormat != dynamicsFileFormat) {
+            plbIOError(std::string("The dynamics in ")+fName.get()+
+                       std::string(" are stored in an unsupported format (version ")+
+                       util::val2str(dynamicsFormat)+std::string(")."));
+        }
+    }
     reader["Block3D"]["Structure"]["BoundingBox"].read<plint,6>(boundingBox_array);
     boundingBox.from_plbArray(boundingBox_array);
     reader["Block3D"]["Structure"]["NumComponents"].read(numComponents);
@@ -38,6 +38,7 @@
 #include "core/multiBlockIdentifiers3D.h"
 #include "core/processorIdentifiers3D.h"
 #include "multiBlock/nonLocalTransfer3D.h"
+#include "atomicBlock/dynamicsMap3D.h"
 #include "multiBlock/multiBlockOperations3D.h"
 #include "io/plbFiles.h"
 #include <numeric>
@@ -70,6 +71,9 @@ void writeXmlSpec( MultiBlock3D& multiBlock, FileName fName,
     }
     xmlMultiBlock["General"]["cellDim"].set(multiBlock.getCellDim());
     xmlMultiBlock["General"]["dynamicContent"].set(dynamicContent);
+    if (dynamicContent) {
+        xmlMultiBlock["General"]["dynamicsFormat"].set(dynamicsFileFormat);
+    }
     xmlMultiBlock["General"]["globalId"].set(multiBlock.getId());
 
     Array<plint,6> boundingBox = multiBlock.getBoundingBox().to_plbArray();
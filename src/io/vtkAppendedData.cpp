@@ -0,0 +1,218 @@
+/* This file is part of the Palabos library.
+ *
+ * Copyright (C) 2011-2015 FlowKit Sarl
+ * Route d'Oron 2
+ * 1010 Lausanne, Switzerland
+ * E-mail contact: contact@flowkit.com
+ *
+ * The most recent release of Palabos can be downloaded at 
+ * <http://www.palabos.org/>
+ *
+ * The library Palabos is free software: you can redistribute it and/or
+ * modify it under the terms of the GNU Affero General Public License as
+ * published by the Free Software Foundation, either version 3 of the
+ * License, or (at your option) any later version.
+ *
+ * The library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+/** \file
+ * Appended (raw or zlib-compressed) data section of vtk xml files -- implementation file.
+ */
+
+#include "io/vtkAppendedData.h"
+#include "parallelism/mpiManager.h"
+#include "core/plbDebug.h"
+#include "core/runTimeDiagnostics.h"
+#include <algorithm>
+#include <cstdio>
+#include <cstdint>
+#ifdef PLB_USE_ZLIB
+#include <zlib.h>
+#endif
+
+namespace plb {
+
+namespace {
+    /// Uncompressed size of the blocks in zlib mode (same default as VTK).
+    const pluint vtkCompressionBlockSize = 32768;
+    /// Size of the chunks used to copy the scratch file into the vtk file.
+    const pluint vtkCopyChunkSize = 1<<20;
+
+    void writeHeaderEntry(std::ostream& ostr, pluint value) {
+        std::uint64_t entry = value;
+        ostr.write((char const*)&entry, sizeof(entry));
+    }
+}
+
+/* *************** Class VtkAppendedData ******************************** */
+
+VtkAppendedData::VtkAppendedData(std::string const& fileName, vtkEncoding::EncodingT encoding_)
+    : encoding(encoding_),
+      scratchName(fileName+".appended"),
+      offset(0),
+      arrayOpen(false)
+{
+    PLB_PRECONDITION( encoding != vtkEncoding::base64 );
+#ifndef PLB_USE_ZLIB
+    // Palabos was compiled without zlib: fall back to uncompressed data.
+    if (encoding==vtkEncoding::zlib) {
+        encoding = vtkEncoding::raw;
+    }
+#endif
+    scratch.open(scratchName.c_str(), std::ios::in|std::ios::out|std::ios::binary|std::ios::trunc);
+    if (!scratch) {
+        plbIOError("could not open file " + scratchName);
+    }
+}
+
+VtkAppendedData::~VtkAppendedData() {
+    scratch.close();
+    std::remove(scratchName.c_str());
+}
+
+std::string VtkAppendedData::getFileAttributes() const {
+    std::string attributes = " header_type=\"UInt64\"";
+    if (encoding==vtkEncoding::zlib) {
+        attributes += " compressor=\"vtkZLibDataCompressor\"";
+    }
+    return attributes;
+}
+
+void VtkAppendedData::writeDataArrayTag(std::ostream& ostr, std::string const& typeName,
+                                        std::string const& name, plint nDim)
+{
+    ostr << "<DataArray type=\"" << typeName
+         << "\" Name=\"" << name
+         << "\" format=\"appended\" offset=\"" << offset;
+    if (nDim>1) {
+        ostr << "\" NumberOfComponents=\"" << nDim;
+    }
+    ostr << "\"/>\n";
+}
+
+void VtkAppendedData::startArray() {
+    PLB_PRECONDITION( !arrayOpen );
+    arrayOpen = true;
+    arrays.push_back(ArrayInfo());
+    arrays.back().rawSize = 0;
+}
+
+void VtkAppendedData::writeData(char const* data, pluint size) {
+    PLB_PRECONDITION( arrayOpen );
+    arrays.back().rawSize += size;
+    if (encoding==vtkEncoding::raw) {
+        scratch.write(data, size);
+        return;
+    }
+    // zlib: fill up the current block, and compress it once it is full.
+    while (size>0) {
+        pluint numCopy = std::min(size, vtkCompressionBlockSize-(pluint)block.size());
+        block.insert(block.end(), data, data+numCopy);
+        data += numCopy;
+        size -= numCopy;
+        if ((pluint)block.size()==vtkCompressionBlockSize) {
+            compressBlock();
+        }
+    }
+}
+
+void VtkAppendedData::compressBlock() {
+#ifdef PLB_USE_ZLIB
+    uLongf compressedSize = compressBound(block.size());
+    compressed.resize(compressedSize);
+    // The fastest compression level: the output step is limited by the CPU time.
+    int status = compress2((Bytef*)&compressed[0], &compressedSize,
+                           (Bytef const*)&block[0], block.size(), Z_BEST_SPEED);
+    if (status != Z_OK) {
+        plbIOError("zlib compression failed in file " + scratchName);
+    }
+    scratch.write(&compressed[0], compressedSize);
+    arrays.back().blockSizes.push_back(compressedSize);
+#endif
+    block.clear();
+}
+
+void VtkAppendedData::endArray() {
+    PLB_PRECONDITION( arrayOpen );
+    if (!block.empty()) {
+        compressBlock();
+    }
+    ArrayInfo const& info = arrays.back();
+    pluint numHeaderEntries = encoding==vtkEncoding::zlib ? 3+info.blockSizes.size() : 1;
+    pluint dataSize = info.rawSize;
+    if (encoding==vtkEncoding::zlib) {
+        dataSize = 0;
+        for (pluint iBlock=0; iBlock<info.blockSizes.size(); ++iBlock) {
+            dataSize += info.blockSizes[iBlock];
+        }
+    }
+    offset += numHeaderEntries*sizeof(std::uint64_t) + dataSize;
+    arrayOpen = false;
+}
+
+void VtkAppendedData::writeSection(std::ostream& ostr) {
+    PLB_PRECONDITION( !arrayOpen );
+    ostr << "<AppendedData encoding=\"raw\">\n_";
+    scratch.flush();
+    scratch.seekg(0);
+    std::vector<char> chunk(vtkCopyChunkSize);
+    for (pluint iArray=0; iArray<arrays.size(); ++iArray) {
+        ArrayInfo const& info = arrays[iArray];
+        pluint dataSize = info.rawSize;
+        if (encoding==vtkEncoding::zlib) {
+            // Compression header: number of blocks, block size, size of the last partial block,
+            //   and compressed size of each block.
+            writeHeaderEntry(ostr, info.blockSizes.size());
+            writeHeaderEntry(ostr, vtkCompressionBlockSize);
+            writeHeaderEntry(ostr, info.rawSize % vtkCompressionBlockSize);
+            dataSize = 0;
+            for (pluint iBlock=0; iBlock<info.blockSizes.size(); ++iBlock) {
+                writeHeaderEntry(ostr, info.blockSizes[iBlock]);
+                dataSize += info.blockSizes[iBlock];
+            }
+        }
+        else {
+            writeHeaderEntry(ostr, info.rawSize);
+        }
+        while (dataSize>0) {
+            pluint numRead = std::min(dataSize, vtkCopyChunkSize);
+            scratch.read(&chunk[0], numRead);
+            ostr.write(&chunk[0], numRead);
+            dataSize -= numRead;
+        }
+    }
+    ostr << "\n</AppendedData>\n";
+
+    arrays.clear();
+    offset = 0;
+    scratch.close();
+    scratch.open(scratchName.c_str(), std::ios::in|std::ios::out|std::ios::binary|std::ios::trunc);
+}
+
+
+/* *************** Class VtkAppendedWriter ******************************** */
+
+VtkAppendedWriter::VtkAppendedWriter(VtkAppendedData* data_)
+    : data(data_)
+{ }
+
+VtkAppendedWriter* VtkAppendedWriter::clone() const {
+    return new VtkAppendedWriter(*this);
+}
+
+void VtkAppendedWriter::writeHeader(pluint) {
+    // The length or compression header is written with the appended section.
+}
+
+void VtkAppendedWriter::writeData(char const* dataBuffer, pluint bufferSize) {
+    data->writeData(dataBuffer, bufferSize);
+}
+
+}  // namespace plb
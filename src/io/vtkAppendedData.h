@@ -0,0 +1,100 @@
+/* This file is part of the Palabos library.
+ *
+ * Copyright (C) 2011-2015 FlowKit Sarl
+ * Route d'Oron 2
+ * 1010 Lausanne, Switzerland
+ * E-mail contact: contact@flowkit.com
+ *
+ * The most recent release of Palabos can be downloaded at 
+ * <http://www.palabos.org/>
+ *
+ * The library Palabos is free software: you can redistribute it and/or
+ * modify it under the terms of the GNU Affero General Public License as
+ * published by the Free Software Foundation, either version 3 of the
+ * License, or (at your option) any later version.
+ *
+ * The library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+/** \file
+ * Appended (raw or zlib-compressed) data section of vtk xml files -- header file.
+ */
+
+#ifndef VTK_APPENDED_DATA_H
+#define VTK_APPENDED_DATA_H
+
+#include "core/globalDefs.h"
+#include "core/serializer.h"
+#include <string>
+#include <fstream>
+#include <vector>
+
+namespace plb {
+
+/// Binary content of the data arrays of a vtk xml file in appended format.
+/** The data of each array is streamed into a scratch file next to the vtk file
+ *  while the xml part of the file is written. writeSection() then writes the
+ *  <AppendedData> element, with the length header (raw) or compression header
+ *  (zlib) in front of each array. Headers are of type UInt64, so that a single
+ *  array can exceed 4 GB. Only the main processor may create and use this object.
+ */
+class VtkAppendedData {
+public:
+    VtkAppendedData(std::string const& fileName, vtkEncoding::EncodingT encoding_);
+    ~VtkAppendedData();
+    vtkEncoding::EncodingT getEncoding() const { return encoding; }
+    /// Attributes which must be added to the VTKFile element.
+    std::string getFileAttributes() const;
+    /// Write a DataArray element which refers to the next array of the appended section.
+    void writeDataArrayTag(std::ostream& ostr, std::string const& typeName, std::string const& name, plint nDim);
+    /// Start a new array of binary data. In time series, each frame is an array
+    ///   of its own, all of them following the offset of the DataArray element.
+    void startArray();
+    /// Append data to the current array.
+    void writeData(char const* data, pluint size);
+    /// Terminate the current array.
+    void endArray();
+    /// Write the <AppendedData> element, and clear the scratch file.
+    void writeSection(std::ostream& ostr);
+private:
+    void compressBlock();
+    VtkAppendedData(VtkAppendedData const& rhs);
+    VtkAppendedData& operator=(VtkAppendedData const& rhs);
+private:
+    /// Description of an array: size of the uncompressed data, and size of
+    ///   each compressed block (zlib only).
+    struct ArrayInfo {
+        pluint rawSize;
+        std::vector<pluint> blockSizes;
+    };
+    vtkEncoding::EncodingT encoding;
+    std::string scratchName;
+    std::fstream scratch;
+    std::vector<ArrayInfo> arrays;
+    pluint offset;
+    bool arrayOpen;
+    std::vector<char> block, compressed;
+};
+
+/// Sink which streams the output of serializerToSink() into the current array.
+/** The object pointer may be null on all but the main processor.
+ */
+class VtkAppendedWriter : public SerializedWriter {
+public:
+    VtkAppendedWriter(VtkAppendedData* data_);
+    virtual VtkAppendedWriter* clone() const;
+    virtual void writeHeader(pluint dataSize);
+    virtual void writeData(char const* dataBuffer, pluint bufferSize);
+private:
+    VtkAppendedData* data;
+};
+
+}  // namespace plb
+
+#endif  // VTK_APPENDED_DATA_H
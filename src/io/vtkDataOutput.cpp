@@ -38,10 +38,15 @@ namespace plb {
 
 VtkDataWriter3D::VtkDataWriter3D(std::string const& fileName_)
     : fileName(fileName_),
-      ostr(0)
+      ostr(0),
+      encoding(global::IOpolicy().getVtkEncoding()),
+      appended(0)
 {
     if (global::mpi().isMainProcessor()) {
-        ostr = new std::ofstream(fileName.c_str());
+        if (encoding != vtkEncoding::base64) {
+            appended = new VtkAppendedData(fileName, encoding);
+        }
+        ostr = new std::ofstream(fileName.c_str(), std::ios::binary);
         if (!(*ostr)) {
             std::cerr << "could not open file " <<  fileName << "\n";
             return;
@@ -50,6 +55,7 @@ VtkDataWriter3D::VtkDataWriter3D(std::string const& fileName_)
 }
 
 VtkDataWriter3D::~VtkDataWriter3D() {
+    delete appended;
     delete ostr;
 }
 
@@ -57,11 +63,17 @@ void VtkDataWriter3D::writeHeader(Box3D domain, Array<double,3> origin, double d
 {
     if (global::mpi().isMainProcessor()) {
         (*ostr) << "<?xml version=\"1.0\"?>\n";
+        // The header_type attribute of the appended formats requires version 1.0.
+        (*ostr) << "<VTKFile type=\"ImageData\" version=\"" << (appended ? "1.0" : "0.1") << "\"";
 #ifdef PLB_BIG_ENDIAN
-        (*ostr) << "<VTKFile type=\"ImageData\" version=\"0.1\" byte_order=\"BigEndian\">\n";
+        (*ostr) << " byte_order=\"BigEndian\"";
 #else
-        (*ostr) << "<VTKFile type=\"ImageData\" version=\"0.1\" byte_order=\"LittleEndian\">\n";
+        (*ostr) << " byte_order=\"LittleEndian\"";
 #endif
+        if (appended) {
+            (*ostr) << appended->getFileAttributes();
+        }
+        (*ostr) << ">\n";
         (*ostr) << "<ImageData WholeExtent=\""
                 << domain.x0 << " " << domain.x1 << " "
                 << domain.y0 << " " << domain.y1 << " "
@@ -93,6 +105,9 @@ void VtkDataWriter3D::endPiece() {
 void VtkDataWriter3D::writeFooter() {
     if (global::mpi().isMainProcessor()) {
         (*ostr) << "</ImageData>\n";
+        if (appended) {
+            appended->writeSection(*ostr);
+        }
         (*ostr) << "</VTKFile>\n";
     }
 }
@@ -38,6 +38,7 @@
 #include "atomicBlock/dataField3D.h"
 #include "multiBlock/multiDataField3D.h"
 #include "core/array.h"
+#include "io/vtkAppendedData.h"
 
 namespace plb {
 
@@ -58,6 +59,10 @@ private:
 private:
     std::string fileName;
     std::ofstream *ostr;
+    /// Encoding of the data arrays, chosen with global::IOpolicy().setVtkEncoding().
+    vtkEncoding::EncodingT encoding;
+    /// Appended data section (main processor only, if the encoding is not base64).
+    VtkAppendedData *appended;
 };
 
 template<typename T>
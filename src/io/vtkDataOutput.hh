@@ -72,6 +72,18 @@ template<typename T>
 void VtkDataWriter3D::writeDataField(DataSerializer const* serializer,
                                      std::string const& name, plint nDim)
 {
+    if (encoding != vtkEncoding::base64) {
+        // The data is streamed in binary form into the appended section.
+        if (global::mpi().isMainProcessor()) {
+            appended->writeDataArrayTag(*ostr, VtkTypeNames<T>::getName(), name, nDim);
+            appended->startArray();
+        }
+        serializerToSink(serializer, new VtkAppendedWriter(appended));
+        if (global::mpi().isMainProcessor()) {
+            appended->endArray();
+        }
+        return;
+    }
     if (global::mpi().isMainProcessor()) {
         (*ostr) << "<DataArray type=\"" << VtkTypeNames<T>::getName()
                 << "\" Name=\"" << name
@@ -41,10 +41,14 @@ namespace plb {
 ////////// class VtkStructuredWriter3D ////////////////////////////////////////
 
 VtkStructuredWriter3D::VtkStructuredWriter3D(std::string const& fileName_)
-    : fileName(fileName_), ostr(0)
+    : fileName(fileName_), ostr(0),
+      encoding(global::IOpolicy().getVtkEncoding()), appended(0)
 {
     if (global::mpi().isMainProcessor()) {
-        ostr = new std::ofstream(fileName.c_str());
+        if (encoding != vtkEncoding::base64) {
+            appended = new VtkAppendedData(fileName, encoding);
+        }
+        ostr = new std::ofstream(fileName.c_str(), std::ios::binary);
         if (!(*ostr)) {
             std::cerr << "could not open file " <<  fileName << "\n";
             return;
@@ -53,6 +57,7 @@ VtkStructuredWriter3D::VtkStructuredWriter3D(std::string const& fileName_)
 }
 
 VtkStructuredWriter3D::~VtkStructuredWriter3D() {
+    delete appended;
     delete ostr;
 }
 
@@ -60,11 +65,17 @@ void VtkStructuredWriter3D::writeHeader(Box3D domain)
 {
     if (global::mpi().isMainProcessor()) {
         (*ostr) << "<?xml version=\"1.0\"?>\n";
+        // The header_type attribute of the appended formats requires version 1.0.
+        (*ostr) << "<VTKFile type=\"StructuredGrid\" version=\"" << (appended ? "1.0" : "0.1") << "\"";
 #ifdef PLB_BIG_ENDIAN
-        (*ostr) << "<VTKFile type=\"StructuredGrid\" version=\"0.1\" byte_order=\"BigEndian\">\n";
+        (*ostr) << " byte_order=\"BigEndian\"";
 #else
-        (*ostr) << "<VTKFile type=\"StructuredGrid\" version=\"0.1\" byte_order=\"LittleEndian\">\n";
+        (*ostr) << " byte_order=\"LittleEndian\"";
 #endif
+        if (appended) {
+            (*ostr) << appended->getFileAttributes();
+        }
+        (*ostr) << ">\n";
         (*ostr) << "<StructuredGrid WholeExtent=\""
         << domain.x0 << " " << domain.x1 << " "
         << domain.y0 << " " << domain.y1 << " "
@@ -79,6 +90,27 @@ void VtkStructuredWriter3D::startPiece(Box3D domain, const Array<double,3> &orig
         << domain.y0 << " " << domain.y1 << " "
         << domain.z0 << " " << domain.z1 << "\">\n";
         (*ostr) << "<Points>\n";
+        if (appended) {
+            // The coordinates are by far the largest part of the file: write them in binary form as well.
+            appended->writeDataArrayTag(*ostr, "Float32", "Points", 3);
+            appended->startArray();
+            std::vector<float> row(3*(domain.x1-domain.x0+1));
+            for (plint i=domain.z0; i<=domain.z1; i++) {
+                for (plint j=domain.y0; j<=domain.y1; j++) {
+                    for (plint k=domain.x0; k<=domain.x1; k++) {
+                        float* point = &row[3*(k-domain.x0)];
+                        point[0] = k*deltaX-origin[2];
+                        point[1] = j*deltaX-origin[1];
+                        point[2] = i*deltaX-origin[0];
+                    }
+                    appended->writeData((char const*)&row[0], row.size()*sizeof(float));
+                }
+            }
+            appended->endArray();
+            (*ostr) << "</Points>\n";
+            (*ostr) << "<PointData>\n";
+            return;
+        }
         (*ostr) << "<DataArray  NumberOfComponents=\"3\" type=\"Float32\" format=\"ascii\">\n";
 // point loop
         plb::plint i, j, k;
@@ -104,6 +136,9 @@ void VtkStructuredWriter3D::endPiece() {
 void VtkStructuredWriter3D::writeFooter() {
     if (global::mpi().isMainProcessor()) {
         (*ostr) << "</StructuredGrid>\n";
+        if (appended) {
+            appended->writeSection(*ostr);
+        }
         (*ostr) << "</VTKFile>\n";
     }
 }
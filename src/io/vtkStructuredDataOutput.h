@@ -40,6 +40,7 @@
 #include "atomicBlock/dataField3D.h"
 #include "multiBlock/multiDataField3D.h"
 #include "core/array.h"
+#include "io/vtkAppendedData.h"
 
 namespace plb {
     
@@ -56,6 +57,11 @@ public:
 	template<typename T>
 	void writeDataField( DataSerializer const* serializer, std::string const& name, plint nDim, const bool& first = true,
 		const bool& last = false );
+	/// Write data which was gathered beforehand on the main processor, see serializerToBuffer().
+	///   This function does not communicate, and can be called from a background thread.
+	template<typename T>
+	void writeDataField( std::vector<char> const& data, std::string const& name, plint nDim, const bool& first = true,
+		const bool& last = false );
 
 private:
     VtkStructuredWriter3D(VtkStructuredWriter3D const& rhs);
@@ -63,6 +69,10 @@ private:
 private:
     std::string fileName;
     std::ofstream *ostr;
+    /// Encoding of the data arrays, chosen with global::IOpolicy().setVtkEncoding().
+    vtkEncoding::EncodingT encoding;
+    /// Appended data section (main processor only, if the encoding is not base64).
+    VtkAppendedData *appended;
 };
 
 template<typename T>
@@ -128,6 +138,13 @@ public:
 	void writeData(MultiTensorField3D<T,3>& tensorField, const std::string& tensorFieldName, const TConv& scalingFactor=(TConv)1,
 					const bool& first = true, const bool& last = false);
 
+	/// Write a field of size nx*ny*nz with nDim components of type TConv, which was gathered
+	///   beforehand with serializerToBuffer() in the ordering IndexOrdering::backward. This
+	///   function does not communicate, and can be called from a background thread.
+	template<typename TConv>
+	void writeData(plint nx_, plint ny_, plint nz_, std::vector<char> const& data, const std::string& fieldName,
+					plint nDim, const bool& first = true, const bool& last = false);
+
 private:
     void writeHeader(plint nx_, plint ny_, plint nz_);
     void writeFooter();
@@ -33,11 +33,14 @@
 #include "io/vtkStructuredDataOutput.h"
 #include "io/vtkDataOutput.hh"
 #include "io/serializerIO.h"
+#include "io/base64.h"
+#include "io/endianness.h"
 
 #include <iostream>
 #include <iomanip>
 #include <fstream>
 #include <sstream>
+#include <limits>
 
 namespace plb {
 
@@ -47,7 +50,29 @@ template<typename T>
 void VtkStructuredWriter3D::writeDataField(DataSerializer const* serializer,
                                     std::string const& name, plint nDim)
 {
-    if (global::mpi().isMainProcessor()) {
+    writeDataField<T>(serializer, name, nDim, true, true);
+}
+
+template<typename T>
+void VtkStructuredWriter3D::writeDataField(DataSerializer const* serializer, std::string const& name, plint nDim, const bool& first,
+const bool& last)
+{
+    if (encoding != vtkEncoding::base64) {
+        // The data is streamed in binary form into the appended section; in a time series, each
+        //   frame is an array of its own, which follows the previous one.
+        if (global::mpi().isMainProcessor()) {
+            if (first) {
+                appended->writeDataArrayTag(*ostr, VtkTypeNames<T>::getName(), name, nDim);
+            }
+            appended->startArray();
+        }
+        serializerToSink(serializer, new VtkAppendedWriter(appended));
+        if (global::mpi().isMainProcessor()) {
+            appended->endArray();
+        }
+        return;
+    }
+    if (global::mpi().isMainProcessor() && first) {
         (*ostr) << "<DataArray type=\"" << VtkTypeNames<T>::getName()
         << "\" Name=\"" << name
         << "\" format=\"binary\" encoding=\"base64";
@@ -56,29 +81,44 @@ void VtkStructuredWriter3D::writeDataField(DataSerializer const* serializer,
         }
         (*ostr) << "\">\n";
     }
-    
+
     // Undocumented requirement of the vtk xml file format:
-    // in front of every binary blob, base64 or raw-binary, appended or not, 
+    // in front of every binary blob, base64 or raw-binary, appended or not,
     // there is an UInt32 length indicator, giving the size of the binary blob in bytes;
     // when using base64 encoding, that length header must be encoded separately;
     // there must be no newline between the encoded length indicator and the encoded data block.
     //
     // Those properties are properly handled by the serializer2ostr function, if pluint plint is
     // equal to UInt32. If not, you are on your own.
-    
+
     bool enforceUint=true; // VTK uses "unsigned" to indicate the size of data, even on a 64-bit machine.
-    serializerToBase64Stream(serializer, ostr, enforceUint);
-    
-    if (global::mpi().isMainProcessor()) {
+
+	serializerToBase64Stream(serializer, ostr, enforceUint);
+
+    if (global::mpi().isMainProcessor() && last) {
         (*ostr) << "\n</DataArray>\n";
     }
 }
 
 template<typename T>
-void VtkStructuredWriter3D::writeDataField(DataSerializer const* serializer, std::string const& name, plint nDim, const bool& first,
-const bool& last)
+void VtkStructuredWriter3D::writeDataField(std::vector<char> const& data, std::string const& name, plint nDim,
+const bool& first, const bool& last)
 {
-    if (global::mpi().isMainProcessor() && first) {
+    if (!global::mpi().isMainProcessor()) {
+        return;
+    }
+    if (appended) {
+        if (first) {
+            appended->writeDataArrayTag(*ostr, VtkTypeNames<T>::getName(), name, nDim);
+        }
+        appended->startArray();
+        if (!data.empty()) {
+            appended->writeData(&data[0], data.size());
+        }
+        appended->endArray();
+        return;
+    }
+    if (first) {
         (*ostr) << "<DataArray type=\"" << VtkTypeNames<T>::getName()
         << "\" Name=\"" << name
         << "\" format=\"binary\" encoding=\"base64";
@@ -88,20 +128,21 @@ const bool& last)
         (*ostr) << "\">\n";
     }
 
-    // Undocumented requirement of the vtk xml file format:
-    // in front of every binary blob, base64 or raw-binary, appended or not,
-    // there is an UInt32 length indicator, giving the size of the binary blob in bytes;
-    // when using base64 encoding, that length header must be encoded separately;
-    // there must be no newline between the encoded length indicator and the encoded data block.
-    //
-    // Those properties are properly handled by the serializer2ostr function, if pluint plint is
-    // equal to UInt32. If not, you are on your own.
-
-    bool enforceUint=true; // VTK uses "unsigned" to indicate the size of data, even on a 64-bit machine.
-
-	serializerToBase64Stream(serializer, ostr, enforceUint);
+    // Same layout as serializerToBase64Stream: the UInt32 length indicator is encoded
+    //   separately, without newline before the encoded data block.
+    PLB_PRECONDITION(data.size() <= std::numeric_limits<unsigned int>::max());
+    unsigned int uintBinarySize = (unsigned int)data.size();
+    if (global::IOpolicy().getEndianSwitchOnBase64out()) {
+        endianByteSwap(uintBinarySize);
+    }
+    Base64Encoder<unsigned int> sizeEncoder(*ostr, 1);
+    sizeEncoder.encode(&uintBinarySize, 1);
+    Base64Encoder<char> dataEncoder(*ostr, data.size());
+    if (!data.empty()) {
+        dataEncoder.encode(&data[0], data.size());
+    }
 
-    if (global::mpi().isMainProcessor() && last) {
+    if (last) {
         (*ostr) << "\n</DataArray>\n";
     }
 }
@@ -383,6 +424,15 @@ const TConv& scalingFactor, const bool& first, const bool& last)
                                   tensorFieldName, 3, first, last);
 }
 
+template<typename T>
+template<typename TConv>
+void VtkStructuredImageOutput3D<T>::writeData(plint nx_, plint ny_, plint nz_, std::vector<char> const& data,
+const std::string& fieldName, plint nDim, const bool& first, const bool& last)
+{
+    if(first){writeHeader(nx_, ny_, nz_);}
+    vtkOut.writeDataField<TConv>(data, fieldName, nDim, first, last);
+}
+
 }  // namespace plb
 
 #endif // VTK_STRUCTURED_DATA_OUTPUT_HH
@@ -0,0 +1,192 @@
+/* This file is part of the Palabos library.
+ *
+ * Copyright (C) 2011-2015 FlowKit Sarl
+ * Route d'Oron 2
+ * 1010 Lausanne, Switzerland
+ * E-mail contact: contact@flowkit.com
+ *
+ * The most recent release of Palabos can be downloaded at 
+ * <http://www.palabos.org/>
+ *
+ * The library Palabos is free software: you can redistribute it and/or
+ * modify it under the terms of the GNU Affero General Public License as
+ * published by the Free Software Foundation, either version 3 of the
+ * License, or (at your option) any later version.
+ *
+ * The library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+/** \file
+ * Minimal wrapper around SIMD registers, used by vectorized collision kernels.
+ */
+
+#ifndef SIMD_PACK_H
+#define SIMD_PACK_H
+
+#include "core/globalDefs.h"
+
+#if !defined(PLB_NO_SIMD) && (defined(__AVX512F__) || defined(__AVX2__))
+#include <immintrin.h>
+#endif
+
+namespace plb {
+
+/// A pack of "width" values of type T, processed by one SIMD instruction.
+/** The generic version is a plain array, and is flagged as not vectorized:
+ *  kernels are expected to fall back to their scalar implementation in this
+ *  case, which is faster than emulating SIMD registers. Specializations for
+ *  double and float use AVX-512 or AVX2 intrinsics when the corresponding
+ *  instruction set is enabled at compile time (e.g. with -march=native, or
+ *  with the CMake option PLB_ENABLE_AVX2).
+ *  Compile with PLB_NO_SIMD to force the portable version.
+ */
+template<typename T>
+struct SimdPack {
+    enum { width = 4, vectorized = 0 };
+    T v[width];
+
+    static SimdPack broadcast(T value) {
+        SimdPack result;
+        for (int i=0; i<width; ++i) result.v[i] = value;
+        return result;
+    }
+    static SimdPack load(T const* data) {
+        SimdPack result;
+        for (int i=0; i<width; ++i) result.v[i] = data[i];
+        return result;
+    }
+    void store(T* data) const {
+        for (int i=0; i<width; ++i) data[i] = v[i];
+    }
+    friend SimdPack operator+(SimdPack const& a, SimdPack const& b) {
+        SimdPack result;
+        for (int i=0; i<width; ++i) result.v[i] = a.v[i]+b.v[i];
+        return result;
+    }
+    friend SimdPack operator-(SimdPack const& a, SimdPack const& b) {
+        SimdPack result;
+        for (int i=0; i<width; ++i) result.v[i] = a.v[i]-b.v[i];
+        return result;
+    }
+    friend SimdPack operator*(SimdPack const& a, SimdPack const& b) {
+        SimdPack result;
+        for (int i=0; i<width; ++i) result.v[i] = a.v[i]*b.v[i];
+        return result;
+    }
+};
+
+#if !defined(PLB_NO_SIMD) && defined(__AVX512F__)
+
+template<>
+struct SimdPack<double> {
+    enum { width = 8, vectorized = 1 };
+    __m512d v;
+
+    static SimdPack broadcast(double value) {
+        SimdPack result; result.v = _mm512_set1_pd(value); return result;
+    }
+    static SimdPack load(double const* data) {
+        SimdPack result; result.v = _mm512_loadu_pd(data); return result;
+    }
+    void store(double* data) const {
+        _mm512_storeu_pd(data, v);
+    }
+    friend SimdPack operator+(SimdPack const& a, SimdPack const& b) {
+        SimdPack result; result.v = _mm512_add_pd(a.v, b.v); return result;
+    }
+    friend SimdPack operator-(SimdPack const& a, SimdPack const& b) {
+        SimdPack result; result.v = _mm512_sub_pd(a.v, b.v); return result;
+    }
+    friend SimdPack operator*(SimdPack const& a, SimdPack const& b) {
+        SimdPack result; result.v = _mm512_mul_pd(a.v, b.v); return result;
+    }
+};
+
+template<>
+struct SimdPack<float> {
+    enum { width = 16, vectorized = 1 };
+    __m512 v;
+
+    static SimdPack broadcast(float value) {
+        SimdPack result; result.v = _mm512_set1_ps(value); return result;
+    }
+    static SimdPack load(float const* data) {
+        SimdPack result; result.v = _mm512_loadu_ps(data); return result;
+    }
+    void store(float* data) const {
+        _mm512_storeu_ps(data, v);
+    }
+    friend SimdPack operator+(SimdPack const& a, SimdPack const& b) {
+        SimdPack result; result.v = _mm512_add_ps(a.v, b.v); return result;
+    }
+    friend SimdPack operator-(SimdPack const& a, SimdPack const& b) {
+        SimdPack result; result.v = _mm512_sub_ps(a.v, b.v); return result;
+    }
+    friend SimdPack operator*(SimdPack const& a, SimdPack const& b) {
+        SimdPack result; result.v = _mm512_mul_ps(a.v, b.v); return result;
+    }
+};
+
+#elif !defined(PLB_NO_SIMD) && defined(__AVX2__)
+
+template<>
+struct SimdPack<double> {
+    enum { width = 4, vectorized = 1 };
+    __m256d v;
+
+    static SimdPack broadcast(double value) {
+        SimdPack result; result.v = _mm256_set1_pd(value); return result;
+    }
+    static SimdPack load(double const* data) {
+        SimdPack result; result.v = _mm256_loadu_pd(data); return result;
+    }
+    void store(double* data) const {
+        _mm256_storeu_pd(data, v);
+    }
+    friend SimdPack operator+(SimdPack const& a, SimdPack const& b) {
+        SimdPack result; result.v = _mm256_add_pd(a.v, b.v); return result;
+    }
+    friend SimdPack operator-(SimdPack const& a, SimdPack const& b) {
+        SimdPack result; result.v = _mm256_sub_pd(a.v, b.v); return result;
+    }
+    friend SimdPack operator*(SimdPack const& a, SimdPack const& b) {
+        SimdPack result; result.v = _mm256_mul_pd(a.v, b.v); return result;
+    }
+};
+
+template<>
+struct SimdPack<float> {
+    enum { width = 8, vectorized = 1 };
+    __m256 v;
+
+    static SimdPack broadcast(float value) {
+        SimdPack result; result.v = _mm256_set1_ps(value); return result;
+    }
+    static SimdPack load(float const* data) {
+        SimdPack result; result.v = _mm256_loadu_ps(data); return result;
+    }
+    void store(float* data) const {
+        _mm256_storeu_ps(data, v);
+    }
+    friend SimdPack operator+(SimdPack const& a, SimdPack const& b) {
+        SimdPack result; result.v = _mm256_add_ps(a.v, b.v); return result;
+    }
+    friend SimdPack operator-(SimdPack const& a, SimdPack const& b) {
+        SimdPack result; result.v = _mm256_sub_ps(a.v, b.v); return result;
+    }
+    friend SimdPack operator*(SimdPack const& a, SimdPack const& b) {
+        SimdPack result; result.v = _mm256_mul_ps(a.v, b.v); return result;
+    }
+};
+
+#endif
+
+}  // namespace plb
+
+#endif  // SIMD_PACK_H
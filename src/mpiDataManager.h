@@ -14,8 +14,27 @@ namespace plb{
 	namespace global{
 
 	#ifdef PLB_MPI_PARALLEL
+	// Handle on a non-blocking broadcast of a TriangleSet from the main processor.
+	// The transfer is started with MpiDataManager::iSendTriangleSet (main processor)
+	// or iReceiveTriangleSet (all other processors), and completed with complete().
+	template<typename T>
+	class TriangleSetTransfer{
+	public:
+		TriangleSetTransfer();
+		bool pending() const{ return active; }
+		TriangleSet<T> complete();
+	private:
+		TriangleSet<T> triangles;
+		std::vector<T> buffer;
+		MPI_Request request;
+		bool active;
+	friend class MpiDataManager;
+	};
+
 	class MpiDataManager{
 	public:
+		// The sender broadcasts the whole domain in one message, all other processors
+		// must call receiveScalarField3D with the same domain and fromId equal to the sender.
 		template<typename T>
 		void sendScalarField3D(const ScalarField3D<T>& field, const Box3D& fromDomain);
 
@@ -28,14 +47,15 @@ namespace plb{
 		template<typename T>
 		void sendTriangleSet(const TriangleSet<T>& triangles);
 
-		void sendReceiveDomains(const bool& master, std::vector<Box3D>& mpiDomains);
+		template<typename T>
+		void iSendTriangleSet(const TriangleSet<T>& triangles, TriangleSetTransfer<T>& transfer);
 
-		std::vector<Box3D> splitDomains(const Box3D& domain);
+		template<typename T>
+		void iReceiveTriangleSet(TriangleSetTransfer<T>& transfer);
 
 		MpiDataManager& mpiData(){static MpiDataManager instance; return instance;}
 	private:
 		void checkDomain(int rank, Box3D domain, const int& line);
-		Array<int,2> checkIfCrossed(const int& fMin, const int& fMax, const int& n);
 		MpiDataManager();
 		~MpiDataManager();
 	friend MpiDataManager& mpiData();
@@ -43,6 +63,16 @@ namespace plb{
 	#endif
 
 	#ifndef PLB_MPI_PARALLEL
+	template<typename T>
+	class TriangleSetTransfer{
+	public:
+		bool pending() const{ return false; }
+		TriangleSet<T> complete(){ return triangles; }
+	private:
+		TriangleSet<T> triangles;
+	friend class MpiDataManager;
+	};
+
 	class MpiDataManager{
 	public:
 		template<typename T>
@@ -52,19 +82,20 @@ namespace plb{
 		void receiveScalarField3D(ScalarField3D<T>& field, const Box3D& fromDomain, const int& fromId) const{}
 
 		template<typename T>
-		TriangleSet<T> receiveTriangleSet(){}
+		TriangleSet<T> receiveTriangleSet(){ return TriangleSet<T>(); }
 
 		template<typename T>
 		void sendTriangleSet(const TriangleSet<T>& triangles){}
 
-		void sendReceiveDomains(const bool& master, std::vector<Box3D>& mpiDomains){}
+		template<typename T>
+		void iSendTriangleSet(const TriangleSet<T>& triangles, TriangleSetTransfer<T>& transfer){ transfer.triangles = triangles; }
 
-		void splitDomains(const Box3D& domain){ }
+		template<typename T>
+		void iReceiveTriangleSet(TriangleSetTransfer<T>& transfer){}
 
 		MpiDataManager& mpiData(){static MpiDataManager instance; return instance;}
 	private:
 		void checkDomain(int rank, Box3D domain, const int& line){};
-		void checkIfCrossed(const int& fMin, const int& fMax, const int& n){ }
 		MpiDataManager();
 		~MpiDataManager();
 	friend MpiDataManager& mpiData();
@@ -45,6 +45,20 @@ struct BlockCommunicator3D {
      *  is being transmitted.
      **/
     virtual void duplicateOverlaps(MultiBlock3D& multiBlock, modif::ModifT whichData) const =0;
+    /// Initiate duplicateOverlaps() without waiting for the data to arrive.
+    /** The envelopes are filled only by the subsequent call to
+     *  completeDuplicateOverlaps(), and the work between the two calls may
+     *  overlap with the communication. In between, neither the bulk cells
+     *  which are sent nor the envelopes may be modified. By default, all the
+     *  work is done in completeDuplicateOverlaps().
+     **/
+    virtual void startDuplicateOverlaps(MultiBlock3D& multiBlock, modif::ModifT whichData) const
+    { }
+    /// Conclude the communication initiated by startDuplicateOverlaps().
+    virtual void completeDuplicateOverlaps(MultiBlock3D& multiBlock, modif::ModifT whichData) const
+    {
+        duplicateOverlaps(multiBlock, whichData);
+    }
     /// Transmit data between two multi-blocks, according to a user-defined pattern.
     /** The variable whichData specifies which type of content (static/dynamic/full dynamics object)
      *  is being transmitted.
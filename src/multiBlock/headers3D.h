@@ -45,4 +45,6 @@
 #include "multiBlock/localMultiBlockInfo3D.h"
 #include "multiBlock/nonLocalTransfer3D.h"
 #include "multiBlock/multiBlockGenerator3D.h"
+#include "multiBlock/redistribution3D.h"
+#include "multiBlock/loadBalancer3D.h"
 
@@ -0,0 +1,196 @@
+/* This file is part of the Palabos library.
+ *
+ * Copyright (C) 2011-2015 FlowKit Sarl
+ * Route d'Oron 2
+ * 1010 Lausanne, Switzerland
+ * E-mail contact: contact@flowkit.com
+ *
+ * The most recent release of Palabos can be downloaded at 
+ * <http://www.palabos.org/>
+ *
+ * The library Palabos is free software: you can redistribute it and/or
+ * modify it under the terms of the GNU Affero General Public License as
+ * published by the Free Software Foundation, either version 3 of the
+ * License, or (at your option) any later version.
+ *
+ * The library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+/** \file
+ * Dynamic load balancing of 3D multi-blocks -- implementation file.
+ */
+
+#include "multiBlock/loadBalancer3D.h"
+#include "multiBlock/multiBlock3D.h"
+#include "multiBlock/multiContainerBlock3D.h"
+#include "multiBlock/multiBlockOperations3D.h"
+#include "parallelism/mpiManager.h"
+#include "parallelism/threadPool.h"
+#include "atomicBlock/atomicBlock3D.h"
+#include "core/plbDebug.h"
+#include <algorithm>
+
+namespace plb {
+
+namespace {
+
+/// Ratio of maximum to mean cost of the processes, for a given distribution.
+double computeImbalance( std::map<plint,double> const& blockCosts,
+                         ThreadAttribution const& attribution )
+{
+    std::vector<double> processCosts(global::mpi().getSize(), 0.);
+    std::map<plint,double>::const_iterator it = blockCosts.begin();
+    for (; it != blockCosts.end(); ++it) {
+        processCosts[attribution.getMpiProcess(it->first)] += it->second;
+    }
+    double totalCost = 0., maxCost = 0.;
+    for (pluint iProc=0; iProc<processCosts.size(); ++iProc) {
+        totalCost += processCosts[iProc];
+        maxCost = std::max(maxCost, processCosts[iProc]);
+    }
+    if (totalCost <= 0.) {
+        return 1.;
+    }
+    return maxCost / (totalCost / (double)processCosts.size());
+}
+
+}  // namespace
+
+LoadBalancer3D::LoadBalancer3D(double maxImbalance_)
+    : maxImbalance(maxImbalance_),
+      imbalance(1.),
+      predictedImbalance(1.)
+{ }
+
+void LoadBalancer3D::measure (
+        MultiBlock3D& multiBlock, std::map<plint,double> const& localWeights )
+{
+    update(multiBlock, localWeights, true);
+}
+
+void LoadBalancer3D::estimate (
+        MultiBlock3D& multiBlock, std::map<plint,double> const& localWeights )
+{
+    update(multiBlock, localWeights, false);
+}
+
+void LoadBalancer3D::update (
+        MultiBlock3D& multiBlock, std::map<plint,double> const& localWeights,
+        bool useTimers )
+{
+    MultiBlockManagement3D const& management = multiBlock.getMultiBlockManagement();
+    std::vector<plint> const& localBlocks = multiBlock.getLocalInfo().getBlocks();
+
+    // Computation time of each local block since the previous measurement.
+    std::map<plint,double> localTimes;
+    double totalTime = 0.;
+    for (pluint iBlock=0; iBlock<localBlocks.size(); ++iBlock) {
+        PLB_ASSERT( localWeights.find(localBlocks[iBlock]) != localWeights.end() );
+        AtomicBlock3D& block = multiBlock.getComponent(localBlocks[iBlock]);
+        double time = useTimers ? block.getProcessorTime() : 0.;
+        localTimes[localBlocks[iBlock]] = time;
+        totalTime += time;
+        block.resetProcessorTime();
+    }
+#ifdef PLB_MPI_PARALLEL
+    global::mpi().reduceAndBcast(totalTime, MPI_SUM);
+#endif
+
+    // The weights serve as costs as long as no time has been measured.
+    // Each process fills in the cost of its own blocks.
+    std::map<plint,Box3D> const& bulks = multiBlock.getSparseBlockStructure().getBulks();
+    std::vector<double> costs(bulks.size(), 0.);
+    std::map<plint,Box3D>::const_iterator it = bulks.begin();
+    for (pluint pos=0; it != bulks.end(); ++it, ++pos) {
+        if (management.getThreadAttribution().isLocal(it->first)) {
+            if (totalTime > 0.) {
+                costs[pos] = localTimes[it->first];
+            }
+            else {
+                costs[pos] = localWeights.find(it->first)->second;
+            }
+        }
+    }
+#ifdef PLB_MPI_PARALLEL
+    global::mpi().allReduceVect(costs, MPI_SUM);
+#endif
+
+    blockCosts.clear();
+    it = bulks.begin();
+    for (pluint pos=0; it != bulks.end(); ++it, ++pos) {
+        blockCosts[it->first] = costs[pos];
+    }
+
+    imbalance = computeImbalance(blockCosts, management.getThreadAttribution());
+    MultiBlockManagement3D newManagement = getRedistribution().redistribute(management);
+    predictedImbalance = computeImbalance(blockCosts, newManagement.getThreadAttribution());
+}
+
+bool LoadBalancer3D::needsRebalancing() const {
+    return imbalance > maxImbalance && predictedImbalance < imbalance;
+}
+
+WeightedHilbertRedistribute3D LoadBalancer3D::getRedistribution() const {
+    return WeightedHilbertRedistribute3D (
+            blockCosts, global::mpi().getSize(), global::threadPool().getNumThreads() );
+}
+
+void redistribute( std::vector<MultiBlock3D*> multiBlocks,
+                   MultiBlockRedistribute3D const& redistribution )
+{
+    // Move the data. Every multi-block keeps its identity and exchanges its
+    //   atomic-blocks with a temporary clone on the new distribution.
+    for (pluint iBlock=0; iBlock<multiBlocks.size(); ++iBlock) {
+        MultiBlock3D& multiBlock = *multiBlocks[iBlock];
+        MultiBlockManagement3D newManagement =
+            redistribution.redistribute(multiBlock.getMultiBlockManagement());
+        MultiBlock3D* newBlock = 0;
+        if (dynamic_cast<MultiContainerBlock3D*>(&multiBlock)) {
+            // The data of a container cannot be transferred (see
+            //   MultiContainerBlock3D::clone): new containers are empty.
+            newBlock = new MultiContainerBlock3D (
+                    newManagement, multiBlock.getCombinedStatistics().clone() );
+        }
+        else {
+            newBlock = multiBlock.clone(newManagement);
+        }
+        multiBlock.swapDistribution(*newBlock);
+        delete newBlock;
+    }
+
+    // The processors of the old atomic-blocks are gone: add the stored ones
+    //   again, once all multi-blocks of the group have been redistributed.
+    std::vector<std::vector<MultiBlock3D::ProcessorStorage3D> > processors(multiBlocks.size());
+    for (pluint iBlock=0; iBlock<multiBlocks.size(); ++iBlock) {
+        multiBlocks[iBlock]->releaseProcessors(processors[iBlock]);
+    }
+    for (pluint iBlock=0; iBlock<multiBlocks.size(); ++iBlock) {
+        for (pluint iProc=0; iProc<processors[iBlock].size(); ++iProc) {
+            MultiBlock3D::ProcessorStorage3D const& storage = processors[iBlock][iProc];
+            std::vector<id_t> const& ids = storage.getMultiBlockIds();
+            std::vector<MultiBlock3D*> args(ids.size());
+            bool argsExist = true;
+            for (pluint iArg=0; iArg<ids.size(); ++iArg) {
+                args[iArg] = multiBlockRegistration3D().find(ids[iArg]);
+                argsExist = argsExist && args[iArg];
+            }
+            if (argsExist) {
+                addInternalProcessor(storage.getGenerator(), *multiBlocks[iBlock], args, storage.getLevel());
+            }
+        }
+    }
+
+    for (pluint iBlock=0; iBlock<multiBlocks.size(); ++iBlock) {
+        if (!dynamic_cast<MultiContainerBlock3D*>(multiBlocks[iBlock])) {
+            multiBlocks[iBlock]->duplicateOverlaps(modif::dataStructure);
+        }
+    }
+}
+
+}  // namespace plb
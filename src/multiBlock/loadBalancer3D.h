@@ -0,0 +1,108 @@
+/* This file is part of the Palabos library.
+ *
+ * Copyright (C) 2011-2015 FlowKit Sarl
+ * Route d'Oron 2
+ * 1010 Lausanne, Switzerland
+ * E-mail contact: contact@flowkit.com
+ *
+ * The most recent release of Palabos can be downloaded at 
+ * <http://www.palabos.org/>
+ *
+ * The library Palabos is free software: you can redistribute it and/or
+ * modify it under the terms of the GNU Affero General Public License as
+ * published by the Free Software Foundation, either version 3 of the
+ * License, or (at your option) any later version.
+ *
+ * The library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+/** \file
+ * Dynamic load balancing of 3D multi-blocks -- header file.
+ */
+
+#ifndef LOAD_BALANCER_3D_H
+#define LOAD_BALANCER_3D_H
+
+#include "core/globalDefs.h"
+#include "multiBlock/redistribution3D.h"
+#include <map>
+#include <vector>
+
+namespace plb {
+
+class MultiBlock3D;
+template<typename T, template<typename U> class Descriptor> class MultiBlockLattice3D;
+
+/// Measure the cost of the blocks of a multi-block, and decide when a
+///   redistribution pays off.
+/** The cost of a block is the time spent in its internal data processors
+ *  (see AtomicBlock3D::getProcessorTime()), which includes the
+ *  collision-streaming step when it is carried out by a processor, as with
+ *  ExternalRhoJcollideAndStream3D. It is measured for each block on its own,
+ *  also when the blocks are processed concurrently by the thread pool. As
+ *  long as no time has been measured, the weights of the blocks, typically
+ *  their number of active cells, are used as costs.
+ */
+class LoadBalancer3D {
+public:
+    /// Rebalancing is suggested when the maximum cost of a process exceeds
+    ///   the mean cost by more than the ratio maxImbalance.
+    LoadBalancer3D(double maxImbalance_=1.1);
+    /// Update the block costs with the time spent since the previous call,
+    ///   and restart the time measurement of the blocks. The weights of all
+    ///   local blocks of the multi-block must be provided; they serve as
+    ///   costs if no time was measured. This is a collective operation.
+    void measure(MultiBlock3D& multiBlock, std::map<plint,double> const& localWeights);
+    /// Use the weights as block costs, e.g. before the first time steps, and
+    ///   start the time measurement from here. Collective operation as well.
+    void estimate(MultiBlock3D& multiBlock, std::map<plint,double> const& localWeights);
+    /// Cost of all blocks (local and non-local) at the last measurement.
+    std::map<plint,double> const& getBlockCosts() const { return blockCosts; }
+    /// Ratio of maximum to mean process cost, at the last measurement.
+    double getImbalance() const { return imbalance; }
+    /// Same ratio, predicted for the distribution of getRedistribution().
+    double getPredictedImbalance() const { return predictedImbalance; }
+    /// True if the imbalance exceeds its limit and a redistribution improves it.
+    bool needsRebalancing() const;
+    /// Distribution which balances the measured costs.
+    WeightedHilbertRedistribute3D getRedistribution() const;
+private:
+    void update(MultiBlock3D& multiBlock, std::map<plint,double> const& localWeights,
+                bool useTimers);
+private:
+    double maxImbalance;
+    std::map<plint,double> blockCosts;
+    double imbalance, predictedImbalance;
+};
+
+/// Give each multi-block of the list the distribution computed by "redistribution".
+/** The blocks are moved in place: the multi-blocks keep their identity, so
+ *  that all references to them remain valid. The data are transferred with
+ *  the usual block-data transfers, the envelopes are updated, and the stored
+ *  data processors are instantiated again on the new atomic-blocks.
+ *  Processors which refer to a multi-block that no longer exists are dropped.
+ *
+ *  Multi-blocks with a common distribution, which are coupled by data
+ *  processors, must be redistributed together, in one call. Processors
+ *  are only restored if they are stored in one of the multi-blocks of the list.
+ *  The content of multi-container blocks is not transferred: it must be
+ *  regenerated, for example by a data processor.
+ */
+void redistribute(std::vector<MultiBlock3D*> multiBlocks,
+                  MultiBlockRedistribute3D const& redistribution);
+
+/// Weight of each local block of the lattice: the number of cells, in which a
+///   cell with no dynamics (NoDynamics) counts as inactiveWeight.
+template<typename T, template<typename U> class Descriptor>
+std::map<plint,double> computeBlockWeights (
+        MultiBlockLattice3D<T,Descriptor>& lattice, double inactiveWeight=0.1 );
+
+}  // namespace plb
+
+#endif  // LOAD_BALANCER_3D_H
@@ -0,0 +1,67 @@
+/* This file is part of the Palabos library.
+ *
+ * Copyright (C) 2011-2015 FlowKit Sarl
+ * Route d'Oron 2
+ * 1010 Lausanne, Switzerland
+ * E-mail contact: contact@flowkit.com
+ *
+ * The most recent release of Palabos can be downloaded at 
+ * <http://www.palabos.org/>
+ *
+ * The library Palabos is free software: you can redistribute it and/or
+ * modify it under the terms of the GNU Affero General Public License as
+ * published by the Free Software Foundation, either version 3 of the
+ * License, or (at your option) any later version.
+ *
+ * The library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+/** \file
+ * Dynamic load balancing of 3D multi-blocks -- generic implementation.
+ */
+
+#ifndef LOAD_BALANCER_3D_HH
+#define LOAD_BALANCER_3D_HH
+
+#include "multiBlock/loadBalancer3D.h"
+#include "multiBlock/multiBlockLattice3D.h"
+#include "core/dynamics.h"
+
+namespace plb {
+
+template<typename T, template<typename U> class Descriptor>
+std::map<plint,double> computeBlockWeights (
+        MultiBlockLattice3D<T,Descriptor>& lattice, double inactiveWeight )
+{
+    int noDynamicsId = NoDynamics<T,Descriptor>().getId();
+    std::map<plint,double> weights;
+    std::vector<plint> const& blocks = lattice.getLocalInfo().getBlocks();
+    for (pluint iBlock=0; iBlock<blocks.size(); ++iBlock) {
+        plint blockId = blocks[iBlock];
+        BlockLattice3D<T,Descriptor>& block = lattice.getComponent(blockId);
+        SmartBulk3D bulk(lattice.getMultiBlockManagement(), blockId);
+        Box3D domain(bulk.toLocal(bulk.getBulk()));
+        plint numInactive = 0;
+        for (plint iX=domain.x0; iX<=domain.x1; ++iX) {
+            for (plint iY=domain.y0; iY<=domain.y1; ++iY) {
+                for (plint iZ=domain.z0; iZ<=domain.z1; ++iZ) {
+                    if (block.get(iX,iY,iZ).getDynamics().getId()==noDynamicsId) {
+                        ++numInactive;
+                    }
+                }
+            }
+        }
+        weights[blockId] = (double)(domain.nCells()-numInactive) + inactiveWeight*(double)numInactive;
+    }
+    return weights;
+}
+
+}  // namespace plb
+
+#endif  // LOAD_BALANCER_3D_HH
@@ -28,10 +28,12 @@
 #include "multiBlock/multiBlock3D.h"
 #include "core/plbDebug.h"
 #include "core/plbProfiler.h"
+#include "core/plbTracer.h"
 #include "atomicBlock/atomicBlock3D.h"
 #include "multiBlock/multiBlockOperations3D.h"
 #include "multiBlock/multiBlockSerializer3D.h"
 #include "multiBlock/defaultMultiBlockPolicy3D.h"
+#include "parallelism/threadPool.h"
 #include <cmath>
 #include <algorithm>
 
@@ -484,6 +486,7 @@ void MultiBlock3D::setRefinementLevel(plint newLevel)
 }
 
 void MultiBlock3D::executeInternalProcessors() {
+    PLB_TRACE_SCOPE("dataProcessors");
     global::profiler().start("dataProcessor");
     // Execute all automatic internal processors.
     for (plint iLevel=0; iLevel<=maxProcessorLevel; ++iLevel) {
@@ -491,6 +494,7 @@ void MultiBlock3D::executeInternalProcessors() {
     }
     // Duplicate boundaries at least once in case there is no automatic processor.
     if (maxProcessorLevel==-1) {
+        PLB_TRACE_SCOPE("envelopeUpdate");
         global::profiler().start("envelope-update");
         this->duplicateOverlaps(internalModifT);
         global::profiler().stop("envelope-update");
@@ -500,11 +504,31 @@ void MultiBlock3D::executeInternalProcessors() {
 
 void MultiBlock3D::executeInternalProcessors(plint level, bool communicate) {
     std::vector<plint> const& blocks = getLocalInfo().getBlocks();
-    for (pluint iBlock=0; iBlock<blocks.size(); ++iBlock) {
-        plint blockId = blocks[iBlock];
-        getComponent(blockId).executeInternalProcessors(level);
+    if (global::threadPool().isThreaded()) {
+        // The processors of different blocks act on disjoint atomic-blocks
+        //   and can be executed concurrently by the shared-memory threads.
+        ThreadAttribution const& threadAttribution = multiBlockManagement.getThreadAttribution();
+        std::vector<global::ThreadPool::Task> tasks(blocks.size());
+        std::vector<plint> preferredThread(blocks.size());
+        for (pluint iBlock=0; iBlock<blocks.size(); ++iBlock) {
+            AtomicBlock3D* component = &getComponent(blocks[iBlock]);
+            tasks[iBlock] = [component,level]() {
+                PLB_TRACE_SCOPE("block.dataProcessors");
+                component->executeInternalProcessors(level);
+            };
+            preferredThread[iBlock] = threadAttribution.getLocalThreadId(blocks[iBlock]);
+        }
+        global::threadPool().execute(tasks, preferredThread);
+    }
+    else {
+        for (pluint iBlock=0; iBlock<blocks.size(); ++iBlock) {
+            PLB_TRACE_SCOPE("block.dataProcessors");
+            plint blockId = blocks[iBlock];
+            getComponent(blockId).executeInternalProcessors(level);
+        }
     }
     if (communicate) {
+        PLB_TRACE_SCOPE("envelopeUpdate");
         duplicateOverlapsInModifiedMultiBlocks(level);
     }
 }
@@ -542,6 +566,31 @@ std::vector<MultiBlock3D::ProcessorStorage3D> const&
     return storedProcessors;
 }
 
+void MultiBlock3D::releaseProcessors(std::vector<ProcessorStorage3D>& processors)
+{
+    processors.clear();
+    processors.swap(storedProcessors);
+    multiBlocksChangedByManualProcessors.clear();
+    multiBlocksChangedByAutomaticProcessors.clear();
+    maxProcessorLevel = -1;
+}
+
+bool MultiBlock3D::hasInternalProcessors() const {
+    return maxProcessorLevel>=0;
+}
+
+void MultiBlock3D::swapDistribution(MultiBlock3D& rhs) {
+    throw PlbLogicException( "Multi-blocks of type " + getBlockName() +
+                             " cannot be redistributed." );
+}
+
+void MultiBlock3D::swapManagement(MultiBlock3D& rhs) {
+    multiBlockManagement.swap(rhs.multiBlockManagement);
+    // The cached communication patterns refer to the old distribution.
+    signalPeriodicity();
+    rhs.signalPeriodicity();
+}
+
 void MultiBlock3D::addModifiedBlocks (
         plint level,
         std::vector<MultiBlock3D*> modifiedBlocks,
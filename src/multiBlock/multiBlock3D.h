@@ -148,6 +148,18 @@ public:
     void storeProcessor(DataProcessorGenerator3D const& generator,
                         std::vector<MultiBlock3D*> multiBlocks, plint level);
     std::vector<ProcessorStorage3D> const& getStoredProcessors() const;
+    /// Hand the stored processors over to the caller, and unsubscribe all
+    ///   internal processors. The processors instantiated on the atomic-blocks
+    ///   are left untouched: this is meant to be used after swapDistribution(),
+    ///   before the processors are added again to the new atomic-blocks.
+    void releaseProcessors(std::vector<ProcessorStorage3D>& processors);
+    /// Tell if automatic internal processors have been subscribed.
+    bool hasInternalProcessors() const;
+    /// Exchange the distribution (block management and atomic-blocks) with
+    ///   the one of rhs, a multi-block of the same type. The identity, the
+    ///   periodicity, the statistics and the processors stay in place. By
+    ///   default, multi-blocks cannot be redistributed and an exception is thrown.
+    virtual void swapDistribution(MultiBlock3D& rhs);
 public:
     MultiBlockManagement3D const& getMultiBlockManagement() const;
     void setCoProcessors(std::map<plint,int> const& coProcessors);
@@ -197,7 +209,7 @@ public:
                 MultiBlock3D const& fromBlock, Box3D const& fromDomain,
                 Box3D const& toDomain, modif::ModifT whichData=modif::dataStructure ) =0;
     void duplicateOverlaps(modif::ModifT whichData);
-    void signalPeriodicity();
+    virtual void signalPeriodicity();
     virtual DataSerializer* getBlockSerializer (
             Box3D const& domain, IndexOrdering::OrderingT ordering ) const;
     virtual DataUnSerializer* getBlockUnSerializer (
@@ -211,6 +223,10 @@ public:
     /// Get one or two string identifiers for the template parameters of the block.
     ///   E.g. "double" and "d3q19"
     virtual std::vector<std::string> getTypeInfo() const =0;
+protected:
+    /// Exchange the block management with rhs, and invalidate the
+    ///   communication patterns; to be used in swapDistribution().
+    void swapManagement(MultiBlock3D& rhs);
 private:
     MultiBlockManagement3D multiBlockManagement;
     /// List of MultiBlocks which are modified by the manual processors and require
@@ -457,6 +457,12 @@ template<typename T, template<typename U> class Descriptor>
 std::auto_ptr<MultiBlockLattice3D<T,Descriptor> > generateMultiBlockLattice (
         Box3D boundingBox, Dynamics<T,Descriptor>* backgroundDynamics, plint envelopeWidth=1 );
 
+/// Generate a multi-block-lattice on a given block-management, for example
+///   one which was computed from a voxelized geometry.
+template<typename T, template<typename U> class Descriptor>
+std::auto_ptr<MultiBlockLattice3D<T,Descriptor> > generateMultiBlockLattice (
+        MultiBlockManagement3D const& management, Dynamics<T,Descriptor>* backgroundDynamics );
+
 /// Generate a multi-block-lattice from scratch. As opposed to the standard
 ///   constructor, this factory function takes the explicit block-management
 ///   object, which includes stuff like block-distribution, parallelization,
@@ -955,6 +955,20 @@ std::auto_ptr<MultiBlockLattice3D<T,Descriptor> > generateMultiBlockLattice (
     );
 }
 
+template<typename T, template<typename U> class Descriptor>
+std::auto_ptr<MultiBlockLattice3D<T,Descriptor> > generateMultiBlockLattice (
+        MultiBlockManagement3D const& management, Dynamics<T,Descriptor>* backgroundDynamics )
+{
+    return std::auto_ptr<MultiBlockLattice3D<T,Descriptor> > (
+        new MultiBlockLattice3D<T,Descriptor> (
+            management,
+            defaultMultiBlockPolicy3D().getBlockCommunicator(),
+            defaultMultiBlockPolicy3D().getCombinedStatistics(),
+            defaultMultiBlockPolicy3D().getMultiCellAccess<T,Descriptor>(),
+            backgroundDynamics )
+    );
+}
+
 template<typename T, template<typename U> class Descriptor>
 std::auto_ptr<MultiBlockLattice3D<T,Descriptor> > defaultGenerateMultiBlockLattice3D (
         MultiBlockManagement3D const& management, plint nDim )
@@ -92,6 +92,9 @@ public:
     /// Attention: data-processors of rhs, which were pointing at rhs, will continue pointing
     /// to rhs, and not to *this.
     void swap(MultiBlockLattice3D& rhs);
+    /// Exchange the distribution with rhs, which must be a MultiBlockLattice3D
+    ///   of the same type. No AA-streaming step may be pending in rhs.
+    virtual void swapDistribution(MultiBlock3D& rhs);
     /// Attention: data-processors of rhs, which were pointing at rhs, will continue pointing
     /// to rhs, and not to *this.
     MultiBlockLattice3D<T,Descriptor>& operator=(MultiBlockLattice3D<T,Descriptor> const& rhs);
@@ -106,6 +109,43 @@ public:
     virtual void stream();
     virtual void collideAndStream(Box3D domain);
     virtual void collideAndStream();
+    /// Select the scheme used by collideAndStream() to propagate populations
+    /** The AA-pattern (see BlockLattice3D::setPropagationScheme()) requires
+     *  an envelope of width 2*vicinity: the envelope is then updated
+     *  consistently by the local collision step, and the communication is
+     *  needed only once per pair of time steps. The blocks fall back to the
+     *  swap scheme as long as internal processors are present, because
+     *  these need the populations in natural order after every step.
+     *  The scheme affects collideAndStream() only: a time step carried out
+     *  by a processor through executeInternalProcessors(), as with
+     *  ExternalRhoJcollideAndStream3D in the moving-body driver, always
+     *  uses the swap scheme.
+     **/
+    void setPropagationScheme(propagation::SchemeT scheme);
+    propagation::SchemeT getPropagationScheme() const { return propagationScheme; }
+    /// Conclude a pending streaming step of the AA-pattern
+    /** This must be called before accessing the cell content after an odd
+     *  number of time steps with the AA-pattern.
+     **/
+    void completeStream();
+    /// Overlap the communication of the envelopes with the computation
+    /** When activated, collideAndStream() first processes the outer shell
+     *  of each block, initiates the communication of the envelopes, and
+     *  processes the interior of the blocks while the messages are in
+     *  flight. This only takes effect with the swap scheme, and as long as
+     *  there are neither internal processors nor co-processors. A time step
+     *  carried out by a processor through executeInternalProcessors(), as
+     *  in the moving-body driver, is never overlapped: the envelopes are
+     *  then updated after the processors of each level.
+     **/
+    void toggleCommunicationOverlap(bool flag) { communicationIsOverlapped = flag; }
+    bool overlapsCommunication() const { return communicationIsOverlapped; }
+    /// Select the collision policy of the atomic-blocks (see BlockLattice3D::setCollisionPolicy())
+    /** The multi-block takes ownership of the policy, and gives a clone of
+     *  it to each of its atomic-blocks, including the ones created later on
+     *  by a new parallel distribution.
+     **/
+    void setCollisionPolicy(CollisionPolicy3D<T,Descriptor>* policy);
     virtual void incrementTime();
     virtual void resetTime(pluint value);
     virtual BlockLattice3D<T,Descriptor>& getComponent(plint blockId);
@@ -116,6 +156,7 @@ public:
     virtual void copyReceive (
                 MultiBlock3D const& fromBlock, Box3D const& fromDomain,
                 Box3D const& toDomain, modif::ModifT whichData=modif::dataStructure );
+    virtual void signalPeriodicity();
 public:
     BlockMap& getBlockLattices();
     BlockMap const& getBlockLattices() const;
@@ -129,10 +170,26 @@ private:
     void allocateAndInitialize();
     void eliminateStatisticsInEnvelope();
     Box3D extendPeriodic(Box3D const& box, plint envelopeWidth) const;
+    /// Exclude the envelope cells outside the multi-block from the
+    ///   activity classification of the atomic-blocks.
+    void updateActivityDomains();
+    /// Collision-streaming of all local blocks, distributed over the
+    ///   shared-memory threads of global::threadPool(). This only serves
+    ///   collideAndStream(): a time step carried out by a processor at
+    ///   level 0 (see ExternalRhoJcollideAndStream3D) is distributed over
+    ///   the threads by MultiBlock3D::executeInternalProcessors() instead.
+    void threadedCollideAndStream();
+    /// Collision-streaming of the shell of all local blocks, followed by
+    ///   their interior while the envelopes are being communicated.
+    void overlappedCollideAndStream();
 private:
     Dynamics<T,Descriptor>* backgroundDynamics;
     MultiCellAccess3D<T,Descriptor>* multiCellAccess;
     BlockMap blockLattices;
+    propagation::SchemeT propagationScheme;
+    bool streamIsPending;
+    bool communicationIsOverlapped;
+    CollisionPolicy3D<T,Descriptor>* collisionPolicy;
 public:
     static const int staticId;
 };
@@ -149,6 +206,11 @@ double getStoredAverageEnergy(MultiBlockLattice3D<T,Descriptor> const& blockLatt
 template<typename T, template<typename U> class Descriptor>
 double getStoredMaxVelocity(MultiBlockLattice3D<T,Descriptor> const& blockLattice);
 
+/// Count the atomic-blocks of each activity class over all processes
+///   (see BlockLattice3D::getActivity()). The result is indexed by activity::ClassT.
+template<typename T, template<typename U> class Descriptor>
+std::vector<plint> countBlockActivity(MultiBlockLattice3D<T,Descriptor> const& blockLattice);
+
 }  // namespace plb
 
 #endif  // MULTI_BLOCK_LATTICE_3D_H
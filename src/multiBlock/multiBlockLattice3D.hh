@@ -30,6 +30,7 @@
 
 #include "multiBlock/multiBlockLattice3D.h"
 #include "atomicBlock/blockLattice3D.h"
+#include "basicDynamics/dynamicsDispatch.h"
 #include "multiBlock/defaultMultiBlockPolicy3D.h"
 #include "multiBlock/nonLocalTransfer3D.h"
 #include "multiBlock/multiBlockGenerator3D.h"
@@ -37,9 +38,11 @@
 #include "core/plbTypenames.h"
 #include "core/multiBlockIdentifiers3D.h"
 #include "core/plbProfiler.h"
+#include "core/plbTracer.h"
 #include "core/dynamicsIdentifiers.h"
 #include "dataProcessors/metaStuffWrapper3D.h"
 #include "coProcessors/coProcessor3D.h"
+#include "parallelism/threadPool.h"
 #include <algorithm>
 #include <limits>
 #include <cmath>
@@ -65,7 +68,11 @@ MultiBlockLattice3D<T,Descriptor>::MultiBlockLattice3D (
         Dynamics<T,Descriptor>* backgroundDynamics_ )
     : MultiBlock3D(multiBlockManagement_, blockCommunicator_, combinedStatistics_ ),
       backgroundDynamics(backgroundDynamics_),
-      multiCellAccess(multiCellAccess_)
+      multiCellAccess(multiCellAccess_),
+      propagationScheme(propagation::swap),
+      streamIsPending(false),
+      communicationIsOverlapped(false),
+      collisionPolicy(0)
 {
     allocateAndInitialize();
     eliminateStatisticsInEnvelope();
@@ -78,7 +85,11 @@ MultiBlockLattice3D<T,Descriptor>::MultiBlockLattice3D (
         Dynamics<T,Descriptor>* backgroundDynamics_ )
     : MultiBlock3D(nx,ny,nz,Descriptor<T>::vicinity),
       backgroundDynamics(backgroundDynamics_),
-      multiCellAccess(defaultMultiBlockPolicy3D().getMultiCellAccess<T,Descriptor>())
+      multiCellAccess(defaultMultiBlockPolicy3D().getMultiCellAccess<T,Descriptor>()),
+      propagationScheme(propagation::swap),
+      streamIsPending(false),
+      communicationIsOverlapped(false),
+      collisionPolicy(0)
 {
     allocateAndInitialize();
     eliminateStatisticsInEnvelope();
@@ -88,7 +99,11 @@ MultiBlockLattice3D<T,Descriptor>::MultiBlockLattice3D (
 template<typename T, template<typename U> class Descriptor>
 MultiBlockLattice3D<T,Descriptor>::MultiBlockLattice3D(BlockMap& blockLattices_, Dynamics<T,Descriptor>* backgroundDynamics_):
 backgroundDynamics(backgroundDynamics_),
-multiCellAccess(defaultMultiBlockPolicy3D().getMultiCellAccess<T,Descriptor>())
+multiCellAccess(defaultMultiBlockPolicy3D().getMultiCellAccess<T,Descriptor>()),
+propagationScheme(propagation::swap),
+streamIsPending(false),
+communicationIsOverlapped(false),
+collisionPolicy(0)
 {
 	this->blockLattices = blockLattices_;
     //allocateAndInitialize();
@@ -105,6 +120,7 @@ MultiBlockLattice3D<T,Descriptor>::~MultiBlockLattice3D() {
     }
     delete backgroundDynamics;
     delete multiCellAccess;
+    delete collisionPolicy;
 }
 
 template<typename T, template<typename U> class Descriptor>
@@ -112,7 +128,11 @@ MultiBlockLattice3D<T,Descriptor>::MultiBlockLattice3D(MultiBlockLattice3D<T,Des
     : BlockLatticeBase3D<T,Descriptor>(rhs),
       MultiBlock3D(rhs),
       backgroundDynamics(rhs.backgroundDynamics->clone()),
-      multiCellAccess(rhs.multiCellAccess->clone())
+      multiCellAccess(rhs.multiCellAccess->clone()),
+      propagationScheme(rhs.propagationScheme),
+      streamIsPending(rhs.streamIsPending),
+      communicationIsOverlapped(rhs.communicationIsOverlapped),
+      collisionPolicy(rhs.collisionPolicy ? rhs.collisionPolicy->clone() : 0)
 {
     for ( typename  BlockMap::const_iterator it = rhs.blockLattices.begin();
           it != rhs.blockLattices.end(); ++it )
@@ -126,7 +146,11 @@ MultiBlockLattice3D<T,Descriptor>::MultiBlockLattice3D(MultiBlock3D const& rhs)
       // Use MultiBlock's sub-domain constructor to avoid that the data-processors are copied
     : MultiBlock3D(rhs, rhs.getBoundingBox(), false),
       backgroundDynamics(new NoDynamics<T,Descriptor>),
-      multiCellAccess(defaultMultiBlockPolicy3D().getMultiCellAccess<T,Descriptor>())
+      multiCellAccess(defaultMultiBlockPolicy3D().getMultiCellAccess<T,Descriptor>()),
+      propagationScheme(propagation::swap),
+      streamIsPending(false),
+      communicationIsOverlapped(false),
+      collisionPolicy(0)
 {
     allocateAndInitialize();
     eliminateStatisticsInEnvelope();
@@ -136,7 +160,11 @@ template<typename T, template<typename U> class Descriptor>
 MultiBlockLattice3D<T,Descriptor>::MultiBlockLattice3D(MultiBlock3D const& rhs, Box3D subDomain, bool crop)
     : MultiBlock3D(rhs, subDomain, crop),
       backgroundDynamics(new NoDynamics<T,Descriptor>),
-      multiCellAccess(defaultMultiBlockPolicy3D().getMultiCellAccess<T,Descriptor>())
+      multiCellAccess(defaultMultiBlockPolicy3D().getMultiCellAccess<T,Descriptor>()),
+      propagationScheme(propagation::swap),
+      streamIsPending(false),
+      communicationIsOverlapped(false),
+      collisionPolicy(0)
 {
     allocateAndInitialize();
     eliminateStatisticsInEnvelope();
@@ -149,6 +177,29 @@ void MultiBlockLattice3D<T,Descriptor>::swap(MultiBlockLattice3D<T,Descriptor>&
     std::swap(backgroundDynamics, rhs.backgroundDynamics);
     std::swap(multiCellAccess, rhs.multiCellAccess);
     blockLattices.swap(rhs.blockLattices);
+    std::swap(propagationScheme, rhs.propagationScheme);
+    std::swap(streamIsPending, rhs.streamIsPending);
+    std::swap(communicationIsOverlapped, rhs.communicationIsOverlapped);
+    std::swap(collisionPolicy, rhs.collisionPolicy);
+}
+
+template<typename T, template<typename U> class Descriptor>
+void MultiBlockLattice3D<T,Descriptor>::swapDistribution(MultiBlock3D& rhs) {
+    MultiBlockLattice3D<T,Descriptor>* rhsLattice =
+        dynamic_cast<MultiBlockLattice3D<T,Descriptor>*>(&rhs);
+    PLB_ASSERT( rhsLattice );
+    PLB_PRECONDITION( !rhsLattice->streamIsPending );
+    completeStream();
+    this->swapManagement(rhs);
+    std::swap(multiCellAccess, rhsLattice->multiCellAccess);
+    blockLattices.swap(rhsLattice->blockLattices);
+    // The new atomic-blocks continue from the current time step.
+    for ( typename BlockMap::iterator it = blockLattices.begin();
+          it != blockLattices.end(); ++it )
+    {
+        it->second->getTimeCounter().resetTime(this->getTimeCounter().getTime());
+        it->second->setCollisionPolicy(collisionPolicy ? collisionPolicy->clone() : 0);
+    }
 }
 
 template<typename T, template<typename U> class Descriptor>
@@ -179,6 +230,9 @@ MultiBlockLattice3D<T,Descriptor>*
                 multiCellAccess->clone(),
                 getBackgroundDynamics().clone() );
     copy(*this, this->getBoundingBox(), *newLattice, newLattice->getBoundingBox(), modif::dataStructure);
+    if (collisionPolicy) {
+        newLattice->setCollisionPolicy(collisionPolicy->clone());
+    }
     return newLattice;
 }
 
@@ -316,9 +370,34 @@ void MultiBlockLattice3D<T,Descriptor>::collideAndStream(Box3D domain) {
 
 template<typename T, template<typename U> class Descriptor>
 void MultiBlockLattice3D<T,Descriptor>::collideAndStream() {
+    PLB_TRACE_SCOPE("collideAndStream");
     global::profiler().start("cycle");
     ThreadAttribution const& threadAttribution=this->getMultiBlockManagement().getThreadAttribution();
-    if (threadAttribution.hasCoProcessors()) {
+    // Internal processors need the populations in natural order after each
+    //   step, and co-processors stream on their own: the AA-pattern is then
+    //   replaced by the swap scheme.
+    propagation::SchemeT blockScheme = propagation::swap;
+    if ( propagationScheme==propagation::aa &&
+         !this->hasInternalProcessors() && !threadAttribution.hasCoProcessors() )
+    {
+        blockScheme = propagation::aa;
+    }
+    else {
+        completeStream();
+    }
+    for ( typename BlockMap::iterator it = blockLattices.begin();
+          it != blockLattices.end(); ++it )
+    {
+        it->second -> setPropagationScheme(blockScheme);
+    }
+    // The envelope can be sent early only if no internal processor acts
+    //   on the populations after the collision-streaming step.
+    bool overlapCommunication = communicationIsOverlapped && blockScheme==propagation::swap &&
+                                !this->hasInternalProcessors() && !threadAttribution.hasCoProcessors();
+    if (overlapCommunication) {
+        overlappedCollideAndStream();
+    }
+    else if (threadAttribution.hasCoProcessors()) {
         for ( typename BlockMap::iterator it = blockLattices.begin();
               it != blockLattices.end(); ++it )
         {
@@ -337,10 +416,14 @@ void MultiBlockLattice3D<T,Descriptor>::collideAndStream() {
             }
         }
     }
+    else if (global::threadPool().isThreaded()) {
+        threadedCollideAndStream();
+    }
     else  {
         for ( typename BlockMap::iterator it = blockLattices.begin();
               it != blockLattices.end(); ++it)
         {
+            PLB_TRACE_SCOPE("block.collideAndStream");
             SmartBulk3D bulk(this->getMultiBlockManagement(), it->first);
             // CollideAndStream must be applied to full domain,
             //   including currently active envelopes.
@@ -349,7 +432,14 @@ void MultiBlockLattice3D<T,Descriptor>::collideAndStream() {
             it->second -> collideAndStream( bulk.toLocal(domain) );
         }
     }
-    this->executeInternalProcessors();
+    if (blockScheme==propagation::aa) {
+        streamIsPending = !streamIsPending;
+    }
+    // After the collision step of the AA-pattern, the envelope already
+    //   holds the same values as the bulk of the neighboring blocks.
+    if (!streamIsPending && !overlapCommunication) {
+        this->executeInternalProcessors();
+    }
     this->evaluateStatistics();
     this->incrementTime();
     if (global::profiler().cyclingIsAutomatic()) {
@@ -358,6 +448,126 @@ void MultiBlockLattice3D<T,Descriptor>::collideAndStream() {
     global::profiler().stop("cycle");
 }
 
+template<typename T, template<typename U> class Descriptor>
+void MultiBlockLattice3D<T,Descriptor>::threadedCollideAndStream() {
+    ThreadAttribution const& threadAttribution=this->getMultiBlockManagement().getThreadAttribution();
+    plint envelopeWidth = this->getMultiBlockManagement().getEnvelopeWidth();
+    std::vector<global::ThreadPool::Task> tasks;
+    std::vector<plint> preferredThread;
+    plint numCells = 0;
+    for ( typename BlockMap::iterator it = blockLattices.begin();
+          it != blockLattices.end(); ++it)
+    {
+        SmartBulk3D bulk(this->getMultiBlockManagement(), it->first);
+        // CollideAndStream must be applied to full domain,
+        //   including currently active envelopes.
+        Box3D domain = bulk.toLocal(extendPeriodic(bulk.computeNonPeriodicEnvelope(), envelopeWidth));
+        BlockLattice3D<T,Descriptor>* block = it->second;
+        if (!block->hasPendingStream() && block->isIdle()) {
+            continue;
+        }
+        tasks.push_back([block,domain]() {
+                PLB_TRACE_SCOPE("block.collideAndStream");
+                block->collideAndStream(domain); });
+        preferredThread.push_back(threadAttribution.getLocalThreadId(it->first));
+        numCells += domain.nCells();
+    }
+    // The profiler is suspended inside the thread pool; the time spent in
+    //   collision-streaming is accounted for globally instead of per block.
+    global::profiler().start("collStream");
+    global::profiler().incrementCollStream(numCells, 2*Descriptor<T>::q*sizeof(T));
+    global::threadPool().execute(tasks, preferredThread);
+    global::profiler().stop("collStream");
+}
+
+/** The cells which are sent to the envelope of other blocks lie at a
+ *  distance smaller than twice the envelope width from the border of the
+ *  collision-streaming domain. Their shell is processed first, then the
+ *  communication is initiated, and the interior of the blocks is processed
+ *  while the messages are in flight.
+ */
+template<typename T, template<typename U> class Descriptor>
+void MultiBlockLattice3D<T,Descriptor>::overlappedCollideAndStream() {
+    ThreadAttribution const& threadAttribution=this->getMultiBlockManagement().getThreadAttribution();
+    plint envelopeWidth = this->getMultiBlockManagement().getEnvelopeWidth();
+    plint shellWidth = 2*envelopeWidth + Descriptor<T>::vicinity;
+    std::vector<global::ThreadPool::Task> shellTasks, interiorTasks;
+    std::vector<plint> preferredThread;
+    for ( typename BlockMap::iterator it = blockLattices.begin();
+          it != blockLattices.end(); ++it)
+    {
+        SmartBulk3D bulk(this->getMultiBlockManagement(), it->first);
+        Box3D domain = bulk.toLocal(extendPeriodic(bulk.computeNonPeriodicEnvelope(), envelopeWidth));
+        BlockLattice3D<T,Descriptor>* block = it->second;
+        // As in threadedCollideAndStream(), idle blocks are left unchanged.
+        if (!block->hasPendingStream() && block->isIdle()) {
+            continue;
+        }
+        shellTasks.push_back([block,domain,shellWidth]() {
+                PLB_TRACE_SCOPE("block.collideAndStreamShell");
+                block->collideAndStreamShell(domain, shellWidth); });
+        interiorTasks.push_back([block,domain,shellWidth]() {
+                PLB_TRACE_SCOPE("block.collideAndStreamInterior");
+                block->collideAndStreamInterior(domain, shellWidth); });
+        preferredThread.push_back(threadAttribution.getLocalThreadId(it->first));
+    }
+    bool threaded = global::threadPool().isThreaded();
+    if (threaded) global::profiler().start("collStream");
+    global::threadPool().execute(shellTasks, preferredThread);
+    if (threaded) global::profiler().stop("collStream");
+
+    modif::ModifT whichData = this->getInternalTypeOfModification();
+    global::profiler().start("envelope-update");
+    this->getBlockCommunicator().startDuplicateOverlaps(*this, whichData);
+    global::profiler().stop("envelope-update");
+
+    if (threaded) global::profiler().start("collStream");
+    global::threadPool().execute(interiorTasks, preferredThread);
+    if (threaded) global::profiler().stop("collStream");
+
+    global::profiler().start("envelope-update");
+    this->getBlockCommunicator().completeDuplicateOverlaps(*this, whichData);
+    global::profiler().stop("envelope-update");
+}
+
+template<typename T, template<typename U> class Descriptor>
+void MultiBlockLattice3D<T,Descriptor>::setCollisionPolicy(CollisionPolicy3D<T,Descriptor>* policy) {
+    delete collisionPolicy;
+    collisionPolicy = policy;
+    for ( typename BlockMap::iterator it = blockLattices.begin();
+          it != blockLattices.end(); ++it )
+    {
+        it->second->setCollisionPolicy(collisionPolicy ? collisionPolicy->clone() : 0);
+    }
+}
+
+template<typename T, template<typename U> class Descriptor>
+void MultiBlockLattice3D<T,Descriptor>::setPropagationScheme(propagation::SchemeT scheme) {
+    if ( scheme==propagation::aa &&
+         this->getMultiBlockManagement().getEnvelopeWidth() < 2*Descriptor<T>::vicinity )
+    {
+        throw PlbLogicException("The AA propagation pattern requires a multi-block "
+                                "lattice with an envelope of width 2*vicinity.");
+    }
+    if (scheme==propagation::swap) {
+        completeStream();
+    }
+    propagationScheme = scheme;
+}
+
+template<typename T, template<typename U> class Descriptor>
+void MultiBlockLattice3D<T,Descriptor>::completeStream() {
+    if (streamIsPending) {
+        for ( typename BlockMap::iterator it = blockLattices.begin();
+              it != blockLattices.end(); ++it )
+        {
+            it->second -> completeStream();
+        }
+        this->duplicateOverlaps(modif::staticVariables);
+        streamIsPending = false;
+    }
+}
+
 template<typename T, template<typename U> class Descriptor>
 void MultiBlockLattice3D<T,Descriptor>::incrementTime() {
     for ( typename BlockMap::iterator it = blockLattices.begin();
@@ -395,8 +605,32 @@ void MultiBlockLattice3D<T,Descriptor>::allocateAndInitialize()
                     envelope.getNx(), envelope.getNy(), envelope.getNz(),
                     backgroundDynamics->clone() );
         newLattice -> setLocation(Dot3D(envelope.x0, envelope.y0, envelope.z0));
+        if (collisionPolicy) {
+            newLattice -> setCollisionPolicy(collisionPolicy->clone());
+        }
         blockLattices[blockId] = newLattice;
     }
+    updateActivityDomains();
+}
+
+template<typename T, template<typename U> class Descriptor>
+void MultiBlockLattice3D<T,Descriptor>::updateActivityDomains()
+{
+    plint envelopeWidth = this->getMultiBlockManagement().getEnvelopeWidth();
+    for ( typename BlockMap::iterator it = blockLattices.begin();
+          it != blockLattices.end(); ++it )
+    {
+        SmartBulk3D bulk(this->getMultiBlockManagement(), it->first);
+        Box3D domain = extendPeriodic(bulk.computeNonPeriodicEnvelope(), envelopeWidth);
+        it->second -> setActivityDomain(bulk.toLocal(domain));
+    }
+}
+
+template<typename T, template<typename U> class Descriptor>
+void MultiBlockLattice3D<T,Descriptor>::signalPeriodicity()
+{
+    MultiBlock3D::signalPeriodicity();
+    updateActivityDomains();
 }
 
 template<typename T, template<typename U> class Descriptor>
@@ -546,6 +780,19 @@ double getStoredMaxVelocity(MultiBlockLattice3D<T,Descriptor> const& blockLattic
                              LatticeStatistics::maxUSqr ) );
 }
 
+template<typename T, template<typename U> class Descriptor>
+std::vector<plint> countBlockActivity(MultiBlockLattice3D<T,Descriptor> const& blockLattice) {
+    std::vector<plint> numBlocks(3, 0);
+    std::vector<plint> const& blocks = blockLattice.getLocalInfo().getBlocks();
+    for (pluint iBlock=0; iBlock<blocks.size(); ++iBlock) {
+        ++numBlocks[blockLattice.getComponent(blocks[iBlock]).getActivity()];
+    }
+#ifdef PLB_MPI_PARALLEL
+    global::mpi().allReduceVect(numBlocks, MPI_SUM);
+#endif
+    return numBlocks;
+}
+
 }  // namespace plb
 
 #endif  // MULTI_BLOCK_LATTICE_3D_HH
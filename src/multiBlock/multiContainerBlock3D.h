@@ -52,6 +52,9 @@ public:
     MultiContainerBlock3D* clone() const;
     MultiContainerBlock3D* clone(MultiBlockManagement3D const& multiBlockManagement) const;
     void swap(MultiContainerBlock3D& rhs);
+    /// Container data cannot be transferred: after the exchange, this block
+    ///   holds the atomic containers of rhs, together with their data.
+    virtual void swapDistribution(MultiBlock3D& rhs);
 public:
 	std::vector<AtomicContainerBlock3D*> getAtomics();
     virtual AtomicContainerBlock3D& getComponent(plint iBlock);
@@ -78,6 +78,7 @@ public:
     MultiScalarField3D<T>* clone() const;
     MultiScalarField3D<T>* clone(MultiBlockManagement3D const& newMultiBlockManagement) const;
     void swap(MultiScalarField3D<T>& rhs);
+    virtual void swapDistribution(MultiBlock3D& rhs);
 public: 
     virtual void reset();
     virtual T& get(plint iX, plint iY, plint iZ);
@@ -154,6 +155,7 @@ public:
     MultiTensorField3D<T,nDim>* clone() const;
     MultiTensorField3D<T,nDim>* clone(MultiBlockManagement3D const& newMultiBlockManagement) const;
     void swap(MultiTensorField3D<T,nDim>& rhs);
+    virtual void swapDistribution(MultiBlock3D& rhs);
 public:
     virtual void reset();
     virtual Array<T,nDim>& get(plint iX, plint iY, plint iZ);
@@ -232,6 +234,7 @@ public:
     MultiNTensorField3D<T>* clone() const;
     MultiNTensorField3D<T>* clone(MultiBlockManagement3D const& newMultiBlockManagement) const;
     void swap(MultiNTensorField3D<T>& rhs);
+    virtual void swapDistribution(MultiBlock3D& rhs);
 public:
     virtual void reset();
     virtual T* get(plint iX, plint iY, plint iZ);
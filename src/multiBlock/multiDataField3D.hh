@@ -143,6 +143,15 @@ void MultiScalarField3D<T>::swap(MultiScalarField3D<T>& rhs) {
     std::swap(multiScalarAccess, rhs.multiScalarAccess);
 }
 
+template<typename T>
+void MultiScalarField3D<T>::swapDistribution(MultiBlock3D& rhs) {
+    MultiScalarField3D<T>* rhsField = dynamic_cast<MultiScalarField3D<T>*>(&rhs);
+    PLB_ASSERT( rhsField );
+    this->swapManagement(rhs);
+    fields.swap(rhsField->fields);
+    std::swap(multiScalarAccess, rhsField->multiScalarAccess);
+}
+
 template<typename T>
 void MultiScalarField3D<T>::reset() {
     for ( typename BlockMap::iterator it = fields.begin();
@@ -388,6 +397,15 @@ void MultiTensorField3D<T,nDim>::swap(MultiTensorField3D<T,nDim>& rhs) {
     std::swap(multiTensorAccess, rhs.multiTensorAccess);
 }
 
+template<typename T, int nDim>
+void MultiTensorField3D<T,nDim>::swapDistribution(MultiBlock3D& rhs) {
+    MultiTensorField3D<T,nDim>* rhsField = dynamic_cast<MultiTensorField3D<T,nDim>*>(&rhs);
+    PLB_ASSERT( rhsField );
+    this->swapManagement(rhs);
+    fields.swap(rhsField->fields);
+    std::swap(multiTensorAccess, rhsField->multiTensorAccess);
+}
+
 template<typename T, int nDim>
 void MultiTensorField3D<T,nDim>::reset() {
     for ( typename BlockMap::iterator it = fields.begin();
@@ -650,6 +668,15 @@ void MultiNTensorField3D<T>::swap(MultiNTensorField3D<T>& rhs) {
     std::swap(multiNTensorAccess, rhs.multiNTensorAccess);
 }
 
+template<typename T>
+void MultiNTensorField3D<T>::swapDistribution(MultiBlock3D& rhs) {
+    MultiNTensorField3D<T>* rhsField = dynamic_cast<MultiNTensorField3D<T>*>(&rhs);
+    PLB_ASSERT( rhsField && rhsField->getNdim()==this->getNdim() );
+    this->swapManagement(rhs);
+    fields.swap(rhsField->fields);
+    std::swap(multiNTensorAccess, rhsField->multiNTensorAccess);
+}
+
 template<typename T>
 void MultiNTensorField3D<T>::reset() {
     for ( typename BlockMap::iterator it = fields.begin();
@@ -28,7 +28,11 @@
 
 #include "core/globalDefs.h"
 #include "multiBlock/redistribution3D.h"
+#include "core/array.h"
+#include "core/plbDebug.h"
 #include <cstdlib>
+#include <algorithm>
+#include <vector>
 
 namespace plb {
 
@@ -69,5 +73,139 @@ MultiBlockManagement3D RandomRedistribute3D::redistribute (
             original.getEnvelopeWidth(), original.getRefinementLevel() );
 }
 
+namespace {
+
+/// Index along the Hilbert curve of a point with coordinates in [0, 2^numBits),
+///   after J. Skilling, "Programming the Hilbert curve", AIP Conf. Proc. 707 (2004).
+pluint hilbertIndex3D(Array<pluint,3> x, plint numBits)
+{
+    pluint highBit = (pluint)1 << (numBits-1);
+    // Inverse undo excess work.
+    for (pluint q=highBit; q>1; q>>=1) {
+        pluint p = q-1;
+        for (int i=0; i<3; ++i) {
+            if (x[i] & q) {
+                x[0] ^= p;
+            }
+            else {
+                pluint t = (x[0]^x[i]) & p;
+                x[0] ^= t;
+                x[i] ^= t;
+            }
+        }
+    }
+    // Gray encode.
+    x[1] ^= x[0];
+    x[2] ^= x[1];
+    pluint t = 0;
+    for (pluint q=highBit; q>1; q>>=1) {
+        if (x[2] & q) t ^= q-1;
+    }
+    for (int i=0; i<3; ++i) x[i] ^= t;
+    // Interleave the transposed bits.
+    pluint index = 0;
+    for (plint bit=numBits-1; bit>=0; --bit) {
+        for (int i=0; i<3; ++i) {
+            index = (index << 1) | ((x[i] >> bit) & 1);
+        }
+    }
+    return index;
+}
+
+/// Cut a sequence of costs into numParts contiguous pieces of nearly equal
+///   total cost; an item goes to the piece which contains its midpoint.
+std::vector<plint> cutByCost(std::vector<double> const& costs, plint numParts)
+{
+    double totalCost = 0.;
+    for (pluint i=0; i<costs.size(); ++i) {
+        totalCost += costs[i];
+    }
+    std::vector<plint> parts(costs.size());
+    double cumulatedCost = 0.;
+    for (pluint i=0; i<costs.size(); ++i) {
+        plint part = 0;
+        if (totalCost > 0.) {
+            part = (plint)((cumulatedCost + 0.5*costs[i]) / totalCost * (double)numParts);
+        }
+        else {
+            part = (plint)i*numParts / (plint)costs.size();
+        }
+        parts[i] = std::min(part, numParts-1);
+        cumulatedCost += costs[i];
+    }
+    return parts;
+}
+
+}  // namespace
+
+WeightedHilbertRedistribute3D::WeightedHilbertRedistribute3D (
+        std::map<plint,double> const& blockCosts_, plint numProcesses_, plint numThreads_ )
+    : blockCosts(blockCosts_),
+      numProcesses(numProcesses_),
+      numThreads(numThreads_)
+{
+    PLB_ASSERT( numProcesses>0 && numThreads>0 );
+}
+
+MultiBlockManagement3D WeightedHilbertRedistribute3D::redistribute (
+        MultiBlockManagement3D const& original ) const
+{
+    SparseBlockStructure3D const& originalSparseBlock = original.getSparseBlockStructure();
+    std::map<plint,Box3D> const& domains = originalSparseBlock.getBulks();
+    Box3D boundingBox = originalSparseBlock.getBoundingBox();
+
+    plint maxExtent = std::max(boundingBox.getNx(), std::max(boundingBox.getNy(), boundingBox.getNz()));
+    plint numBits = 1;
+    while (numBits<21 && ((plint)1 << numBits) < maxExtent) {
+        ++numBits;
+    }
+
+    // Order the blocks along the curve; the block ID breaks ties.
+    std::vector<std::pair<pluint,plint> > curve;
+    curve.reserve(domains.size());
+    std::map<plint,Box3D>::const_iterator it = domains.begin();
+    for (; it != domains.end(); ++it) {
+        Box3D const& bulk = it->second;
+        Array<pluint,3> center (
+                (pluint)((bulk.x0+bulk.x1)/2 - boundingBox.x0),
+                (pluint)((bulk.y0+bulk.y1)/2 - boundingBox.y0),
+                (pluint)((bulk.z0+bulk.z1)/2 - boundingBox.z0) );
+        curve.push_back(std::make_pair(hilbertIndex3D(center, numBits), it->first));
+    }
+    std::sort(curve.begin(), curve.end());
+
+    std::vector<double> costs(curve.size());
+    for (pluint i=0; i<curve.size(); ++i) {
+        plint blockId = curve[i].second;
+        std::map<plint,double>::const_iterator cost = blockCosts.find(blockId);
+        if (cost != blockCosts.end()) {
+            costs[i] = cost->second;
+        }
+        else {
+            costs[i] = (double)domains.find(blockId)->second.nCells();
+        }
+    }
+    std::vector<plint> procs = cutByCost(costs, numProcesses);
+
+    ExplicitThreadAttribution* newAttribution = new ExplicitThreadAttribution;
+    pluint begin = 0;
+    while (begin<curve.size()) {
+        pluint end = begin;
+        while (end<curve.size() && procs[end]==procs[begin]) {
+            ++end;
+        }
+        std::vector<double> procCosts(costs.begin()+begin, costs.begin()+end);
+        std::vector<plint> threads = cutByCost(procCosts, numThreads);
+        for (pluint i=begin; i<end; ++i) {
+            newAttribution->addBlock(curve[i].second, procs[i], threads[i-begin]);
+        }
+        begin = end;
+    }
+
+    return MultiBlockManagement3D (
+            originalSparseBlock, newAttribution,
+            original.getEnvelopeWidth(), original.getRefinementLevel() );
+}
+
 }  // namespace plb
 
@@ -32,6 +32,7 @@
 #include "parallelism/mpiManager.h"
 #include "core/globalDefs.h"
 #include "multiBlock/multiBlockManagement3D.h"
+#include <map>
 
 namespace plb {
 
@@ -48,6 +49,22 @@ private:
     pluint rseed;
 };
 
+/// Attribute the blocks to the processes by cutting a Hilbert curve, which
+///   runs through the block centers, into pieces of equal cost. The blocks of
+///   a process are attributed to its threads in the same way. Blocks without
+///   an entry in the cost map are assumed to cost their number of cells.
+class WeightedHilbertRedistribute3D : public MultiBlockRedistribute3D {
+public:
+    WeightedHilbertRedistribute3D(std::map<plint,double> const& blockCosts_,
+                                  plint numProcesses_=global::mpi().getSize(),
+                                  plint numThreads_=1);
+    virtual MultiBlockManagement3D redistribute(MultiBlockManagement3D const& original) const;
+private:
+    std::map<plint,double> blockCosts;
+    plint numProcesses;
+    plint numThreads;
+};
+
 }  // namespace plb
 
 #endif  // REDISTRIBUTION_3D_H
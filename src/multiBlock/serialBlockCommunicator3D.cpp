@@ -66,6 +66,13 @@ void SerialBlockCommunicator3D::copyOverlap (
 
     AtomicBlock3D const* originalBlock = &fromMultiBlock.getComponent(originalId);
     AtomicBlock3D* overlapBlock = &toMultiBlock.getComponent(overlapId);
+    // The envelope of idle blocks is not updated, except for changes of the
+    //   data structure, which can make them active again.
+    if ( &fromMultiBlock==&toMultiBlock && whichData!=modif::dataStructure &&
+         overlapBlock->isIdle() )
+    {
+        return;
+    }
     plint deltaX = originalCoords.x0 - overlapCoords.x0;
     plint deltaY = originalCoords.y0 - overlapCoords.y0;
     plint deltaZ = originalCoords.z0 - overlapCoords.z0;
@@ -215,6 +215,7 @@ void LatticeCopyFineToCoarseZerothOrder3D<T,Descriptor>::process (
                 divideAndFitSmaller(stretch).                        // Rescale, but don't exceed original domain.
                     shift(-posCoarse.x,-posCoarse.y,-posCoarse.z) ); // Convert to relative coarse coordinates.
     PLB_ASSERT( contained(coarseDomain, coarseLattice.getBoundingBox()) );
+    coarseLattice.invalidateActivity();
 
     plint fineX = (coarseDomain.x0+posCoarse.x)*stretch - posFine.x;
     for (plint coarseX=coarseDomain.x0; coarseX<=coarseDomain.x1; ++coarseX, fineX+=stretch) {
@@ -317,6 +318,7 @@ void LatticeCopyFineToCoarseNoScale3D<T,Descriptor>::process (
                 divideAndFitSmaller(stretch).                        // Rescale, but don't exceed original domain.
                     shift(-posCoarse.x,-posCoarse.y,-posCoarse.z) ); // Convert to relative coarse coordinates.
     PLB_ASSERT( contained(coarseDomain, coarseLattice.getBoundingBox()) );
+    coarseLattice.invalidateActivity();
 
     plint fineX = (coarseDomain.x0+posCoarse.x)*stretch - posFine.x;
     for (plint coarseX=coarseDomain.x0; coarseX<=coarseDomain.x1; ++coarseX, fineX+=stretch) {
@@ -12,6 +12,7 @@
 #include "obstacle.h"
 #include "variables.h"
 #include "output.h"
+#include "sweep.h"
 #include "helper.h"
 
 
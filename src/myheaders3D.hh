@@ -11,6 +11,7 @@
 #include "obstacle.hh"
 #include "variables.hh"
 #include "output.hh"
+#include "sweep.hh"
 #include "helper.hh"
 
 
@@ -13,8 +13,12 @@ public:
 
 	void update(const TriangleBoundary3D<T>* tb);
 
+	// Take the normals from a rigid body instead of the last update().
+	void setBody(const RigidBody3D<T>* body);
+
 private:
 	static std::vector<Array<T,3> > normals;
+	static const RigidBody3D<T>* body;
 	static bool master;
 };
 
@@ -29,6 +33,9 @@ std::vector<Array<T,3> > SurfaceNormal<T>::normals;
 template<typename T>
 bool SurfaceNormal<T>::master= false;
 
+template<typename T>
+const RigidBody3D<T>* SurfaceNormal<T>::body = nullptr;
+
 }
 
 #endif
@@ -29,9 +29,17 @@ namespace plb{
 	template<typename T>
 	Array<T,3> SurfaceNormal<T>::operator()(const pluint& id)
 	{
+		if(body){ return body->getNormal(id); }
 		return normals[id];
 	}
 
+	template<typename T>
+	void SurfaceNormal<T>::setBody(const RigidBody3D<T>* _body)
+	{
+		body = _body;
+		normals.clear();
+	}
+
 	template<typename T>
 	void SurfaceNormal<T>::update(const TriangleBoundary3D<T>* tb){
 		plint numVertices = tb->getMesh().getNumVertices();
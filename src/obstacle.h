@@ -18,6 +18,10 @@ public:
 
 	~Obstacle();
 // Methods
+	// Read the STL file on the main processor and start broadcasting it to the other processors,
+	// the transfer is completed in initialize().
+	static void loadMesh();
+
 	void initialize();
 
 	static Array<T,3> getCenter(const ConnectedTriangleSet<T>& triangles);
@@ -35,11 +39,29 @@ public:
 	// Function to Move Obstacle to it's starting position
 	static void moveToStart();
 
+	// Rebuild the rigid body from the present position of the mesh of tb.
+	static void createBody();
+
 	static void updateImmersedWall();
 
+	// Re-voxelize the region swept by the obstacle since it covered previousDomain, and update
+	// the dynamics and the boundary condition of the lattice in this region only.
+	static void reVoxelize(const Box3D& previousDomain);
+
 	// Function to Move the Obstacle through the Fluid
 	bool move();
 
+	// Write the state of the rigid body (mesh position and kinematics) to a checkpoint.
+	static void save(parallelIO::CheckpointWriter& checkpoint);
+	static void save(parallelIO::CheckpointRecord& record);
+
+	// Restore the state of the rigid body from a checkpoint, and re-voxelize the lattice around it.
+	static void load(parallelIO::CheckpointReader& checkpoint);
+	// The state may come from another grid level: the vertices are then mapped to x/dxRatio+offset, and the
+	// kinematics rescaled to the lattice units of the present level.
+	static void load(parallelIO::CheckpointRecord& record, const T& dxRatio = 1, const T& dtRatio = 1,
+		const Array<T,3>& offset = Array<T,3>(0,0,0));
+
 // Attributes
 	static bool firstMove;
 	static int flowType;
@@ -57,10 +79,14 @@ public:
 	static std::unique_ptr<TriangleFlowShape3D<T,SurfaceData> > fs;
 	static std::unique_ptr<GuoOffLatticeModel3D<T,Descriptor> > model;
 	static std::unique_ptr<OffLatticeBoundaryCondition3D<T,Descriptor,BoundaryType> > bc;
+	static std::shared_ptr<ImmersedWallVertexBuffer3D<T> > wallBuffer;
+	static std::unique_ptr<RigidBody3D<T> > body;
 	static std::unique_ptr<Obstacle<T,BoundaryType,SurfaceData,Descriptor> > o;
 	static SurfaceVelocity<T> velocityFunc;
 private:
 	static SurfaceNormal<T> normalFunc;
+	static global::TriangleSetTransfer<T> meshTransfer;
+	static bool meshLoading;
 	static Array<T,3> rotation_LB, velocity_LB, rotationalVelocity_LB, acceleration_LB, rotationalAcceleration_LB, location_LB;
 	static bool master;
 };
@@ -164,12 +190,24 @@ std::unique_ptr<GuoOffLatticeModel3D<T,Descriptor> > Obstacle<T,BoundaryType,Sur
 template<typename T, class BoundaryType, class SurfaceData, template<class U> class Descriptor>
 std::unique_ptr<OffLatticeBoundaryCondition3D<T,Descriptor,BoundaryType> > Obstacle<T,BoundaryType,SurfaceData,Descriptor>::bc(nullptr);
 
+template<typename T, class BoundaryType, class SurfaceData, template<class U> class Descriptor>
+std::shared_ptr<ImmersedWallVertexBuffer3D<T> > Obstacle<T,BoundaryType,SurfaceData,Descriptor>::wallBuffer(nullptr);
+
+template<typename T, class BoundaryType, class SurfaceData, template<class U> class Descriptor>
+std::unique_ptr<RigidBody3D<T> > Obstacle<T,BoundaryType,SurfaceData,Descriptor>::body(nullptr);
+
 template<typename T, class BoundaryType, class SurfaceData, template<class U> class Descriptor>
 SurfaceVelocity<T> Obstacle<T,BoundaryType,SurfaceData,Descriptor>::velocityFunc = SurfaceVelocity<T>();
 
 template<typename T, class BoundaryType, class SurfaceData, template<class U> class Descriptor>
 SurfaceNormal<T> Obstacle<T,BoundaryType,SurfaceData,Descriptor>::normalFunc = SurfaceNormal<T>();
 
+template<typename T, class BoundaryType, class SurfaceData, template<class U> class Descriptor>
+global::TriangleSetTransfer<T> Obstacle<T,BoundaryType,SurfaceData,Descriptor>::meshTransfer;
+
+template<typename T, class BoundaryType, class SurfaceData, template<class U> class Descriptor>
+bool Obstacle<T,BoundaryType,SurfaceData,Descriptor>::meshLoading = false;
+
 template<typename T, class BoundaryType, class SurfaceData, template<class U> class Descriptor>
 std::unique_ptr<Obstacle<T,BoundaryType,SurfaceData,Descriptor> > Obstacle<T,BoundaryType,SurfaceData,Descriptor>::o(nullptr);
 
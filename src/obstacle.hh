@@ -44,6 +44,22 @@ namespace plb{
 		objCount--;
 	}
 
+	template<typename T, class BoundaryType, class SurfaceData, template<class U> class Descriptor>
+	void Obstacle<T,BoundaryType,SurfaceData,Descriptor>::loadMesh()
+	{
+		try{
+			if(meshLoading){ return; }
+			std::string meshFileName = Constants<T>::obstacle.fileName;
+			if(global::mpi().isMainProcessor()){
+				TriangleSet<T> surface(meshFileName, Constants<T>::precision, STL);
+				global::mpiData().iSendTriangleSet<T>(surface, meshTransfer);
+			}
+			else{ global::mpiData().iReceiveTriangleSet<T>(meshTransfer); }
+			meshLoading = true;
+		}
+		catch(const std::exception& e){exHandler(e,__FILE__,__FUNCTION__,__LINE__);}
+	}
+
 	template<typename T, class BoundaryType, class SurfaceData, template<class U> class Descriptor>
 	void Obstacle<T,BoundaryType,SurfaceData,Descriptor>::initialize()
 	{
@@ -63,16 +79,9 @@ namespace plb{
 			rotation[0] = 0;	rotation[1] = 0; rotation[2] = 0;
 			rotationalVelocity[0] = 0;	rotationalVelocity[1] = 0;	rotationalVelocity[2] = 0;
 			rotationalAcceleration[0] = 0;	rotationalAcceleration[1] = 0;	rotationalAcceleration[2] = 0;
-			TriangleSet<T> surface;
-			#ifdef PLB_MPI_PARALLEL
-				if(global::mpi().isMainProcessor()){
-					surface = TriangleSet<T>(meshFileName, Constants<T>::precision, STL);
-					global::mpiData().sendTriangleSet<T>(surface);
-				}
-				else{ surface = global::mpiData().receiveTriangleSet<T>(); }
-			#else
-				surface = TriangleSet<T>(meshFileName, Constants<T>::precision, STL);
-			#endif
+			loadMesh();
+			TriangleSet<T> surface = meshTransfer.complete();
+			meshLoading = false;
 
 			Box3D domain = getDomain(surface);
 
@@ -354,6 +363,7 @@ namespace plb{
 				global::log(mesg);
 				global::timer("obstacle").start();
 			#endif
+				PLB_TRACE_SCOPE("Obstacle::moveToStart");
 				const T dx = Variables<T,BoundaryType,SurfaceData,Descriptor>::p.getDeltaX();
 
 				Box3D wall_domain = Wall<T,BoundaryType,SurfaceData,Descriptor>::getDomain();
@@ -408,6 +418,19 @@ namespace plb{
 		catch(const std::exception& e){exHandler(e,__FILE__,__FUNCTION__,__LINE__);}
 	}
 
+	template<typename T, class BoundaryType, class SurfaceData, template<class U> class Descriptor>
+	void Obstacle<T,BoundaryType,SurfaceData,Descriptor>::createBody()
+	{
+		try{
+			numVertices = tb->getMesh().getNumVertices();
+			if(numVertices == 0){throw std::runtime_error("No vertices returned from obstacle TriangleBoundary"); }
+			body.reset(new RigidBody3D<T>(tb->getMesh()));
+			velocityFunc.setBody(body.get());
+			normalFunc.setBody(body.get());
+		}
+		catch(const std::exception& e){exHandler(e,__FILE__,__FUNCTION__,__LINE__);}
+	}
+
 	template<typename T, class BoundaryType, class SurfaceData, template<class U> class Descriptor>
 	void Obstacle<T,BoundaryType,SurfaceData,Descriptor>::updateImmersedWall()
 	{
@@ -418,42 +441,14 @@ namespace plb{
 				global::log(mesg);
 				global::timer("update").start();
 			#endif
+				PLB_TRACE_SCOPE("Obstacle::updateImmersedWall");
 
-				numVertices = tb->getMesh().getNumVertices();
-				if(numVertices == 0){throw std::runtime_error("No vertices returned from obstacle TriangleBoundary"); }
-				vertices.clear();
-				vertices.resize(numVertices);
-				vertices.reserve(numVertices);
-
-				unitNormals.clear();
-				unitNormals.resize(numVertices);
-				unitNormals.reserve(numVertices);
-
-				areas.clear();
-				areas.resize(numVertices);
-				areas.reserve(numVertices);
-
-				const bool weightedArea = false;
-
-				for(int i = 0; i < numVertices; i++){
-					vertices[i] = tb->getMesh().getVertex(i);
-					areas[i] = tb->getMesh().computeVertexArea(i);
-					unitNormals[i] = tb->getMesh().computeVertexNormal(i,weightedArea);
-				}
-
-				//instantiateImmersedWallData(vertices, areas, *Variables<T,BoundaryType,SurfaceData,Descriptor>::container);
-
-				std::vector<MultiBlock3D*> args;
-				plint pl = 4;
-
-				args.resize(0);
-				args.push_back(Variables<T,BoundaryType,SurfaceData,Descriptor>::container);
-				integrateProcessingFunctional(new InstantiateImmersedWallData3D<T>(
-					vertices,
-					areas,
-					unitNormals),
-					Variables<T,BoundaryType,SurfaceData,Descriptor>::container->getBoundingBox(),
-					*Variables<T,BoundaryType,SurfaceData,Descriptor>::lattice, args, pl);
+				if(!body){ throw std::runtime_error("No rigid body created for the obstacle, call createBody first"); }
+				// The UpdateImmersedWallData3D processor integrated in Variables::createLattice picks up
+				// the new pose on the next call to executeInternalProcessors(), and computes the vertices
+				// of the blocks it updates only.
+				if(!wallBuffer){ throw std::runtime_error("Immersed wall buffer not created, call Variables::setLattice first"); }
+				wallBuffer->setRigidBody(*body);
 
 			#ifdef PLB_DEBUG
 				mesg =   "[DEBUG] DONE Updating Immersed Wall";
@@ -465,6 +460,59 @@ namespace plb{
 		catch(const std::exception& e){exHandler(e,__FILE__,__FUNCTION__,__LINE__);}
 	}
 
+	template<typename T, class BoundaryType, class SurfaceData, template<class U> class Descriptor>
+	void Obstacle<T,BoundaryType,SurfaceData,Descriptor>::reVoxelize(const Box3D& previousDomain)
+	{
+		try{
+			#ifdef PLB_DEBUG
+				std::string mesg = "[DEBUG] Re-voxelizing Obstacle";
+				if(master){std::cout << mesg << std::endl;}
+				global::log(mesg);
+				global::timer("revoxelize").start();
+			#endif
+				PLB_TRACE_SCOPE("Obstacle::reVoxelize");
+				// Only the cells between the previous and the current position of the surface can change
+				// their flag: the voxelization re-flags a shell around the surface inside this box.
+				const Box3D domain = getDomain();
+				const Box3D swept(std::min(previousDomain.x0,domain.x0), std::max(previousDomain.x1,domain.x1),
+					std::min(previousDomain.y0,domain.y0), std::max(previousDomain.y1,domain.y1),
+					std::min(previousDomain.z0,domain.z0), std::max(previousDomain.z1,domain.z1));
+
+				const Box3D voxelDomain = vd->adjustVoxelization(swept, Constants<T>::obstacle.dynamicMesh);
+
+				Box3D inters;
+				if(intersect(voxelDomain, vd->getVoxelMatrix().getBoundingBox(), inters)){
+					std::vector<MultiScalarField3D<int>*> voxelMatrices;
+					voxelMatrices.push_back(&Wall<T,BoundaryType,SurfaceData,Descriptor>::vd->getVoxelMatrix());
+					voxelMatrices.push_back(&vd->getVoxelMatrix());
+					std::vector<int> solidFlags;
+					solidFlags.push_back(voxelFlag::outside);
+					solidFlags.push_back(voxelFlag::inside);
+
+					// The cells which the obstacle uncovers start at equilibrium with its mean velocity,
+					// and the density with which the lattice was initialized.
+					Array<T,3> u = body->getVelocity();
+					T rho_lb = Variables<T,BoundaryType,SurfaceData,Descriptor>::getRho(Constants<T>::initialTemperature);
+
+					updateVoxelDynamics(*Variables<T,BoundaryType,SurfaceData,Descriptor>::lattice, voxelMatrices, solidFlags,
+						voxelDomain, Variables<T,BoundaryType,SurfaceData,Descriptor>::dynamics->clone(), rho_lb, u);
+
+					bc->update(voxelDomain);
+
+					applyProcessingFunctional(new BoxRhoBarJfunctional3D<T,Descriptor>(), voxelDomain,
+						Variables<T,BoundaryType,SurfaceData,Descriptor>::rhoBarJarg);
+				}
+
+			#ifdef PLB_DEBUG
+				mesg = "[DEBUG] DONE Re-voxelizing Obstacle Domain= "+box_string(voxelDomain);
+				if(master){std::cout << mesg << std::endl;}
+				global::log(mesg);
+				global::timer("revoxelize").stop();
+			#endif
+		}
+		catch(const std::exception& e){exHandler(e,__FILE__,__FUNCTION__,__LINE__);}
+	}
+
 	template<typename T, class BoundaryType, class SurfaceData, template<class U> class Descriptor>
 	bool Obstacle<T,BoundaryType,SurfaceData,Descriptor>::move()
 	{
@@ -476,6 +524,7 @@ namespace plb{
 				global::log(mesg);
 				global::timer("move").start();
 			#endif
+				PLB_TRACE_SCOPE("Obstacle::move");
 				const T dt = Variables<T,BoundaryType,SurfaceData,Descriptor>::p.getDeltaT();
 				const T dx = Variables<T,BoundaryType,SurfaceData,Descriptor>::p.getDeltaX();
 				const T omega = Variables<T,BoundaryType,SurfaceData,Descriptor>::p.getOmega();
@@ -483,7 +532,6 @@ namespace plb{
 				const T timeLB = Variables<T,BoundaryType,SurfaceData,Descriptor>::time;
 				const Box3D lattice_domain = Variables<T,BoundaryType,SurfaceData,Descriptor>::lattice->getBoundingBox();
 				const Box3D obstacle_domain = getDomain();
-				normalFunc.update(tb.get());
 
 				T factor = util::sqr(util::sqr(dx)) / util::sqr(dt);
 
@@ -494,14 +542,15 @@ namespace plb{
 					*Variables<T,BoundaryType,SurfaceData,Descriptor>::container,
 					Constants<T>::envelopeWidth, obstacle_domain, true);
 
+				// Force, torque and wetted area in one pass over the wall data and one global reduction.
+				Array<T,3> center = body->getPosition();
 				Array<T,3> force = Array<T,3>(0,0,0);
-				force = -reduceImmersedForce<T>(*Variables<T,BoundaryType,SurfaceData,Descriptor>::container, voxelFlag::outside);
-
-				Array<T,3> center = getCenter();
-
 				Array<T,3> torque = Array<T,3>(0,0,0);
-				torque = -reduceAxialTorqueImmersed(*Variables<T,BoundaryType,SurfaceData,Descriptor>::container,
-										center, Array<T,3>(1,1,1), voxelFlag::outside);
+				T area = 0;
+				reduceImmersedForceTorqueArea<T>(*Variables<T,BoundaryType,SurfaceData,Descriptor>::container,
+										center, Array<T,3>(1,1,1), force, torque, area, voxelFlag::outside);
+				force = -force;
+				torque = -torque;
 
 				stop = velocityFunc.update(Variables<T,BoundaryType,SurfaceData,Descriptor>::p,
 											timeLB,force,torque,tb.get(),lattice_domain);
@@ -515,10 +564,10 @@ namespace plb{
 									true);
 				}*/
 
-				normalFunc.update(tb.get());
-
 				updateImmersedWall();
 
+				reVoxelize(obstacle_domain);
+
 			#ifdef PLB_DEBUG
 				mesg =   "[DEBUG] DONE Moving Obstacle";
 				if(master){std::cout << mesg << std::endl;}
@@ -530,6 +579,102 @@ namespace plb{
 		return stop;
 	}
 
+	template<typename T, class BoundaryType, class SurfaceData, template<class U> class Descriptor>
+	void Obstacle<T,BoundaryType,SurfaceData,Descriptor>::save(parallelIO::CheckpointWriter& checkpoint)
+	{
+		try{
+			parallelIO::CheckpointRecord record;
+			save(record);
+			checkpoint.write("obstacle", record);
+		}
+		catch(const std::exception& e){exHandler(e,__FILE__,__FUNCTION__,__LINE__);}
+	}
+
+	template<typename T, class BoundaryType, class SurfaceData, template<class U> class Descriptor>
+	void Obstacle<T,BoundaryType,SurfaceData,Descriptor>::save(parallelIO::CheckpointRecord& record)
+	{
+		try{
+			record.add(firstMove);
+			record.add(position);
+			record.add(rotation);
+			record.add(velocity);
+			record.add(rotationalVelocity);
+			record.add(acceleration);
+			record.add(rotationalAcceleration);
+			record.add(location);
+			record.add(rotation_LB);
+			record.add(velocity_LB);
+			record.add(rotationalVelocity_LB);
+			record.add(acceleration_LB);
+			record.add(rotationalAcceleration_LB);
+			record.add(location_LB);
+			// The immersed wall data in the container is rebuilt from the vertices and their velocities.
+			std::vector<Array<T,3> > meshVertices(tb->getMesh().getNumVertices());
+			for(plint i = 0; i < (plint)meshVertices.size(); i++){ meshVertices[i] = tb->getMesh().getVertex(i); }
+			record.add(meshVertices);
+			velocityFunc.save(record);
+		}
+		catch(const std::exception& e){exHandler(e,__FILE__,__FUNCTION__,__LINE__);}
+	}
+
+	template<typename T, class BoundaryType, class SurfaceData, template<class U> class Descriptor>
+	void Obstacle<T,BoundaryType,SurfaceData,Descriptor>::load(parallelIO::CheckpointReader& checkpoint)
+	{
+		try{
+			parallelIO::CheckpointRecord record;
+			checkpoint.read("obstacle", record);
+			load(record);
+		}
+		catch(const std::exception& e){exHandler(e,__FILE__,__FUNCTION__,__LINE__);}
+	}
+
+	template<typename T, class BoundaryType, class SurfaceData, template<class U> class Descriptor>
+	void Obstacle<T,BoundaryType,SurfaceData,Descriptor>::load(parallelIO::CheckpointRecord& record, const T& dxRatio,
+		const T& dtRatio, const Array<T,3>& offset)
+	{
+		try{
+			#ifdef PLB_DEBUG
+				std::string mesg = "[DEBUG] Restoring Obstacle";
+				if(master){std::cout << mesg << std::endl;}
+				global::log(mesg);
+			#endif
+			const Box3D previousDomain = getDomain();
+			record.get(firstMove);
+			record.get(position);
+			record.get(rotation);
+			record.get(velocity);
+			record.get(rotationalVelocity);
+			record.get(acceleration);
+			record.get(rotationalAcceleration);
+			record.get(location);
+			record.get(rotation_LB);
+			record.get(velocity_LB);
+			record.get(rotationalVelocity_LB);
+			record.get(acceleration_LB);
+			record.get(rotationalAcceleration_LB);
+			record.get(location_LB);
+			std::vector<Array<T,3> > meshVertices;
+			record.get(meshVertices);
+			if((plint)meshVertices.size() != tb->getMesh().getNumVertices()){
+				throw std::runtime_error("The obstacle mesh of the checkpoint does not match the STL file");
+			}
+			for(plint i = 0; i < (plint)meshVertices.size(); i++){
+				tb->getMesh().replaceVertex(i, meshVertices[i] / dxRatio + offset);
+			}
+			velocityFunc.load(record);
+			if(dxRatio != (T)1 || dtRatio != (T)1){ velocityFunc.rescale(dxRatio, dtRatio); }
+
+			createBody();
+			updateImmersedWall();
+			reVoxelize(previousDomain);
+			#ifdef PLB_DEBUG
+				mesg = "[DEBUG] Done Restoring Obstacle";
+				if(master){std::cout << mesg << std::endl;}
+				global::log(mesg);
+			#endif
+		}
+		catch(const std::exception& e){exHandler(e,__FILE__,__FUNCTION__,__LINE__);}
+	}
 
 } // namespace plb
 
@@ -34,6 +34,8 @@
 #include "offLattice/triangularSurfaceMesh.h"
 #include "offLattice/voxelizer.h"
 #include "offLattice/makeSparse3D.h"
+#include "offLattice/voxelDecomposition3D.h"
+#include "offLattice/voxelDynamics3D.h"
 #include "offLattice/triangleHash.h"
 #include "offLattice/offLatticeBoundaryProcessor3D.h"
 #include "offLattice/offLatticeBoundaryProfiles3D.h"
@@ -45,6 +47,7 @@
 #include "offLattice/bouzidiOffLatticeModel3D.h"
 #include "offLattice/guoAdvDiffOffLatticeModel3D.h"
 #include "offLattice/triangleSetGenerator.h"
+#include "offLattice/rigidBody3D.h"
 #include "offLattice/immersedWalls3D.h"
 #include "offLattice/immersedAdvectionDiffusionWalls3D.h"
 #include "offLattice/filippovaHaenel3D.h"
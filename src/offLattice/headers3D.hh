@@ -33,6 +33,7 @@
 #include "offLattice/triangularSurfaceMesh.hh"
 #include "offLattice/voxelizer.hh"
 #include "offLattice/makeSparse3D.hh"
+#include "offLattice/voxelDynamics3D.hh"
 #include "offLattice/triangleHash.hh"
 #include "offLattice/offLatticeBoundaryProcessor3D.hh"
 #include "offLattice/offLatticeBoundaryProfiles3D.hh"
@@ -44,6 +45,7 @@
 #include "offLattice/bouzidiOffLatticeModel3D.hh"
 #include "offLattice/guoAdvDiffOffLatticeModel3D.hh"
 #include "offLattice/triangleSetGenerator.hh"
+#include "offLattice/rigidBody3D.hh"
 #include "offLattice/immersedWalls3D.hh"
 #include "offLattice/immersedAdvectionDiffusionWalls3D.hh"
 #include "offLattice/filippovaHaenel3D.hh"
@@ -31,6 +31,8 @@
 #include "atomicBlock/dataField3D.h"
 #include "multiBlock/headers3D.h"
 #include "multiBlock/headers3D.hh"
+#include "offLattice/rigidBody3D.h"
+#include <memory>
 
 namespace plb {
 
@@ -91,6 +93,30 @@ InamuroDeltaFunction<T> const& inamuroDeltaFunction() {
     return deltaFunction;
 }
 
+/* ******** InamuroStencil3D ************************************ */
+
+// Cells and delta-function weights of the interpolation stencils of the vertices
+// of an ImmersedWallData3D, as flat arrays: the entries of vertex i are in
+// [begin[i], begin[i+1]), and the cells are linear indices into the rhoBar and
+// j fields. It is built by CachedInamuroIteration3D for a given domain, and
+// must be invalidated whenever the vertices change.
+template<typename T>
+struct InamuroStencil3D
+{
+    InamuroStencil3D()
+        : valid(false)
+    { }
+    void invalidate() {
+        valid = false;
+    }
+    bool valid;
+    Box3D domain;
+    std::vector<plint> begin;
+    std::vector<plint> rhoBarIndex;
+    std::vector<plint> jIndex;
+    std::vector<T> weights;
+};
+
 /* ******** ImmersedWallData3D ************************************ */
 
 template<typename T>
@@ -103,6 +129,7 @@ struct ImmersedWallData3D : public ContainerBlockData
     std::vector< Array<T,3> > g;
     std::vector<int> flags; // Flag for each vertex used to distinguish between vertices for conditional reduction operations.
     std::vector<pluint> globalVertexIds;
+    InamuroStencil3D<T> stencil; // Cached by CachedInamuroIteration3D.
     virtual ImmersedWallData3D<T>* clone() const {
         return new ImmersedWallData3D<T>(*this);
     }
@@ -207,6 +234,50 @@ T reduceImmersedArea(MultiContainerBlock3D& container, int reductionFlag = 0)
     return functional.getSumArea();
 }
 
+/* ******** ReduceImmersedForceTorqueArea3D ************************************ */
+
+// Computes in one pass over the immersed wall data the sum of the force ("g"),
+// the torque about "center" and the area of the vertices which have a flag equal
+// to "reductionFlag". The torque is computed as ReduceAxialTorqueImmersed3D does;
+// a zero "unitaryAxis" gives the full torque about "center". If "traction" is
+// not null, it must hold one entry per global vertex, and the force per unit area
+// of the vertices reduced by the current process is written at their global id.
+// All the sums are combined in a single global reduction.
+template<typename T>
+class ReduceImmersedForceTorqueArea3D : public PlainReductiveBoxProcessingFunctional3D
+{
+public:
+    ReduceImmersedForceTorqueArea3D(Array<T,3> const& center_, Array<T,3> const& unitaryAxis_,
+            int reductionFlag_ = 0, std::vector<Array<T,3> >* traction_ = 0);
+    virtual void processGenericBlocks(Box3D domain, std::vector<AtomicBlock3D*> fields);
+    virtual ReduceImmersedForceTorqueArea3D<T>* clone() const;
+    virtual void getTypeOfModification(std::vector<modif::ModifT>& modified) const;
+    virtual BlockDomain::DomainT appliesTo() const;
+    Array<T,3> getSumG() const;
+    Array<T,3> getSumTorque() const;
+    T getSumArea() const;
+private:
+    Array<T,3> center, unitaryAxis;
+    Array<plint,3> sum_g_ids, sum_torque_ids;
+    plint sum_area_id;
+    int reductionFlag;
+    std::vector<Array<T,3> >* traction;
+};
+
+template<typename T>
+void reduceImmersedForceTorqueArea(MultiContainerBlock3D& container, Array<T,3> const& center,
+        Array<T,3> const& unitaryAxis, Array<T,3>& force, Array<T,3>& torque, T& area,
+        int reductionFlag = 0, std::vector<Array<T,3> >* traction = 0)
+{
+    std::vector<MultiBlock3D*> args;
+    args.push_back(&container);
+    ReduceImmersedForceTorqueArea3D<T> functional(center, unitaryAxis, reductionFlag, traction);
+    applyProcessingFunctional(functional, container.getBoundingBox(), args);
+    force = functional.getSumG();
+    torque = functional.getSumTorque();
+    area = functional.getSumArea();
+}
+
 /* ******** InamuroIteration3D ************************************ */
 
 template<typename T, class VelFunction>
@@ -276,6 +347,48 @@ void indexedInamuroIteration (
         new IndexedInamuroIteration3D<T,VelFunction>(velFunction, tau, incompressibleModel), rhoBar.getBoundingBox(), args );
 }
 
+/* ******** CachedInamuroIteration3D ************************************ */
+
+// This is the same as IndexedInamuroIteration3D, but the stencil cells and the
+// delta-function weights of the vertices are computed once and kept in the
+// InamuroStencil3D of the immersed wall data, until the vertices change. The
+// successive iterations of a time step, and the time steps of a fixed surface,
+// then only gather and scatter over that table. Blocks which hold no vertex
+// return immediately.
+template<typename T, class VelFunction>
+class CachedInamuroIteration3D : public BoxProcessingFunctional3D
+{
+public:
+    CachedInamuroIteration3D(VelFunction velFunction_, T tau_, bool incompressibleModel_);
+    virtual void processGenericBlocks(Box3D domain, std::vector<AtomicBlock3D*> fields);
+    virtual CachedInamuroIteration3D<T,VelFunction>* clone() const;
+    virtual void getTypeOfModification(std::vector<modif::ModifT>& modified) const;
+    virtual BlockDomain::DomainT appliesTo() const;
+private:
+    void buildStencil(Box3D const& domain, ScalarField3D<T> const& rhoBar, TensorField3D<T,3> const& j,
+            ImmersedWallData3D<T>& wallData) const;
+private:
+    VelFunction velFunction;
+    T tau;
+    bool incompressibleModel;
+};
+
+template<typename T, class VelFunction>
+void cachedInamuroIteration (
+    VelFunction velFunction,
+    MultiScalarField3D<T>& rhoBar,
+    MultiTensorField3D<T,3>& j,
+    MultiContainerBlock3D& container, T tau,
+    bool incompressibleModel )
+{
+    std::vector<MultiBlock3D*> args;
+    args.push_back(&rhoBar);
+    args.push_back(&j);
+    args.push_back(&container);
+    applyProcessingFunctional (
+        new CachedInamuroIteration3D<T,VelFunction>(velFunction, tau, incompressibleModel), rhoBar.getBoundingBox(), args );
+}
+
 /* ******** ConstVelInamuroIteration3D ************************************ */
 
 template<typename T>
@@ -380,6 +493,134 @@ void instantiateImmersedWallData (
             new InstantiateImmersedWallData3D<T>(vertices,areas,normals), container.getBoundingBox(), args );
 }
 
+/* ******** ImmersedWallVertexBuffer3D ************************************ */
+
+// This class holds the vertices, areas and normals of a moving immersed surface
+// in a place which is shared by all the clones of a UpdateImmersedWallData3D
+// processor. Every call to one of the setters increments a version number, and
+// stores the bounding box of the surface and an upper bound of the distance
+// moved by the vertices. The processor uses this information to decide if the
+// ImmersedWallData3D of a given container block must be updated, rebuilt or
+// left untouched.
+// The surface may instead be given as a RigidBody3D, which must then outlive the
+// buffer: the data of a vertex are computed only when a processor asks for them.
+template<typename T>
+class ImmersedWallVertexBuffer3D
+{
+public:
+    ImmersedWallVertexBuffer3D();
+    ImmersedWallVertexBuffer3D (
+            std::vector< Array<T,3> > const& vertices_,
+            std::vector<T> const& areas_,
+            std::vector< Array<T,3> > const& normals_ );
+    // Update the vertex positions only. Areas and normals are kept, which is
+    //   correct for a pure translation of the surface.
+    void setVertices(std::vector< Array<T,3> > const& vertices_);
+    // Update the vertex positions, the areas and (optionally, if the vector is
+    //   non-empty) the normals.
+    void setVertices (
+            std::vector< Array<T,3> > const& vertices_,
+            std::vector<T> const& areas_,
+            std::vector< Array<T,3> > const& normals_ );
+    // Use the present pose of a rigid body; call again every time the body moves.
+    void setRigidBody(RigidBody3D<T> const& body_);
+    std::vector< Array<T,3> > const& getVertices() const { return vertices; }
+    std::vector<T> const& getAreas() const { return areas; }
+    std::vector< Array<T,3> > const& getNormals() const { return normals; }
+    pluint getNumVertices() const { return body ? body->getNumVertices() : vertices.size(); }
+    Array<T,3> getVertex(pluint iVertex) const { return body ? body->getVertex(iVertex) : vertices[iVertex]; }
+    T getArea(pluint iVertex) const { return body ? body->getArea(iVertex) : areas[iVertex]; }
+    Array<T,3> getNormal(pluint iVertex) const { return body ? body->getNormal(iVertex) : normals[iVertex]; }
+    bool hasNormals() const { return body || !normals.empty(); }
+    // Append the ids of the vertices which may be inside a box (all of them,
+    //   unless the surface is a rigid body).
+    void getCandidateVertices(Cuboid<T> const& cuboid, std::vector<pluint>& ids) const;
+    // Append, in increasing order, the ids of the vertices which may be inside a
+    //   box, at a distance smaller than width from its boundary.
+    void getCandidateVertices(Cuboid<T> const& cuboid, T width, std::vector<pluint>& ids) const;
+    pluint getVersion() const { return version; }
+    // Last version at which the set of vertices was replaced: the distance moved
+    //   by the vertices since an earlier version is unknown.
+    pluint getResetVersion() const { return resetVersion; }
+    // Sum, over all versions, of an upper bound of the distance moved by any
+    //   vertex. The difference between two values bounds the displacement of
+    //   the vertices between the two corresponding versions.
+    T getAccumulatedDisplacement() const { return accumulatedDisplacement; }
+    // Bounding box of the surface, in absolute lattice units.
+    Cuboid<T> const& getBoundingCuboid() const { return boundingCuboid; }
+private:
+    void computeBoundingCuboid();
+    T computeDisplacement(std::vector< Array<T,3> > const& newVertices) const;
+private:
+    std::vector< Array<T,3> > vertices;
+    std::vector<T> areas;
+    std::vector< Array<T,3> > normals;
+    RigidBody3D<T> const* body;
+    Array<T,3> bodyPosition;
+    Array<T,4> bodyOrientation;
+    Cuboid<T> boundingCuboid;
+    pluint version;
+    pluint resetVersion;
+    T accumulatedDisplacement;
+};
+
+/* ******** UpdateImmersedWallData3D ************************************ */
+
+// This data processor is meant to be integrated once into a lattice, as a
+// replacement of a repeated integration of InstantiateImmersedWallData3D for
+// moving surfaces. It reads the vertices from an ImmersedWallVertexBuffer3D,
+// and acts only when the version of the buffer has changed. On a given
+// container block:
+//   - if the surface is away from the block and the block holds no vertices,
+//     nothing is done;
+//   - if the vertices have moved by a known distance since the last update,
+//     the vertex data of the block are overwritten in place, the vertices which
+//     have left the extended envelope are removed, and the ones which have
+//     entered it are added: they are searched for only in a layer of the
+//     envelope, whose width is the distance moved;
+//   - otherwise (first update, or a new set of vertices), the ImmersedWallData3D
+//     of the block is rebuilt from scratch.
+// In both cases, the vertices of a block are sorted by global id, so that the
+// result does not depend on the history of the surface.
+// Like in InstantiateImmersedWallData3D, the force vectors "g" and the flags are
+// reset to zero on every update.
+// The buffer is shared by all clones of the processor, and by its creator.
+template<typename T>
+class UpdateImmersedWallData3D : public BoxProcessingFunctional3D
+{
+public:
+    UpdateImmersedWallData3D(std::shared_ptr<ImmersedWallVertexBuffer3D<T> const> buffer_);
+    virtual void processGenericBlocks(Box3D domain, std::vector<AtomicBlock3D*> fields);
+    virtual UpdateImmersedWallData3D<T>* clone() const;
+    virtual void getTypeOfModification(std::vector<modif::ModifT>& modified) const;
+    virtual BlockDomain::DomainT appliesTo() const;
+private:
+    void rebuild(Box3D const& extendedEnvelope, Array<T,3> const& offset, ImmersedWallData3D<T>& wallData) const;
+    void updateInPlace( Box3D const& extendedEnvelope, Array<T,3> const& offset, T displacement,
+                        ImmersedWallData3D<T>& wallData ) const;
+    void addVertices( std::vector<pluint> const& ids, Array<T,3> const& offset,
+                      ImmersedWallData3D<T>& wallData ) const;
+    template<typename U>
+    static void reorder(std::vector<pluint> const& order, std::vector<U>& data);
+private:
+    std::shared_ptr<ImmersedWallVertexBuffer3D<T> const> buffer;
+    pluint lastVersion;
+    T lastDisplacement;
+    bool initialized;
+};
+
+// Integrate the processor at the given level, with the lattice as an actor.
+template<typename T, template<typename U> class Descriptor>
+void integrateUpdateImmersedWallData (
+            std::shared_ptr<ImmersedWallVertexBuffer3D<T> const> buffer, MultiBlockLattice3D<T,Descriptor>& lattice,
+            MultiContainerBlock3D& container, plint level )
+{
+    std::vector<MultiBlock3D*> args;
+    args.push_back(&container);
+    integrateProcessingFunctional (
+            new UpdateImmersedWallData3D<T>(buffer), container.getBoundingBox(), lattice, args, level );
+}
+
 /* ******** InstantiateImmersedWallDataWithTagging3D ************************************ */
 
 template<typename T>
@@ -31,6 +31,8 @@
 #include "atomicBlock/dataField3D.h"
 
 #include "immersedWalls3D.h"
+#include <algorithm>
+#include <cmath>
 
 namespace plb {
 
@@ -225,6 +227,115 @@ T ReduceImmersedArea3D<T>::getSumArea() const {
     return this->getStatistics().getSum(sum_area_id);
 }
 
+/* ******** ReduceImmersedForceTorqueArea3D ************************************ */
+
+template<typename T>
+ReduceImmersedForceTorqueArea3D<T>::ReduceImmersedForceTorqueArea3D (
+        Array<T,3> const& center_, Array<T,3> const& unitaryAxis_, int reductionFlag_,
+        std::vector<Array<T,3> >* traction_ )
+    : center(center_),
+      unitaryAxis(unitaryAxis_),
+      sum_g_ids (
+            Array<plint,3> (
+                this->getStatistics().subscribeSum(),
+                this->getStatistics().subscribeSum(),
+                this->getStatistics().subscribeSum() ) ),
+      sum_torque_ids (
+            Array<plint,3> (
+                this->getStatistics().subscribeSum(),
+                this->getStatistics().subscribeSum(),
+                this->getStatistics().subscribeSum() ) ),
+      sum_area_id(this->getStatistics().subscribeSum()),
+      reductionFlag(reductionFlag_),
+      traction(traction_)
+{ }
+
+template<typename T>
+void ReduceImmersedForceTorqueArea3D<T>::processGenericBlocks (
+        Box3D domain, std::vector<AtomicBlock3D*> blocks )
+{
+    PLB_PRECONDITION( blocks.size()==1 );
+    AtomicContainerBlock3D* container = dynamic_cast<AtomicContainerBlock3D*>(blocks[0]);
+    PLB_ASSERT( container );
+
+    ImmersedWallData3D<T>* wallData = 
+        dynamic_cast<ImmersedWallData3D<T>*>( container->getData() );
+    PLB_ASSERT(wallData);
+    std::vector< Array<T,3> > const& vertices = wallData->vertices;
+    std::vector< Array<T,3> > const& g = wallData->g;
+    std::vector<T> const& areas = wallData->areas;
+    std::vector<int> const& flags = wallData->flags;
+    std::vector<pluint> const& globalVertexIds = wallData->globalVertexIds;
+    Array<T,3> offset = wallData->offset;
+    PLB_ASSERT( vertices.size()==g.size() );
+    PLB_ASSERT( vertices.size()==areas.size() );
+    PLB_ASSERT( vertices.size()==flags.size() );
+    PLB_ASSERT( !traction || vertices.size()==globalVertexIds.size() );
+
+    Array<T,3> sumG, sumTorque;
+    sumG.resetToZero();
+    sumTorque.resetToZero();
+    T sumArea = T();
+    for (pluint i=0; i<vertices.size(); ++i) {
+        Array<T,3> vertex = vertices[i];
+        if ( flags[i]==reductionFlag &&
+             closedOpenContained(vertex, domain) )
+        {
+            Array<T,3> r(vertex+offset-center);
+            r -= dot(r,unitaryAxis)*unitaryAxis;
+            sumG += g[i];
+            sumTorque += crossProduct(r,g[i]);
+            sumArea += areas[i];
+            if (traction && areas[i] > T()) {
+                PLB_ASSERT( globalVertexIds[i] < traction->size() );
+                (*traction)[globalVertexIds[i]] = g[i] / areas[i];
+            }
+        }
+    }
+
+    for (plint iDim=0; iDim<3; ++iDim) {
+        this->getStatistics().gatherSum(sum_g_ids[iDim], sumG[iDim]);
+        this->getStatistics().gatherSum(sum_torque_ids[iDim], sumTorque[iDim]);
+    }
+    this->getStatistics().gatherSum(sum_area_id, sumArea);
+}
+
+template<typename T>
+ReduceImmersedForceTorqueArea3D<T>* ReduceImmersedForceTorqueArea3D<T>::clone() const {
+    return new ReduceImmersedForceTorqueArea3D<T>(*this);
+}
+
+template<typename T>
+void ReduceImmersedForceTorqueArea3D<T>::getTypeOfModification(std::vector<modif::ModifT>& modified) const {
+    modified[0] = modif::nothing; // Container Block.
+}
+
+template<typename T>
+BlockDomain::DomainT ReduceImmersedForceTorqueArea3D<T>::appliesTo() const {
+    return BlockDomain::bulk;
+}
+
+template<typename T>
+Array<T,3> ReduceImmersedForceTorqueArea3D<T>::getSumG() const {
+    return Array<T,3> (
+            this->getStatistics().getSum(sum_g_ids[0]),
+            this->getStatistics().getSum(sum_g_ids[1]),
+            this->getStatistics().getSum(sum_g_ids[2]) );
+}
+
+template<typename T>
+Array<T,3> ReduceImmersedForceTorqueArea3D<T>::getSumTorque() const {
+    return Array<T,3> (
+            this->getStatistics().getSum(sum_torque_ids[0]),
+            this->getStatistics().getSum(sum_torque_ids[1]),
+            this->getStatistics().getSum(sum_torque_ids[2]) );
+}
+
+template<typename T>
+T ReduceImmersedForceTorqueArea3D<T>::getSumArea() const {
+    return this->getStatistics().getSum(sum_area_id);
+}
+
 /* ******** InamuroIteration3D ************************************ */
 
 template<typename T, class VelFunction>
@@ -502,6 +613,149 @@ BlockDomain::DomainT IndexedInamuroIteration3D<T,VelFunction>::appliesTo() const
     return BlockDomain::bulk;
 }
 
+/* ******** CachedInamuroIteration3D ************************************ */
+
+template<typename T, class VelFunction>
+CachedInamuroIteration3D<T,VelFunction>::CachedInamuroIteration3D(VelFunction velFunction_, T tau_, bool incompressibleModel_)
+    : velFunction(velFunction_),
+      tau(tau_),
+      incompressibleModel(incompressibleModel_)
+{ }
+
+template<typename T, class VelFunction>
+void CachedInamuroIteration3D<T,VelFunction>::buildStencil (
+        Box3D const& domain, ScalarField3D<T> const& rhoBar, TensorField3D<T,3> const& j,
+        ImmersedWallData3D<T>& wallData ) const
+{
+    Dot3D ofsJ = computeRelativeDisplacement(rhoBar, j);
+    std::vector< Array<T,3> > const& vertices = wallData.vertices;
+    InamuroStencil3D<T>& stencil = wallData.stencil;
+
+    // The vectors are cleared but not deallocated, the table of a moving surface
+    // is rebuilt with the same size on every time step.
+    stencil.begin.clear();
+    stencil.rhoBarIndex.clear();
+    stencil.jIndex.clear();
+    stencil.weights.clear();
+    for (pluint i=0; i<vertices.size(); ++i) {
+        stencil.begin.push_back((plint)stencil.weights.size());
+        Array<T,3> const& vertex = vertices[i];
+        Array<plint,3> intPos((plint)vertex[0], (plint)vertex[1], (plint)vertex[2] );
+        // x   x . x   x
+        for (plint dx=-1; dx<=+2; ++dx) {
+            for (plint dy=-1; dy<=+2; ++dy) {
+                for (plint dz=-1; dz<=+2; ++dz) {
+                    Array<plint,3> pos(intPos+Array<plint,3>(dx,dy,dz));
+                    plint next_x = pos[0]+ofsJ.x;
+                    plint next_y = pos[1]+ofsJ.y;
+                    plint next_z = pos[2]+ofsJ.z;
+                    if (next_x >= domain.x0 && next_x <= domain.x1 &&
+                        next_y >= domain.y0 && next_y <= domain.y1 &&
+                        next_z >= domain.z0 && next_z <= domain.z1)
+                    {
+                        Array<T,3> r(pos[0]-vertex[0],pos[1]-vertex[1],pos[2]-vertex[2]);
+                        stencil.rhoBarIndex.push_back((pos[0]*rhoBar.getNy()+pos[1])*rhoBar.getNz()+pos[2]);
+                        stencil.jIndex.push_back((next_x*j.getNy()+next_y)*j.getNz()+next_z);
+                        stencil.weights.push_back(inamuroDeltaFunction<T>().W(r));
+                    }
+                }
+            }
+        }
+    }
+    stencil.begin.push_back((plint)stencil.weights.size());
+    stencil.domain = domain;
+    stencil.valid = true;
+}
+
+template<typename T, class VelFunction>
+void CachedInamuroIteration3D<T,VelFunction>::processGenericBlocks (
+        Box3D domain, std::vector<AtomicBlock3D*> blocks )
+{
+    PLB_PRECONDITION( blocks.size()==3 );
+    ScalarField3D<T>* rhoBar = dynamic_cast<ScalarField3D<T>*>(blocks[0]);
+    TensorField3D<T,3>* j = dynamic_cast<TensorField3D<T,3>*>(blocks[1]);
+    AtomicContainerBlock3D* container = dynamic_cast<AtomicContainerBlock3D*>(blocks[2]);
+    PLB_ASSERT( rhoBar );
+    PLB_ASSERT( j );
+    PLB_ASSERT( container );
+
+    ImmersedWallData3D<T>* wallData = 
+        dynamic_cast<ImmersedWallData3D<T>*>( container->getData() );
+    PLB_ASSERT(wallData);
+
+    std::vector< Array<T,3> > const& vertices = wallData->vertices;
+    if (vertices.empty()) {
+        return;
+    }
+    std::vector<T> const& areas = wallData->areas;
+    PLB_ASSERT( vertices.size()==areas.size() );
+    std::vector<Array<T,3> >& g = wallData->g;
+    PLB_ASSERT( vertices.size()==g.size() );
+    std::vector<pluint> const& globalVertexIds = wallData->globalVertexIds;
+    PLB_ASSERT( vertices.size()==globalVertexIds.size() );
+
+    InamuroStencil3D<T>& stencil = wallData->stencil;
+    if (!stencil.valid || !(stencil.domain == domain)) {
+        buildStencil(domain, *rhoBar, *j, *wallData);
+    }
+    PLB_ASSERT( stencil.begin.size()==vertices.size()+1 );
+    // The neighborhoods may all be empty, for example if no vertex is close to the
+    //   domain, and then so are the index and weight arrays.
+    plint const* begin = stencil.begin.data();
+    plint const* rhoBarIndex = stencil.rhoBarIndex.data();
+    plint const* jIndex = stencil.jIndex.data();
+    T const* weights = stencil.weights.data();
+
+    std::vector<Array<T,3> > deltaG(vertices.size());
+    if (incompressibleModel) {
+        for (pluint i=0; i<vertices.size(); ++i) {
+            Array<T,3> averageJ; averageJ.resetToZero();
+            for (plint k=begin[i]; k<begin[i+1]; ++k) {
+                averageJ += weights[k]*(*j)[jIndex[k]];
+            }
+            Array<T,3> wallVelocity = velFunction(globalVertexIds[i]);
+            deltaG[i] = areas[i]*(wallVelocity-averageJ);
+            g[i] += deltaG[i];
+        }
+    }
+    else { // Compressible model.
+        for (pluint i=0; i<vertices.size(); ++i) {
+            Array<T,3> averageJ; averageJ.resetToZero();
+            T averageRhoBar = T();
+            for (plint k=begin[i]; k<begin[i+1]; ++k) {
+                averageJ += weights[k]*(*j)[jIndex[k]];
+                averageRhoBar += weights[k]*(*rhoBar)[rhoBarIndex[k]];
+            }
+            Array<T,3> wallVelocity = velFunction(globalVertexIds[i]);
+            deltaG[i] = areas[i]*((averageRhoBar+(T)1.)*wallVelocity-averageJ);
+            g[i] += deltaG[i]/((T)1.0+averageRhoBar);
+        }
+    }
+
+    for (pluint i=0; i<vertices.size(); ++i) {
+        for (plint k=begin[i]; k<begin[i+1]; ++k) {
+            (*j)[jIndex[k]] += tau*weights[k]*deltaG[i];
+        }
+    }
+}
+
+template<typename T, class VelFunction>
+CachedInamuroIteration3D<T,VelFunction>* CachedInamuroIteration3D<T,VelFunction>::clone() const {
+    return new CachedInamuroIteration3D<T,VelFunction>(*this);
+}
+
+template<typename T, class VelFunction>
+void CachedInamuroIteration3D<T,VelFunction>::getTypeOfModification(std::vector<modif::ModifT>& modified) const {
+    modified[0] = modif::nothing;          // RhoBar
+    modified[1] = modif::staticVariables;  // J
+    modified[2] = modif::nothing;          // Container Block with triangle data.
+}
+
+template<typename T, class VelFunction>
+BlockDomain::DomainT CachedInamuroIteration3D<T,VelFunction>::appliesTo() const {
+    return BlockDomain::bulk;
+}
+
 /* ******** ConstVelInamuroIteration3D ************************************ */
 
 template<typename T>
@@ -751,6 +1005,392 @@ BlockDomain::DomainT InstantiateImmersedWallData3D<T>::appliesTo() const {
 }
 
 
+/* ******** ImmersedWallVertexBuffer3D ************************************ */
+
+template<typename T>
+ImmersedWallVertexBuffer3D<T>::ImmersedWallVertexBuffer3D()
+    : body(0),
+      bodyPosition((T)0,(T)0,(T)0),
+      bodyOrientation((T)1,(T)0,(T)0,(T)0),
+      version(0),
+      resetVersion(0),
+      accumulatedDisplacement((T)0)
+{ }
+
+template<typename T>
+ImmersedWallVertexBuffer3D<T>::ImmersedWallVertexBuffer3D (
+        std::vector< Array<T,3> > const& vertices_,
+        std::vector<T> const& areas_,
+        std::vector< Array<T,3> > const& normals_ )
+    : body(0),
+      bodyPosition((T)0,(T)0,(T)0),
+      bodyOrientation((T)1,(T)0,(T)0,(T)0),
+      version(0),
+      resetVersion(0),
+      accumulatedDisplacement((T)0)
+{
+    setVertices(vertices_, areas_, normals_);
+}
+
+template<typename T>
+void ImmersedWallVertexBuffer3D<T>::setVertices(std::vector< Array<T,3> > const& vertices_)
+{
+    PLB_ASSERT(vertices_.size() == areas.size());
+    if (!body && vertices_.size()==vertices.size()) {
+        accumulatedDisplacement += computeDisplacement(vertices_);
+    }
+    else {
+        resetVersion = version+1;
+    }
+    body = 0;
+    vertices = vertices_;
+    computeBoundingCuboid();
+    ++version;
+}
+
+template<typename T>
+void ImmersedWallVertexBuffer3D<T>::setVertices (
+        std::vector< Array<T,3> > const& vertices_,
+        std::vector<T> const& areas_,
+        std::vector< Array<T,3> > const& normals_ )
+{
+    PLB_ASSERT(vertices_.size() == areas_.size());
+    PLB_ASSERT(normals_.size()==0 || normals_.size() == areas_.size());
+    if (!body && vertices_.size()==vertices.size()) {
+        accumulatedDisplacement += computeDisplacement(vertices_);
+    }
+    else {
+        resetVersion = version+1;
+    }
+    body = 0;
+    vertices = vertices_;
+    areas = areas_;
+    normals = normals_;
+    computeBoundingCuboid();
+    ++version;
+}
+
+template<typename T>
+void ImmersedWallVertexBuffer3D<T>::setRigidBody(RigidBody3D<T> const& body_)
+{
+    if (body==&body_) {
+        // A vertex at distance r from the centre is moved by the rotation by at
+        //   most 2 sin(theta/2) r, where cos(theta/2) is the scalar product of
+        //   the two unit quaternions.
+        Array<T,4> const& orientation = body_.getOrientation();
+        T cosHalfAngle = std::fabs(orientation[0]*bodyOrientation[0] + orientation[1]*bodyOrientation[1] +
+                                   orientation[2]*bodyOrientation[2] + orientation[3]*bodyOrientation[3]);
+        T sinHalfAngle = std::sqrt(std::max((T)0, (T)1-cosHalfAngle*cosHalfAngle));
+        accumulatedDisplacement += norm(body_.getPosition()-bodyPosition) +
+                                   (T)2*sinHalfAngle*body_.getRadius();
+    }
+    else {
+        resetVersion = version+1;
+    }
+    body = &body_;
+    bodyPosition = body_.getPosition();
+    bodyOrientation = body_.getOrientation();
+    vertices.clear();
+    areas.clear();
+    normals.clear();
+    computeBoundingCuboid();
+    ++version;
+}
+
+template<typename T>
+void ImmersedWallVertexBuffer3D<T>::getCandidateVertices(Cuboid<T> const& cuboid, std::vector<pluint>& ids) const
+{
+    if (body) {
+        body->getVerticesInCuboid(cuboid, ids);
+        return;
+    }
+    for (pluint i=0; i<vertices.size(); ++i) {
+        ids.push_back(i);
+    }
+}
+
+template<typename T>
+void ImmersedWallVertexBuffer3D<T>::getCandidateVertices (
+        Cuboid<T> const& cuboid, T width, std::vector<pluint>& ids ) const
+{
+    Array<T,3> const& llc = cuboid.lowerLeftCorner;
+    Array<T,3> const& urc = cuboid.upperRightCorner;
+    bool isThin = false;
+    for (int d=0; d<3; ++d) {
+        isThin = isThin || (T)2*width >= urc[d]-llc[d];
+    }
+    if (!body || isThin) {
+        getCandidateVertices(cuboid, ids);
+        return;
+    }
+    // One slab on each face of the box; the slabs overlap along the edges.
+    pluint first = ids.size();
+    for (int d=0; d<3; ++d) {
+        Array<T,3> lowerSlabEnd(urc);
+        lowerSlabEnd[d] = llc[d]+width;
+        body->getVerticesInCuboid(Cuboid<T>(llc, lowerSlabEnd), ids);
+        Array<T,3> upperSlabBegin(llc);
+        upperSlabBegin[d] = urc[d]-width;
+        body->getVerticesInCuboid(Cuboid<T>(upperSlabBegin, urc), ids);
+    }
+    std::sort(ids.begin()+first, ids.end());
+    ids.erase(std::unique(ids.begin()+first, ids.end()), ids.end());
+}
+
+template<typename T>
+void ImmersedWallVertexBuffer3D<T>::computeBoundingCuboid()
+{
+    if (body) {
+        boundingCuboid = body->getBoundingCuboid();
+        return;
+    }
+    if (vertices.empty()) {
+        boundingCuboid = Cuboid<T>();
+        return;
+    }
+    Array<T,3> llc(vertices[0]), urc(vertices[0]);
+    for (pluint i=1; i<vertices.size(); ++i) {
+        for (int d=0; d<3; ++d) {
+            llc[d] = std::min(llc[d], vertices[i][d]);
+            urc[d] = std::max(urc[d], vertices[i][d]);
+        }
+    }
+    boundingCuboid = Cuboid<T>(llc, urc);
+}
+
+template<typename T>
+T ImmersedWallVertexBuffer3D<T>::computeDisplacement(std::vector< Array<T,3> > const& newVertices) const
+{
+    T maxDisplacementSqr = T();
+    for (pluint i=0; i<vertices.size(); ++i) {
+        maxDisplacementSqr = std::max(maxDisplacementSqr, normSqr(newVertices[i]-vertices[i]));
+    }
+    return std::sqrt(maxDisplacementSqr);
+}
+
+/* ******** UpdateImmersedWallData3D ************************************ */
+
+template<typename T>
+UpdateImmersedWallData3D<T>::UpdateImmersedWallData3D (
+        std::shared_ptr<ImmersedWallVertexBuffer3D<T> const> buffer_ )
+    : buffer(buffer_),
+      lastVersion(0),
+      lastDisplacement((T)0),
+      initialized(false)
+{
+    PLB_ASSERT( buffer );
+}
+
+template<typename T>
+void UpdateImmersedWallData3D<T>::processGenericBlocks (
+        Box3D domain, std::vector<AtomicBlock3D*> blocks )
+{
+    PLB_PRECONDITION( blocks.size()==1 );
+    AtomicContainerBlock3D* container = dynamic_cast<AtomicContainerBlock3D*>(blocks[0]);
+    PLB_ASSERT( container );
+
+    if (initialized && lastVersion==buffer->getVersion()) {
+        return;
+    }
+
+    Dot3D location = container->getLocation();
+    Array<T,3> offset(location.x,location.y,location.z);
+    Box3D extendedEnvelope(domain.enlarge(2));
+
+    ImmersedWallData3D<T>* wallData =
+        dynamic_cast<ImmersedWallData3D<T>*>( container->getData() );
+    if (!wallData) {
+        wallData = new ImmersedWallData3D<T>;
+        wallData->offset = offset;
+        container->setData(wallData);
+        initialized = false;
+    }
+    PLB_ASSERT( wallData->offset[0]==offset[0] &&
+                wallData->offset[1]==offset[1] &&
+                wallData->offset[2]==offset[2] );
+
+    // The same epsilon-margin as in InstantiateImmersedWallData3D is used, so
+    // that both processors select exactly the same vertices.
+    static const T epsilon = 1.e-4;
+    Array<T,3> llc = buffer->getBoundingCuboid().lowerLeftCorner - offset;
+    Array<T,3> urc = buffer->getBoundingCuboid().upperRightCorner - offset;
+    bool intersectsEnvelope =
+        buffer->getNumVertices()>0 &&
+        urc[0]-epsilon>extendedEnvelope.x0 && llc[0]+epsilon<extendedEnvelope.x1 &&
+        urc[1]-epsilon>extendedEnvelope.y0 && llc[1]+epsilon<extendedEnvelope.y1 &&
+        urc[2]-epsilon>extendedEnvelope.z0 && llc[2]+epsilon<extendedEnvelope.z1;
+
+    if (!intersectsEnvelope && wallData->vertices.empty()) {
+        // Surface is away from this block: nothing to do.
+    }
+    else if (initialized && lastVersion>=buffer->getResetVersion()) {
+        // Same set of vertices, moved by a bounded distance.
+        updateInPlace( extendedEnvelope, offset,
+                       buffer->getAccumulatedDisplacement()-lastDisplacement, *wallData );
+    }
+    else {
+        rebuild(extendedEnvelope, offset, *wallData);
+    }
+
+    lastVersion = buffer->getVersion();
+    lastDisplacement = buffer->getAccumulatedDisplacement();
+    initialized = true;
+}
+
+template<typename T>
+void UpdateImmersedWallData3D<T>::rebuild (
+        Box3D const& extendedEnvelope, Array<T,3> const& offset, ImmersedWallData3D<T>& wallData ) const
+{
+    static const T epsilon = 1.e-4;
+
+    // The vectors are cleared but not deallocated, to avoid a reallocation on
+    // every time step.
+    wallData.vertices.clear();
+    wallData.areas.clear();
+    wallData.normals.clear();
+    wallData.g.clear();
+    wallData.flags.clear();
+    wallData.globalVertexIds.clear();
+    std::vector<pluint> candidates, ids;
+    buffer->getCandidateVertices(Cuboid<T> (
+            Array<T,3>(extendedEnvelope.x0-epsilon, extendedEnvelope.y0-epsilon, extendedEnvelope.z0-epsilon)+offset,
+            Array<T,3>(extendedEnvelope.x1+epsilon, extendedEnvelope.y1+epsilon, extendedEnvelope.z1+epsilon)+offset),
+        candidates );
+    for (pluint iCandidate=0; iCandidate<candidates.size(); ++iCandidate) {
+        pluint i = candidates[iCandidate];
+        if (contained(buffer->getVertex(i)-offset, extendedEnvelope, epsilon)) {
+            ids.push_back(i);
+        }
+    }
+    addVertices(ids, offset, wallData);
+    wallData.stencil.invalidate();
+}
+
+template<typename T>
+void UpdateImmersedWallData3D<T>::updateInPlace (
+        Box3D const& extendedEnvelope, Array<T,3> const& offset, T displacement,
+        ImmersedWallData3D<T>& wallData ) const
+{
+    static const T epsilon = 1.e-4;
+    bool useNormals = buffer->hasNormals();
+    if (useNormals) {
+        wallData.normals.resize(wallData.vertices.size());
+    }
+    else {
+        wallData.normals.clear();
+    }
+
+    // New position of the vertices of the block; the ones which have left the
+    //   envelope are removed, and the order of the others is kept.
+    std::vector<pluint>& ids = wallData.globalVertexIds;
+    pluint numKept = 0;
+    for (pluint i=0; i<wallData.vertices.size(); ++i) {
+        pluint id = ids[i];
+        Array<T,3> vertex = buffer->getVertex(id)-offset;
+        if (!contained(vertex, extendedEnvelope, epsilon)) {
+            continue;
+        }
+        wallData.vertices[numKept] = vertex;
+        wallData.areas[numKept] = buffer->getArea(id);
+        if (useNormals) {
+            wallData.normals[numKept] = buffer->getNormal(id);
+        }
+        ids[numKept] = id;
+        ++numKept;
+    }
+    wallData.vertices.resize(numKept);
+    wallData.areas.resize(numKept);
+    if (useNormals) {
+        wallData.normals.resize(numKept);
+    }
+    ids.resize(numKept);
+    wallData.g.assign(numKept, Array<T,3>((T)0.,(T)0.,(T)0.));
+    wallData.flags.assign(numKept, 0);
+
+    // A vertex which has entered the envelope is now closer to its boundary
+    //   than the distance it has moved.
+    std::vector<pluint> candidates, newIds;
+    buffer->getCandidateVertices(Cuboid<T> (
+            Array<T,3>(extendedEnvelope.x0-epsilon, extendedEnvelope.y0-epsilon, extendedEnvelope.z0-epsilon)+offset,
+            Array<T,3>(extendedEnvelope.x1+epsilon, extendedEnvelope.y1+epsilon, extendedEnvelope.z1+epsilon)+offset),
+        displacement+(T)3*epsilon, candidates );
+    for (pluint iCandidate=0; iCandidate<candidates.size(); ++iCandidate) {
+        pluint i = candidates[iCandidate];
+        if ( !std::binary_search(ids.begin(), ids.end(), i) &&
+             contained(buffer->getVertex(i)-offset, extendedEnvelope, epsilon) )
+        {
+            newIds.push_back(i);
+        }
+    }
+    addVertices(newIds, offset, wallData);
+    wallData.stencil.invalidate();
+}
+
+template<typename T>
+void UpdateImmersedWallData3D<T>::addVertices (
+        std::vector<pluint> const& newIds, Array<T,3> const& offset, ImmersedWallData3D<T>& wallData ) const
+{
+    if (newIds.empty()) {
+        return;
+    }
+    bool useNormals = buffer->hasNormals();
+    std::vector<pluint>& ids = wallData.globalVertexIds;
+    for (pluint iNew=0; iNew<newIds.size(); ++iNew) {
+        pluint i = newIds[iNew];
+        wallData.vertices.push_back(buffer->getVertex(i)-offset);
+        wallData.areas.push_back(buffer->getArea(i));
+        if (useNormals) {
+            wallData.normals.push_back(buffer->getNormal(i));
+        }
+        wallData.g.push_back(Array<T,3>((T)0.,(T)0.,(T)0.));
+        wallData.flags.push_back(0);
+        ids.push_back(i);
+    }
+    if (std::is_sorted(ids.begin(), ids.end())) {
+        return;
+    }
+    // Restore the order of the global ids.
+    std::vector<pluint> order(ids.size());
+    for (pluint i=0; i<order.size(); ++i) {
+        order[i] = i;
+    }
+    std::sort(order.begin(), order.end(), [&ids](pluint a, pluint b) { return ids[a]<ids[b]; });
+    reorder(order, wallData.vertices);
+    reorder(order, wallData.areas);
+    if (useNormals) {
+        reorder(order, wallData.normals);
+    }
+    reorder(order, wallData.g);
+    reorder(order, wallData.flags);
+    reorder(order, ids);
+}
+
+template<typename T>
+template<typename U>
+void UpdateImmersedWallData3D<T>::reorder(std::vector<pluint> const& order, std::vector<U>& data)
+{
+    std::vector<U> sorted(data.size());
+    for (pluint i=0; i<order.size(); ++i) {
+        sorted[i] = data[order[i]];
+    }
+    data.swap(sorted);
+}
+
+template<typename T>
+UpdateImmersedWallData3D<T>* UpdateImmersedWallData3D<T>::clone() const {
+    return new UpdateImmersedWallData3D<T>(*this);
+}
+
+template<typename T>
+void UpdateImmersedWallData3D<T>::getTypeOfModification(std::vector<modif::ModifT>& modified) const {
+    modified[0] = modif::staticVariables;  // Container Block with triangle data.
+}
+
+template<typename T>
+BlockDomain::DomainT UpdateImmersedWallData3D<T>::appliesTo() const {
+    return BlockDomain::bulk;
+}
+
 /* ******** InstantiateImmersedWallDataWithTagging3D ************************************ */
 
 template<typename T>
@@ -58,6 +58,9 @@ public:
     void insert();
     void apply(std::vector<MultiBlock3D*> const& completionArg);
     void insert(std::vector<MultiBlock3D*> const& completionArg);
+    /// Recompute the off-lattice pattern after the voxel-matrix was re-voxelized
+    ///   on the given domain. Only the atomic-blocks close to this domain are visited.
+    void update(Box3D const& domain);
     Array<T,3> getForceOnObject();
     std::auto_ptr<MultiTensorField3D<T,3> > computeVelocity(Box3D domain);
     std::auto_ptr<MultiTensorField3D<T,3> > computeVelocity();
@@ -210,6 +210,37 @@ void OffLatticeBoundaryCondition3D<T,Descriptor,BoundaryType>::apply (
             boundaryShapeArg.getBoundingBox(), offLatticeArg );
 }
 
+template< typename T,
+          template<typename U> class Descriptor,
+          class BoundaryType >
+void OffLatticeBoundaryCondition3D<T,Descriptor,BoundaryType>::update(Box3D const& domain)
+{
+    std::vector<MultiBlock3D*> offLatticeIniArg;
+    // First argument for compute-off-lattice-pattern.
+    offLatticeIniArg.push_back(&offLatticePattern);
+    // Remaining arguments for inner-flow-shape.
+    offLatticeIniArg.push_back(&voxelizedDomain.getVoxelMatrix());
+    offLatticeIniArg.push_back(&voxelizedDomain.getTriangleHash());
+    offLatticeIniArg.push_back(&boundaryShapeArg);
+    // The pattern of a cell depends on the voxels of its neighbors.
+    Box3D patternDomain(domain.enlarge(offLatticeModel->getNumNeighbors()));
+    // OffLatticePatternFunctional3D replaces the data of each atomic-block it is
+    //   applied to, and must therefore be executed on their full bulk.
+    SparseBlockStructure3D const& sparseBlock =
+        offLatticePattern.getMultiBlockManagement().getSparseBlockStructure();
+    std::vector<plint> ids;
+    std::vector<Box3D> intersections;
+    sparseBlock.intersect(patternDomain, ids, intersections);
+    for (pluint iBlock=0; iBlock<ids.size(); ++iBlock) {
+        Box3D bulk;
+        sparseBlock.getBulk(ids[iBlock], bulk);
+        applyProcessingFunctional (
+                new OffLatticePatternFunctional3D<T,BoundaryType> (
+                    offLatticeModel->clone() ),
+                bulk, offLatticeIniArg );
+    }
+}
+
 template< typename T,
           template<typename U> class Descriptor,
           class BoundaryType >
@@ -0,0 +1,107 @@
+/* This file is part of the Palabos library.
+ *
+ * Copyright (C) 2011-2015 FlowKit Sarl
+ * Route d'Oron 2
+ * 1010 Lausanne, Switzerland
+ * E-mail contact: contact@flowkit.com
+ *
+ * The most recent release of Palabos can be downloaded at 
+ * <http://www.palabos.org/>
+ *
+ * The library Palabos is free software: you can redistribute it and/or
+ * modify it under the terms of the GNU Affero General Public License as
+ * published by the Free Software Foundation, either version 3 of the
+ * License, or (at your option) any later version.
+ *
+ * The library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+/** \file
+ * Rigid-body representation of a triangular surface -- header file.
+ */
+#ifndef RIGID_BODY_3D_H
+#define RIGID_BODY_3D_H
+
+#include "core/globalDefs.h"
+#include "core/array.h"
+#include "core/geometry3D.h"
+#include "offLattice/triangularSurfaceMesh.h"
+#include <vector>
+
+namespace plb {
+
+/// A triangular surface which moves as a rigid body.
+/** The vertices, the vertex areas and the vertex normals are stored once, in
+ *  the body frame (centred on the mean of the vertices), together with the
+ *  inertia tensor of the body per unit density. The present position, normal
+ *  and velocity of a vertex are computed on demand from the pose (a unit
+ *  quaternion and the position of the centre) and from the linear and angular
+ *  velocities, so that moving the body costs O(1), and every process only pays
+ *  for the vertices it actually uses.
+ */
+template<typename T>
+class RigidBody3D {
+public:
+    RigidBody3D();
+    /// The body frame is aligned with the mesh in its present position. The
+    ///   vertices are also sorted into a body-frame grid of spacing cellWidth.
+    explicit RigidBody3D(TriangularSurfaceMesh<T> const& mesh, T cellWidth = (T)2);
+    pluint getNumVertices() const { return bodyVertices.size(); }
+    /// Position of the centre, in absolute lattice units.
+    Array<T,3> const& getPosition() const { return position; }
+    /// Unit quaternion (w,x,y,z) from the body to the world frame.
+    Array<T,4> const& getOrientation() const { return orientation; }
+    void setPose(Array<T,3> const& position_, Array<T,4> const& orientation_);
+    void translate(Array<T,3> const& displacement);
+    /// Rotate about the centre by |rotationVector| radians, around rotationVector.
+    void rotate(Array<T,3> const& rotationVector);
+    void setVelocity(Array<T,3> const& velocity_, Array<T,3> const& angularVelocity_);
+    Array<T,3> const& getVelocity() const { return velocity; }
+    Array<T,3> const& getAngularVelocity() const { return angularVelocity; }
+    Array<T,3> getVertex(plint iVertex) const;
+    Array<T,3> getNormal(plint iVertex) const;
+    T getArea(plint iVertex) const { return areas[iVertex]; }
+    Array<T,3> getVertexVelocity(plint iVertex) const;
+    /// Distance from the centre to the farthest vertex.
+    T getRadius() const { return radius; }
+    /// Inertia tensor about the centre, in the world frame, for a given density, as
+    ///   (Ixx, Iyy, Izz, Ixy, Ixz, Iyz), the products of inertia carrying their minus sign.
+    Array<T,6> getInertia(T rho) const;
+    /// Box which contains the body in its present pose; it is exact as long as
+    ///   the body has not rotated.
+    Cuboid<T> getBoundingCuboid() const;
+    /// Append, in increasing order, the ids of the vertices which may be inside a
+    ///   box given in the world frame; the cost depends on the size of the box,
+    ///   not on the number of vertices of the body.
+    void getVerticesInCuboid(Cuboid<T> const& cuboid, std::vector<pluint>& ids) const;
+private:
+    void computeRotationMatrix();
+    Array<T,3> toWorld(Array<T,3> const& x) const;
+    Array<T,3> toBody(Array<T,3> const& x) const;
+    plint cellIndex(Array<T,3> const& bodyVertex, int d) const;
+private:
+    std::vector< Array<T,3> > bodyVertices;
+    std::vector< Array<T,3> > bodyNormals;
+    std::vector<T> areas;
+    Array<T,6> bodyInertia;
+    Cuboid<T> bodyCuboid;
+    T radius;
+    T cellWidth;
+    Array<plint,3> numCells;
+    std::vector<plint> cellBegin;
+    std::vector<pluint> cellVertices;
+    Array<T,3> position;
+    Array<T,4> orientation;
+    Array<T,9> rotationMatrix;
+    Array<T,3> velocity, angularVelocity;
+};
+
+}  // namespace plb
+
+#endif  // RIGID_BODY_3D_H
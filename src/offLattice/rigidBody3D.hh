@@ -0,0 +1,303 @@
+/* This file is part of the Palabos library.
+ *
+ * Copyright (C) 2011-2015 FlowKit Sarl
+ * Route d'Oron 2
+ * 1010 Lausanne, Switzerland
+ * E-mail contact: contact@flowkit.com
+ *
+ * The most recent release of Palabos can be downloaded at 
+ * <http://www.palabos.org/>
+ *
+ * The library Palabos is free software: you can redistribute it and/or
+ * modify it under the terms of the GNU Affero General Public License as
+ * published by the Free Software Foundation, either version 3 of the
+ * License, or (at your option) any later version.
+ *
+ * The library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+/** \file
+ * Rigid-body representation of a triangular surface -- generic implementation.
+ */
+#ifndef RIGID_BODY_3D_HH
+#define RIGID_BODY_3D_HH
+
+#include "offLattice/rigidBody3D.h"
+#include "latticeBoltzmann/geometricOperationTemplates.h"
+#include <algorithm>
+#include <cmath>
+
+namespace plb {
+
+template<typename T>
+RigidBody3D<T>::RigidBody3D()
+    : bodyInertia((T)0,(T)0,(T)0,(T)0,(T)0,(T)0),
+      radius((T)0),
+      cellWidth((T)1),
+      numCells(0,0,0),
+      position((T)0,(T)0,(T)0),
+      orientation((T)1,(T)0,(T)0,(T)0),
+      velocity((T)0,(T)0,(T)0),
+      angularVelocity((T)0,(T)0,(T)0)
+{
+    computeRotationMatrix();
+}
+
+template<typename T>
+RigidBody3D<T>::RigidBody3D(TriangularSurfaceMesh<T> const& mesh, T cellWidth_)
+    : bodyInertia((T)0,(T)0,(T)0,(T)0,(T)0,(T)0),
+      radius((T)0),
+      cellWidth(cellWidth_),
+      position((T)0,(T)0,(T)0),
+      orientation((T)1,(T)0,(T)0,(T)0),
+      velocity((T)0,(T)0,(T)0),
+      angularVelocity((T)0,(T)0,(T)0)
+{
+    computeRotationMatrix();
+    plint numVertices = mesh.getNumVertices();
+    PLB_ASSERT( numVertices > 0 );
+    for (plint iVertex=0; iVertex<numVertices; ++iVertex) {
+        position += mesh.getVertex(iVertex);
+    }
+    position /= (T)numVertices;
+
+    bodyVertices.resize(numVertices);
+    bodyNormals.resize(numVertices);
+    areas.resize(numVertices);
+    Array<T,3> llc(mesh.getVertex(0)-position), urc(llc);
+    for (plint iVertex=0; iVertex<numVertices; ++iVertex) {
+        bodyVertices[iVertex] = mesh.getVertex(iVertex)-position;
+        bodyNormals[iVertex] = mesh.computeVertexNormal(iVertex, false);
+        areas[iVertex] = mesh.computeVertexArea(iVertex);
+        radius = std::max(radius, norm(bodyVertices[iVertex]));
+        for (int d=0; d<3; ++d) {
+            llc[d] = std::min(llc[d], bodyVertices[iVertex][d]);
+            urc[d] = std::max(urc[d], bodyVertices[iVertex][d]);
+        }
+    }
+    bodyCuboid = Cuboid<T>(llc, urc);
+
+    // Counting sort of the vertices into the grid cells.
+    PLB_ASSERT( cellWidth > (T)0 );
+    for (int d=0; d<3; ++d) {
+        numCells[d] = (plint)((urc[d]-llc[d])/cellWidth)+1;
+    }
+    cellBegin.assign(numCells[0]*numCells[1]*numCells[2]+1, 0);
+    std::vector<plint> vertexCell(numVertices);
+    for (plint iVertex=0; iVertex<numVertices; ++iVertex) {
+        Array<T,3> const& x = bodyVertices[iVertex];
+        vertexCell[iVertex] = (cellIndex(x,0)*numCells[1]+cellIndex(x,1))*numCells[2]+cellIndex(x,2);
+        ++cellBegin[vertexCell[iVertex]+1];
+    }
+    for (pluint iCell=1; iCell<cellBegin.size(); ++iCell) {
+        cellBegin[iCell] += cellBegin[iCell-1];
+    }
+    cellVertices.resize(numVertices);
+    std::vector<plint> cellEnd(cellBegin.begin(), cellBegin.end()-1);
+    for (plint iVertex=0; iVertex<numVertices; ++iVertex) {
+        cellVertices[cellEnd[vertexCell[iVertex]]++] = iVertex;
+    }
+
+    // Each triangle spans a tetrahedron with the centre, whose mass is lumped at
+    //   its own centre.
+    Array<T,3> center((T)0,(T)0,(T)0);
+    for (plint iTriangle=0; iTriangle<mesh.getNumTriangles(); ++iTriangle) {
+        Array<T,3> a(mesh.getVertex(iTriangle,0)-position);
+        Array<T,3> b(mesh.getVertex(iTriangle,1)-position);
+        Array<T,3> c(mesh.getVertex(iTriangle,2)-position);
+        T mass = std::fabs(computeTetrahedronSignedVolume(a,b,c,center));
+        Array<T,3> r((a+b+c)/(T)4);
+        bodyInertia[0] += mass*(r[1]*r[1]+r[2]*r[2]);
+        bodyInertia[1] += mass*(r[0]*r[0]+r[2]*r[2]);
+        bodyInertia[2] += mass*(r[0]*r[0]+r[1]*r[1]);
+        bodyInertia[3] -= mass*r[0]*r[1];
+        bodyInertia[4] -= mass*r[0]*r[2];
+        bodyInertia[5] -= mass*r[1]*r[2];
+    }
+}
+
+template<typename T>
+void RigidBody3D<T>::setPose(Array<T,3> const& position_, Array<T,4> const& orientation_)
+{
+    position = position_;
+    orientation = orientation_;
+    computeRotationMatrix();
+}
+
+template<typename T>
+void RigidBody3D<T>::translate(Array<T,3> const& displacement)
+{
+    position += displacement;
+}
+
+template<typename T>
+void RigidBody3D<T>::rotate(Array<T,3> const& rotationVector)
+{
+    T angle = std::sqrt(normSqr(rotationVector));
+    if (angle == (T)0) {
+        return;
+    }
+    T s = std::sin((T)0.5*angle)/angle;
+    Array<T,4> q(std::cos((T)0.5*angle), s*rotationVector[0], s*rotationVector[1], s*rotationVector[2]);
+    Array<T,4> const& p = orientation;
+    Array<T,4> qp (
+            q[0]*p[0] - q[1]*p[1] - q[2]*p[2] - q[3]*p[3],
+            q[0]*p[1] + q[1]*p[0] + q[2]*p[3] - q[3]*p[2],
+            q[0]*p[2] - q[1]*p[3] + q[2]*p[0] + q[3]*p[1],
+            q[0]*p[3] + q[1]*p[2] - q[2]*p[1] + q[3]*p[0] );
+    // Renormalize, so that rounding errors do not accumulate over many steps.
+    T norm = std::sqrt(qp[0]*qp[0]+qp[1]*qp[1]+qp[2]*qp[2]+qp[3]*qp[3]);
+    for (int i=0; i<4; ++i) {
+        qp[i] /= norm;
+    }
+    orientation = qp;
+    computeRotationMatrix();
+}
+
+template<typename T>
+void RigidBody3D<T>::setVelocity(Array<T,3> const& velocity_, Array<T,3> const& angularVelocity_)
+{
+    velocity = velocity_;
+    angularVelocity = angularVelocity_;
+}
+
+template<typename T>
+Array<T,3> RigidBody3D<T>::getVertex(plint iVertex) const
+{
+    return position + toWorld(bodyVertices[iVertex]);
+}
+
+template<typename T>
+Array<T,3> RigidBody3D<T>::getNormal(plint iVertex) const
+{
+    return toWorld(bodyNormals[iVertex]);
+}
+
+template<typename T>
+Array<T,3> RigidBody3D<T>::getVertexVelocity(plint iVertex) const
+{
+    return velocity + crossProduct(angularVelocity, toWorld(bodyVertices[iVertex]));
+}
+
+template<typename T>
+Array<T,6> RigidBody3D<T>::getInertia(T rho) const
+{
+    // I = R I_body R^T
+    Array<T,9> I;
+    I[0] = bodyInertia[0]; I[1] = bodyInertia[3]; I[2] = bodyInertia[4];
+    I[3] = bodyInertia[3]; I[4] = bodyInertia[1]; I[5] = bodyInertia[5];
+    I[6] = bodyInertia[4]; I[7] = bodyInertia[5]; I[8] = bodyInertia[2];
+    Array<T,9> const& R = rotationMatrix;
+    Array<T,9> RI, RIRt;
+    for (int i=0; i<3; ++i) {
+        for (int j=0; j<3; ++j) {
+            RI[3*i+j] = R[3*i]*I[j] + R[3*i+1]*I[3+j] + R[3*i+2]*I[6+j];
+        }
+    }
+    for (int i=0; i<3; ++i) {
+        for (int j=0; j<3; ++j) {
+            RIRt[3*i+j] = RI[3*i]*R[3*j] + RI[3*i+1]*R[3*j+1] + RI[3*i+2]*R[3*j+2];
+        }
+    }
+    return Array<T,6>(rho*RIRt[0], rho*RIRt[4], rho*RIRt[8], rho*RIRt[1], rho*RIRt[2], rho*RIRt[5]);
+}
+
+template<typename T>
+Cuboid<T> RigidBody3D<T>::getBoundingCuboid() const
+{
+    Array<T,3> center((T)0.5*(bodyCuboid.lowerLeftCorner+bodyCuboid.upperRightCorner));
+    Array<T,3> halfWidth((T)0.5*(bodyCuboid.upperRightCorner-bodyCuboid.lowerLeftCorner));
+    Array<T,3> worldCenter(position+toWorld(center));
+    Array<T,3> worldHalfWidth;
+    for (int i=0; i<3; ++i) {
+        worldHalfWidth[i] = std::fabs(rotationMatrix[3*i])*halfWidth[0] +
+                            std::fabs(rotationMatrix[3*i+1])*halfWidth[1] +
+                            std::fabs(rotationMatrix[3*i+2])*halfWidth[2];
+    }
+    return Cuboid<T>(worldCenter-worldHalfWidth, worldCenter+worldHalfWidth);
+}
+
+template<typename T>
+void RigidBody3D<T>::getVerticesInCuboid(Cuboid<T> const& cuboid, std::vector<pluint>& ids) const
+{
+    if (cellVertices.empty()) {
+        return;
+    }
+    // Box of the query in the body frame.
+    Array<T,3> center((T)0.5*(cuboid.lowerLeftCorner+cuboid.upperRightCorner));
+    Array<T,3> halfWidth((T)0.5*(cuboid.upperRightCorner-cuboid.lowerLeftCorner));
+    Array<T,3> bodyCenter(toBody(center-position));
+    Array<plint,3> from, to;
+    for (int d=0; d<3; ++d) {
+        T bodyHalfWidth = std::fabs(rotationMatrix[d])*halfWidth[0] +
+                          std::fabs(rotationMatrix[3+d])*halfWidth[1] +
+                          std::fabs(rotationMatrix[6+d])*halfWidth[2];
+        T lower = bodyCenter[d]-bodyHalfWidth;
+        T upper = bodyCenter[d]+bodyHalfWidth;
+        if (upper < bodyCuboid.lowerLeftCorner[d] || lower > bodyCuboid.upperRightCorner[d]) {
+            return;
+        }
+        from[d] = std::max((plint)0, (plint)std::floor((lower-bodyCuboid.lowerLeftCorner[d])/cellWidth));
+        to[d] = std::min(numCells[d]-1, (plint)std::floor((upper-bodyCuboid.lowerLeftCorner[d])/cellWidth));
+    }
+    pluint first = ids.size();
+    for (plint iX=from[0]; iX<=to[0]; ++iX) {
+        for (plint iY=from[1]; iY<=to[1]; ++iY) {
+            for (plint iZ=from[2]; iZ<=to[2]; ++iZ) {
+                plint iCell = (iX*numCells[1]+iY)*numCells[2]+iZ;
+                ids.insert(ids.end(), cellVertices.begin()+cellBegin[iCell], cellVertices.begin()+cellBegin[iCell+1]);
+            }
+        }
+    }
+    std::sort(ids.begin()+first, ids.end());
+}
+
+template<typename T>
+plint RigidBody3D<T>::cellIndex(Array<T,3> const& bodyVertex, int d) const
+{
+    plint iCell = (plint)((bodyVertex[d]-bodyCuboid.lowerLeftCorner[d])/cellWidth);
+    return std::min(std::max(iCell, (plint)0), numCells[d]-1);
+}
+
+template<typename T>
+void RigidBody3D<T>::computeRotationMatrix()
+{
+    T w = orientation[0], x = orientation[1], y = orientation[2], z = orientation[3];
+    rotationMatrix[0] = (T)1-(T)2*(y*y+z*z);
+    rotationMatrix[1] = (T)2*(x*y-w*z);
+    rotationMatrix[2] = (T)2*(x*z+w*y);
+    rotationMatrix[3] = (T)2*(x*y+w*z);
+    rotationMatrix[4] = (T)1-(T)2*(x*x+z*z);
+    rotationMatrix[5] = (T)2*(y*z-w*x);
+    rotationMatrix[6] = (T)2*(x*z-w*y);
+    rotationMatrix[7] = (T)2*(y*z+w*x);
+    rotationMatrix[8] = (T)1-(T)2*(x*x+y*y);
+}
+
+template<typename T>
+Array<T,3> RigidBody3D<T>::toWorld(Array<T,3> const& x) const
+{
+    Array<T,9> const& R = rotationMatrix;
+    return Array<T,3>(R[0]*x[0]+R[1]*x[1]+R[2]*x[2],
+                      R[3]*x[0]+R[4]*x[1]+R[5]*x[2],
+                      R[6]*x[0]+R[7]*x[1]+R[8]*x[2]);
+}
+
+template<typename T>
+Array<T,3> RigidBody3D<T>::toBody(Array<T,3> const& x) const
+{
+    Array<T,9> const& R = rotationMatrix;
+    return Array<T,3>(R[0]*x[0]+R[3]*x[1]+R[6]*x[2],
+                      R[1]*x[0]+R[4]*x[1]+R[7]*x[2],
+                      R[2]*x[0]+R[5]*x[1]+R[8]*x[2]);
+}
+
+}  // namespace plb
+
+#endif  // RIGID_BODY_3D_HH
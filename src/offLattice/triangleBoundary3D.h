@@ -384,7 +384,17 @@ public:
 	CombinedStatistics* getCombinedStatistics();
     template<class ParticleFieldT>
     void adjustVoxelization(MultiParticleField3D<ParticleFieldT>& particles, bool dynamicMesh);
+    /// Re-voxelize only the shell which the surface swept through since the last
+    ///   voxelization: the cells of domain (which contains the surface at the old and
+    ///   at the new position) that are closer to the surface than its largest vertex
+    ///   displacement plus borderWidth+1. Returns the domain on which the voxel flags
+    ///   may have changed.
+    Box3D adjustVoxelization(Box3D const& domain, bool dynamicMesh);
     void reparallelize(MultiBlockRedistribute3D const& redistribute);
+    /// Take over the blocks of another multi-block (typically the lattice), restricted
+    ///   to the bounding box of the voxel-matrix, so that both can be coupled by data
+    ///   processors. Cells which the voxel-matrix did not cover become solid.
+    void reparallelize(MultiBlockManagement3D const& management);
     TriangleBoundary3D<T> const& getBoundary() const { return boundary; }
     int getFlowType() const { return flowType; }
 private:
@@ -401,12 +411,15 @@ private:
     template<class ParticleFieldT>
     void reCreateTriangleHash(MultiParticleField3D<ParticleFieldT>& particles);
     void computeOuterMask();
+    void recordVertices();
 private:
     int flowType;
     plint borderWidth;
     TriangleBoundary3D<T> const& boundary;
     MultiScalarField3D<int>* voxelMatrix;
     MultiContainerBlock3D* triangleHash;
+    /// Vertices of the mesh at the last voxelization.
+    std::vector<Array<T,3> > voxelizedVertices;
 };
 
 template<typename T>
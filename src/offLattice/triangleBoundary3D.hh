@@ -1079,6 +1079,7 @@ boundary(boundary_)
     fullVoxelMatrix->setRefinementLevel(gridLevel_);
     createSparseVoxelMatrix(*fullVoxelMatrix, blockSize_, envelopeWidth_);
     createTriangleHash();
+    recordVertices();
     boundary.popSelect();
 }
 
@@ -1104,6 +1105,7 @@ VoxelizedDomain3D<T>::VoxelizedDomain3D (
     fullVoxelMatrix->setRefinementLevel(gridLevel_);
     createSparseVoxelMatrix(*fullVoxelMatrix, blockSize_, envelopeWidth_);
     createTriangleHash();
+    recordVertices();
     boundary.popSelect();
 }
 
@@ -1129,6 +1131,7 @@ VoxelizedDomain3D<T>::VoxelizedDomain3D (
     fullVoxelMatrix->setRefinementLevel(gridLevel_);
     createSparseVoxelMatrix(*fullVoxelMatrix, blockSize_, envelopeWidth_);
     createTriangleHash();
+    recordVertices();
     boundary.popSelect();
 }
 
@@ -1151,9 +1154,12 @@ void VoxelizedDomain3D<T>::createSparseVoxelMatrix (
 template<typename T>
 VoxelizedDomain3D<T>::VoxelizedDomain3D (
         VoxelizedDomain3D<T> const& rhs )
-    : boundary(rhs.boundary),
+    : flowType(rhs.flowType),
+      borderWidth(rhs.borderWidth),
+      boundary(rhs.boundary),
       voxelMatrix(new MultiScalarField3D<int>(*rhs.voxelMatrix)),
-      triangleHash(new MultiContainerBlock3D(*rhs.triangleHash))
+      triangleHash(new MultiContainerBlock3D(*rhs.triangleHash)),
+      voxelizedVertices(rhs.voxelizedVertices)
 { }
 
 template<typename T>
@@ -1200,9 +1206,65 @@ void VoxelizedDomain3D<T>::adjustVoxelization (
         revoxelize(boundary.getMesh(), *voxelMatrix, *triangleHash, borderWidth).release();
     std::swap(voxelMatrix, newVoxelMatrix);
     delete newVoxelMatrix;
+    recordVertices();
     boundary.popSelect();
 }
 
+template<typename T>
+Box3D VoxelizedDomain3D<T>::adjustVoxelization(Box3D const& domain, bool dynamicMesh)
+{
+    if (dynamicMesh) {
+        boundary.pushSelect(1,1); // Closed, Dynamic.
+    }
+    else {
+        boundary.pushSelect(1,0); // Closed, Static.
+    }
+    // The border-flags reach borderWidth cells away from the surface, and one more
+    //   layer is needed to make sure the seeds around the domain are not affected.
+    Box3D boundingBox(voxelMatrix->getBoundingBox());
+    Box3D hashDomain, voxelDomain;
+    if ( !intersect(domain.enlarge(borderWidth+1), boundingBox, hashDomain) ||
+         !intersect(hashDomain, boundingBox.enlarge(-1), voxelDomain) )
+    {
+        boundary.popSelect();
+        return Box3D(0,-1,0,-1,0,-1);
+    }
+    // The triangles are re-hashed on the atomic-blocks which intersect with the domain
+    //   only; the other ones contain no triangle, neither before nor after the move.
+    std::vector<MultiBlock3D*> hashArg;
+    hashArg.push_back(triangleHash);
+    applyProcessingFunctional (
+            new CreateTriangleHash<T>(boundary.getMesh()),
+            hashDomain, hashArg );
+    // Every point of a triangle moves by at most the largest displacement of its vertices,
+    //   so the flags can only change closer to the present surface than this distance plus
+    //   the width of the border-flags. Without a record of the previous vertices, the whole
+    //   domain is re-voxelized.
+    TriangularSurfaceMesh<T> const& mesh = boundary.getMesh();
+    plint shellWidth = std::max(std::max(voxelDomain.getNx(), voxelDomain.getNy()), voxelDomain.getNz());
+    if ((plint)voxelizedVertices.size() == mesh.getNumVertices()) {
+        T displacement = T();
+        for (plint iVertex=0; iVertex<mesh.getNumVertices(); ++iVertex) {
+            displacement = std::max(displacement, norm(mesh.getVertex(iVertex)-voxelizedVertices[iVertex]));
+        }
+        shellWidth = std::min(shellWidth, (plint)std::ceil(displacement) + borderWidth + 1);
+    }
+    revoxelize(mesh, *voxelMatrix, *triangleHash, voxelDomain, borderWidth, shellWidth);
+    recordVertices();
+    boundary.popSelect();
+    return voxelDomain;
+}
+
+template<typename T>
+void VoxelizedDomain3D<T>::recordVertices()
+{
+    TriangularSurfaceMesh<T> const& mesh = boundary.getMesh();
+    voxelizedVertices.resize(mesh.getNumVertices());
+    for (plint iVertex=0; iVertex<mesh.getNumVertices(); ++iVertex) {
+        voxelizedVertices[iVertex] = mesh.getVertex(iVertex);
+    }
+}
+
 template<typename T>
 void VoxelizedDomain3D<T>::reparallelize(MultiBlockRedistribute3D const& redistribute) {
     MultiBlockManagement3D newManagement = redistribute.redistribute(voxelMatrix->getMultiBlockManagement());
@@ -1219,6 +1281,27 @@ void VoxelizedDomain3D<T>::reparallelize(MultiBlockRedistribute3D const& redistr
     createTriangleHash();
 }
 
+template<typename T>
+void VoxelizedDomain3D<T>::reparallelize(MultiBlockManagement3D const& management) {
+    MultiBlockManagement3D newManagement (
+            intersect(management.getSparseBlockStructure(), voxelMatrix->getBoundingBox(), true),
+            management.getThreadAttribution().clone(),
+            voxelMatrix->getMultiBlockManagement().getEnvelopeWidth(),
+            voxelMatrix->getMultiBlockManagement().getRefinementLevel() );
+    int solidFlag = flowType==voxelFlag::inside ? voxelFlag::outside : voxelFlag::inside;
+    MultiScalarField3D<int>* newVoxelMatrix =
+        new MultiScalarField3D<int>(
+                newManagement,
+                voxelMatrix->getBlockCommunicator().clone(),
+                voxelMatrix->getCombinedStatistics().clone(),
+                defaultMultiBlockPolicy3D().getMultiScalarAccess<int>(), solidFlag );
+    copyNonLocal(*voxelMatrix, *newVoxelMatrix, voxelMatrix->getBoundingBox());
+    std::swap(voxelMatrix, newVoxelMatrix);
+    delete newVoxelMatrix;
+    delete triangleHash;
+    createTriangleHash();
+}
+
 template<typename T>
 MultiBlockManagement3D const&
     VoxelizedDomain3D<T>::getMultiBlockManagement() const
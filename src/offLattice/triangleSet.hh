@@ -148,7 +148,6 @@ bool TriangleSet<T>::isAsciiSTL(FILE* fp)
     (void) fread(buf, sizeof(char), PLB_CBUFSIZ, fp);
 #endif
     PLB_ASSERT(sz == PLB_CBUFSIZ); // The input file cannot be read.
-	std::string bug = std::to_string(sz);
     buf[PLB_CBUFSIZ] = '\0';
     rewind(fp);
 
@@ -0,0 +1,162 @@
+/* This file is part of the Palabos library.
+ *
+ * Copyright (C) 2011-2015 FlowKit Sarl
+ * Route d'Oron 2
+ * 1010 Lausanne, Switzerland
+ * E-mail contact: contact@flowkit.com
+ *
+ * The most recent release of Palabos can be downloaded at 
+ * <http://www.palabos.org/>
+ *
+ * The library Palabos is free software: you can redistribute it and/or
+ * modify it under the terms of the GNU Affero General Public License as
+ * published by the Free Software Foundation, either version 3 of the
+ * License, or (at your option) any later version.
+ *
+ * The library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+/** \file
+ * Domain decomposition from voxelized geometries -- implementation.
+ */
+
+#include "offLattice/voxelDecomposition3D.h"
+#include "offLattice/voxelizer.h"
+#include "multiBlock/redistribution3D.h"
+#include "multiBlock/sparseBlockStructure3D.h"
+#include "multiBlock/threadAttribution.h"
+#include "atomicBlock/dataField3D.h"
+#include "atomicBlock/dataField3D.hh"
+#include "multiBlock/multiDataField3D.hh"
+#include "parallelism/mpiManager.h"
+#include "parallelism/threadPool.h"
+#include "core/plbDebug.h"
+#include <algorithm>
+#include <cmath>
+#include <map>
+#include <vector>
+
+namespace plb {
+
+namespace {
+
+/// Regular grid of cubes which covers a bounding box; the cubes at the
+///   upper end of each direction may be cut.
+struct CubeGrid3D {
+    CubeGrid3D(Box3D const& boundingBox_, plint blockSize_)
+        : boundingBox(boundingBox_),
+          blockSize(blockSize_),
+          nx((boundingBox.getNx()+blockSize-1)/blockSize),
+          ny((boundingBox.getNy()+blockSize-1)/blockSize),
+          nz((boundingBox.getNz()+blockSize-1)/blockSize)
+    { }
+    plint numCubes() const { return nx*ny*nz; }
+    plint index(plint iX, plint iY, plint iZ) const {
+        return ( (iX-boundingBox.x0)/blockSize*ny
+                 + (iY-boundingBox.y0)/blockSize ) * nz
+               + (iZ-boundingBox.z0)/blockSize;
+    }
+    Box3D cube(plint index) const {
+        plint cX = index / (ny*nz);
+        plint cY = (index / nz) % ny;
+        plint cZ = index % nz;
+        Box3D result( boundingBox.x0+cX*blockSize, boundingBox.x0+(cX+1)*blockSize-1,
+                      boundingBox.y0+cY*blockSize, boundingBox.y0+(cY+1)*blockSize-1,
+                      boundingBox.z0+cZ*blockSize, boundingBox.z0+(cZ+1)*blockSize-1 );
+        Box3D cut;
+        intersect(result, boundingBox, cut);
+        return cut;
+    }
+    Box3D boundingBox;
+    plint blockSize, nx, ny, nz;
+};
+
+/// Bulk flag of the solid side, for a given flow type.
+int solidFlag(int flowType) {
+    PLB_ASSERT( flowType==voxelFlag::inside || flowType==voxelFlag::outside );
+    return flowType==voxelFlag::inside ? voxelFlag::outside : voxelFlag::inside;
+}
+
+/// Count, for each cube, the cells of the local blocks of a voxel-matrix
+///   which carry the given flag, or which do not carry it if "match" is false.
+void countFlags ( MultiScalarField3D<int> const& voxelMatrix, CubeGrid3D const& grid,
+                  int flag, bool match, std::vector<plint>& counts )
+{
+    Box3D const& boundingBox = grid.boundingBox;
+    std::vector<plint> const& blocks = voxelMatrix.getLocalInfo().getBlocks();
+    for (pluint iBlock=0; iBlock<blocks.size(); ++iBlock) {
+        plint blockId = blocks[iBlock];
+        ScalarField3D<int> const& field = voxelMatrix.getComponent(blockId);
+        SmartBulk3D bulk(voxelMatrix.getMultiBlockManagement(), blockId);
+        Box3D domain;
+        if (!intersect(bulk.getBulk(), boundingBox, domain)) continue;
+        for (plint iX=domain.x0; iX<=domain.x1; ++iX) {
+            for (plint iY=domain.y0; iY<=domain.y1; ++iY) {
+                for (plint iZ=domain.z0; iZ<=domain.z1; ++iZ) {
+                    int value = field.get(bulk.toLocalX(iX), bulk.toLocalY(iY), bulk.toLocalZ(iZ));
+                    if ((value==flag) == match) {
+                        ++counts[grid.index(iX,iY,iZ)];
+                    }
+                }
+            }
+        }
+    }
+}
+
+}  // namespace
+
+MultiBlockManagement3D computeVoxelManagement (
+        MultiScalarField3D<int> const& wallMatrix, int wallFlowType,
+        MultiScalarField3D<int> const& obstacleMatrix, int obstacleFlowType,
+        plint blockSize, plint envelopeWidth, double inactiveWeight )
+{
+    Box3D boundingBox = wallMatrix.getBoundingBox();
+    plint numProcesses = global::mpi().getSize();
+    plint numThreads = global::threadPool().getNumThreads();
+    if (blockSize<=0) {
+        double cellsPerCube = (double)boundingBox.nCells() / (double)(8*numProcesses*numThreads);
+        blockSize = std::max((plint)1, (plint)std::cbrt(cellsPerCube));
+    }
+    CubeGrid3D grid(boundingBox, blockSize);
+
+    // Non-solid cells of the wall, and solid cells of the obstacle.
+    std::vector<plint> numFluid(grid.numCubes(), 0);
+    std::vector<plint> numObstacle(grid.numCubes(), 0);
+    countFlags(wallMatrix, grid, solidFlag(wallFlowType), false, numFluid);
+    countFlags(obstacleMatrix, grid, solidFlag(obstacleFlowType), true, numObstacle);
+#ifdef PLB_MPI_PARALLEL
+    global::mpi().allReduceVect(numFluid, MPI_SUM);
+    global::mpi().allReduceVect(numObstacle, MPI_SUM);
+#endif
+
+    SparseBlockStructure3D sparseBlock(boundingBox);
+    std::map<plint,double> costs;
+    plint newId = 0;
+    for (plint iCube=0; iCube<grid.numCubes(); ++iCube) {
+        if (numFluid[iCube]==0) continue;
+        Box3D cube(grid.cube(iCube));
+        plint numActive = std::max((plint)0, numFluid[iCube]-numObstacle[iCube]);
+        sparseBlock.addBlock(cube, cube, newId);
+        costs[newId] = (double)numActive + inactiveWeight*(double)(cube.nCells()-numActive);
+        ++newId;
+    }
+    // If this assertion fails, the wall voxel-matrix contains no fluid cell.
+    PLB_ASSERT( newId>0 );
+
+    ExplicitThreadAttribution* attribution = new ExplicitThreadAttribution;
+    for (plint iBlock=0; iBlock<newId; ++iBlock) {
+        attribution->addBlock(iBlock, 0);
+    }
+    MultiBlockManagement3D management (
+            sparseBlock, attribution, envelopeWidth,
+            wallMatrix.getMultiBlockManagement().getRefinementLevel() );
+    return WeightedHilbertRedistribute3D(costs, numProcesses, numThreads).redistribute(management);
+}
+
+}  // namespace plb
@@ -0,0 +1,60 @@
+/* This file is part of the Palabos library.
+ *
+ * Copyright (C) 2011-2015 FlowKit Sarl
+ * Route d'Oron 2
+ * 1010 Lausanne, Switzerland
+ * E-mail contact: contact@flowkit.com
+ *
+ * The most recent release of Palabos can be downloaded at 
+ * <http://www.palabos.org/>
+ *
+ * The library Palabos is free software: you can redistribute it and/or
+ * modify it under the terms of the GNU Affero General Public License as
+ * published by the Free Software Foundation, either version 3 of the
+ * License, or (at your option) any later version.
+ *
+ * The library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+/** \file
+ * Domain decomposition from voxelized geometries -- header file.
+ */
+
+#ifndef VOXEL_DECOMPOSITION_3D_H
+#define VOXEL_DECOMPOSITION_3D_H
+
+#include "core/globalDefs.h"
+#include "multiBlock/multiBlockManagement3D.h"
+#include "multiBlock/multiDataField3D.h"
+
+namespace plb {
+
+/// Cover the bounding box of the wall voxel-matrix with cubes, drop the cubes
+///   which are entirely solid, and distribute the others over the processes
+///   and threads such that each of them gets the same number of active cells.
+/** A cell is solid for a voxel-matrix if it carries the bulk flag opposite to
+ *  the flow type (voxelFlag::outside for a flow inside the wall), or, for the
+ *  wall, if it is not covered by the (sparse) voxel-matrix. Cells which are
+ *  solid for the obstacle remain in the domain, because the obstacle may move,
+ *  but count as inactiveWeight instead of one. The obstacle is assumed to lie
+ *  within the fluid region of the wall.
+ *
+ *  The cubes have a side of blockSize; if blockSize is not positive, it is
+ *  chosen to produce about eight cubes per thread. The blocks are attributed
+ *  along a Hilbert curve (see WeightedHilbertRedistribute3D). This is a
+ *  collective operation.
+ */
+MultiBlockManagement3D computeVoxelManagement (
+        MultiScalarField3D<int> const& wallMatrix, int wallFlowType,
+        MultiScalarField3D<int> const& obstacleMatrix, int obstacleFlowType,
+        plint blockSize, plint envelopeWidth, double inactiveWeight=0.1 );
+
+}  // namespace plb
+
+#endif  // VOXEL_DECOMPOSITION_3D_H
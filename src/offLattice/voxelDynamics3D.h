@@ -0,0 +1,81 @@
+/* This file is part of the Palabos library.
+ *
+ * Copyright (C) 2011-2015 FlowKit Sarl
+ * Route d'Oron 2
+ * 1010 Lausanne, Switzerland
+ * E-mail contact: contact@flowkit.com
+ *
+ * The most recent release of Palabos can be downloaded at 
+ * <http://www.palabos.org/>
+ *
+ * The library Palabos is free software: you can redistribute it and/or
+ * modify it under the terms of the GNU Affero General Public License as
+ * published by the Free Software Foundation, either version 3 of the
+ * License, or (at your option) any later version.
+ *
+ * The library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+/** \file
+ * Re-assignment of the dynamics after a re-voxelization -- header file.
+ */
+
+#ifndef VOXEL_DYNAMICS_3D_H
+#define VOXEL_DYNAMICS_3D_H
+
+#include "core/globalDefs.h"
+#include "core/dynamics.h"
+#include "atomicBlock/dataProcessingFunctional3D.h"
+#include "multiBlock/multiBlockLattice3D.h"
+#include "multiBlock/multiDataField3D.h"
+#include <vector>
+
+namespace plb {
+
+/// Bring the dynamics of the lattice in agreement with voxel-matrices which have
+///   changed, for example after a moving obstacle was re-voxelized. A cell is solid
+///   if, in any of the voxel-matrices, it carries the corresponding solid flag.
+///   Solid cells which became fluid get the fluid dynamics and are initialized at
+///   equilibrium; fluid cells which became solid get NoDynamics. The other cells
+///   are left untouched.
+/// Block 0: Lattice; Blocks 1..n: Voxel-matrices.
+template<typename T, template<typename U> class Descriptor>
+class VoxelDynamicsFunctional3D : public BoxProcessingFunctional3D {
+public:
+    VoxelDynamicsFunctional3D (
+            Dynamics<T,Descriptor>* fluidDynamics_, std::vector<int> const& solidFlags_,
+            T density_, Array<T,3> const& velocity_ );
+    VoxelDynamicsFunctional3D(VoxelDynamicsFunctional3D<T,Descriptor> const& rhs);
+    VoxelDynamicsFunctional3D<T,Descriptor>& operator= (
+            VoxelDynamicsFunctional3D<T,Descriptor> const& rhs );
+    virtual ~VoxelDynamicsFunctional3D();
+    virtual void processGenericBlocks(Box3D domain, std::vector<AtomicBlock3D*> blocks);
+    virtual VoxelDynamicsFunctional3D<T,Descriptor>* clone() const;
+    virtual BlockDomain::DomainT appliesTo() const;
+    virtual void getTypeOfModification(std::vector<modif::ModifT>& modified) const;
+private:
+    Dynamics<T,Descriptor>* fluidDynamics;
+    std::vector<int> solidFlags;
+    T density;
+    Array<T,3> velocity;
+    int noDynamicsId;
+};
+
+/// Re-assign the dynamics on a domain, see VoxelDynamicsFunctional3D. The voxel-matrices
+///   must have the same block distribution as the lattice.
+template<typename T, template<typename U> class Descriptor>
+void updateVoxelDynamics (
+        MultiBlockLattice3D<T,Descriptor>& lattice,
+        std::vector<MultiScalarField3D<int>*> const& voxelMatrices,
+        std::vector<int> const& solidFlags, Box3D domain,
+        Dynamics<T,Descriptor>* fluidDynamics, T density, Array<T,3> const& velocity );
+
+}  // namespace plb
+
+#endif  // VOXEL_DYNAMICS_3D_H
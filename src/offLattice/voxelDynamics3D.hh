@@ -0,0 +1,162 @@
+/* This file is part of the Palabos library.
+ *
+ * Copyright (C) 2011-2015 FlowKit Sarl
+ * Route d'Oron 2
+ * 1010 Lausanne, Switzerland
+ * E-mail contact: contact@flowkit.com
+ *
+ * The most recent release of Palabos can be downloaded at 
+ * <http://www.palabos.org/>
+ *
+ * The library Palabos is free software: you can redistribute it and/or
+ * modify it under the terms of the GNU Affero General Public License as
+ * published by the Free Software Foundation, either version 3 of the
+ * License, or (at your option) any later version.
+ *
+ * The library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+/** \file
+ * Re-assignment of the dynamics after a re-voxelization -- generic implementation.
+ */
+
+#ifndef VOXEL_DYNAMICS_3D_HH
+#define VOXEL_DYNAMICS_3D_HH
+
+#include "offLattice/voxelDynamics3D.h"
+#include "core/cell.h"
+#include "atomicBlock/blockLattice3D.h"
+#include "atomicBlock/dataField3D.h"
+#include "atomicBlock/dataProcessingFunctional3D.hh"
+
+namespace plb {
+
+/* ******** VoxelDynamicsFunctional3D ************************************ */
+
+template<typename T, template<typename U> class Descriptor>
+VoxelDynamicsFunctional3D<T,Descriptor>::VoxelDynamicsFunctional3D (
+        Dynamics<T,Descriptor>* fluidDynamics_, std::vector<int> const& solidFlags_,
+        T density_, Array<T,3> const& velocity_ )
+    : fluidDynamics(fluidDynamics_),
+      solidFlags(solidFlags_),
+      density(density_),
+      velocity(velocity_),
+      noDynamicsId(NoDynamics<T,Descriptor>().getId())
+{ }
+
+template<typename T, template<typename U> class Descriptor>
+VoxelDynamicsFunctional3D<T,Descriptor>::VoxelDynamicsFunctional3D (
+        VoxelDynamicsFunctional3D<T,Descriptor> const& rhs )
+    : fluidDynamics(rhs.fluidDynamics->clone()),
+      solidFlags(rhs.solidFlags),
+      density(rhs.density),
+      velocity(rhs.velocity),
+      noDynamicsId(rhs.noDynamicsId)
+{ }
+
+template<typename T, template<typename U> class Descriptor>
+VoxelDynamicsFunctional3D<T,Descriptor>&
+    VoxelDynamicsFunctional3D<T,Descriptor>::operator= (
+        VoxelDynamicsFunctional3D<T,Descriptor> const& rhs )
+{
+    delete fluidDynamics; fluidDynamics = rhs.fluidDynamics->clone();
+    solidFlags = rhs.solidFlags;
+    density = rhs.density;
+    velocity = rhs.velocity;
+    noDynamicsId = rhs.noDynamicsId;
+    return *this;
+}
+
+template<typename T, template<typename U> class Descriptor>
+VoxelDynamicsFunctional3D<T,Descriptor>::~VoxelDynamicsFunctional3D() {
+    delete fluidDynamics;
+}
+
+template<typename T, template<typename U> class Descriptor>
+void VoxelDynamicsFunctional3D<T,Descriptor>::processGenericBlocks (
+        Box3D domain, std::vector<AtomicBlock3D*> blocks )
+{
+    PLB_PRECONDITION( blocks.size()==solidFlags.size()+1 );
+    BlockLattice3D<T,Descriptor>& lattice =
+        dynamic_cast<BlockLattice3D<T,Descriptor>&>(*blocks[0]);
+    plint numMatrices = (plint)solidFlags.size();
+    std::vector<ScalarField3D<int>*> voxels(numMatrices);
+    std::vector<Dot3D> offsets(numMatrices);
+    for (plint iMatrix=0; iMatrix<numMatrices; ++iMatrix) {
+        voxels[iMatrix] = dynamic_cast<ScalarField3D<int>*>(blocks[iMatrix+1]);
+        PLB_ASSERT( voxels[iMatrix] );
+        offsets[iMatrix] = computeRelativeDisplacement(lattice, *voxels[iMatrix]);
+    }
+    for (plint iX=domain.x0; iX<=domain.x1; ++iX) {
+        for (plint iY=domain.y0; iY<=domain.y1; ++iY) {
+            for (plint iZ=domain.z0; iZ<=domain.z1; ++iZ) {
+                bool isSolid = false;
+                for (plint iMatrix=0; iMatrix<numMatrices && !isSolid; ++iMatrix) {
+                    Dot3D const& off = offsets[iMatrix];
+                    isSolid = voxels[iMatrix]->get(iX+off.x,iY+off.y,iZ+off.z)==solidFlags[iMatrix];
+                }
+                bool wasSolid = lattice.get(iX,iY,iZ).getDynamics().getId()==noDynamicsId;
+                if (isSolid && !wasSolid) {
+                    lattice.attributeDynamics(iX,iY,iZ, new NoDynamics<T,Descriptor>);
+                }
+                else if (wasSolid && !isSolid) {
+                    lattice.attributeDynamics(iX,iY,iZ, fluidDynamics->clone());
+                    iniCellAtEquilibrium(lattice.get(iX,iY,iZ), density, velocity);
+                }
+            }
+        }
+    }
+}
+
+template<typename T, template<typename U> class Descriptor>
+VoxelDynamicsFunctional3D<T,Descriptor>*
+    VoxelDynamicsFunctional3D<T,Descriptor>::clone() const
+{
+    return new VoxelDynamicsFunctional3D<T,Descriptor>(*this);
+}
+
+template<typename T, template<typename U> class Descriptor>
+BlockDomain::DomainT VoxelDynamicsFunctional3D<T,Descriptor>::appliesTo() const {
+    // Dynamics needs to be instantiated everywhere, including envelope.
+    return BlockDomain::bulkAndEnvelope;
+}
+
+template<typename T, template<typename U> class Descriptor>
+void VoxelDynamicsFunctional3D<T,Descriptor>::getTypeOfModification (
+        std::vector<modif::ModifT>& modified ) const
+{
+    modified[0] = modif::staticVariables;
+    for (pluint iMatrix=1; iMatrix<modified.size(); ++iMatrix) {
+        modified[iMatrix] = modif::nothing;
+    }
+}
+
+
+template<typename T, template<typename U> class Descriptor>
+void updateVoxelDynamics (
+        MultiBlockLattice3D<T,Descriptor>& lattice,
+        std::vector<MultiScalarField3D<int>*> const& voxelMatrices,
+        std::vector<int> const& solidFlags, Box3D domain,
+        Dynamics<T,Descriptor>* fluidDynamics, T density, Array<T,3> const& velocity )
+{
+    PLB_PRECONDITION( voxelMatrices.size()==solidFlags.size() );
+    std::vector<MultiBlock3D*> args;
+    args.push_back(&lattice);
+    for (pluint iMatrix=0; iMatrix<voxelMatrices.size(); ++iMatrix) {
+        args.push_back(voxelMatrices[iMatrix]);
+    }
+    applyProcessingFunctional (
+            new VoxelDynamicsFunctional3D<T,Descriptor> (
+                fluidDynamics, solidFlags, density, velocity ),
+            domain, args );
+}
+
+}  // namespace plb
+
+#endif  // VOXEL_DYNAMICS_3D_HH
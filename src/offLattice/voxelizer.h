@@ -29,7 +29,9 @@
 
 #include "core/globalDefs.h"
 #include "atomicBlock/dataProcessingFunctional3D.h"
+#include "offLattice/triangularSurfaceMesh.h"
 #include "offLattice/triangleHash.h"
+#include <memory>
 
 namespace plb {
 
@@ -76,6 +78,18 @@ std::auto_ptr<MultiScalarField3D<int> > revoxelize (
         MultiScalarField3D<int>& oldVoxelMatrix,
         MultiContainerBlock3D& hashContainer, plint borderWidth );
 
+/// Re-voxelize, in place, the cells of a sub-domain of an existing voxel-matrix
+///   which are at most shellWidth cells away from a triangle of the mesh. The other
+///   cells keep their flag and serve as seed: shellWidth must exceed the displacement
+///   of the surface since the previous voxelization by at least borderWidth+1 cells,
+///   and so must the distance between the surface and the border of the domain.
+template<typename T>
+void revoxelize (
+        TriangularSurfaceMesh<T> const& mesh,
+        MultiScalarField3D<int>& voxelMatrix,
+        MultiContainerBlock3D& hashContainer,
+        Box3D const& domain, plint borderWidth, plint shellWidth );
+
 template<typename T>
 class VoxelizeMeshFunctional3D : public BoxProcessingFunctional3D {
 public:
@@ -118,6 +132,8 @@ class DetectBorderLineFunctional3D : public BoxProcessingFunctional3D_S<T> {
 public:
     DetectBorderLineFunctional3D(plint borderWidth_);
     virtual void process(Box3D domain, ScalarField3D<T>& voxels);
+    /// Apply the conversion to the cell (iX,iY,iZ) only.
+    static void detectBorder(ScalarField3D<T>& voxels, plint iX, plint iY, plint iZ, plint borderWidth);
     virtual DetectBorderLineFunctional3D<T>* clone() const;
     virtual void getTypeOfModification(std::vector<modif::ModifT>& modified) const;
     virtual BlockDomain::DomainT appliesTo() const;
@@ -125,6 +141,41 @@ private:
     plint borderWidth;
 };
 
+/// Bounding box of a triangle of the mesh, enlarged by width cells.
+template<typename T>
+Box3D triangleBoundingBox(TriangularSurfaceMesh<T> const& mesh, plint iTriangle, plint width);
+
+/// Reset to undetermined the cells which are at most shellWidth cells away
+///   from a triangle of the mesh.
+template<typename T>
+class UndetermineShellFunctional3D : public BoxProcessingFunctional3D_S<int> {
+public:
+    UndetermineShellFunctional3D(TriangularSurfaceMesh<T> const& mesh_, plint shellWidth_);
+    virtual void process(Box3D domain, ScalarField3D<int>& voxels);
+    virtual UndetermineShellFunctional3D<T>* clone() const;
+    virtual void getTypeOfModification(std::vector<modif::ModifT>& modified) const;
+    virtual BlockDomain::DomainT appliesTo() const;
+private:
+    TriangularSurfaceMesh<T> const& mesh;
+    plint shellWidth;
+};
+
+/// Same as DetectBorderLineFunctional3D, restricted to the cells which are at most
+///   shellWidth cells away from a triangle of the mesh.
+template<typename T>
+class DetectShellBorderLineFunctional3D : public BoxProcessingFunctional3D_S<int> {
+public:
+    DetectShellBorderLineFunctional3D(TriangularSurfaceMesh<T> const& mesh_,
+                                      plint shellWidth_, plint borderWidth_);
+    virtual void process(Box3D domain, ScalarField3D<int>& voxels);
+    virtual DetectShellBorderLineFunctional3D<T>* clone() const;
+    virtual void getTypeOfModification(std::vector<modif::ModifT>& modified) const;
+    virtual BlockDomain::DomainT appliesTo() const;
+private:
+    TriangularSurfaceMesh<T> const& mesh;
+    plint shellWidth, borderWidth;
+};
+
 } // namespace plb
 
 #endif  // VOXELIZER_H
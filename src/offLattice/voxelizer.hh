@@ -224,6 +224,46 @@ std::auto_ptr<MultiScalarField3D<int> > revoxelize (
 	return ptr;
 }
 
+template<typename T>
+void revoxelize (
+        TriangularSurfaceMesh<T> const& mesh,
+        MultiScalarField3D<int>& voxelMatrix,
+        MultiContainerBlock3D& hashContainer,
+        Box3D const& domain, plint borderWidth, plint shellWidth )
+{
+	try{
+    applyProcessingFunctional (
+            new UndetermineShellFunctional3D<T>(mesh, shellWidth),
+            domain, voxelMatrix );
+
+    std::vector<MultiBlock3D*> flag_hash_arg;
+    flag_hash_arg.push_back(&voxelMatrix);
+    flag_hash_arg.push_back(&hashContainer);
+
+    // Flags are used internally by VoxelizeMeshFunctional3D. The atomic-blocks
+    //   which do not intersect with the domain are already voxelized.
+    voxelMatrix.resetFlags();
+    MultiBlockManagement3D const& management = voxelMatrix.getMultiBlockManagement();
+    std::vector<plint> const& blocks = management.getLocalInfo().getBlocks();
+    for (pluint iBlock=0; iBlock<blocks.size(); ++iBlock) {
+        Box3D inters;
+        if (!intersect(management.getBulk(blocks[iBlock]), domain, inters)) {
+            voxelMatrix.getComponent(blocks[iBlock]).setFlag(true);
+        }
+    }
+    while (!allFlagsTrue(&voxelMatrix)) {
+        applyProcessingFunctional (
+                new VoxelizeMeshFunctional3D<T>(mesh),
+                domain, flag_hash_arg );
+    }
+
+    applyProcessingFunctional (
+            new DetectShellBorderLineFunctional3D<T>(mesh, shellWidth, borderWidth),
+            domain, voxelMatrix );
+	}
+	catch(const std::exception& e){exHandler(e,__FILE__,__FUNCTION__,__LINE__);}
+}
+
 
 /* ******** VoxelizeMeshFunctional3D ************************************* */
 
@@ -657,26 +697,7 @@ void DetectBorderLineFunctional3D<T>::process (
     for (plint iX = domain.x0; iX <= domain.x1; ++iX) {
         for (plint iY = domain.y0; iY <= domain.y1; ++iY) {
             for (plint iZ = domain.z0; iZ <= domain.z1; ++iZ) {
-                for (plint dx=-borderWidth; dx<=borderWidth; ++dx)
-                for (plint dy=-borderWidth; dy<=borderWidth; ++dy)
-                for (plint dz=-borderWidth; dz<=borderWidth; ++dz)
-                if(!(dx==0 && dy==0 && dz==0)) {
-                    plint nextX = iX + dx;
-                    plint nextY = iY + dy;
-                    plint nextZ = iZ + dz;
-                    if (contained(Dot3D(nextX,nextY,nextZ),voxels.getBoundingBox())) {
-                        if ( voxelFlag::outsideFlag(voxels.get(iX,iY,iZ)) &&
-                             voxelFlag::insideFlag(voxels.get(nextX,nextY,nextZ)) )
-                        {
-                            voxels.get(iX,iY,iZ) = voxelFlag::outerBorder;
-                        }
-                        if ( voxelFlag::insideFlag(voxels.get(iX,iY,iZ)) &&
-                             voxelFlag::outsideFlag(voxels.get(nextX,nextY,nextZ)) )
-                        {
-                            voxels.get(iX,iY,iZ) = voxelFlag::innerBorder;
-                        }
-                    }
-                }
+                detectBorder(voxels, iX, iY, iZ, borderWidth);
             }
         }
     }
@@ -684,6 +705,32 @@ void DetectBorderLineFunctional3D<T>::process (
 	catch(const std::exception& e){exHandler(e,__FILE__,__FUNCTION__,__LINE__);}
 }
 
+template<typename T>
+void DetectBorderLineFunctional3D<T>::detectBorder (
+        ScalarField3D<T>& voxels, plint iX, plint iY, plint iZ, plint borderWidth )
+{
+    for (plint dx=-borderWidth; dx<=borderWidth; ++dx)
+    for (plint dy=-borderWidth; dy<=borderWidth; ++dy)
+    for (plint dz=-borderWidth; dz<=borderWidth; ++dz)
+    if(!(dx==0 && dy==0 && dz==0)) {
+        plint nextX = iX + dx;
+        plint nextY = iY + dy;
+        plint nextZ = iZ + dz;
+        if (contained(Dot3D(nextX,nextY,nextZ),voxels.getBoundingBox())) {
+            if ( voxelFlag::outsideFlag(voxels.get(iX,iY,iZ)) &&
+                 voxelFlag::insideFlag(voxels.get(nextX,nextY,nextZ)) )
+            {
+                voxels.get(iX,iY,iZ) = voxelFlag::outerBorder;
+            }
+            if ( voxelFlag::insideFlag(voxels.get(iX,iY,iZ)) &&
+                 voxelFlag::outsideFlag(voxels.get(nextX,nextY,nextZ)) )
+            {
+                voxels.get(iX,iY,iZ) = voxelFlag::innerBorder;
+            }
+        }
+    }
+}
+
 template<typename T>
 DetectBorderLineFunctional3D<T>* DetectBorderLineFunctional3D<T>::clone() const {
 	try{
@@ -704,6 +751,133 @@ try{return BlockDomain::bulk;}
 catch(const std::exception& e){exHandler(e,__FILE__,__FUNCTION__,__LINE__);}
 }
 
+
+
+/* ******** UndetermineShellFunctional3D ************************************* */
+
+template<typename T>
+Box3D triangleBoundingBox(TriangularSurfaceMesh<T> const& mesh, plint iTriangle, plint width)
+{
+    Array<T,3> const& p0 = mesh.getVertex(iTriangle, 0);
+    Array<T,3> const& p1 = mesh.getVertex(iTriangle, 1);
+    Array<T,3> const& p2 = mesh.getVertex(iTriangle, 2);
+    Array<plint,3> lower, upper;
+    for (int iD=0; iD<3; ++iD) {
+        lower[iD] = (plint)std::floor(std::min(p0[iD], std::min(p1[iD], p2[iD]))) - width;
+        upper[iD] = (plint)std::ceil (std::max(p0[iD], std::max(p1[iD], p2[iD]))) + width;
+    }
+    return Box3D(lower[0], upper[0], lower[1], upper[1], lower[2], upper[2]);
+}
+
+template<typename T>
+UndetermineShellFunctional3D<T>::UndetermineShellFunctional3D (
+        TriangularSurfaceMesh<T> const& mesh_, plint shellWidth_ )
+    : mesh(mesh_),
+      shellWidth(shellWidth_)
+{ }
+
+template<typename T>
+void UndetermineShellFunctional3D<T>::process (
+        Box3D domain, ScalarField3D<int>& voxels )
+{
+	try{
+    Dot3D location = voxels.getLocation();
+    Box3D absoluteDomain(domain.shift(location.x, location.y, location.z));
+    for (plint iTriangle=0; iTriangle<mesh.getNumTriangles(); ++iTriangle) {
+        Box3D shell;
+        if (intersect(triangleBoundingBox(mesh, iTriangle, shellWidth), absoluteDomain, shell)) {
+            shell = shell.shift(-location.x, -location.y, -location.z);
+            for (plint iX = shell.x0; iX <= shell.x1; ++iX) {
+                for (plint iY = shell.y0; iY <= shell.y1; ++iY) {
+                    for (plint iZ = shell.z0; iZ <= shell.z1; ++iZ) {
+                        voxels.get(iX,iY,iZ) = voxelFlag::undetermined;
+                    }
+                }
+            }
+        }
+    }
+	}
+	catch(const std::exception& e){exHandler(e,__FILE__,__FUNCTION__,__LINE__);}
+}
+
+template<typename T>
+UndetermineShellFunctional3D<T>* UndetermineShellFunctional3D<T>::clone() const {
+    return new UndetermineShellFunctional3D<T>(*this);
+}
+
+template<typename T>
+void UndetermineShellFunctional3D<T>::getTypeOfModification(std::vector<modif::ModifT>& modified) const {
+    modified[0] = modif::staticVariables;
+}
+
+template<typename T>
+BlockDomain::DomainT UndetermineShellFunctional3D<T>::appliesTo() const {
+    return BlockDomain::bulk;
+}
+
+
+/* ******** DetectShellBorderLineFunctional3D ************************************* */
+
+template<typename T>
+DetectShellBorderLineFunctional3D<T>::DetectShellBorderLineFunctional3D (
+        TriangularSurfaceMesh<T> const& mesh_, plint shellWidth_, plint borderWidth_ )
+    : mesh(mesh_),
+      shellWidth(shellWidth_),
+      borderWidth(borderWidth_)
+{ }
+
+template<typename T>
+void DetectShellBorderLineFunctional3D<T>::process (
+        Box3D domain, ScalarField3D<int>& voxels )
+{
+	try{
+    // The shells of neighboring triangles overlap, so the cells are marked first
+    //   and converted once.
+    Dot3D location = voxels.getLocation();
+    Box3D absoluteDomain(domain.shift(location.x, location.y, location.z));
+    std::vector<bool> inShell(domain.nCells(), false);
+    for (plint iTriangle=0; iTriangle<mesh.getNumTriangles(); ++iTriangle) {
+        Box3D shell;
+        if (intersect(triangleBoundingBox(mesh, iTriangle, shellWidth), absoluteDomain, shell)) {
+            for (plint iX = shell.x0; iX <= shell.x1; ++iX) {
+                for (plint iY = shell.y0; iY <= shell.y1; ++iY) {
+                    for (plint iZ = shell.z0; iZ <= shell.z1; ++iZ) {
+                        inShell[ ((iX-absoluteDomain.x0)*domain.getNy() + iY-absoluteDomain.y0)
+                                 *domain.getNz() + iZ-absoluteDomain.z0 ] = true;
+                    }
+                }
+            }
+        }
+    }
+    pluint iCell = 0;
+    for (plint iX = domain.x0; iX <= domain.x1; ++iX) {
+        for (plint iY = domain.y0; iY <= domain.y1; ++iY) {
+            for (plint iZ = domain.z0; iZ <= domain.z1; ++iZ, ++iCell) {
+                if (inShell[iCell]) {
+                    DetectBorderLineFunctional3D<int>::detectBorder(voxels, iX, iY, iZ, borderWidth);
+                }
+            }
+        }
+    }
+	}
+	catch(const std::exception& e){exHandler(e,__FILE__,__FUNCTION__,__LINE__);}
+}
+
+template<typename T>
+DetectShellBorderLineFunctional3D<T>* DetectShellBorderLineFunctional3D<T>::clone() const {
+    return new DetectShellBorderLineFunctional3D<T>(*this);
+}
+
+template<typename T>
+void DetectShellBorderLineFunctional3D<T>::getTypeOfModification(std::vector<modif::ModifT>& modified) const {
+    modified[0] = modif::staticVariables;
+}
+
+template<typename T>
+BlockDomain::DomainT DetectShellBorderLineFunctional3D<T>::appliesTo() const {
+    return BlockDomain::bulk;
+}
+
 } // namespace plb
 
 #endif  // VOXELIZER_HH
@@ -30,6 +30,9 @@ private:
 
 	void writeVorticity();
 
+	// Open the files of a new series on the output thread.
+	void openSeries(const T& dx);
+
 public:
 	void writeImages(const plint& reynolds_, const plint& gridLevel_, const bool& last = false);
 
@@ -44,6 +47,7 @@ private:
 	static std::unique_ptr<VtkStructuredImageOutput3D<T> > densityOut;
 	static std::unique_ptr<VtkStructuredImageOutput3D<T> > velocityOut;
 	static std::unique_ptr<VtkStructuredImageOutput3D<T> > vorticityOut;
+	static std::unique_ptr<AsyncWriter> writer;
 	static std::unique_ptr<MultiTensorField3D<T,3> > v;
 	static std::unique_ptr<MultiTensorField3D<T,3> > w;
 	static std::unique_ptr<MultiScalarField3D<T> > r;
@@ -71,6 +75,9 @@ std::unique_ptr<VtkStructuredImageOutput3D<T> > Output<T,BoundaryType,SurfaceDat
 template<typename T, class BoundaryType, class SurfaceData, template<class U> class Descriptor>
 std::unique_ptr<VtkStructuredImageOutput3D<T> > Output<T,BoundaryType,SurfaceData,Descriptor>::vorticityOut(nullptr);
 
+template<typename T, class BoundaryType, class SurfaceData, template<class U> class Descriptor>
+std::unique_ptr<AsyncWriter> Output<T,BoundaryType,SurfaceData,Descriptor>::writer(nullptr);
+
 template<typename T, class BoundaryType, class SurfaceData, template<class U> class Descriptor>
 std::unique_ptr<MultiTensorField3D<T,3> > Output<T,BoundaryType,SurfaceData,Descriptor>::v(nullptr);
 
@@ -137,8 +137,18 @@ namespace plb{
 			float offset = (float)0;
 
 			r.reset(computeDensity(*Variables<T,BoundaryType,SurfaceData,Descriptor>::lattice).release());
-			std::string name = "density";
-			densityOut->writeData(*r, name, tconv, offset, first, last);
+			std::unique_ptr<MultiScalarField3D<float> > field(copyConvert<T,float>(*r).release());
+			multiplyInPlace(*field, tconv);
+			if(!util::isZero(offset)){ addInPlace(*field, offset); }
+
+			// The field is gathered into a staging buffer here; it is encoded and written on the output thread.
+			std::vector<char>& buffer = writer->acquireBuffer();
+			serializerToBuffer(field->getBlockSerializer(field->getBoundingBox(), IndexOrdering::backward), buffer);
+			const std::string name = "density";
+			const plint nx = field->getNx(), ny = field->getNy(), nz = field->getNz();
+			const bool first_ = first, last_ = last;
+			writer->submit(buffer, [=](std::vector<char> const& data){
+				densityOut->template writeData<float>(nx, ny, nz, data, name, 1, first_, last_); });
 
 			#ifdef PLB_DEBUG
 				mesg = "[DEBUG] Done Writing Density";
@@ -165,9 +175,17 @@ namespace plb{
 			float offset = (float)0;
 
 			//Tensor field for the velocity
-			std::string name = "velocity";
 			v.reset(computeVelocity(*Variables<T,BoundaryType,SurfaceData,Descriptor>::lattice).release());
-			velocityOut->writeData(*v, name, tconv, first, last);
+			std::unique_ptr<MultiTensorField3D<float,3> > field(copyConvert<T,float,3>(*v).release());
+			multiplyInPlace(*field, tconv);
+
+			std::vector<char>& buffer = writer->acquireBuffer();
+			serializerToBuffer(field->getBlockSerializer(field->getBoundingBox(), IndexOrdering::backward), buffer);
+			const std::string name = "velocity";
+			const plint nx = field->getNx(), ny = field->getNy(), nz = field->getNz();
+			const bool first_ = first, last_ = last;
+			writer->submit(buffer, [=](std::vector<char> const& data){
+				velocityOut->template writeData<float>(nx, ny, nz, data, name, 3, first_, last_); });
 
 			#ifdef PLB_DEBUG
 				mesg = "[DEBUG] Done Writing Velocity";
@@ -194,8 +212,16 @@ namespace plb{
 			float offset = (float)0;
 
 			w.reset(computeVorticity(*v).release());
-			std::string name = "vorticity";
-			vorticityOut->writeData(*w, name, tconv, first, last);
+			std::unique_ptr<MultiTensorField3D<float,3> > field(copyConvert<T,float,3>(*w).release());
+			multiplyInPlace(*field, tconv);
+
+			std::vector<char>& buffer = writer->acquireBuffer();
+			serializerToBuffer(field->getBlockSerializer(field->getBoundingBox(), IndexOrdering::backward), buffer);
+			const std::string name = "vorticity";
+			const plint nx = field->getNx(), ny = field->getNy(), nz = field->getNz();
+			const bool first_ = first, last_ = last;
+			writer->submit(buffer, [=](std::vector<char> const& data){
+				vorticityOut->template writeData<float>(nx, ny, nz, data, name, 3, first_, last_); });
 
 			#ifdef PLB_DEBUG
 				mesg = "[DEBUG] Done Writing Vorticity";
@@ -206,6 +232,24 @@ namespace plb{
 		catch(const std::exception& e){exHandler(e,__FILE__,__FUNCTION__,__LINE__);}
 	}
 
+	template<typename T, class BoundaryType, class SurfaceData, template<class U> class Descriptor>
+	void Output<T,BoundaryType,SurfaceData,Descriptor>::openSeries(const T& dx)
+	{
+		try{
+			// A restarted series is written to new files, so that the frames written before the checkpoint are kept.
+			const plint restartIter = Variables<T,BoundaryType,SurfaceData,Descriptor>::restartIter;
+			const std::string suffix = "_Re"+std::to_string(reynolds)+"_Lvl"+std::to_string(gridLevel)
+				+(restartIter > 0 ? "_From"+std::to_string(restartIter) : "")+".dat";
+			// The writers are only used by the output thread, the previous ones write their footer when they are replaced.
+			writer->submit([=](std::vector<char> const&){
+				densityOut.reset(new VtkStructuredImageOutput3D<T>("density"+suffix, dx));
+				velocityOut.reset(new VtkStructuredImageOutput3D<T>("velocity"+suffix, dx));
+				vorticityOut.reset(new VtkStructuredImageOutput3D<T>("vorticity"+suffix, dx));
+			});
+		}
+		catch(const std::exception& e){exHandler(e,__FILE__,__FUNCTION__,__LINE__);}
+	}
+
 	template<typename T, class BoundaryType, class SurfaceData, template<class U> class Descriptor>
 	void Output<T,BoundaryType,SurfaceData,Descriptor>::writeImages(const plint& reynolds_, const plint& gridLevel_, const bool& last_)
 	{
@@ -215,38 +259,26 @@ namespace plb{
 				if(master){std::cout << mesg << std::endl;}
 				global::log(mesg);
 			#endif
+			PLB_TRACE_SCOPE("Output::writeImages");
 
 			last = last_;
-			if(vtkCount==0)
-			{
-				first = true;
-				reynolds = reynolds_;
-				gridLevel = gridLevel_;
-				const T dx = Variables<T,BoundaryType,SurfaceData,Descriptor>::p.getDeltaX();
-
-				std::string fileName = "density_Re"+std::to_string(reynolds)+"_Lvl"+std::to_string(gridLevel)+".dat";
-				densityOut.reset(new VtkStructuredImageOutput3D<T>(fileName, dx));
-				pcout << "1" << std::endl;
-				fileName = "velocity_Re"+std::to_string(reynolds)+"_Lvl"+std::to_string(gridLevel)+".dat";
-				velocityOut.reset(new VtkStructuredImageOutput3D<T>(fileName, dx));
-				pcout << "2" << std::endl;
-				fileName = "vorticity_Re"+std::to_string(reynolds)+"_Lvl"+std::to_string(gridLevel)+".dat";
-				vorticityOut.reset(new VtkStructuredImageOutput3D<T>(fileName, dx));
+			// imageSave is the physical time between two frames; the last frame is always written.
+			plint cadence = 1;
+			if(Constants<T>::imageSave > 0){
+				cadence = std::max((plint)1, Variables<T,BoundaryType,SurfaceData,Descriptor>::p.nStep(Constants<T>::imageSave));
 			}
-			else if(reynolds != reynolds_ || gridLevel != gridLevel_){
+			bool newSeries = vtkCount==0 || reynolds != reynolds_ || gridLevel != gridLevel_;
+			if(!last && !newSeries && Variables<T,BoundaryType,SurfaceData,Descriptor>::iter % cadence != 0){ return; }
+
+			// Each field takes one staging buffer, and outputQueue frames may be in flight.
+			if(!writer){ writer.reset(new AsyncWriter(3*std::max((plint)1, Constants<T>::outputQueue))); }
+
+			if(newSeries)
+			{
 				first = true;
 				reynolds = reynolds_;
 				gridLevel = gridLevel_;
-				const T dx = Variables<T,BoundaryType,SurfaceData,Descriptor>::p.getDeltaX();
-
-				std::string fileName = "density_Re"+std::to_string(reynolds)+"_Lvl"+std::to_string(gridLevel)+".dat";
-				densityOut.reset(new VtkStructuredImageOutput3D<T>(fileName, dx));
-
-				fileName = "velocity_Re"+std::to_string(reynolds)+"_Lvl"+std::to_string(gridLevel)+".dat";
-				velocityOut.reset(new VtkStructuredImageOutput3D<T>(fileName, dx));
-
-				fileName = "vorticity_Re"+std::to_string(reynolds)+"_Lvl"+std::to_string(gridLevel)+".dat";
-				vorticityOut.reset(new VtkStructuredImageOutput3D<T>(fileName, dx));
+				openSeries(Variables<T,BoundaryType,SurfaceData,Descriptor>::p.getDeltaX());
 				vtkCount = 0;
 			}
 			else{first = false;}
@@ -259,6 +291,8 @@ namespace plb{
 
 			vtkCount++;
 
+			if(last){ writer->flush(); }
+
 			#ifdef PLB_DEBUG
 				mesg = "[DEBUG] Done Writing VTK";
 				if(master){std::cout << mesg << std::endl;}
@@ -330,6 +364,15 @@ namespace plb{
 		global::log(mesg);
 		elapsedTime();
 		timer.stop();
+		// Write the remaining frames and close the files.
+		if(writer){
+			writer->submit([](std::vector<char> const&){
+				densityOut.reset();
+				velocityOut.reset();
+				vorticityOut.reset();
+			});
+			writer.reset();
+		}
 		}
 		catch(const std::exception& e){exHandler(e,__FILE__,__FUNCTION__,__LINE__);}
 	}
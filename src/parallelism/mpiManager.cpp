@@ -1457,6 +1457,46 @@ void MpiManager::bCast<Complex<__float128> >(Complex<__float128>* sendBuf, int s
 }
 #endif
 
+template <>
+void MpiManager::iBCast<char>(char* sendBuf, int sendCount, MPI_Request* request, int root)
+{
+    if (!ok) return;
+    MPI_Ibcast(static_cast<void*>(sendBuf),
+               sendCount, MPI_CHAR, root, getGlobalCommunicator(), request);
+}
+
+template <>
+void MpiManager::iBCast<int>(int* sendBuf, int sendCount, MPI_Request* request, int root)
+{
+    if (!ok) return;
+    MPI_Ibcast(static_cast<void*>(sendBuf),
+               sendCount, MPI_INT, root, getGlobalCommunicator(), request);
+}
+
+template <>
+void MpiManager::iBCast<long>(long* sendBuf, int sendCount, MPI_Request* request, int root)
+{
+    if (!ok) return;
+    MPI_Ibcast(static_cast<void*>(sendBuf),
+               sendCount, MPI_LONG, root, getGlobalCommunicator(), request);
+}
+
+template <>
+void MpiManager::iBCast<float>(float* sendBuf, int sendCount, MPI_Request* request, int root)
+{
+    if (!ok) return;
+    MPI_Ibcast(static_cast<void*>(sendBuf),
+               sendCount, MPI_FLOAT, root, getGlobalCommunicator(), request);
+}
+
+template <>
+void MpiManager::iBCast<double>(double* sendBuf, int sendCount, MPI_Request* request, int root)
+{
+    if (!ok) return;
+    MPI_Ibcast(static_cast<void*>(sendBuf),
+               sendCount, MPI_DOUBLE, root, getGlobalCommunicator(), request);
+}
+
 template <>
 void MpiManager::bCastThroughMaster<char>(char* sendBuf, int sendCount, bool iAmRoot)
 {
@@ -120,6 +120,10 @@ public:
     /// Special case for broadcasting strings. Memory handling is automatic.
     void bCast( std::string& message, int root = 0 );
 
+    /// Broadcast data from one processor to multiple processors, non-blocking
+    template <typename T>
+    void iBCast( T* sendBuf, int sendCount, MPI_Request* request, int root = 0 );
+
     /// Broadcast data when root is unknown to other processors
     template <typename T>
     void bCastThroughMaster( T* sendBuf, int sendCount, bool iAmRoot );
@@ -32,6 +32,7 @@
 #include "atomicBlock/atomicBlock3D.h"
 #include "core/plbDebug.h"
 #include "core/plbProfiler.h"
+#include "core/plbTracer.h"
 #include <algorithm>
 #ifdef PLB_MPI_PARALLEL
 #include <mpi.h>
@@ -207,6 +208,26 @@ ParallelBlockCommunicator3D* ParallelBlockCommunicator3D::clone() const {
 
 void ParallelBlockCommunicator3D::duplicateOverlaps( MultiBlock3D& multiBlock,
                                                      modif::ModifT whichData ) const
+{
+    updateCommunication(multiBlock);
+    communicate(*communication, multiBlock, multiBlock, whichData);
+}
+
+void ParallelBlockCommunicator3D::startDuplicateOverlaps( MultiBlock3D& multiBlock,
+                                                          modif::ModifT whichData ) const
+{
+    updateCommunication(multiBlock);
+    startCommunication(*communication, multiBlock, whichData);
+}
+
+void ParallelBlockCommunicator3D::completeDuplicateOverlaps( MultiBlock3D& multiBlock,
+                                                             modif::ModifT whichData ) const
+{
+    PLB_PRECONDITION( !overlapsModified );
+    completeCommunication(*communication, multiBlock, multiBlock, whichData);
+}
+
+void ParallelBlockCommunicator3D::updateCommunication(MultiBlock3D const& multiBlock) const
 {
     MultiBlockManagement3D const& multiBlockManagement = multiBlock.getMultiBlockManagement();
     PeriodicitySwitch3D const& periodicity             = multiBlock.periodicity();
@@ -228,8 +249,6 @@ void ParallelBlockCommunicator3D::duplicateOverlaps( MultiBlock3D& multiBlock,
                                 multiBlockManagement, multiBlockManagement,
                                 multiBlock.sizeOfCell() );
     }
-
-    communicate(*communication, multiBlock, multiBlock, whichData);
 }
 
 void ParallelBlockCommunicator3D::communicate (
@@ -253,6 +272,15 @@ void ParallelBlockCommunicator3D::communicate (
         MultiBlock3D const& originMultiBlock,
         MultiBlock3D& destinationMultiBlock, modif::ModifT whichData ) const
 {
+    startCommunication(communication, originMultiBlock, whichData);
+    completeCommunication(communication, originMultiBlock, destinationMultiBlock, whichData);
+}
+
+void ParallelBlockCommunicator3D::startCommunication (
+        CommunicationStructure3D& communication,
+        MultiBlock3D const& originMultiBlock, modif::ModifT whichData ) const
+{
+    PLB_TRACE_SCOPE("mpi.startCommunication");
     global::profiler().start("mpiCommunication");
     bool staticMessage = whichData == modif::staticVariables;
     // 1. Non-blocking receives.
@@ -267,32 +295,63 @@ void ParallelBlockCommunicator3D::communicate (
                 whichData );
         communication.sendComm.acceptMessage(info.toProcessId, staticMessage);
     }
+    global::profiler().stop("mpiCommunication");
+}
 
+void ParallelBlockCommunicator3D::completeCommunication (
+        CommunicationStructure3D& communication,
+        MultiBlock3D const& originMultiBlock,
+        MultiBlock3D& destinationMultiBlock, modif::ModifT whichData ) const
+{
+    PLB_TRACE_SCOPE("mpi.completeCommunication");
+    global::profiler().start("mpiCommunication");
+    bool staticMessage = whichData == modif::staticVariables;
+    // The envelope of idle blocks is not updated, except for changes of the
+    //   data structure, which can make them active again.
+    bool skipIdleBlocks = &originMultiBlock==&destinationMultiBlock &&
+                          whichData != modif::dataStructure;
     // 3. Local copies which require no communication.
-    for (unsigned iSendRecv=0; iSendRecv<communication.sendRecvPackage.size(); ++iSendRecv) {
-        CommunicationInfo3D const& info = communication.sendRecvPackage[iSendRecv];
-        AtomicBlock3D const& fromBlock = originMultiBlock.getComponent(info.fromBlockId);
-        AtomicBlock3D& toBlock = destinationMultiBlock.getComponent(info.toBlockId);
-        plint deltaX = info.fromDomain.x0 - info.toDomain.x0;
-        plint deltaY = info.fromDomain.y0 - info.toDomain.y0;
-        plint deltaZ = info.fromDomain.z0 - info.toDomain.z0;
-        toBlock.getDataTransfer().attribute (
-                info.toDomain, deltaX, deltaY, deltaZ, fromBlock,
-                whichData, info.absoluteOffset );
+    {
+        PLB_TRACE_SCOPE("mpi.localCopies");
+        for (unsigned iSendRecv=0; iSendRecv<communication.sendRecvPackage.size(); ++iSendRecv) {
+            CommunicationInfo3D const& info = communication.sendRecvPackage[iSendRecv];
+            AtomicBlock3D const& fromBlock = originMultiBlock.getComponent(info.fromBlockId);
+            AtomicBlock3D& toBlock = destinationMultiBlock.getComponent(info.toBlockId);
+            if (skipIdleBlocks && toBlock.isIdle()) {
+                continue;
+            }
+            plint deltaX = info.fromDomain.x0 - info.toDomain.x0;
+            plint deltaY = info.fromDomain.y0 - info.toDomain.y0;
+            plint deltaZ = info.fromDomain.z0 - info.toDomain.z0;
+            toBlock.getDataTransfer().attribute (
+                    info.toDomain, deltaX, deltaY, deltaZ, fromBlock,
+                    whichData, info.absoluteOffset );
+        }
     }
 
     // 4. Finalize the receives.
-    for (unsigned iRecv=0; iRecv<communication.recvPackage.size(); ++iRecv) {
-        CommunicationInfo3D const& info = communication.recvPackage[iRecv];
-        AtomicBlock3D& toBlock = destinationMultiBlock.getComponent(info.toBlockId);
-        toBlock.getDataTransfer().receive (
-                info.toDomain,
-                communication.recvComm.receiveMessage(info.fromProcessId, staticMessage),
-                whichData, info.absoluteOffset );
+    {
+        PLB_TRACE_SCOPE("mpi.receive");
+        for (unsigned iRecv=0; iRecv<communication.recvPackage.size(); ++iRecv) {
+            CommunicationInfo3D const& info = communication.recvPackage[iRecv];
+            AtomicBlock3D& toBlock = destinationMultiBlock.getComponent(info.toBlockId);
+            // The message must be received in any case, to keep the order
+            //   of the messages from the same process.
+            std::vector<char> const& message =
+                communication.recvComm.receiveMessage(info.fromProcessId, staticMessage);
+            if (skipIdleBlocks && toBlock.isIdle()) {
+                continue;
+            }
+            toBlock.getDataTransfer().receive (
+                    info.toDomain, message, whichData, info.absoluteOffset );
+        }
     }
 
     // 5. Finalize the sends.
-    communication.sendComm.finalize(staticMessage);
+    {
+        PLB_TRACE_SCOPE("mpi.finalizeSends");
+        communication.sendComm.finalize(staticMessage);
+    }
     global::profiler().stop("mpiCommunication");
 }
 
@@ -77,15 +77,27 @@ public:
     void swap(ParallelBlockCommunicator3D& rhs);
     virtual ParallelBlockCommunicator3D* clone() const;
     virtual void duplicateOverlaps(MultiBlock3D& multiBlock, modif::ModifT whichData) const;
+    /// Post the non-blocking receives and the sends of the overlaps.
+    virtual void startDuplicateOverlaps(MultiBlock3D& multiBlock, modif::ModifT whichData) const;
+    /// Copy the local overlaps, then wait for the receives and the sends.
+    virtual void completeDuplicateOverlaps(MultiBlock3D& multiBlock, modif::ModifT whichData) const;
     virtual void communicate( std::vector<Overlap3D> const& overlaps,
                               MultiBlock3D const& originMultiBlock,
                               MultiBlock3D& destinationMultiBlock,
                               modif::ModifT whichData ) const;
     virtual void signalPeriodicity() const;
 private:
+    void updateCommunication(MultiBlock3D const& multiBlock) const;
     void communicate( CommunicationStructure3D& communication,
                       MultiBlock3D const& originMultiBlock,
                       MultiBlock3D& destinationMultiBlock, modif::ModifT whichData ) const;
+    void startCommunication( CommunicationStructure3D& communication,
+                             MultiBlock3D const& originMultiBlock,
+                             modif::ModifT whichData ) const;
+    void completeCommunication( CommunicationStructure3D& communication,
+                                MultiBlock3D const& originMultiBlock,
+                                MultiBlock3D& destinationMultiBlock,
+                                modif::ModifT whichData ) const;
     void subscribeOverlap (
         Overlap3D const& overlap, MultiBlockManagement3D const& multiBlockManagement,
         SendRecvPool& sendPool, SendRecvPool& recvPool, plint sizeOfCell ) const;
@@ -28,6 +28,7 @@
 #include "parallelism/mpiManager.h"
 #include "parallelism/parallelStatistics.h"
 #include <cmath>
+#include <algorithm>
 
 namespace plb {
 
@@ -45,41 +46,37 @@ void ParallelCombinedStatistics::reduceStatistics (
             std::vector<double>& maxObservables,
             std::vector<plint>& intSumObservables ) const
 {
+    // All the averages and sums are reduced together, the maxima and the integer
+    // sums each in one more collective call, instead of one reduction and one
+    // broadcast per observable.
+    pluint numAverages = averageObservables.size();
+    pluint numSums = sumObservables.size();
+    std::vector<double> sums(2*numAverages+numSums);
+    for (pluint iAverage=0; iAverage<numAverages; ++iAverage) {
+        sums[2*iAverage] = averageObservables[iAverage]*sumWeights[iAverage];
+        sums[2*iAverage+1] = sumWeights[iAverage];
+    }
+    std::copy(sumObservables.begin(), sumObservables.end(), sums.begin()+2*numAverages);
+    global::mpi().allReduceVect(sums, MPI_SUM);
+
     // Averages
-    for (pluint iAverage=0; iAverage<averageObservables.size(); ++iAverage) {
-        double globalAverage, globalWeight;
-        global::mpi().reduce(averageObservables[iAverage]*sumWeights[iAverage], globalAverage, MPI_SUM);
-        global::mpi().reduce(sumWeights[iAverage], globalWeight, MPI_SUM);
-        if (global::mpi().isMainProcessor() && std::fabs(globalWeight) > 0.5) {
+    for (pluint iAverage=0; iAverage<numAverages; ++iAverage) {
+        double globalAverage = sums[2*iAverage];
+        double globalWeight = sums[2*iAverage+1];
+        if (std::fabs(globalWeight) > 0.5) {
             globalAverage /= globalWeight;
         }
-        global::mpi().bCast(&globalAverage, 1);
         averageObservables[iAverage] = globalAverage;
     }
 
     // Sum
-    for (pluint iSum=0; iSum<sumObservables.size(); ++iSum) {
-        double globalSum;
-        global::mpi().reduce(sumObservables[iSum], globalSum, MPI_SUM);
-        global::mpi().bCast(&globalSum, 1);
-        sumObservables[iSum] = globalSum;
-    }
+    std::copy(sums.begin()+2*numAverages, sums.end(), sumObservables.begin());
 
     // Max
-    for (pluint iMax=0; iMax<maxObservables.size(); ++iMax) {
-        double globalMax;
-        global::mpi().reduce(maxObservables[iMax], globalMax, MPI_MAX);
-        global::mpi().bCast(&globalMax, 1);
-        maxObservables[iMax] = globalMax;
-    }
+    global::mpi().allReduceVect(maxObservables, MPI_MAX);
 
     // Integer sum
-    for (pluint iSum=0; iSum<intSumObservables.size(); ++iSum) {
-        plint globalSum;
-        global::mpi().reduce(intSumObservables[iSum], globalSum, MPI_SUM);
-        global::mpi().bCast(&globalSum, 1);
-        intSumObservables[iSum] = globalSum;
-    }
+    global::mpi().allReduceVect(intSumObservables, MPI_SUM);
 }
 
 #endif  // PLB_MPI_PARALLEL
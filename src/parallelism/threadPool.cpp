@@ -0,0 +1,210 @@
+/* This file is part of the Palabos library.
+ *
+ * Copyright (C) 2011-2015 FlowKit Sarl
+ * Route d'Oron 2
+ * 1010 Lausanne, Switzerland
+ * E-mail contact: contact@flowkit.com
+ *
+ * The most recent release of Palabos can be downloaded at 
+ * <http://www.palabos.org/>
+ *
+ * The library Palabos is free software: you can redistribute it and/or
+ * modify it under the terms of the GNU Affero General Public License as
+ * published by the Free Software Foundation, either version 3 of the
+ * License, or (at your option) any later version.
+ *
+ * The library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+/** \file
+ * Shared-memory thread pool used to execute the local blocks of a
+ * multi-block concurrently -- implementation file.
+ */
+
+#include "parallelism/threadPool.h"
+#include "core/plbProfiler.h"
+#include "core/plbDebug.h"
+
+namespace plb {
+
+namespace global {
+
+ThreadPool::ThreadPool()
+    : numThreads(1),
+      currentTasks(0),
+      generation(0),
+      busyWorkers(0),
+      shutdown(false)
+{
+    queues.push_back(new TaskQueue);
+}
+
+ThreadPool::~ThreadPool() {
+    stopWorkers();
+    for (pluint iQueue=0; iQueue<queues.size(); ++iQueue) {
+        delete queues[iQueue];
+    }
+}
+
+void ThreadPool::setNumThreads(plint numThreads_) {
+    PLB_PRECONDITION( numThreads_>=1 );
+    if (numThreads_==numThreads) {
+        return;
+    }
+    stopWorkers();
+    for (pluint iQueue=0; iQueue<queues.size(); ++iQueue) {
+        delete queues[iQueue];
+    }
+    numThreads = numThreads_;
+    queues.resize(numThreads);
+    for (plint iQueue=0; iQueue<numThreads; ++iQueue) {
+        queues[iQueue] = new TaskQueue;
+    }
+    startWorkers();
+}
+
+void ThreadPool::startWorkers() {
+    // The workers are created while no task is being executed, so that
+    //   they all start waiting for the generation that follows this one.
+    for (plint threadId=1; threadId<numThreads; ++threadId) {
+        workers.push_back(std::thread(&ThreadPool::workerLoop, this, threadId, generation));
+    }
+}
+
+void ThreadPool::stopWorkers() {
+    {
+        std::lock_guard<std::mutex> lock(poolMutex);
+        shutdown = true;
+    }
+    startCondition.notify_all();
+    for (pluint iWorker=0; iWorker<workers.size(); ++iWorker) {
+        workers[iWorker].join();
+    }
+    workers.clear();
+    shutdown = false;
+}
+
+void ThreadPool::execute(std::vector<Task> const& tasks, std::vector<plint> const& preferredThread)
+{
+    PLB_PRECONDITION( tasks.size()==preferredThread.size() );
+    if (tasks.empty()) {
+        return;
+    }
+    if (!isThreaded()) {
+        for (pluint iTask=0; iTask<tasks.size(); ++iTask) {
+            tasks[iTask]();
+        }
+        return;
+    }
+
+    bool profiling = profiler().doProfiling();
+    if (profiling) {
+        profiler().suspend();
+    }
+    // The workers are idle at this point: the queues can be filled without locking.
+    for (pluint iTask=0; iTask<tasks.size(); ++iTask) {
+        plint threadId = preferredThread[iTask] % numThreads;
+        if (threadId<0) threadId += numThreads;
+        queues[threadId]->indices.push_back((plint)iTask);
+    }
+    {
+        std::lock_guard<std::mutex> lock(poolMutex);
+        currentTasks = &tasks;
+        busyWorkers = numThreads-1;
+        ++generation;
+    }
+    startCondition.notify_all();
+
+    consumeTasks(0);
+
+    std::exception_ptr exception;
+    {
+        std::unique_lock<std::mutex> lock(poolMutex);
+        while (busyWorkers>0) {
+            doneCondition.wait(lock);
+        }
+        currentTasks = 0;
+        exception = firstException;
+        firstException = std::exception_ptr();
+    }
+    if (profiling) {
+        profiler().resume();
+    }
+    if (exception) {
+        std::rethrow_exception(exception);
+    }
+}
+
+void ThreadPool::workerLoop(plint threadId, pluint lastGeneration) {
+    while (true) {
+        {
+            std::unique_lock<std::mutex> lock(poolMutex);
+            while (!shutdown && generation==lastGeneration) {
+                startCondition.wait(lock);
+            }
+            if (shutdown) {
+                return;
+            }
+            lastGeneration = generation;
+        }
+        consumeTasks(threadId);
+        {
+            std::lock_guard<std::mutex> lock(poolMutex);
+            --busyWorkers;
+            if (busyWorkers==0) {
+                doneCondition.notify_one();
+            }
+        }
+    }
+}
+
+void ThreadPool::consumeTasks(plint threadId) {
+    // Tasks never generate new tasks: once all queues are found empty,
+    //   there is nothing left to do for this thread.
+    plint iTask;
+    while (popTask(threadId, iTask) || stealTask(threadId, iTask)) {
+        try {
+            (*currentTasks)[iTask]();
+        }
+        catch (...) {
+            std::lock_guard<std::mutex> lock(poolMutex);
+            if (!firstException) {
+                firstException = std::current_exception();
+            }
+        }
+    }
+}
+
+bool ThreadPool::popTask(plint threadId, plint& iTask) {
+    TaskQueue& queue = *queues[threadId];
+    std::lock_guard<std::mutex> lock(queue.mutex);
+    if (queue.indices.empty()) {
+        return false;
+    }
+    iTask = queue.indices.back();
+    queue.indices.pop_back();
+    return true;
+}
+
+bool ThreadPool::stealTask(plint threadId, plint& iTask) {
+    for (plint iOffset=1; iOffset<numThreads; ++iOffset) {
+        TaskQueue& victim = *queues[(threadId+iOffset)%numThreads];
+        std::lock_guard<std::mutex> lock(victim.mutex);
+        if (!victim.indices.empty()) {
+            iTask = victim.indices.front();
+            victim.indices.pop_front();
+            return true;
+        }
+    }
+    return false;
+}
+
+}  // namespace global
+
+}  // namespace plb
@@ -0,0 +1,117 @@
+/* This file is part of the Palabos library.
+ *
+ * Copyright (C) 2011-2015 FlowKit Sarl
+ * Route d'Oron 2
+ * 1010 Lausanne, Switzerland
+ * E-mail contact: contact@flowkit.com
+ *
+ * The most recent release of Palabos can be downloaded at 
+ * <http://www.palabos.org/>
+ *
+ * The library Palabos is free software: you can redistribute it and/or
+ * modify it under the terms of the GNU Affero General Public License as
+ * published by the Free Software Foundation, either version 3 of the
+ * License, or (at your option) any later version.
+ *
+ * The library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+/** \file
+ * Shared-memory thread pool used to execute the local blocks of a
+ * multi-block concurrently -- header file.
+ */
+
+#ifndef THREAD_POOL_H
+#define THREAD_POOL_H
+
+#include "core/globalDefs.h"
+#include <vector>
+#include <deque>
+#include <functional>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <exception>
+
+namespace plb {
+
+namespace global {
+
+/// Work-stealing pool of shared-memory threads, for hybrid MPI+threads runs.
+/** Each MPI process owns one pool. By default the pool has a single
+ *  thread (the calling one), in which case execute() runs all tasks
+ *  serially and no additional thread is ever created. With n threads,
+ *  n-1 workers are spawned and the calling thread acts as worker 0.
+ *
+ *  Tasks are first queued on their preferred thread (typically the one
+ *  given by ThreadAttribution::getLocalThreadId). Every thread consumes
+ *  its own queue from the back and, once it runs dry, steals from the
+ *  front of the other queues. execute() returns once all tasks are done.
+ *
+ *  Tasks run concurrently and must therefore only modify data that
+ *  belongs to their own block. The profiler is suspended while tasks
+ *  are executed, because its timers are not thread-safe.
+ */
+class ThreadPool {
+public:
+    typedef std::function<void()> Task;
+public:
+    ~ThreadPool();
+    /// Number of threads, including the calling one. Must be called
+    ///   outside of execute(), and by the main thread only.
+    void setNumThreads(plint numThreads_);
+    plint getNumThreads() const {
+        return numThreads;
+    }
+    bool isThreaded() const {
+        return numThreads>1;
+    }
+    /// Execute all tasks, and return once they are completed. The task
+    ///   iTask is initially queued on thread preferredThread[iTask] (modulo
+    ///   the number of threads). If an exception is thrown by a task, the
+    ///   first one is re-thrown here after all tasks have terminated.
+    void execute(std::vector<Task> const& tasks, std::vector<plint> const& preferredThread);
+private:
+    ThreadPool();
+    void startWorkers();
+    void stopWorkers();
+    void workerLoop(plint threadId, pluint lastGeneration);
+    /// Run tasks until no queue has any task left.
+    void consumeTasks(plint threadId);
+    bool popTask(plint threadId, plint& iTask);
+    bool stealTask(plint threadId, plint& iTask);
+private:
+    struct TaskQueue {
+        std::mutex mutex;
+        std::deque<plint> indices;
+    };
+    plint numThreads;
+    std::vector<std::thread> workers;
+    std::vector<TaskQueue*> queues;
+    std::vector<Task> const* currentTasks;
+    std::mutex poolMutex;
+    std::condition_variable startCondition;
+    std::condition_variable doneCondition;
+    pluint generation;
+    plint busyWorkers;
+    bool shutdown;
+    std::exception_ptr firstException;
+friend ThreadPool& threadPool();
+};
+
+inline ThreadPool& threadPool() {
+    static ThreadPool instance;
+    return instance;
+}
+
+}  // namespace global
+
+}  // namespace plb
+
+#endif  // THREAD_POOL_H
@@ -0,0 +1,68 @@
+#ifndef SWEEP_H
+#define SWEEP_H
+
+#include <palabos3D.h>
+#include "myheaders3D.h"
+
+#include <string>
+#include <vector>
+#include <utility>
+
+namespace plb{
+
+// Runs the (Reynolds number, grid level) cases of the parameter sweep. The cases are ordered by grid level,
+// so that the voxelization, the block structure and the boundary conditions of a grid level are built once
+// and reused for all its Reynolds numbers. The processes can be split into groups which run different
+// cases concurrently, each group on its own communicator.
+template<typename T, class BoundaryType, class SurfaceData, template<class U> class Descriptor>
+class Sweep{
+public:
+	// Split MPI_COMM_WORLD into the number of groups given by simulation/sweepGroups (optional, defaults to 1).
+	// Must be called before the Helper is constructed: all the following objects live on the communicator of the group.
+	static void split(const std::string& fileName);
+
+	// Free the communicator of the group and return to MPI_COMM_WORLD, once all the objects of the group are done.
+	static void finalize();
+
+	// Distribute the cases over the groups, once the constants are read.
+	static void initialize();
+
+	// Set up the lattice for the next case of this group; returns false when the group is done.
+	static bool next(plint& reynolds, plint& gridLevel);
+
+	static plint getGroup(){ return group; }
+
+	static plint getNumGroups(){ return numGroups; }
+
+	// Suffix which distinguishes the output files of the groups, empty with a single group.
+	static std::string groupSuffix(){ return numGroups > 1 ? "_group"+std::to_string(group) : ""; }
+private:
+	static std::vector<std::pair<plint,plint> > cases;
+	static pluint current;
+	static plint group, numGroups;
+	// Grid level of the lattice which is set up, -1 before the first case.
+	static plint latticeLevel;
+	static bool master;
+};
+
+template<typename T, class BoundaryType, class SurfaceData, template<class U> class Descriptor>
+std::vector<std::pair<plint,plint> > Sweep<T,BoundaryType,SurfaceData,Descriptor>::cases;
+
+template<typename T, class BoundaryType, class SurfaceData, template<class U> class Descriptor>
+pluint Sweep<T,BoundaryType,SurfaceData,Descriptor>::current = 0;
+
+template<typename T, class BoundaryType, class SurfaceData, template<class U> class Descriptor>
+plint Sweep<T,BoundaryType,SurfaceData,Descriptor>::group = 0;
+
+template<typename T, class BoundaryType, class SurfaceData, template<class U> class Descriptor>
+plint Sweep<T,BoundaryType,SurfaceData,Descriptor>::numGroups = 1;
+
+template<typename T, class BoundaryType, class SurfaceData, template<class U> class Descriptor>
+plint Sweep<T,BoundaryType,SurfaceData,Descriptor>::latticeLevel = -1;
+
+template<typename T, class BoundaryType, class SurfaceData, template<class U> class Descriptor>
+bool Sweep<T,BoundaryType,SurfaceData,Descriptor>::master = false;
+
+} // namespace plb
+
+#endif // SWEEP_H
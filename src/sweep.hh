@@ -0,0 +1,134 @@
+#ifndef SWEEP_HH
+#define SWEEP_HH
+
+#include "sweep.h"
+#include <palabos3D.hh>
+#include "myheaders3D.hh"
+
+#include <cmath>
+#include <string>
+#include <algorithm>
+
+namespace plb{
+
+	template<typename T, class BoundaryType, class SurfaceData, template<class U> class Descriptor>
+	void Sweep<T,BoundaryType,SurfaceData,Descriptor>::split(const std::string& fileName)
+	{
+		try{
+			XMLreader r(fileName);
+			try{ r["simulation"]["sweepGroups"].read(numGroups); }
+			catch(PlbIOException& e){ numGroups = 1; }
+			group = 0;
+			#ifdef PLB_MPI_PARALLEL
+				const plint size = global::mpi().getSize();
+				numGroups = std::max((plint)1, std::min(numGroups, size));
+				if(numGroups > 1){
+					// Consecutive ranks form a group, they are more likely to share a node.
+					group = global::mpi().getRank() * numGroups / size;
+					MPI_Comm communicator;
+					MPI_Comm_split(global::mpi().getGlobalCommunicator(), (int)group, global::mpi().getRank(), &communicator);
+					global::mpi().init(communicator);
+				}
+			#else
+				numGroups = 1;
+			#endif
+			master = global::mpi().isMainProcessor();
+			#ifdef PLB_DEBUG
+				std::string mesg = "[DEBUG] Sweep Group "+std::to_string(group)+" of "+std::to_string(numGroups)
+					+" Processes="+std::to_string(global::mpi().getSize());
+				if(master){std::cout << mesg << std::endl;}
+				global::log(mesg);
+			#endif
+		}
+		catch(const std::exception& e){exHandler(e,__FILE__,__FUNCTION__,__LINE__);}
+	}
+
+	template<typename T, class BoundaryType, class SurfaceData, template<class U> class Descriptor>
+	void Sweep<T,BoundaryType,SurfaceData,Descriptor>::finalize()
+	{
+		try{
+			#ifdef PLB_MPI_PARALLEL
+				if(numGroups > 1){
+					MPI_Comm communicator = global::mpi().getGlobalCommunicator();
+					global::mpi().init(MPI_COMM_WORLD);
+					MPI_Comm_free(&communicator);
+				}
+			#endif
+			group = 0;
+			numGroups = 1;
+			master = global::mpi().isMainProcessor();
+		}
+		catch(const std::exception& e){exHandler(e,__FILE__,__FUNCTION__,__LINE__);}
+	}
+
+	template<typename T, class BoundaryType, class SurfaceData, template<class U> class Descriptor>
+	void Sweep<T,BoundaryType,SurfaceData,Descriptor>::initialize()
+	{
+		try{
+			master = global::mpi().isMainProcessor();
+			// A test runs the test Reynolds number on all grid levels.
+			const plint maxRe = Constants<T>::test ? Constants<T>::minRe : Constants<T>::maxRe;
+
+			// The cost of a case grows with the number of cells and of time steps, by a factor 16 for each grid level.
+			// The list of cases is cut into consecutive pieces of about the same cost, so that a group shares the
+			// geometry between as many cases as possible.
+			std::vector<std::pair<plint,plint> > all;
+			std::vector<double> weights;
+			double total = 0;
+			for(plint gridLevel = 0; gridLevel <= Constants<T>::maxGridLevel; gridLevel++){
+				for(plint reynolds = Constants<T>::minRe; reynolds <= maxRe; reynolds++){
+					all.push_back(std::make_pair(gridLevel, reynolds));
+					weights.push_back(std::pow(16.0, (double)gridLevel));
+					total += weights.back();
+				}
+			}
+			cases.clear();
+			current = 0;
+			latticeLevel = -1;
+			double before = 0;
+			for(pluint i = 0; i < all.size(); i++){
+				plint owner = std::min(numGroups-1, (plint)(numGroups*(before + weights[i]/2.0)/total));
+				if(owner == group){ cases.push_back(all[i]); }
+				before += weights[i];
+			}
+
+			// A restart skips the cases which precede the checkpoint in the group which ran it.
+			plint restartRe = -1, restartLevel = -1;
+			Variables<T,BoundaryType,SurfaceData,Descriptor>::getRestartLevel(restartRe, restartLevel);
+			for(pluint i = 0; i < cases.size(); i++){
+				if(cases[i].first == restartLevel && cases[i].second == restartRe){ current = i; }
+			}
+
+			#ifdef PLB_DEBUG
+				std::string mesg = "[DEBUG] Sweep Group "+std::to_string(group)+" Cases="+std::to_string(cases.size());
+				if(master){std::cout << mesg << std::endl;}
+				global::log(mesg);
+			#endif
+		}
+		catch(const std::exception& e){exHandler(e,__FILE__,__FUNCTION__,__LINE__);}
+	}
+
+	template<typename T, class BoundaryType, class SurfaceData, template<class U> class Descriptor>
+	bool Sweep<T,BoundaryType,SurfaceData,Descriptor>::next(plint& reynolds, plint& gridLevel)
+	{
+		try{
+			if(current >= cases.size()){ return false; }
+			Variables<T,BoundaryType,SurfaceData,Descriptor>* variables = Variables<T,BoundaryType,SurfaceData,Descriptor>::v.get();
+			gridLevel = cases[current].first;
+			reynolds = cases[current].second;
+			if(gridLevel == latticeLevel){ variables->reparameterize(reynolds); }
+			else{
+				variables->update(gridLevel, reynolds);
+				variables->setLattice();
+				latticeLevel = gridLevel;
+			}
+			current++;
+			return true;
+		}
+		catch(const std::exception& e){exHandler(e,__FILE__,__FUNCTION__,__LINE__);}
+		return false;
+	}
+
+} // namespace plb
+
+#endif // SWEEP_HH
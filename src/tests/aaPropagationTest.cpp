@@ -0,0 +1,109 @@
+/* This file is part of the Palabos library.
+ *
+ * Copyright (C) 2011-2015 FlowKit Sarl
+ * Route d'Oron 2
+ * 1010 Lausanne, Switzerland
+ * E-mail contact: contact@flowkit.com
+ *
+ * The most recent release of Palabos can be downloaded at 
+ * <http://www.palabos.org/>
+ *
+ * The library Palabos is free software: you can redistribute it and/or
+ * modify it under the terms of the GNU Affero General Public License as
+ * published by the Free Software Foundation, either version 3 of the
+ * License, or (at your option) any later version.
+ *
+ * The library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+/** \file
+ * Regression test: the AA-pattern propagation gives the same populations as
+ * the swap scheme, up to round-off, on an atomic block with bounce-back at the
+ * domain boundary and on a periodic multi-block, after an even number of steps
+ * and after an odd one concluded by completeStream().
+ */
+
+typedef double T;
+
+#include "palabos3D.h"
+#include "palabos3D.hh"
+#include "testUtil3D.h"
+
+#include <cstdlib>
+#include <iostream>
+
+using namespace plb;
+
+#define DESCRIPTOR descriptors::D3Q19Descriptor
+
+/// A lattice with an obstacle, with a given propagation scheme.
+void setUp(MultiBlockLattice3D<T,DESCRIPTOR>& lattice, propagation::SchemeT scheme) {
+    lattice.periodicity().toggleAll(true);
+    defineDynamics(lattice, Box3D(6,9, 5,8, 4,12), new BounceBack<T,DESCRIPTOR>((T)1.));
+    initializeAtEquilibrium(lattice, lattice.getBoundingBox(), InitialState());
+    lattice.initialize();
+    lattice.setPropagationScheme(scheme);
+}
+
+void report(bool& success, T difference, std::string const& message) {
+    // The two schemes carry out the same operations in a different order.
+    const T tolerance = (T)1.e-13;
+    bool passed = difference <= tolerance;
+    pcout << (passed ? "passed" : "FAILED") << ": " << message << ", the populations differ by "
+          << difference << std::endl;
+    success = success && passed;
+}
+
+int main(int argc, char* argv[]) {
+    plbInit(&argc, &argv);
+    bool success = true;
+    const plint nx = 24, ny = 20, nz = 18;
+
+    // Atomic blocks: the populations leaving the domain are bounced back. The
+    //   steps are carried out on a Box3D, as collideAndStream() without argument
+    //   concludes the streaming of the AA-pattern at every step.
+    BlockLattice3D<T,DESCRIPTOR> swapBlock(nx,ny,nz, new BGKdynamics<T,DESCRIPTOR>((T)1.3));
+    BlockLattice3D<T,DESCRIPTOR> aaBlock(nx,ny,nz, new BGKdynamics<T,DESCRIPTOR>((T)1.3));
+    initializeAtEquilibrium(swapBlock, swapBlock.getBoundingBox(), InitialState());
+    initializeAtEquilibrium(aaBlock, aaBlock.getBoundingBox(), InitialState());
+    aaBlock.setPropagationScheme(propagation::aa);
+    for (plint iT=0; iT<10; ++iT) {
+        swapBlock.collideAndStream(swapBlock.getBoundingBox());
+        aaBlock.collideAndStream(aaBlock.getBoundingBox());
+    }
+    report(success, maxPopulationDifference(swapBlock, aaBlock), "atomic block, 10 steps");
+    swapBlock.collideAndStream(swapBlock.getBoundingBox());
+    aaBlock.collideAndStream(aaBlock.getBoundingBox());
+    aaBlock.completeStream();
+    report(success, maxPopulationDifference(swapBlock, aaBlock), "atomic block, 11 steps");
+
+    // Periodic multi-blocks, with the envelope of width 2 required by the AA-pattern.
+    MultiBlockManagement3D management = createManagement(nx,ny,nz, 2);
+    MultiBlockLattice3D<T,DESCRIPTOR> swapLattice (
+            MultiBlockManagement3D(management), defaultMultiBlockPolicy3D().getBlockCommunicator(),
+            defaultMultiBlockPolicy3D().getCombinedStatistics(),
+            defaultMultiBlockPolicy3D().getMultiCellAccess<T,DESCRIPTOR>(), new BGKdynamics<T,DESCRIPTOR>((T)1.3) );
+    MultiBlockLattice3D<T,DESCRIPTOR> aaLattice (
+            MultiBlockManagement3D(management), defaultMultiBlockPolicy3D().getBlockCommunicator(),
+            defaultMultiBlockPolicy3D().getCombinedStatistics(),
+            defaultMultiBlockPolicy3D().getMultiCellAccess<T,DESCRIPTOR>(), new BGKdynamics<T,DESCRIPTOR>((T)1.3) );
+    setUp(swapLattice, propagation::swap);
+    setUp(aaLattice, propagation::aa);
+    for (plint iT=0; iT<10; ++iT) {
+        swapLattice.collideAndStream();
+        aaLattice.collideAndStream();
+    }
+    report(success, maxPopulationDifference(swapLattice, aaLattice), "multi-block, 10 steps");
+    swapLattice.collideAndStream();
+    aaLattice.collideAndStream();
+    aaLattice.completeStream();
+    report(success, maxPopulationDifference(swapLattice, aaLattice), "multi-block, 11 steps");
+
+    return success ? EXIT_SUCCESS : EXIT_FAILURE;
+}
@@ -0,0 +1,161 @@
+/* This file is part of the Palabos library.
+ *
+ * Copyright (C) 2011-2015 FlowKit Sarl
+ * Route d'Oron 2
+ * 1010 Lausanne, Switzerland
+ * E-mail contact: contact@flowkit.com
+ *
+ * The most recent release of Palabos can be downloaded at 
+ * <http://www.palabos.org/>
+ *
+ * The library Palabos is free software: you can redistribute it and/or
+ * modify it under the terms of the GNU Affero General Public License as
+ * published by the Free Software Foundation, either version 3 of the
+ * License, or (at your option) any later version.
+ *
+ * The library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+/** \file
+ * Regression test: a time series of images written through the AsyncWriter,
+ * from staging buffers gathered with serializerToBuffer, is byte for byte the
+ * file written synchronously from the multi-block fields, in every vtk encoding.
+ */
+
+typedef double T;
+
+#include "palabos3D.h"
+#include "palabos3D.hh"
+
+#include <cstdlib>
+#include <fstream>
+#include <iostream>
+#include <iterator>
+#include <memory>
+#include <string>
+
+using namespace plb;
+
+/// A field which changes from one frame to the next.
+struct FrameDensity {
+    FrameDensity(plint frame_) : frame(frame_) { }
+    T operator()(plint iX, plint iY, plint iZ) const {
+        return (T)1 + (T)0.001*(T)(iX*iY - 3*iZ + frame);
+    }
+    plint frame;
+};
+
+struct FrameVelocity {
+    FrameVelocity(plint frame_) : frame(frame_) { }
+    void operator()(plint iX, plint iY, plint iZ, Array<T,3>& u) const {
+        u = Array<T,3>((T)0.01*(T)iX, (T)-0.02*(T)(iY+frame), (T)0.003*(T)(iX*iZ));
+    }
+    plint frame;
+};
+
+std::string readFile(std::string const& fileName) {
+    std::ifstream file(fileName.c_str(), std::ios::binary);
+    return std::string(std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>());
+}
+
+/// Write the frames like Output::writeImages() did before it became asynchronous.
+void writeSynchronously(MultiScalarField3D<T>& density, MultiTensorField3D<T,3>& velocity,
+                        std::string const& suffix, plint numFrames, float scale)
+{
+    VtkStructuredImageOutput3D<T> densityOut("syncDensity"+suffix, (T)0.5);
+    VtkStructuredImageOutput3D<T> velocityOut("syncVelocity"+suffix, (T)0.5);
+    for (plint iFrame=0; iFrame<numFrames; ++iFrame) {
+        setToFunction(density, density.getBoundingBox(), FrameDensity(iFrame));
+        setToFunction(velocity, velocity.getBoundingBox(), FrameVelocity(iFrame));
+        bool first = iFrame==0;
+        bool last = iFrame==numFrames-1;
+        densityOut.writeData<float>(density, "density", scale, (float)0, first, last);
+        velocityOut.writeData<float>(velocity, "velocity", scale, first, last);
+    }
+}
+
+/// Write the frames like Output::writeImages().
+void writeAsynchronously(MultiScalarField3D<T>& density, MultiTensorField3D<T,3>& velocity,
+                         std::string const& suffix, plint numFrames, float scale)
+{
+    std::shared_ptr<VtkStructuredImageOutput3D<T> > densityOut, velocityOut;
+    AsyncWriter writer(2);
+    writer.submit([&](std::vector<char> const&) {
+        densityOut.reset(new VtkStructuredImageOutput3D<T>("asyncDensity"+suffix, (T)0.5));
+        velocityOut.reset(new VtkStructuredImageOutput3D<T>("asyncVelocity"+suffix, (T)0.5));
+    });
+    const plint nx = density.getNx(), ny = density.getNy(), nz = density.getNz();
+    for (plint iFrame=0; iFrame<numFrames; ++iFrame) {
+        setToFunction(density, density.getBoundingBox(), FrameDensity(iFrame));
+        setToFunction(velocity, velocity.getBoundingBox(), FrameVelocity(iFrame));
+        const bool first = iFrame==0;
+        const bool last = iFrame==numFrames-1;
+
+        std::unique_ptr<MultiScalarField3D<float> > densityField(copyConvert<T,float>(density).release());
+        multiplyInPlace(*densityField, scale);
+        std::vector<char>& densityBuffer = writer.acquireBuffer();
+        serializerToBuffer(densityField->getBlockSerializer(densityField->getBoundingBox(), IndexOrdering::backward),
+                           densityBuffer);
+        writer.submit(densityBuffer, [=, &densityOut](std::vector<char> const& data) {
+            densityOut->template writeData<float>(nx, ny, nz, data, "density", 1, first, last); });
+
+        std::unique_ptr<MultiTensorField3D<float,3> > velocityField(copyConvert<T,float,3>(velocity).release());
+        multiplyInPlace(*velocityField, scale);
+        std::vector<char>& velocityBuffer = writer.acquireBuffer();
+        serializerToBuffer(velocityField->getBlockSerializer(velocityField->getBoundingBox(), IndexOrdering::backward),
+                           velocityBuffer);
+        writer.submit(velocityBuffer, [=, &velocityOut](std::vector<char> const& data) {
+            velocityOut->template writeData<float>(nx, ny, nz, data, "velocity", 3, first, last); });
+    }
+    // The writers write their footer when they are destroyed, on the output thread.
+    writer.submit([&](std::vector<char> const&) {
+        densityOut.reset();
+        velocityOut.reset();
+    });
+    writer.flush();
+}
+
+int main(int argc, char* argv[]) {
+    plbInit(&argc, &argv);
+    global::directories().setOutputDir("./");
+
+    const plint nx = 13, ny = 11, nz = 9;
+    const plint numFrames = 4;
+    const float scale = (float)2.5;
+    MultiScalarField3D<T> density(nx, ny, nz);
+    MultiTensorField3D<T,3> velocity(nx, ny, nz);
+
+    bool success = true;
+    const vtkEncoding::EncodingT encodings[] = { vtkEncoding::base64, vtkEncoding::raw, vtkEncoding::zlib };
+    const std::string names[] = { "base64", "raw", "zlib" };
+    for (plint iEncoding=0; iEncoding<3; ++iEncoding) {
+        global::IOpolicy().setVtkEncoding(encodings[iEncoding]);
+        std::string suffix = "_" + names[iEncoding];
+        writeSynchronously(density, velocity, suffix, numFrames, scale);
+        writeAsynchronously(density, velocity, suffix, numFrames, scale);
+
+        bool same = true;
+        if (global::mpi().isMainProcessor()) {
+            std::string dir = global::directories().getVtkOutDir();
+            std::string syncDensity = readFile(dir+"syncDensity"+suffix+".vts");
+            std::string syncVelocity = readFile(dir+"syncVelocity"+suffix+".vts");
+            same = !syncDensity.empty() && !syncVelocity.empty() &&
+                   syncDensity == readFile(dir+"asyncDensity"+suffix+".vts") &&
+                   syncVelocity == readFile(dir+"asyncVelocity"+suffix+".vts");
+        }
+        global::mpi().bCast(&same, 1);
+        pcout << (same ? "passed" : "FAILED") << ": " << names[iEncoding]
+              << " encoding, the asynchronous files are "
+              << (same ? "identical" : "different") << std::endl;
+        success = success && same;
+    }
+    global::IOpolicy().setVtkEncoding(vtkEncoding::base64);
+
+    return success ? EXIT_SUCCESS : EXIT_FAILURE;
+}
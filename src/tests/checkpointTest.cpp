@@ -0,0 +1,172 @@
+/* This file is part of the Palabos library.
+ *
+ * Copyright (C) 2011-2015 FlowKit Sarl
+ * Route d'Oron 2
+ * 1010 Lausanne, Switzerland
+ * E-mail contact: contact@flowkit.com
+ *
+ * The most recent release of Palabos can be downloaded at 
+ * <http://www.palabos.org/>
+ *
+ * The library Palabos is free software: you can redistribute it and/or
+ * modify it under the terms of the GNU Affero General Public License as
+ * published by the Free Software Foundation, either version 3 of the
+ * License, or (at your option) any later version.
+ *
+ * The library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+/** \file
+ * Regression test: a lattice, a scalar-field and a record written with
+ * CheckpointWriter are read back identically by CheckpointReader, on another
+ * parallel distribution and with non-contiguous block ids, and the lattice is
+ * also rebuilt identically without a target block. A writer which is not
+ * closed leaves the previous checkpoint intact.
+ */
+
+typedef double T;
+
+#include "palabos3D.h"
+#include "palabos3D.hh"
+
+#include <algorithm>
+#include <cstdlib>
+#include <iostream>
+#include <memory>
+
+using namespace plb;
+
+#define DESCRIPTOR descriptors::D3Q19Descriptor
+
+int main(int argc, char* argv[]) {
+    plbInit(&argc, &argv);
+    global::directories().setOutputDir("./");
+    global::directories().setInputDir("./");
+
+    const plint nx = 31, ny = 23, nz = 17;
+    const plint envelopeWidth = 1;
+
+    // Eight blocks with the ids 1, 4, 7, ..., distributed cyclically over the processes.
+    SparseBlockStructure3D blockStructure(Box3D(0,nx-1, 0,ny-1, 0,nz-1));
+    ExplicitThreadAttribution* attribution = new ExplicitThreadAttribution;
+    plint iBlock = 0;
+    for (plint iX=0; iX<2; ++iX) {
+        for (plint iY=0; iY<2; ++iY) {
+            for (plint iZ=0; iZ<2; ++iZ, ++iBlock) {
+                Box3D bulk(iX*(nx/2), iX==0 ? nx/2-1 : nx-1,
+                           iY*(ny/2), iY==0 ? ny/2-1 : ny-1,
+                           iZ*(nz/2), iZ==0 ? nz/2-1 : nz-1);
+                blockStructure.addBlock(bulk, 3*iBlock+1);
+                attribution->addBlock(3*iBlock+1, iBlock % global::mpi().getSize());
+            }
+        }
+    }
+    MultiBlockLattice3D<T,DESCRIPTOR> lattice (
+            MultiBlockManagement3D(blockStructure, attribution, envelopeWidth),
+            defaultMultiBlockPolicy3D().getBlockCommunicator(),
+            defaultMultiBlockPolicy3D().getCombinedStatistics(),
+            defaultMultiBlockPolicy3D().getMultiCellAccess<T,DESCRIPTOR>(),
+            new BGKdynamics<T,DESCRIPTOR>(1.2) );
+    for (plint iX=0; iX<nx; ++iX) {
+        Array<T,3> u((T)0.01*iX/nx, (T)-0.02, (T)0.005);
+        initializeAtEquilibrium(lattice, Box3D(iX,iX, 0,ny-1, 0,nz-1), (T)1+(T)0.001*iX, u);
+    }
+    defineDynamics(lattice, Box3D(3,6, 3,6, 3,6), new BounceBack<T,DESCRIPTOR>((T)1));
+    lattice.collideAndStream();
+    std::auto_ptr<MultiScalarField3D<T> > density(computeDensity(lattice));
+
+    {
+        parallelIO::CheckpointWriter checkpoint("checkpointTest");
+        parallelIO::CheckpointRecord record;
+        record.add((plint)42);
+        record.add(std::string("checkpoint"));
+        checkpoint.write("record", record);
+        checkpoint.write("lattice", lattice, true);
+        checkpoint.write("density", *density);
+        checkpoint.close();
+    }
+    {
+        // An unsuccessful checkpoint, which is not closed.
+        parallelIO::CheckpointWriter checkpoint("checkpointTest");
+        parallelIO::CheckpointRecord record;
+        record.add((plint)0);
+        record.add(std::string("abandoned"));
+        checkpoint.write("record", record);
+    }
+
+    bool success = true;
+    parallelIO::CheckpointReader checkpoint("checkpointTest");
+
+    parallelIO::CheckpointRecord record;
+    checkpoint.read("record", record);
+    plint number;
+    std::string text;
+    record.get(number);
+    record.get(text);
+    bool recordOk = number==42 && text=="checkpoint" && !checkpoint.contains("unknown");
+    pcout << (recordOk ? "passed" : "FAILED") << ": the record of the closed checkpoint is read back" << std::endl;
+    success = success && recordOk;
+
+    // Default distribution of the present processes.
+    MultiBlockLattice3D<T,DESCRIPTOR> restored(nx, ny, nz, new BGKdynamics<T,DESCRIPTOR>(1.2));
+    checkpoint.read("lattice", restored);
+    std::auto_ptr<MultiScalarField3D<T> > restoredDensity(computeDensity(restored));
+    T latticeError = computeMax(*computeAbsoluteValue(*subtract(*density, *restoredDensity)));
+    // The density of the bounce-back cells differs from the one of BGK cells, so that
+    //   the density error also covers the dynamics of each cell.
+    std::map<std::string,int> dynamics, restoredDynamics;
+    lattice.getDynamicsDict(lattice.getBoundingBox(), dynamics);
+    restored.getDynamicsDict(restored.getBoundingBox(), restoredDynamics);
+    bool dynamicsOk = dynamics.size()==2 && restoredDynamics==dynamics;
+    pcout << ((latticeError==(T)0 && dynamicsOk) ? "passed" : "FAILED")
+          << ": lattice read back, density error " << latticeError << std::endl;
+    success = success && latticeError==(T)0 && dynamicsOk;
+
+    // Without a target, the lattice is rebuilt with the blocks under which it was saved.
+    std::unique_ptr<MultiBlock3D> rebuiltBlock(checkpoint.read("lattice"));
+    MultiBlockLattice3D<T,DESCRIPTOR>* rebuilt = dynamic_cast<MultiBlockLattice3D<T,DESCRIPTOR>*>(rebuiltBlock.get());
+    // The blocks are renumbered, but keep their bulks.
+    std::vector<Box3D> bulks, rebuiltBulks;
+    std::map<plint,Box3D>::const_iterator it = blockStructure.getBulks().begin();
+    for (; it != blockStructure.getBulks().end(); ++it) {
+        bulks.push_back(it->second);
+    }
+    if (rebuilt) {
+        it = rebuilt->getMultiBlockManagement().getSparseBlockStructure().getBulks().begin();
+        for (; it != rebuilt->getMultiBlockManagement().getSparseBlockStructure().getBulks().end(); ++it) {
+            rebuiltBulks.push_back(it->second);
+        }
+    }
+    std::sort(bulks.begin(), bulks.end());
+    std::sort(rebuiltBulks.begin(), rebuiltBulks.end());
+    bool rebuiltOk = rebuilt && bulks.size()==rebuiltBulks.size();
+    for (pluint iBulk=0; rebuiltOk && iBulk<bulks.size(); ++iBulk) {
+        rebuiltOk = !(bulks[iBulk] < rebuiltBulks[iBulk]) && !(rebuiltBulks[iBulk] < bulks[iBulk]);
+    }
+    T rebuiltError = (T)-1;
+    if (rebuiltOk) {
+        std::auto_ptr<MultiScalarField3D<T> > rebuiltDensity(computeDensity(*rebuilt));
+        rebuiltError = computeMax(*computeAbsoluteValue(*subtract(*density, *rebuiltDensity)));
+        std::map<std::string,int> rebuiltDynamics;
+        rebuilt->getDynamicsDict(rebuilt->getBoundingBox(), rebuiltDynamics);
+        rebuiltOk = rebuiltError==(T)0 && rebuiltDynamics==dynamics;
+    }
+    pcout << (rebuiltOk ? "passed" : "FAILED")
+          << ": lattice rebuilt from its saved blocks, density error " << rebuiltError << std::endl;
+    success = success && rebuiltOk;
+
+    MultiScalarField3D<T> restoredField(nx, ny, nz);
+    checkpoint.read("density", restoredField);
+    T fieldError = computeMax(*computeAbsoluteValue(*subtract(*density, restoredField)));
+    pcout << (fieldError==(T)0 ? "passed" : "FAILED")
+          << ": scalar-field read back, error " << fieldError << std::endl;
+    success = success && fieldError==(T)0;
+
+    return success ? EXIT_SUCCESS : EXIT_FAILURE;
+}
@@ -0,0 +1,134 @@
+/* This file is part of the Palabos library.
+ *
+ * Copyright (C) 2011-2015 FlowKit Sarl
+ * Route d'Oron 2
+ * 1010 Lausanne, Switzerland
+ * E-mail contact: contact@flowkit.com
+ *
+ * The most recent release of Palabos can be downloaded at 
+ * <http://www.palabos.org/>
+ *
+ * The library Palabos is free software: you can redistribute it and/or
+ * modify it under the terms of the GNU Affero General Public License as
+ * published by the Free Software Foundation, either version 3 of the
+ * License, or (at your option) any later version.
+ *
+ * The library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+/** \file
+ * Regression test: ExternalRhoJcollideAndStream3D gives the same result bit
+ * for bit when the collision is dispatched on a DynamicsList as with virtual
+ * calls, including for cells whose dynamics are not in the list. The same
+ * holds for the collision-streaming of a lattice with a DispatchedCollision3D
+ * policy.
+ */
+
+typedef double T;
+
+#include "palabos3D.h"
+#include "palabos3D.hh"
+#include "testUtil3D.h"
+
+#include <cstdlib>
+#include <iostream>
+#include <memory>
+
+using namespace plb;
+
+#define DESCRIPTOR descriptors::D3Q19Descriptor
+
+/// A lattice stepped like in the moving-body driver: collision-streaming with
+///   the external rhoBar and j, followed by their computation.
+template<class List>
+struct Simulation {
+    Simulation(MultiBlockManagement3D const& management)
+        : lattice(MultiBlockManagement3D(management), defaultMultiBlockPolicy3D().getBlockCommunicator(),
+                  defaultMultiBlockPolicy3D().getCombinedStatistics(),
+                  defaultMultiBlockPolicy3D().getMultiCellAccess<T,DESCRIPTOR>(),
+                  new IncBGKdynamics<T,DESCRIPTOR>((T)1.3)),
+          rhoBar(lattice),
+          j(lattice)
+    {
+        lattice.periodicity().toggleAll(true);
+        initializeAtEquilibrium(lattice, lattice.getBoundingBox(), InitialState());
+        // NoDynamics is in the list, BounceBack and BGKdynamics are not.
+        defineDynamics(lattice, Box3D(6,9, 5,8, 4,12), new NoDynamics<T,DESCRIPTOR>());
+        defineDynamics(lattice, Box3D(15,16, 2,17, 2,15), new BounceBack<T,DESCRIPTOR>((T)1.));
+        defineDynamics(lattice, Box3D(18,23, 0,19, 0,17), new BGKdynamics<T,DESCRIPTOR>((T)1.1));
+        lattice.initialize();
+
+        std::vector<MultiBlock3D*> args;
+        args.push_back(&lattice);
+        args.push_back(&rhoBar);
+        args.push_back(&j);
+        applyProcessingFunctional(new BoxRhoBarJfunctional3D<T,DESCRIPTOR>(), lattice.getBoundingBox(), args);
+        integrateProcessingFunctional(new ExternalRhoJcollideAndStream3D<T,DESCRIPTOR,List>(), lattice.getBoundingBox(), args, 0);
+        integrateProcessingFunctional(new BoxRhoBarJfunctional3D<T,DESCRIPTOR>(), lattice.getBoundingBox(), args, 1);
+    }
+    void step() {
+        lattice.executeInternalProcessors();
+        lattice.incrementTime();
+    }
+    MultiBlockLattice3D<T,DESCRIPTOR> lattice;
+    MultiScalarField3D<T> rhoBar;
+    MultiTensorField3D<T,3> j;
+};
+
+/// A lattice with BGK, incompressible BGK and bounce-back cells, stepped by
+///   collideAndStream().
+MultiBlockLattice3D<T,DESCRIPTOR>* createMixedLattice(MultiBlockManagement3D const& management) {
+    MultiBlockLattice3D<T,DESCRIPTOR>* lattice = new MultiBlockLattice3D<T,DESCRIPTOR> (
+            MultiBlockManagement3D(management), defaultMultiBlockPolicy3D().getBlockCommunicator(),
+            defaultMultiBlockPolicy3D().getCombinedStatistics(),
+            defaultMultiBlockPolicy3D().getMultiCellAccess<T,DESCRIPTOR>(),
+            new BGKdynamics<T,DESCRIPTOR>((T)1.3) );
+    lattice->periodicity().toggleAll(true);
+    initializeAtEquilibrium(*lattice, lattice->getBoundingBox(), InitialState());
+    defineDynamics(*lattice, Box3D(6,9, 5,8, 4,12), new IncBGKdynamics<T,DESCRIPTOR>((T)1.2));
+    defineDynamics(*lattice, Box3D(15,16, 2,17, 2,15), new BounceBack<T,DESCRIPTOR>((T)1.));
+    lattice->initialize();
+    return lattice;
+}
+
+int main(int argc, char* argv[]) {
+    plbInit(&argc, &argv);
+    const plint nx = 24, ny = 20, nz = 18;
+
+    typedef DynamicsList<IncBGKdynamics<T,DESCRIPTOR>, NoDynamics<T,DESCRIPTOR> > List;
+    MultiBlockManagement3D management = createManagement(nx,ny,nz, 1);
+    Simulation<DynamicsList<> > virtualCalls(management);
+    Simulation<List> dispatched(management);
+    for (plint iT=0; iT<10; ++iT) {
+        virtualCalls.step();
+        dispatched.step();
+    }
+
+    T populationDifference = maxPopulationDifference(virtualCalls.lattice, dispatched.lattice);
+    T jDifference = computeMax(*computeNorm(*subtract(virtualCalls.j, dispatched.j)));
+    bool same = populationDifference==(T)0 && jDifference==(T)0;
+    pcout << (same ? "passed" : "FAILED") << ": with the dispatch on a DynamicsList, the populations differ by "
+          << populationDifference << " and j by " << jDifference << std::endl;
+
+    // Collision policy of the block-lattices; incompressible BGK is not in the list.
+    typedef DynamicsList<BGKdynamics<T,DESCRIPTOR>, BounceBack<T,DESCRIPTOR> > LatticeList;
+    std::auto_ptr<MultiBlockLattice3D<T,DESCRIPTOR> > virtualLattice(createMixedLattice(management));
+    std::auto_ptr<MultiBlockLattice3D<T,DESCRIPTOR> > dispatchedLattice(createMixedLattice(management));
+    dispatchedLattice->setCollisionPolicy(new DispatchedCollision3D<T,DESCRIPTOR,LatticeList>());
+    for (plint iT=0; iT<10; ++iT) {
+        virtualLattice->collideAndStream();
+        dispatchedLattice->collideAndStream();
+    }
+    T latticeDifference = maxPopulationDifference(*virtualLattice, *dispatchedLattice);
+    bool samePolicy = latticeDifference==(T)0;
+    pcout << (samePolicy ? "passed" : "FAILED") << ": with a DispatchedCollision3D policy, the populations differ by "
+          << latticeDifference << std::endl;
+
+    return same && samePolicy ? EXIT_SUCCESS : EXIT_FAILURE;
+}
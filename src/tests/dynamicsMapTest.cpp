@@ -0,0 +1,202 @@
+/* This file is part of the Palabos library.
+ *
+ * Copyright (C) 2011-2015 FlowKit Sarl
+ * Route d'Oron 2
+ * 1010 Lausanne, Switzerland
+ * E-mail contact: contact@flowkit.com
+ *
+ * The most recent release of Palabos can be downloaded at 
+ * <http://www.palabos.org/>
+ *
+ * The library Palabos is free software: you can redistribute it and/or
+ * modify it under the terms of the GNU Affero General Public License as
+ * published by the Free Software Foundation, either version 3 of the
+ * License, or (at your option) any later version.
+ *
+ * The library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+/** \file
+ * Regression test: DynamicsMap3D, the dictionary in which the block-lattices
+ * transfer their dynamics objects, restores the dynamics of every cell, and
+ * rejects truncated or corrupted buffers instead of reading past their end.
+ * The dynamics ids of a block-lattice name the class of every cell, also
+ * after a transfer and a copy.
+ */
+
+#include "palabos3D.h"
+#include "core/plbInit.hh"
+#include "core/cell.hh"
+#include "core/dynamics.hh"
+#include "core/blockLatticeBase3D.hh"
+#include "core/dynamicsIdentifiers.hh"
+#include "atomicBlock/blockLattice3D.hh"
+#include "atomicBlock/dynamicsMap3D.hh"
+#include "basicDynamics/isoThermalDynamics.hh"
+#include "basicDynamics/vectorizedCollision3D.hh"
+#include "boundaryCondition/bounceBackModels.hh"
+#include "latticeBoltzmann/nearestNeighborLattices3D.hh"
+
+#include <cstdlib>
+#include <iostream>
+#include <typeinfo>
+
+using namespace plb;
+
+typedef double T;
+#define DESCRIPTOR descriptors::D3Q19Descriptor
+
+/// Serialized content of the dynamics of a cell.
+std::vector<char> serializedDynamics(BlockLattice3D<T,DESCRIPTOR> const& lattice, plint iX, plint iY, plint iZ) {
+    std::vector<char> data;
+    serialize(lattice.get(iX,iY,iZ).getDynamics(), data);
+    return data;
+}
+
+/// Number of cells whose dynamics or populations differ between the two lattices.
+plint countDifferences(BlockLattice3D<T,DESCRIPTOR> const& a, BlockLattice3D<T,DESCRIPTOR> const& b) {
+    plint differences = 0;
+    for (plint iX=0; iX<a.getNx(); ++iX) {
+        for (plint iY=0; iY<a.getNy(); ++iY) {
+            for (plint iZ=0; iZ<a.getNz(); ++iZ) {
+                bool same = serializedDynamics(a,iX,iY,iZ)==serializedDynamics(b,iX,iY,iZ);
+                for (plint iPop=0; iPop<DESCRIPTOR<T>::q; ++iPop) {
+                    same = same && a.get(iX,iY,iZ)[iPop]==b.get(iX,iY,iZ)[iPop];
+                }
+                if (!same) ++differences;
+            }
+        }
+    }
+    return differences;
+}
+
+/// Whether the dynamics ids of the lattice match the classes of its dynamics objects.
+bool idsMatchDynamics(BlockLattice3D<T,DESCRIPTOR> const& lattice) {
+    for (plint iX=0; iX<lattice.getNx(); ++iX) {
+        for (plint iY=0; iY<lattice.getNy(); ++iY) {
+            for (plint iZ=0; iZ<lattice.getNz(); ++iZ) {
+                plint id = lattice.getDynamicsId(iX,iY,iZ);
+                if ( lattice.getDynamicsIds(iX,iY)[iZ]!=id ||
+                     !(lattice.getDynamicsType(id)==typeid(lattice.get(iX,iY,iZ).getDynamics())) )
+                {
+                    return false;
+                }
+            }
+        }
+    }
+    return true;
+}
+
+/// Whether unserializing the buffer raises an I/O error.
+bool isRejected(std::vector<char> const& buffer) {
+    DynamicsMap3D<T,DESCRIPTOR> map;
+    try {
+        map.unserialize(buffer, 0);
+    }
+    catch (PlbIOException const&) {
+        return true;
+    }
+    return false;
+}
+
+void report(bool& success, bool passed, std::string const& message) {
+    pcout << (passed ? "passed" : "FAILED") << ": " << message << std::endl;
+    success = success && passed;
+}
+
+int main(int argc, char* argv[]) {
+    plbInit(&argc, &argv);
+    bool success = true;
+
+    // 300 cells with a relaxation frequency of their own, so that the ids take
+    //   two bytes, a bounce-back box, and the default BGK dynamics elsewhere.
+    const plint n = 10;
+    BlockLattice3D<T,DESCRIPTOR> lattice(n,n,n, new BGKdynamics<T,DESCRIPTOR>(1.));
+    for (plint iX=0; iX<3; ++iX) {
+        for (plint iY=0; iY<n; ++iY) {
+            for (plint iZ=0; iZ<n; ++iZ) {
+                T omega = (T)1.1 + (T)1.e-3*(T)((iX*n+iY)*n+iZ);
+                lattice.attributeDynamics(iX,iY,iZ, new BGKdynamics<T,DESCRIPTOR>(omega));
+            }
+        }
+    }
+    for (plint iX=5; iX<=7; ++iX) {
+        for (plint iY=5; iY<=7; ++iY) {
+            for (plint iZ=5; iZ<=7; ++iZ) {
+                lattice.attributeDynamics(iX,iY,iZ, new BounceBack<T,DESCRIPTOR>((T)1.));
+            }
+        }
+    }
+    for (plint iX=0; iX<n; ++iX) {
+        for (plint iY=0; iY<n; ++iY) {
+            for (plint iZ=0; iZ<n; ++iZ) {
+                for (plint iPop=0; iPop<DESCRIPTOR<T>::q; ++iPop) {
+                    lattice.get(iX,iY,iZ)[iPop] = (T)1.e-3*(T)(((iX*n+iY)*n+iZ)*DESCRIPTOR<T>::q+iPop);
+                }
+            }
+        }
+    }
+
+    // Transfer of the data structure between two block-lattices.
+    std::vector<char> buffer;
+    lattice.getDataTransfer().send(lattice.getBoundingBox(), buffer, modif::dataStructure);
+    BlockLattice3D<T,DESCRIPTOR> copy(n,n,n, new BGKdynamics<T,DESCRIPTOR>(1.9));
+    copy.getDataTransfer().receive(copy.getBoundingBox(), buffer, modif::dataStructure);
+    plint differences = countDifferences(lattice, copy);
+    report(success, differences==0, "the received lattice differs in "+util::val2str(differences)+" cells");
+
+    // Dynamics ids: one entry for BGK and one for bounce-back.
+    BlockLattice3D<T,DESCRIPTOR> duplicate(lattice);
+    report(success, lattice.getNumDynamicsIds()==2 && copy.getNumDynamicsIds()==2 &&
+                    duplicate.getNumDynamicsIds()==2,
+           "the dictionaries of dynamics ids have two entries");
+    report(success, idsMatchDynamics(lattice) && idsMatchDynamics(copy) && idsMatchDynamics(duplicate),
+           "the dynamics ids match the dynamics of the cells");
+
+    // Round trip of the map alone.
+    DynamicsMap3D<T,DESCRIPTOR> map;
+    for (plint iX=0; iX<n; ++iX) {
+        for (plint iY=0; iY<n; ++iY) {
+            for (plint iZ=0; iZ<n; ++iZ) {
+                map.add(lattice.get(iX,iY,iZ).getDynamics());
+            }
+        }
+    }
+    report(success, map.getNumEntries()==302 && map.getIdSize()==2,
+           util::val2str(map.getNumEntries())+" entries, with ids of "+util::val2str(map.getIdSize())+" bytes");
+    std::vector<char> mapBuffer;
+    map.serialize(mapBuffer);
+    DynamicsMap3D<T,DESCRIPTOR> restored;
+    pluint end = restored.unserialize(mapBuffer, 0);
+    bool sameMap = end==mapBuffer.size() && restored.getNumCells()==map.getNumCells() &&
+                   restored.getNumEntries()==map.getNumEntries();
+    for (plint iCell=0; sameMap && iCell<map.getNumCells(); ++iCell) {
+        sameMap = restored.getId(iCell)==map.getId(iCell) &&
+                  restored.getEntry(map.getId(iCell))==map.getEntry(map.getId(iCell));
+    }
+    report(success, sameMap, "the unserialized map is identical to the original");
+
+    // Truncated buffers: in the header, in the first entry, and in the cell ids.
+    std::vector<char> header(mapBuffer.begin(), mapBuffer.begin()+sizeof(int)+sizeof(plint));
+    std::vector<char> entry(mapBuffer.begin(), mapBuffer.begin()+2*sizeof(int)+sizeof(plint)+sizeof(pluint)+1);
+    std::vector<char> ids(mapBuffer.begin(), mapBuffer.end()-1);
+    report(success, isRejected(header) && isRejected(entry) && isRejected(ids),
+           "truncated buffers are rejected");
+
+    // A cell id beyond the dictionary.
+    DynamicsMap3D<T,DESCRIPTOR> smallMap;
+    smallMap.add(lattice.get(0,0,0).getDynamics());
+    smallMap.add(lattice.get(n-1,n-1,n-1).getDynamics());
+    std::vector<char> corrupted;
+    smallMap.serialize(corrupted);
+    corrupted.back() = (char)200;
+    report(success, isRejected(corrupted), "a cell id out of range is rejected");
+
+    return success ? EXIT_SUCCESS : EXIT_FAILURE;
+}
@@ -0,0 +1,106 @@
+/* This file is part of the Palabos library.
+ *
+ * Copyright (C) 2011-2015 FlowKit Sarl
+ * Route d'Oron 2
+ * 1010 Lausanne, Switzerland
+ * E-mail contact: contact@flowkit.com
+ *
+ * The most recent release of Palabos can be downloaded at 
+ * <http://www.palabos.org/>
+ *
+ * The library Palabos is free software: you can redistribute it and/or
+ * modify it under the terms of the GNU Affero General Public License as
+ * published by the Free Software Foundation, either version 3 of the
+ * License, or (at your option) any later version.
+ *
+ * The library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+/** \file
+ * Regression test: reduceImmersedForceTorqueArea() computes in one pass the
+ * same force, torque and area as the separate reductions, and the traction it
+ * returns is consistent with the force.
+ */
+
+typedef double T;
+
+#include "palabos3D.h"
+#include "palabos3D.hh"
+#include "testUtil3D.h"
+
+#include <cmath>
+#include <cstdlib>
+#include <iostream>
+#include <limits>
+
+using namespace plb;
+
+/// Relative difference between two vectors.
+T relativeDifference(Array<T,3> const& a, Array<T,3> const& b) {
+    return norm(a-b)/std::max(norm(a), std::numeric_limits<T>::min());
+}
+
+void report(bool& success, T difference, std::string const& quantity) {
+    // The vertices are summed in the same order, but the fused reduction
+    //   combines all sums in a single collective call.
+    const T tolerance = (T)1.e-12;
+    bool passed = difference <= tolerance;
+    pcout << (passed ? "passed" : "FAILED") << ": the " << quantity << " differs by " << difference << std::endl;
+    success = success && passed;
+}
+
+int main(int argc, char* argv[]) {
+    plbInit(&argc, &argv);
+
+    // A sphere of immersed vertices in a box of 32^3 cells, split into eight
+    //   blocks which are distributed cyclically over the processes.
+    const plint n = 32;
+    MultiBlockManagement3D management = createManagement(n,n,n, 3);
+    MultiScalarField3D<T> rhoBar(MultiBlockManagement3D(management), defaultMultiBlockPolicy3D().getBlockCommunicator(),
+                                 defaultMultiBlockPolicy3D().getCombinedStatistics(),
+                                 defaultMultiBlockPolicy3D().getMultiScalarAccess<T>(), (T)0);
+    MultiTensorField3D<T,3> j(MultiBlockManagement3D(management), defaultMultiBlockPolicy3D().getBlockCommunicator(),
+                              defaultMultiBlockPolicy3D().getCombinedStatistics(),
+                              defaultMultiBlockPolicy3D().getMultiTensorAccess<T,3>(), Array<T,3>((T)0.02,(T)0,(T)0));
+    MultiContainerBlock3D container(rhoBar);
+
+    std::vector< Array<T,3> > vertices;
+    std::vector<T> areas;
+    constructVertices(Array<T,3>((T)15.3, (T)16.6, (T)14.2), (T)7, 1000, vertices, areas);
+    instantiateImmersedWallData(vertices, areas, container);
+    // A few iterations give every vertex a different force.
+    for (plint i=0; i<3; ++i) {
+        cachedInamuroIteration(WallVelocity(), rhoBar, j, container, (T)0.8, true);
+    }
+
+    Array<T,3> center((T)15., (T)16., (T)14.);
+    Array<T,3> axis((T)0.6, (T)0., (T)0.8);
+    Array<T,3> force, torque;
+    T area;
+    std::vector<Array<T,3> > traction(vertices.size(), Array<T,3>((T)0,(T)0,(T)0));
+    reduceImmersedForceTorqueArea(container, center, axis, force, torque, area, 0, &traction);
+
+    bool success = true;
+    report(success, relativeDifference(reduceImmersedForce<T>(container), force), "force");
+    report(success, relativeDifference(reduceAxialTorqueImmersed(container, center, axis), torque), "torque");
+    report(success, std::fabs(reduceImmersedArea<T>(container)-area)/area, "area");
+
+    // Each vertex is reduced by exactly one process, which writes its traction.
+    std::vector<T> weightedTraction(3, (T)0);
+    for (pluint i=0; i<traction.size(); ++i) {
+        for (int iD=0; iD<3; ++iD) {
+            weightedTraction[iD] += traction[i][iD]*areas[i];
+        }
+    }
+    sumOverProcesses(weightedTraction);
+    report(success, relativeDifference(force, Array<T,3>(weightedTraction[0], weightedTraction[1], weightedTraction[2])),
+           "sum of the traction times the area, compared with the force,");
+
+    return success ? EXIT_SUCCESS : EXIT_FAILURE;
+}
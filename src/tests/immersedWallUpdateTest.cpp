@@ -0,0 +1,119 @@
+/* This file is part of the Palabos library.
+ *
+ * Copyright (C) 2011-2015 FlowKit Sarl
+ * Route d'Oron 2
+ * 1010 Lausanne, Switzerland
+ * E-mail contact: contact@flowkit.com
+ *
+ * The most recent release of Palabos can be downloaded at 
+ * <http://www.palabos.org/>
+ *
+ * The library Palabos is free software: you can redistribute it and/or
+ * modify it under the terms of the GNU Affero General Public License as
+ * published by the Free Software Foundation, either version 3 of the
+ * License, or (at your option) any later version.
+ *
+ * The library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+/** \file
+ * Regression test: UpdateImmersedWallData3D, which updates the immersed wall
+ * data of each block in place while the surface moves, gives on every block
+ * the same data as a new InstantiateImmersedWallData3D.
+ */
+
+typedef double T;
+
+#include "palabos3D.h"
+#include "palabos3D.hh"
+#include "testUtil3D.h"
+
+#include <cmath>
+#include <cstdlib>
+#include <iostream>
+#include <memory>
+
+using namespace plb;
+
+/// Number of blocks on which the immersed wall data of the two containers differ.
+plint countDifferences(MultiContainerBlock3D& a, MultiContainerBlock3D& b) {
+    plint differences = 0;
+    std::vector<plint> const& localBlocks = a.getLocalInfo().getBlocks();
+    for (pluint iBlock=0; iBlock<localBlocks.size(); ++iBlock) {
+        ImmersedWallData3D<T> const* dataA =
+            dynamic_cast<ImmersedWallData3D<T> const*>(a.getComponent(localBlocks[iBlock]).getData());
+        ImmersedWallData3D<T> const* dataB =
+            dynamic_cast<ImmersedWallData3D<T> const*>(b.getComponent(localBlocks[iBlock]).getData());
+        bool same = dataA && dataB &&
+                    dataA->globalVertexIds==dataB->globalVertexIds &&
+                    dataA->areas==dataB->areas &&
+                    dataA->flags==dataB->flags &&
+                    dataA->vertices.size()==dataB->vertices.size() &&
+                    dataA->normals.size()==dataB->normals.size() &&
+                    dataA->g.size()==dataB->g.size();
+        for (pluint i=0; same && i<dataA->vertices.size(); ++i) {
+            same = norm(dataA->vertices[i]-dataB->vertices[i])==(T)0 &&
+                   norm(dataA->normals[i]-dataB->normals[i])==(T)0 &&
+                   norm(dataA->g[i]-dataB->g[i])==(T)0;
+        }
+        if (!same) ++differences;
+    }
+    return sumOverProcesses(differences);
+}
+
+int main(int argc, char* argv[]) {
+    plbInit(&argc, &argv);
+
+    // A sphere of radius 5 crosses the blocks of a box of 32^3 cells, split into
+    //   eight blocks which are distributed cyclically over the processes.
+    const plint n = 32;
+    MultiBlockManagement3D management = createManagement(n,n,n, 3);
+    MultiScalarField3D<T> field(MultiBlockManagement3D(management), defaultMultiBlockPolicy3D().getBlockCommunicator(),
+                                defaultMultiBlockPolicy3D().getCombinedStatistics(),
+                                defaultMultiBlockPolicy3D().getMultiScalarAccess<T>(), (T)0);
+    MultiContainerBlock3D updated(field);
+    MultiContainerBlock3D instantiated(field);
+
+    std::vector< Array<T,3> > vertices, normals;
+    std::vector<T> areas;
+    Array<T,3> center((T)8.3, (T)9.6, (T)10.2);
+    const T radius = (T)5;
+    constructVertices(center, radius, 600, vertices, areas);
+    for (pluint i=0; i<vertices.size(); ++i) {
+        normals.push_back((vertices[i]-center)/radius);
+    }
+    std::shared_ptr<ImmersedWallVertexBuffer3D<T> > buffer (
+            new ImmersedWallVertexBuffer3D<T>(vertices, areas, normals) );
+
+    // The processor keeps track of the versions of the buffer, so it is
+    //   integrated once, like in the moving-body driver.
+    std::vector<MultiBlock3D*> args;
+    args.push_back(&updated);
+    integrateProcessingFunctional (
+            new UpdateImmersedWallData3D<T>(buffer), updated.getBoundingBox(), field, args, 0 );
+
+    bool success = true;
+    const Array<T,3> displacement((T)1.3, (T)1.1, (T)0.9);
+    for (plint iStep=0; iStep<12; ++iStep) {
+        field.executeInternalProcessors();
+        instantiateImmersedWallData(vertices, areas, normals, instantiated);
+        plint differences = countDifferences(updated, instantiated);
+        pcout << (differences==0 ? "passed" : "FAILED") << ": step " << iStep
+              << ", the wall data differ on " << differences << " blocks" << std::endl;
+        success = success && differences==0;
+
+        // The sphere moves, and the version of the buffer changes.
+        for (pluint i=0; i<vertices.size(); ++i) {
+            vertices[i] += displacement;
+        }
+        buffer->setVertices(vertices);
+    }
+
+    return success ? EXIT_SUCCESS : EXIT_FAILURE;
+}
@@ -0,0 +1,148 @@
+/* This file is part of the Palabos library.
+ *
+ * Copyright (C) 2011-2015 FlowKit Sarl
+ * Route d'Oron 2
+ * 1010 Lausanne, Switzerland
+ * E-mail contact: contact@flowkit.com
+ *
+ * The most recent release of Palabos can be downloaded at 
+ * <http://www.palabos.org/>
+ *
+ * The library Palabos is free software: you can redistribute it and/or
+ * modify it under the terms of the GNU Affero General Public License as
+ * published by the Free Software Foundation, either version 3 of the
+ * License, or (at your option) any later version.
+ *
+ * The library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+/** \file
+ * Regression test: CachedInamuroIteration3D yields the same momentum and the
+ * same immersed force as IndexedInamuroIteration3D, on a surface which moves
+ * from one step to the next, and leaves the momentum untouched on a domain
+ * which no vertex stencil reaches.
+ */
+
+typedef double T;
+
+#include "palabos3D.h"
+#include "palabos3D.hh"
+#include "testUtil3D.h"
+
+#include <cmath>
+#include <cstdlib>
+#include <iostream>
+#include <memory>
+
+using namespace plb;
+
+/// Maximum difference between two momentum fields.
+T maxDifference(MultiTensorField3D<T,3>& a, MultiTensorField3D<T,3>& b) {
+    return computeMax(*computeNorm(*subtract(a, b)));
+}
+
+/// The fields of one immersed-boundary computation, and its processors: the
+///   update of the wall data, followed by numIterations Inamuro iterations.
+struct ImmersedSetup {
+    ImmersedSetup(MultiBlockManagement3D const& management,
+                  std::shared_ptr<ImmersedWallVertexBuffer3D<T> const> buffer,
+                  bool cached, plint numIterations, T tau)
+        : rhoBar(MultiBlockManagement3D(management), defaultMultiBlockPolicy3D().getBlockCommunicator(),
+                 defaultMultiBlockPolicy3D().getCombinedStatistics(),
+                 defaultMultiBlockPolicy3D().getMultiScalarAccess<T>(), (T)0),
+          j(MultiBlockManagement3D(management), defaultMultiBlockPolicy3D().getBlockCommunicator(),
+            defaultMultiBlockPolicy3D().getCombinedStatistics(),
+            defaultMultiBlockPolicy3D().getMultiTensorAccess<T,3>(), Array<T,3>((T)0.02,(T)0,(T)0)),
+          container(rhoBar)
+    {
+        std::vector<MultiBlock3D*> args;
+        args.push_back(&container);
+        integrateProcessingFunctional (
+                new UpdateImmersedWallData3D<T>(buffer), container.getBoundingBox(), rhoBar, args, 0 );
+        for (plint i=0; i<numIterations; ++i) {
+            args.resize(0);
+            args.push_back(&rhoBar);
+            args.push_back(&j);
+            args.push_back(&container);
+            BoxProcessingFunctional3D* iteration = 0;
+            if (cached) {
+                iteration = new CachedInamuroIteration3D<T,WallVelocity>(WallVelocity(), tau, true);
+            }
+            else {
+                iteration = new IndexedInamuroIteration3D<T,WallVelocity>(WallVelocity(), tau, true);
+            }
+            integrateProcessingFunctional(iteration, rhoBar.getBoundingBox(), rhoBar, args, i+1);
+        }
+    }
+    MultiScalarField3D<T> rhoBar;
+    MultiTensorField3D<T,3> j;
+    MultiContainerBlock3D container;
+};
+
+int main(int argc, char* argv[]) {
+    plbInit(&argc, &argv);
+
+    // A sphere of radius 6 moves through a box of 32^3 cells, split into eight
+    //   blocks which are distributed cyclically over the processes.
+    const plint n = 32;
+    const plint envelopeWidth = 3;
+    const plint numIterations = 3;
+    const T tau = (T)0.8;
+    MultiBlockManagement3D management = createManagement(n,n,n, envelopeWidth);
+
+    std::vector< Array<T,3> > vertices;
+    std::vector<T> areas;
+    Array<T,3> center((T)12.3, (T)15.6, (T)16.2);
+    constructVertices(center, (T)6, 800, vertices, areas);
+    std::shared_ptr<ImmersedWallVertexBuffer3D<T> > buffer (
+            new ImmersedWallVertexBuffer3D<T>(vertices, areas, std::vector< Array<T,3> >()) );
+
+    ImmersedSetup indexed(management, buffer, false, numIterations, tau);
+    ImmersedSetup cached(management, buffer, true, numIterations, tau);
+
+    // No vertex stencil reaches this corner of the box, but the block which holds
+    //   it also holds vertices.
+    const Box3D farCorner(n-6,n-1, n-6,n-1, n-6,n-1);
+
+    bool success = true;
+    const Array<T,3> displacement((T)0.7, (T)0.2, (T)-0.1);
+    for (plint iStep=0; iStep<5; ++iStep) {
+        indexed.rhoBar.executeInternalProcessors();
+        cached.rhoBar.executeInternalProcessors();
+
+        T jDifference = maxDifference(indexed.j, cached.j);
+        Array<T,3> gDifference = reduceImmersedForce<T>(indexed.container) - reduceImmersedForce<T>(cached.container);
+        T gNorm = norm(reduceImmersedForce<T>(indexed.container));
+        bool same = jDifference <= (T)1.e-14 && norm(gDifference) <= (T)1.e-12*gNorm;
+        pcout << (same ? "passed" : "FAILED") << ": step " << iStep
+              << ", the cached iteration differs by " << jDifference << " in j and by "
+              << norm(gDifference) << " in the force of norm " << gNorm << std::endl;
+        success = success && same;
+
+        for (pluint i=0; i<vertices.size(); ++i) {
+            vertices[i] += displacement;
+        }
+        buffer->setVertices(vertices);
+    }
+
+    // The stencils of the far corner are empty.
+    std::auto_ptr<MultiTensorField3D<T,3> > jBefore(extractSubDomain(cached.j, cached.j.getBoundingBox()));
+    std::vector<MultiBlock3D*> args;
+    args.push_back(&cached.rhoBar);
+    args.push_back(&cached.j);
+    args.push_back(&cached.container);
+    applyProcessingFunctional (
+            new CachedInamuroIteration3D<T,WallVelocity>(WallVelocity(), tau, true), farCorner, args );
+    T farDifference = maxDifference(*jBefore, cached.j);
+    pcout << (farDifference==(T)0 ? "passed" : "FAILED")
+          << ": empty stencils changed j by " << farDifference << std::endl;
+    success = success && farDifference==(T)0;
+
+    return success ? EXIT_SUCCESS : EXIT_FAILURE;
+}
@@ -0,0 +1,130 @@
+/* This file is part of the Palabos library.
+ *
+ * Copyright (C) 2011-2015 FlowKit Sarl
+ * Route d'Oron 2
+ * 1010 Lausanne, Switzerland
+ * E-mail contact: contact@flowkit.com
+ *
+ * The most recent release of Palabos can be downloaded at 
+ * <http://www.palabos.org/>
+ *
+ * The library Palabos is free software: you can redistribute it and/or
+ * modify it under the terms of the GNU Affero General Public License as
+ * published by the Free Software Foundation, either version 3 of the
+ * License, or (at your option) any later version.
+ *
+ * The library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+/** \file
+ * Regression test: LoadBalancer3D attributes to each block the time spent in
+ * its own data processors, instead of splitting the time of the process in
+ * proportion of static weights.
+ */
+
+#include "palabos3D.h"
+#include "atomicBlock/dataField3D.hh"
+#include "atomicBlock/dataProcessingFunctional3D.hh"
+#include "multiBlock/multiDataField3D.hh"
+#include "parallelism/parallelMultiDataField3D.hh"
+
+#include <chrono>
+#include <cstdlib>
+#include <iostream>
+
+using namespace plb;
+
+typedef double T;
+
+/// Processor which keeps its block busy for a fixed time.
+class BusyProcessor3D : public BoxProcessingFunctional3D_S<T> {
+public:
+    BusyProcessor3D(double seconds_)
+        : seconds(seconds_)
+    { }
+    virtual void process(Box3D domain, ScalarField3D<T>& field) {
+        std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+        while (std::chrono::duration<double>(std::chrono::steady_clock::now()-start).count() < seconds)
+        { }
+    }
+    virtual BusyProcessor3D* clone() const {
+        return new BusyProcessor3D(*this);
+    }
+    virtual void getTypeOfModification(std::vector<modif::ModifT>& modified) const {
+        modified[0] = modif::nothing;
+    }
+private:
+    double seconds;
+};
+
+int main(int argc, char* argv[]) {
+    plbInit(&argc, &argv);
+
+    // Eight blocks, distributed cyclically over the processes.
+    const plint n = 16;
+    SparseBlockStructure3D blockStructure = createRegularDistribution3D(n,n,n, 2,2,2);
+    ExplicitThreadAttribution* attribution = new ExplicitThreadAttribution;
+    std::map<plint,Box3D> const& bulks = blockStructure.getBulks();
+    for (std::map<plint,Box3D>::const_iterator it = bulks.begin(); it != bulks.end(); ++it) {
+        attribution->addBlock(it->first, it->first % global::mpi().getSize());
+    }
+    MultiScalarField3D<T> field (
+            MultiBlockManagement3D(blockStructure, attribution, 1),
+            defaultMultiBlockPolicy3D().getBlockCommunicator(),
+            defaultMultiBlockPolicy3D().getCombinedStatistics(),
+            defaultMultiBlockPolicy3D().getMultiScalarAccess<T>() );
+
+    // The block at the origin is twenty times as expensive as the other ones.
+    const double time = 1.e-3;
+    integrateProcessingFunctional(new BusyProcessor3D(19*time), Box3D(0,n/2-1, 0,n/2-1, 0,n/2-1), field, 0);
+    integrateProcessingFunctional(new BusyProcessor3D(time), field.getBoundingBox(), field, 0);
+
+    std::map<plint,double> weights;
+    std::vector<plint> const& localBlocks = field.getLocalInfo().getBlocks();
+    for (pluint iBlock=0; iBlock<localBlocks.size(); ++iBlock) {
+        weights[localBlocks[iBlock]] = 1.;
+    }
+    plint expensiveBlock = blockStructure.locate(0,0,0);
+
+    bool success = true;
+    LoadBalancer3D balancer;
+    balancer.estimate(field, weights);
+    std::map<plint,double> costs = balancer.getBlockCosts();
+    for (std::map<plint,double>::const_iterator it = costs.begin(); it != costs.end(); ++it) {
+        success = success && it->second==1.;
+    }
+    pcout << (success ? "passed" : "FAILED") << ": estimated costs are the weights" << std::endl;
+
+    const plint numSteps = 5;
+    for (plint iStep=0; iStep<numSteps; ++iStep) {
+        field.executeInternalProcessors();
+    }
+    balancer.measure(field, weights);
+    costs = balancer.getBlockCosts();
+    bool measured = costs[expensiveBlock] >= 0.9*20*time*numSteps;
+    for (std::map<plint,double>::const_iterator it = costs.begin(); it != costs.end(); ++it) {
+        if (it->first != expensiveBlock) {
+            measured = measured && it->second >= 0.9*time*numSteps &&
+                                   it->second < 0.25*costs[expensiveBlock];
+        }
+    }
+    pcout << (measured ? "passed" : "FAILED") << ": measured costs per block (expensive block "
+          << costs[expensiveBlock] << " s)" << std::endl;
+    success = success && measured;
+
+    // A second measurement only accounts for the time spent since the first one.
+    field.executeInternalProcessors();
+    balancer.measure(field, weights);
+    costs = balancer.getBlockCosts();
+    bool restarted = costs[expensiveBlock] < 0.5*20*time*numSteps;
+    pcout << (restarted ? "passed" : "FAILED") << ": measurement restarts after each call" << std::endl;
+    success = success && restarted;
+
+    return success ? EXIT_SUCCESS : EXIT_FAILURE;
+}
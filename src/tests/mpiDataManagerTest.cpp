@@ -0,0 +1,138 @@
+/* This file is part of the Palabos library.
+ *
+ * Copyright (C) 2011-2015 FlowKit Sarl
+ * Route d'Oron 2
+ * 1010 Lausanne, Switzerland
+ * E-mail contact: contact@flowkit.com
+ *
+ * The most recent release of Palabos can be downloaded at 
+ * <http://www.palabos.org/>
+ *
+ * The library Palabos is free software: you can redistribute it and/or
+ * modify it under the terms of the GNU Affero General Public License as
+ * published by the Free Software Foundation, either version 3 of the
+ * License, or (at your option) any later version.
+ *
+ * The library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+/** \file
+ * Regression test: the bulk broadcasts of MpiDataManager deliver, on every
+ * process, the same scalar field and triangle set as on the sender.
+ */
+
+typedef double T;
+
+#include "palabos3D.h"
+#include "palabos3D.hh"
+#include "testUtil3D.h"
+#include "myheaders3D.hh"
+
+#include <cstdlib>
+#include <iostream>
+
+using namespace plb;
+
+/// Value of the sent field at a given cell.
+int fieldValue(plint iX, plint iY, plint iZ) {
+    return (int)(iX*10007 + iY*101 - iZ*7 + 3);
+}
+
+/// Number of triangles of a and b which differ, or -1 if the sets have
+///   different sizes.
+plint countDifferences(TriangleSet<T> const& a, TriangleSet<T> const& b) {
+    std::vector<Array<Array<T,3>,3> > const& listA = a.getTriangles();
+    std::vector<Array<Array<T,3>,3> > const& listB = b.getTriangles();
+    if (listA.size() != listB.size()) {
+        return -1;
+    }
+    plint differences = 0;
+    for (pluint i=0; i<listA.size(); ++i) {
+        for (int iVertex=0; iVertex<3; ++iVertex) {
+            if (norm(listA[i][iVertex]-listB[i][iVertex]) != (T)0) {
+                ++differences;
+                break;
+            }
+        }
+    }
+    return differences;
+}
+
+/// Sum over all processes of a number of differences; a negative local
+///   value counts as one difference.
+plint reduceDifferences(plint differences) {
+    return sumOverProcesses(differences<0 ? (plint)1 : differences);
+}
+
+bool report(std::string const& name, plint differences) {
+    pcout << (differences==0 ? "passed" : "FAILED") << ": " << name
+          << ", " << differences << " differences" << std::endl;
+    return differences==0;
+}
+
+int main(int argc, char* argv[]) {
+    plbInit(&argc, &argv);
+    const int sender = global::mpi().bossId();
+    const bool isMain = global::mpi().isMainProcessor();
+    bool success = true;
+
+    // A sub-domain of a scalar field is broadcast from the main processor; the
+    //   cells outside of it must keep their value on the receivers.
+    ScalarField3D<int> field(12, 9, 7, -1);
+    Box3D domain(2, 10, 1, 7, 3, 5);
+    if (isMain) {
+        for (plint iX=domain.x0; iX<=domain.x1; ++iX) {
+            for (plint iY=domain.y0; iY<=domain.y1; ++iY) {
+                for (plint iZ=domain.z0; iZ<=domain.z1; ++iZ) {
+                    field.get(iX,iY,iZ) = fieldValue(iX,iY,iZ);
+                }
+            }
+        }
+        global::mpiData().sendScalarField3D(field, domain);
+    }
+    else {
+        global::mpiData().receiveScalarField3D(field, domain, sender);
+    }
+    plint differences = 0;
+    for (plint iX=0; iX<field.getNx(); ++iX) {
+        for (plint iY=0; iY<field.getNy(); ++iY) {
+            for (plint iZ=0; iZ<field.getNz(); ++iZ) {
+                int expected = contained(iX,iY,iZ, domain) ? fieldValue(iX,iY,iZ) : -1;
+                if (field.get(iX,iY,iZ) != expected) {
+                    ++differences;
+                }
+            }
+        }
+    }
+    success = report("scalar field", reduceDifferences(differences)) && success;
+
+    // A triangle set is broadcast with the blocking and the non-blocking calls.
+    TriangleSet<T> sphere = constructSphere<T>(Array<T,3>((T)1.5, (T)-2., (T)0.25), (T)3.7, 300);
+    TriangleSet<T> received;
+    if (isMain) {
+        global::mpiData().sendTriangleSet<T>(sphere);
+        received = sphere;
+    }
+    else {
+        received = global::mpiData().receiveTriangleSet<T>();
+    }
+    success = report("blocking triangle set", reduceDifferences(countDifferences(sphere, received))) && success;
+
+    global::TriangleSetTransfer<T> transfer;
+    if (isMain) {
+        global::mpiData().iSendTriangleSet<T>(sphere, transfer);
+    }
+    else {
+        global::mpiData().iReceiveTriangleSet<T>(transfer);
+    }
+    received = transfer.complete();
+    success = report("non-blocking triangle set", reduceDifferences(countDifferences(sphere, received))) && success;
+
+    return success ? EXIT_SUCCESS : EXIT_FAILURE;
+}
@@ -0,0 +1,86 @@
+/* This file is part of the Palabos library.
+ *
+ * Copyright (C) 2011-2015 FlowKit Sarl
+ * Route d'Oron 2
+ * 1010 Lausanne, Switzerland
+ * E-mail contact: contact@flowkit.com
+ *
+ * The most recent release of Palabos can be downloaded at 
+ * <http://www.palabos.org/>
+ *
+ * The library Palabos is free software: you can redistribute it and/or
+ * modify it under the terms of the GNU Affero General Public License as
+ * published by the Free Software Foundation, either version 3 of the
+ * License, or (at your option) any later version.
+ *
+ * The library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+/** \file
+ * Regression test: the hardware counters of the profiler follow the calling
+ * thread only, so they are refused, and left out of the roofline report, when
+ * the thread pool runs more than one thread.
+ */
+
+#include "palabos3D.h"
+#include "core/plbInit.hh"
+
+#include <cstdlib>
+#include <fstream>
+#include <iostream>
+#include <sstream>
+
+using namespace plb;
+
+/// Contents of the report, as read by the main process.
+std::string readReport(std::string const& fileName) {
+    std::ifstream file(fileName.c_str());
+    std::stringstream contents;
+    contents << file.rdbuf();
+    return contents.str();
+}
+
+int main(int argc, char* argv[]) {
+    plbInit(&argc, &argv);
+    global::directories().setOutputDir("./");
+
+    global::threadPool().setNumThreads(2);
+    global::profiler().turnOn();
+    global::profiler().setStreamBandwidth(1.e10);
+    bool refused = !global::profiler().turnOnHardwareCounters();
+
+    // A collision-streaming region, of 1000 cells with 19 double-precision
+    //   populations read and written each.
+    global::profiler().start("collStream");
+    global::profiler().incrementCollStream(1000, 2*19*(plint)sizeof(double));
+    global::profiler().stop("collStream");
+
+    global::profiler().setReportFile("profilerTest");
+    global::profiler().writeReport();
+    global::threadPool().setNumThreads(1);
+
+    int reportIsCorrect = 1;
+    if (global::mpi().isMainProcessor()) {
+        std::string report = readReport(global::directories().getOutputDir()+"profilerTest.xml");
+        bool hasModel = report.find("Model_GBs")!=std::string::npos;
+        bool hasCounters = report.find("Cycles")!=std::string::npos ||
+                           report.find("Estimated_GBs_from_LLC_misses")!=std::string::npos;
+        reportIsCorrect = hasModel && !hasCounters ? 1 : 0;
+    }
+    global::mpi().bCast(&reportIsCorrect, 1);
+
+    pcout << (refused ? "passed" : "FAILED")
+          << ": the hardware counters are " << (refused ? "refused" : "accepted")
+          << " with two threads" << std::endl;
+    pcout << (reportIsCorrect ? "passed" : "FAILED")
+          << ": the roofline report " << (reportIsCorrect ? "only has" : "does not only have")
+          << " the model bandwidth" << std::endl;
+
+    return (refused && reportIsCorrect) ? EXIT_SUCCESS : EXIT_FAILURE;
+}
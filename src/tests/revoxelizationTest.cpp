@@ -0,0 +1,137 @@
+/* This file is part of the Palabos library.
+ *
+ * Copyright (C) 2011-2015 FlowKit Sarl
+ * Route d'Oron 2
+ * 1010 Lausanne, Switzerland
+ * E-mail contact: contact@flowkit.com
+ *
+ * The most recent release of Palabos can be downloaded at 
+ * <http://www.palabos.org/>
+ *
+ * The library Palabos is free software: you can redistribute it and/or
+ * modify it under the terms of the GNU Affero General Public License as
+ * published by the Free Software Foundation, either version 3 of the
+ * License, or (at your option) any later version.
+ *
+ * The library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+/** \file
+ * Regression test: VoxelizedDomain3D::adjustVoxelization(Box3D,bool) re-flags
+ * only a shell around a moving surface, and yields the same voxel flags as a
+ * full voxelization of the surface at its new position.
+ */
+
+typedef double T;
+
+#include "palabos3D.h"
+#include "palabos3D.hh"
+#include "testUtil3D.h"
+
+#include <cstdlib>
+#include <iostream>
+
+using namespace plb;
+
+/// Number of cells of the bulk of a in which a and b differ.
+plint countDifferences(MultiScalarField3D<int>& a, MultiScalarField3D<int>& b) {
+    plint differences = 0;
+    std::vector<plint> const& localBlocks = a.getLocalInfo().getBlocks();
+    for (pluint iBlock=0; iBlock<localBlocks.size(); ++iBlock) {
+        SmartBulk3D bulkA(a.getMultiBlockManagement(), localBlocks[iBlock]);
+        SmartBulk3D bulkB(b.getMultiBlockManagement(), localBlocks[iBlock]);
+        Box3D bulk = bulkA.getBulk();
+        ScalarField3D<int>& fieldA = a.getComponent(localBlocks[iBlock]);
+        ScalarField3D<int>& fieldB = b.getComponent(localBlocks[iBlock]);
+        for (plint iX=bulk.x0; iX<=bulk.x1; ++iX) {
+            for (plint iY=bulk.y0; iY<=bulk.y1; ++iY) {
+                for (plint iZ=bulk.z0; iZ<=bulk.z1; ++iZ) {
+                    if ( fieldA.get(bulkA.toLocalX(iX), bulkA.toLocalY(iY), bulkA.toLocalZ(iZ)) !=
+                         fieldB.get(bulkB.toLocalX(iX), bulkB.toLocalY(iY), bulkB.toLocalZ(iZ)) )
+                    {
+                        ++differences;
+                    }
+                }
+            }
+        }
+    }
+    return sumOverProcesses(differences);
+}
+
+Box3D boundingBox(TriangularSurfaceMesh<T> const& mesh) {
+    Array<T,3> lower(mesh.getVertex(0)), upper(mesh.getVertex(0));
+    for (plint iVertex=1; iVertex<mesh.getNumVertices(); ++iVertex) {
+        for (int iD=0; iD<3; ++iD) {
+            lower[iD] = std::min(lower[iD], mesh.getVertex(iVertex)[iD]);
+            upper[iD] = std::max(upper[iD], mesh.getVertex(iVertex)[iD]);
+        }
+    }
+    return Box3D((plint)std::floor(lower[0]), (plint)std::ceil(upper[0]),
+                 (plint)std::floor(lower[1]), (plint)std::ceil(upper[1]),
+                 (plint)std::floor(lower[2]), (plint)std::ceil(upper[2]));
+}
+
+Box3D boundingBoxUnion(Box3D const& a, Box3D const& b) {
+    return Box3D(std::min(a.x0,b.x0), std::max(a.x1,b.x1),
+                 std::min(a.y0,b.y0), std::max(a.y1,b.y1),
+                 std::min(a.z0,b.z0), std::max(a.z1,b.z1));
+}
+
+int main(int argc, char* argv[]) {
+    plbInit(&argc, &argv);
+
+    // A sphere of radius 10 moves through a box of 48^3 cells.
+    const plint n = 48;
+    const plint borderWidth = 1;
+    const plint envelopeWidth = 3;
+    const Box3D domain(0,n-1, 0,n-1, 0,n-1);
+    TriangleSet<T> sphere = constructSphere<T>(Array<T,3>(n/2.-6., n/2., n/2.), 10., 1000);
+    TriangleBoundary3D<T> boundary(sphere);
+    boundary.getMesh().inflate();
+
+    // Eight blocks, distributed cyclically over the processes.
+    MultiBlockManagement3D management = createManagement(n,n,n, envelopeWidth);
+
+    VoxelizedDomain3D<T> voxelizedDomain (
+            boundary, voxelFlag::outside, domain, borderWidth, envelopeWidth, 0 );
+    voxelizedDomain.reparallelize(management);
+    MultiScalarField3D<int>& voxelMatrix = voxelizedDomain.getVoxelMatrix();
+
+    bool success = true;
+    const Array<T,3> displacement(1.7, 0.4, -0.3);
+    for (plint iStep=0; iStep<6; ++iStep) {
+        Box3D before = boundingBox(boundary.getMesh());
+        boundary.getMesh().translate(displacement);
+        Box3D swept = boundingBoxUnion(before, boundingBox(boundary.getMesh()));
+
+        // The corner of the box around the old and the new position of the sphere is
+        //   farther from the surface than the shell, and so are its neighbors: a wrong
+        //   flag placed there is not re-flagged, and does not spread.
+        Box3D corner(swept.x0-2, swept.x0-2, swept.y0-2, swept.y0-2, swept.z0-2, swept.z0-2);
+        setToConstant(voxelMatrix, corner, voxelFlag::inside);
+
+        voxelizedDomain.adjustVoxelization(swept, false);
+
+        std::auto_ptr<MultiScalarField3D<int> > sentinel(extractSubDomain(voxelMatrix, corner));
+        bool shellOnly = computeSum(*sentinel) == voxelFlag::inside;
+        setToConstant(voxelMatrix, corner, voxelFlag::outside);
+
+        VoxelizedDomain3D<T> reference (
+                boundary, voxelFlag::outside, domain, borderWidth, envelopeWidth, 0 );
+        reference.reparallelize(management);
+        plint differences = countDifferences(voxelMatrix, reference.getVoxelMatrix());
+
+        pcout << ((shellOnly && differences==0) ? "passed" : "FAILED") << ": step " << iStep
+              << ", " << differences << " flags differ from a full voxelization, cells far from the surface "
+              << (shellOnly ? "kept" : "re-flagged") << std::endl;
+        success = success && shellOnly && differences==0;
+    }
+
+    return success ? EXIT_SUCCESS : EXIT_FAILURE;
+}
@@ -0,0 +1,135 @@
+/* This file is part of the Palabos library.
+ *
+ * Copyright (C) 2011-2015 FlowKit Sarl
+ * Route d'Oron 2
+ * 1010 Lausanne, Switzerland
+ * E-mail contact: contact@flowkit.com
+ *
+ * The most recent release of Palabos can be downloaded at 
+ * <http://www.palabos.org/>
+ *
+ * The library Palabos is free software: you can redistribute it and/or
+ * modify it under the terms of the GNU Affero General Public License as
+ * published by the Free Software Foundation, either version 3 of the
+ * License, or (at your option) any later version.
+ *
+ * The library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+/** \file
+ * Regression test: a vertex buffer which references a RigidBody3D gives, on
+ * every block, the same immersed wall data as a buffer filled explicitly with
+ * the vertices, areas and normals of the body in its present pose.
+ */
+
+typedef double T;
+
+#include "palabos3D.h"
+#include "palabos3D.hh"
+#include "testUtil3D.h"
+
+#include <cstdlib>
+#include <iostream>
+#include <memory>
+
+using namespace plb;
+
+/// Number of blocks on which the immersed wall data of the two containers differ.
+plint countDifferences(MultiContainerBlock3D& a, MultiContainerBlock3D& b) {
+    plint differences = 0;
+    std::vector<plint> const& localBlocks = a.getLocalInfo().getBlocks();
+    for (pluint iBlock=0; iBlock<localBlocks.size(); ++iBlock) {
+        ImmersedWallData3D<T> const* dataA =
+            dynamic_cast<ImmersedWallData3D<T> const*>(a.getComponent(localBlocks[iBlock]).getData());
+        ImmersedWallData3D<T> const* dataB =
+            dynamic_cast<ImmersedWallData3D<T> const*>(b.getComponent(localBlocks[iBlock]).getData());
+        bool same = dataA && dataB &&
+                    dataA->globalVertexIds==dataB->globalVertexIds &&
+                    dataA->areas==dataB->areas &&
+                    dataA->flags==dataB->flags &&
+                    dataA->vertices.size()==dataB->vertices.size() &&
+                    dataA->normals.size()==dataB->normals.size() &&
+                    dataA->g.size()==dataB->g.size();
+        for (pluint i=0; same && i<dataA->vertices.size(); ++i) {
+            same = norm(dataA->vertices[i]-dataB->vertices[i])==(T)0 &&
+                   norm(dataA->normals[i]-dataB->normals[i])==(T)0 &&
+                   norm(dataA->g[i]-dataB->g[i])==(T)0;
+        }
+        if (!same) ++differences;
+    }
+    return sumOverProcesses(differences);
+}
+
+/// Vertices, areas and normals of the body in its present pose.
+void readBody(RigidBody3D<T> const& body, std::vector< Array<T,3> >& vertices,
+              std::vector<T>& areas, std::vector< Array<T,3> >& normals)
+{
+    vertices.clear();
+    areas.clear();
+    normals.clear();
+    for (pluint i=0; i<body.getNumVertices(); ++i) {
+        vertices.push_back(body.getVertex(i));
+        areas.push_back(body.getArea(i));
+        normals.push_back(body.getNormal(i));
+    }
+}
+
+int main(int argc, char* argv[]) {
+    plbInit(&argc, &argv);
+
+    // A sphere of radius 5 crosses the blocks of a box of 32^3 cells, split into
+    //   eight blocks which are distributed cyclically over the processes.
+    const plint n = 32;
+    MultiBlockManagement3D management = createManagement(n,n,n, 3);
+    MultiScalarField3D<T> field(MultiBlockManagement3D(management), defaultMultiBlockPolicy3D().getBlockCommunicator(),
+                                defaultMultiBlockPolicy3D().getCombinedStatistics(),
+                                defaultMultiBlockPolicy3D().getMultiScalarAccess<T>(), (T)0);
+    MultiContainerBlock3D fromBody(field);
+    MultiContainerBlock3D fromVertices(field);
+
+    TriangleSet<T> sphere = constructSphere<T>(Array<T,3>((T)8.3, (T)9.6, (T)10.2), (T)5, 400);
+    TriangleBoundary3D<T> boundary(sphere);
+    RigidBody3D<T> body(boundary.getMesh());
+
+    std::vector< Array<T,3> > vertices, normals;
+    std::vector<T> areas;
+    readBody(body, vertices, areas, normals);
+    std::shared_ptr<ImmersedWallVertexBuffer3D<T> > bodyBuffer(new ImmersedWallVertexBuffer3D<T>);
+    bodyBuffer->setRigidBody(body);
+    std::shared_ptr<ImmersedWallVertexBuffer3D<T> > vertexBuffer (
+            new ImmersedWallVertexBuffer3D<T>(vertices, areas, normals) );
+
+    std::vector<MultiBlock3D*> bodyArgs, vertexArgs;
+    bodyArgs.push_back(&fromBody);
+    vertexArgs.push_back(&fromVertices);
+    integrateProcessingFunctional (
+            new UpdateImmersedWallData3D<T>(bodyBuffer), fromBody.getBoundingBox(), field, bodyArgs, 0 );
+    integrateProcessingFunctional (
+            new UpdateImmersedWallData3D<T>(vertexBuffer), fromVertices.getBoundingBox(), field, vertexArgs, 0 );
+
+    bool success = true;
+    const Array<T,3> displacement((T)1.3, (T)1.1, (T)0.9);
+    const Array<T,3> rotation((T)0.05, (T)-0.08, (T)0.11);
+    for (plint iStep=0; iStep<12; ++iStep) {
+        field.executeInternalProcessors();
+        plint differences = countDifferences(fromBody, fromVertices);
+        pcout << (differences==0 ? "passed" : "FAILED") << ": step " << iStep
+              << ", the wall data differ on " << differences << " blocks" << std::endl;
+        success = success && differences==0;
+
+        // The body moves and turns; the explicit buffer receives its new vertices.
+        body.translate(displacement);
+        body.rotate(rotation);
+        bodyBuffer->setRigidBody(body);
+        readBody(body, vertices, areas, normals);
+        vertexBuffer->setVertices(vertices, areas, normals);
+    }
+
+    return success ? EXIT_SUCCESS : EXIT_FAILURE;
+}
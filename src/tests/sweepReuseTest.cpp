@@ -0,0 +1,175 @@
+/* This file is part of the Palabos library.
+ *
+ * Copyright (C) 2011-2015 FlowKit Sarl
+ * Route d'Oron 2
+ * 1010 Lausanne, Switzerland
+ * E-mail contact: contact@flowkit.com
+ *
+ * The most recent release of Palabos can be downloaded at 
+ * <http://www.palabos.org/>
+ *
+ * The library Palabos is free software: you can redistribute it and/or
+ * modify it under the terms of the GNU Affero General Public License as
+ * published by the Free Software Foundation, either version 3 of the
+ * License, or (at your option) any later version.
+ *
+ * The library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+/** \file
+ * Regression test: a lattice which is reused for a new relaxation time, by
+ * setting the new omega, integrating its processors again and initializing it
+ * again, as the parameter sweep does between two Reynolds numbers, evolves
+ * exactly like a lattice built from scratch with this relaxation time.
+ */
+
+typedef double T;
+
+#include "palabos3D.h"
+#include "palabos3D.hh"
+#include "testUtil3D.h"
+
+#include <cmath>
+#include <cstdlib>
+#include <iostream>
+#include <memory>
+
+using namespace plb;
+
+#define DESCRIPTOR descriptors::D3Q19Descriptor
+
+/// The lattice of one case, with the fields of the immersed boundary.
+struct Case {
+    Case(MultiBlockManagement3D const& management, T omega)
+        : lattice(MultiBlockManagement3D(management), defaultMultiBlockPolicy3D().getBlockCommunicator(),
+                  defaultMultiBlockPolicy3D().getCombinedStatistics(),
+                  defaultMultiBlockPolicy3D().getMultiCellAccess<T,DESCRIPTOR>(),
+                  new IncBGKdynamics<T,DESCRIPTOR>(omega)),
+          rhoBar(MultiBlockManagement3D(management), defaultMultiBlockPolicy3D().getBlockCommunicator(),
+                 defaultMultiBlockPolicy3D().getCombinedStatistics(),
+                 defaultMultiBlockPolicy3D().getMultiScalarAccess<T>(), (T)0),
+          j(MultiBlockManagement3D(management), defaultMultiBlockPolicy3D().getBlockCommunicator(),
+            defaultMultiBlockPolicy3D().getCombinedStatistics(),
+            defaultMultiBlockPolicy3D().getMultiTensorAccess<T,3>(), Array<T,3>((T)0,(T)0,(T)0)),
+          container(rhoBar)
+    {
+        rhoBarJarg.push_back(&lattice);
+        rhoBarJarg.push_back(&rhoBar);
+        rhoBarJarg.push_back(&j);
+    }
+    /// The same processors as Variables::integrateProcessors().
+    void integrateProcessors(std::shared_ptr<ImmersedWallVertexBuffer3D<T> const> buffer, T tau, plint numIterations) {
+        typedef DynamicsList<IncBGKdynamics<T,DESCRIPTOR>, NoDynamics<T,DESCRIPTOR> > LatticeDynamics;
+        integrateProcessingFunctional (
+                new ExternalRhoJcollideAndStream3D<T,DESCRIPTOR,LatticeDynamics>(), lattice.getBoundingBox(), rhoBarJarg, 0 );
+        integrateProcessingFunctional (
+                new BoxRhoBarJfunctional3D<T,DESCRIPTOR>(), lattice.getBoundingBox(), rhoBarJarg, 3 );
+        integrateUpdateImmersedWallData<T>(buffer, lattice, container, 4);
+        for (plint i=0; i<numIterations; ++i) {
+            std::vector<MultiBlock3D*> args;
+            args.push_back(&rhoBar);
+            args.push_back(&j);
+            args.push_back(&container);
+            integrateProcessingFunctional (
+                    new CachedInamuroIteration3D<T,WallVelocity>(WallVelocity(), tau, true),
+                    rhoBar.getBoundingBox(), lattice, args, 5+i );
+        }
+    }
+    /// The same initial state as Variables::initializeLattice().
+    void initialize() {
+        initializeAtEquilibrium(lattice, lattice.getBoundingBox(), (T)1, Array<T,3>((T)0,(T)0,(T)0));
+        applyProcessingFunctional(new BoxRhoBarJfunctional3D<T,DESCRIPTOR>(), lattice.getBoundingBox(), rhoBarJarg);
+    }
+    /// The same steps as Variables::reparameterize().
+    void reparameterize(std::shared_ptr<ImmersedWallVertexBuffer3D<T> const> buffer, T tau, plint numIterations) {
+        lattice.completeStream();
+        setOmega(lattice, lattice.getBoundingBox(), (T)1/tau);
+        std::vector<MultiBlock3D::ProcessorStorage3D> processors;
+        lattice.releaseProcessors(processors);
+        std::vector<plint> const& blocks = lattice.getLocalInfo().getBlocks();
+        for (pluint i=0; i<blocks.size(); ++i) {
+            lattice.getComponent(blocks[i]).clearDataProcessors();
+        }
+        integrateProcessors(buffer, tau, numIterations);
+        initialize();
+    }
+    MultiBlockLattice3D<T,DESCRIPTOR> lattice;
+    MultiScalarField3D<T> rhoBar;
+    MultiTensorField3D<T,3> j;
+    MultiContainerBlock3D container;
+    std::vector<MultiBlock3D*> rhoBarJarg;
+};
+
+int main(int argc, char* argv[]) {
+    plbInit(&argc, &argv);
+
+    // A sphere of radius 6 moves through a box of 32^3 cells, split into eight
+    //   blocks which are distributed cyclically over the processes.
+    const plint n = 32;
+    const plint envelopeWidth = 3;
+    const plint numIterations = 2;
+    const T firstTau = (T)0.6;
+    const T tau = (T)0.8;
+    MultiBlockManagement3D management = createManagement(n,n,n, envelopeWidth);
+
+    std::vector< Array<T,3> > startVertices, vertices;
+    std::vector<T> areas;
+    constructVertices(Array<T,3>((T)12.3, (T)15.6, (T)16.2), (T)6, 800, startVertices, areas);
+    const std::vector< Array<T,3> > noNormals;
+    const Array<T,3> displacement((T)0.7, (T)0.2, (T)-0.1);
+
+    // The reused lattice first runs a case with another relaxation time, during
+    //   which the sphere moves away; the sphere then returns to its start position.
+    std::shared_ptr<ImmersedWallVertexBuffer3D<T> > reusedBuffer (
+            new ImmersedWallVertexBuffer3D<T>(startVertices, areas, noNormals) );
+    Case reused(management, (T)1/firstTau);
+    reused.integrateProcessors(reusedBuffer, firstTau, numIterations);
+    reused.initialize();
+    vertices = startVertices;
+    for (plint iStep=0; iStep<5; ++iStep) {
+        reused.lattice.executeInternalProcessors();
+        for (pluint i=0; i<vertices.size(); ++i) {
+            vertices[i] += displacement;
+        }
+        reusedBuffer->setVertices(vertices);
+    }
+    reusedBuffer->setVertices(startVertices);
+    reused.reparameterize(reusedBuffer, tau, numIterations);
+
+    std::shared_ptr<ImmersedWallVertexBuffer3D<T> > freshBuffer (
+            new ImmersedWallVertexBuffer3D<T>(startVertices, areas, noNormals) );
+    Case fresh(management, (T)1/tau);
+    fresh.integrateProcessors(freshBuffer, tau, numIterations);
+    fresh.initialize();
+
+    bool success = true;
+    vertices = startVertices;
+    for (plint iStep=0; iStep<6; ++iStep) {
+        fresh.lattice.executeInternalProcessors();
+        reused.lattice.executeInternalProcessors();
+        fresh.lattice.completeStream();
+        reused.lattice.completeStream();
+
+        T fDifference = maxPopulationDifference(fresh.lattice, reused.lattice);
+        T jDifference = computeMax(*computeNorm(*subtract(fresh.j, reused.j)));
+        bool same = fDifference==(T)0 && jDifference==(T)0;
+        pcout << (same ? "passed" : "FAILED") << ": step " << iStep
+              << ", the reused lattice differs by " << fDifference << " in f and by "
+              << jDifference << " in j" << std::endl;
+        success = success && same;
+
+        for (pluint i=0; i<vertices.size(); ++i) {
+            vertices[i] += displacement;
+        }
+        freshBuffer->setVertices(vertices);
+        reusedBuffer->setVertices(vertices);
+    }
+
+    return success ? EXIT_SUCCESS : EXIT_FAILURE;
+}
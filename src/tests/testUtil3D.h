@@ -0,0 +1,134 @@
+/* This file is part of the Palabos library.
+ *
+ * Copyright (C) 2011-2015 FlowKit Sarl
+ * Route d'Oron 2
+ * 1010 Lausanne, Switzerland
+ * E-mail contact: contact@flowkit.com
+ *
+ * The most recent release of Palabos can be downloaded at 
+ * <http://www.palabos.org/>
+ *
+ * The library Palabos is free software: you can redistribute it and/or
+ * modify it under the terms of the GNU Affero General Public License as
+ * published by the Free Software Foundation, either version 3 of the
+ * License, or (at your option) any later version.
+ *
+ * The library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+/** \file
+ * Fixtures shared by the regression tests. The library is compiled together
+ * with the tests: the including file defines the floating-point type T, then
+ * includes palabos3D.h and palabos3D.hh, and finally this file.
+ */
+
+#ifndef TEST_UTIL_3D_H
+#define TEST_UTIL_3D_H
+
+#include <algorithm>
+#include <cmath>
+#include <map>
+#include <vector>
+
+namespace plb {
+
+/// A non-uniform initial condition, so that every population differs.
+struct InitialState {
+    void operator()(plint iX, plint iY, plint iZ, T& rho, Array<T,3>& u) const {
+        rho = (T)1 + (T)1.e-3*(T)((iX*7+iY*3+iZ)%11);
+        u = Array<T,3>((T)0.02*std::sin((T)iY), (T)0.01*std::cos((T)iZ), (T)0.01*std::sin((T)iX));
+    }
+};
+
+/// Blocks of a regular decomposition, by default into eight blocks,
+///   distributed cyclically over the processes.
+inline MultiBlockManagement3D createManagement (
+        plint nx, plint ny, plint nz, plint envelopeWidth,
+        plint numBlocksX=2, plint numBlocksY=2, plint numBlocksZ=2 )
+{
+    SparseBlockStructure3D blockStructure =
+        createRegularDistribution3D(nx,ny,nz, numBlocksX,numBlocksY,numBlocksZ);
+    ExplicitThreadAttribution* attribution = new ExplicitThreadAttribution;
+    std::map<plint,Box3D> const& bulks = blockStructure.getBulks();
+    for (std::map<plint,Box3D>::const_iterator it = bulks.begin(); it != bulks.end(); ++it) {
+        attribution->addBlock(it->first, it->first % global::mpi().getSize());
+    }
+    return MultiBlockManagement3D(blockStructure, attribution, envelopeWidth);
+}
+
+/// Maximum difference between the populations of two lattices.
+template<template<typename U> class Descriptor>
+T maxPopulationDifference(MultiBlockLattice3D<T,Descriptor>& a, MultiBlockLattice3D<T,Descriptor>& b) {
+    T difference = T();
+    for (plint iPop=0; iPop<Descriptor<T>::q; ++iPop) {
+        difference = std::max(difference, computeMax(*computeAbsoluteValue(*subtract (
+                *computePopulation(a, iPop), *computePopulation(b, iPop) ))));
+    }
+    return difference;
+}
+
+/// Maximum difference between the populations of two atomic blocks.
+template<template<typename U> class Descriptor>
+T maxPopulationDifference(BlockLattice3D<T,Descriptor>& a, BlockLattice3D<T,Descriptor>& b) {
+    T difference = T();
+    for (plint iX=0; iX<a.getNx(); ++iX) {
+        for (plint iY=0; iY<a.getNy(); ++iY) {
+            for (plint iZ=0; iZ<a.getNz(); ++iZ) {
+                for (plint iPop=0; iPop<Descriptor<T>::q; ++iPop) {
+                    difference = std::max(difference, std::fabs(a.get(iX,iY,iZ)[iPop]-b.get(iX,iY,iZ)[iPop]));
+                }
+            }
+        }
+    }
+    return difference;
+}
+
+/// Vertices spread uniformly over a sphere, and their share of its area.
+inline void constructVertices(Array<T,3> const& center, T radius, plint numVertices,
+                              std::vector< Array<T,3> >& vertices, std::vector<T>& areas)
+{
+    const T pi = std::acos((T)-1);
+    const T goldenAngle = pi*((T)3-std::sqrt((T)5));
+    vertices.clear();
+    for (plint i=0; i<numVertices; ++i) {
+        T z = (T)1 - (T)2*((T)i+(T)0.5)/(T)numVertices;
+        T r = std::sqrt((T)1-z*z);
+        T phi = goldenAngle*(T)i;
+        vertices.push_back(center + radius*Array<T,3>(r*std::cos(phi), r*std::sin(phi), z));
+    }
+    areas.assign(numVertices, (T)4*pi*radius*radius/(T)numVertices);
+}
+
+/// Prescribed velocity of an immersed vertex, which depends on its global id.
+struct WallVelocity {
+    Array<T,3> operator()(pluint id) const {
+        return Array<T,3>((T)0.01*std::sin((T)id), (T)0.02*std::cos((T)id), (T)-0.01);
+    }
+};
+
+/// Sum of the values of all processes, element by element. In a serial
+///   build, the values are left unchanged.
+template<typename U>
+void sumOverProcesses(std::vector<U>& values) {
+#ifdef PLB_MPI_PARALLEL
+    global::mpi().allReduceVect(values, MPI_SUM);
+#endif
+}
+
+/// Sum of a value over all processes.
+template<typename U>
+U sumOverProcesses(U value) {
+    std::vector<U> sum(1, value);
+    sumOverProcesses(sum);
+    return sum[0];
+}
+
+}  // namespace plb
+
+#endif  // TEST_UTIL_3D_H
@@ -0,0 +1,96 @@
+/* This file is part of the Palabos library.
+ *
+ * Copyright (C) 2011-2015 FlowKit Sarl
+ * Route d'Oron 2
+ * 1010 Lausanne, Switzerland
+ * E-mail contact: contact@flowkit.com
+ *
+ * The most recent release of Palabos can be downloaded at 
+ * <http://www.palabos.org/>
+ *
+ * The library Palabos is free software: you can redistribute it and/or
+ * modify it under the terms of the GNU Affero General Public License as
+ * published by the Free Software Foundation, either version 3 of the
+ * License, or (at your option) any later version.
+ *
+ * The library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+/** \file
+ * Regression test: a multi-block lattice stepped with several threads of the
+ * thread pool, including its internal processors, gives the same result bit
+ * for bit as with a single thread.
+ */
+
+typedef double T;
+
+#include "palabos3D.h"
+#include "palabos3D.hh"
+#include "testUtil3D.h"
+
+#include <cstdlib>
+#include <iostream>
+
+using namespace plb;
+
+#define DESCRIPTOR descriptors::D3Q19Descriptor
+
+/// A periodic lattice with an obstacle, whose rhoBar and j are computed by an
+///   internal processor after every step.
+struct Simulation {
+    Simulation(MultiBlockManagement3D const& management)
+        : lattice(MultiBlockManagement3D(management), defaultMultiBlockPolicy3D().getBlockCommunicator(),
+                  defaultMultiBlockPolicy3D().getCombinedStatistics(),
+                  defaultMultiBlockPolicy3D().getMultiCellAccess<T,DESCRIPTOR>(),
+                  new BGKdynamics<T,DESCRIPTOR>((T)1.3)),
+          rhoBar(lattice),
+          j(lattice)
+    {
+        lattice.periodicity().toggleAll(true);
+        defineDynamics(lattice, Box3D(6,9, 5,8, 4,12), new BounceBack<T,DESCRIPTOR>((T)1.));
+        initializeAtEquilibrium(lattice, lattice.getBoundingBox(), InitialState());
+        lattice.initialize();
+        std::vector<MultiBlock3D*> args;
+        args.push_back(&lattice);
+        args.push_back(&rhoBar);
+        args.push_back(&j);
+        integrateProcessingFunctional(new BoxRhoBarJfunctional3D<T,DESCRIPTOR>(), lattice.getBoundingBox(), args, 0);
+    }
+    MultiBlockLattice3D<T,DESCRIPTOR> lattice;
+    MultiScalarField3D<T> rhoBar;
+    MultiTensorField3D<T,3> j;
+};
+
+int main(int argc, char* argv[]) {
+    plbInit(&argc, &argv);
+
+    const plint nx = 24, ny = 20, nz = 18;
+    MultiBlockManagement3D management = createManagement(nx,ny,nz, 1);
+    Simulation serial(management);
+    Simulation threaded(management);
+
+    bool success = true;
+    for (plint iT=0; iT<10; ++iT) {
+        global::threadPool().setNumThreads(1);
+        serial.lattice.collideAndStream();
+        global::threadPool().setNumThreads(4);
+        threaded.lattice.collideAndStream();
+    }
+    global::threadPool().setNumThreads(1);
+
+    T populationDifference = maxPopulationDifference(serial.lattice, threaded.lattice);
+    T rhoBarDifference = computeMax(*computeAbsoluteValue(*subtract(serial.rhoBar, threaded.rhoBar)));
+    T jDifference = computeMax(*computeNorm(*subtract(serial.j, threaded.j)));
+    bool same = populationDifference==(T)0 && rhoBarDifference==(T)0 && jDifference==(T)0;
+    pcout << (same ? "passed" : "FAILED") << ": with four threads, the populations differ by "
+          << populationDifference << ", rhoBar by " << rhoBarDifference << " and j by " << jDifference << std::endl;
+    success = success && same;
+
+    return success ? EXIT_SUCCESS : EXIT_FAILURE;
+}
@@ -0,0 +1,197 @@
+/* This file is part of the Palabos library.
+ *
+ * Copyright (C) 2011-2015 FlowKit Sarl
+ * Route d'Oron 2
+ * 1010 Lausanne, Switzerland
+ * E-mail contact: contact@flowkit.com
+ *
+ * The most recent release of Palabos can be downloaded at 
+ * <http://www.palabos.org/>
+ *
+ * The library Palabos is free software: you can redistribute it and/or
+ * modify it under the terms of the GNU Affero General Public License as
+ * published by the Free Software Foundation, either version 3 of the
+ * License, or (at your option) any later version.
+ *
+ * The library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+/** \file
+ * Regression test: the vectorized BGK and IncBGK kernels produce the same
+ * populations and statistics as the scalar implementation of the dynamics,
+ * both in BlockLattice3D::collideAndStream() and in the collision with
+ * external moments of ExternalRhoJcollideAndStream3D. Cells of the same
+ * type with different parameters are not collided as a homogeneous run.
+ */
+
+#include "palabos3D.h"
+#include "core/plbInit.hh"
+#include "core/cell.hh"
+#include "core/dynamics.hh"
+#include "core/blockLatticeBase3D.hh"
+#include "core/dynamicsIdentifiers.hh"
+#include "atomicBlock/blockLattice3D.hh"
+#include "atomicBlock/dataField3D.hh"
+#include "basicDynamics/isoThermalDynamics.hh"
+#include "basicDynamics/vectorizedCollision3D.hh"
+#include "basicDynamics/dynamicsProcessor3D.hh"
+#include "boundaryCondition/bounceBackModels.hh"
+#include "latticeBoltzmann/nearestNeighborLattices3D.hh"
+
+#include <cmath>
+#include <cstdlib>
+#include <iostream>
+
+using namespace plb;
+
+typedef double T;
+
+/// Same dynamics, but with a different type: the vectorized kernels do not
+///   recognize it, and it is always collided by the scalar implementation.
+template<class BaseDynamics>
+class ScalarReference : public BaseDynamics {
+public:
+    ScalarReference(T omega)
+        : BaseDynamics(omega)
+    { }
+    virtual ScalarReference<BaseDynamics>* clone() const {
+        return new ScalarReference<BaseDynamics>(*this);
+    }
+};
+
+template<template<typename U> class Descriptor>
+void initialize(BlockLattice3D<T,Descriptor>& lattice, Dynamics<T,Descriptor>* dynamics, T otherOmega) {
+    plint n = lattice.getNx();
+    for (plint iX=0; iX<n; ++iX) {
+        for (plint iY=0; iY<n; ++iY) {
+            for (plint iZ=0; iZ<n; ++iZ) {
+                Array<T,3> u((T)0.02*std::sin(0.5*iX), (T)0.02*std::cos(0.3*iY), (T)0.01*iZ/n);
+                if ((iX-n/2)*(iX-n/2)+(iY-n/2)*(iY-n/2)<9) {
+                    lattice.attributeDynamics(iX,iY,iZ, new BounceBack<T,Descriptor>((T)1));
+                }
+                // Runs of various lengths, with distinct but equal objects.
+                else if (iZ%7==3) {
+                    lattice.attributeDynamics(iX,iY,iZ, dynamics->clone());
+                }
+                // Optionally, a plane of the same type with another relaxation parameter.
+                else if (iX==2 && otherOmega!=T()) {
+                    Dynamics<T,Descriptor>* other = dynamics->clone();
+                    other->setOmega(otherOmega);
+                    lattice.attributeDynamics(iX,iY,iZ, other);
+                }
+                iniCellAtEquilibrium(lattice.get(iX,iY,iZ), (T)1+(T)0.01*std::sin(0.7*iZ), u);
+            }
+        }
+    }
+    delete dynamics;
+}
+
+template<template<typename U> class Descriptor>
+T maxDifference(BlockLattice3D<T,Descriptor>& a, BlockLattice3D<T,Descriptor>& b) {
+    T difference = T();
+    for (plint iX=0; iX<a.getNx(); ++iX) {
+        for (plint iY=0; iY<a.getNy(); ++iY) {
+            for (plint iZ=0; iZ<a.getNz(); ++iZ) {
+                for (plint iPop=0; iPop<Descriptor<T>::q; ++iPop) {
+                    difference = std::max(difference, std::fabs(a.get(iX,iY,iZ)[iPop]-b.get(iX,iY,iZ)[iPop]));
+                }
+            }
+        }
+    }
+    return difference;
+}
+
+bool check(std::string const& name, T difference, T tolerance) {
+    bool success = difference<=tolerance;
+    std::cout << (success ? "passed: " : "FAILED: ") << name
+              << " (difference " << difference << ")" << std::endl;
+    return success;
+}
+
+template<template<typename U> class Descriptor, class BaseDynamics>
+bool testCollideAndStream(std::string const& name, T omega, T otherOmega=T()) {
+    const plint n = 19;
+    BlockLattice3D<T,Descriptor> vectorized(n,n,n, new BaseDynamics(omega));
+    BlockLattice3D<T,Descriptor> scalar(n,n,n, new ScalarReference<BaseDynamics>(omega));
+    initialize(vectorized, new BaseDynamics(omega), otherOmega);
+    initialize(scalar, new ScalarReference<BaseDynamics>(omega), otherOmega);
+    for (plint iT=0; iT<10; ++iT) {
+        vectorized.collideAndStream();
+        scalar.collideAndStream();
+    }
+    BlockStatistics const& vStat = vectorized.getInternalStatistics();
+    BlockStatistics const& sStat = scalar.getInternalStatistics();
+    bool success = check(name+" populations", maxDifference(vectorized, scalar), (T)1.e-13);
+    success = check( name+" average rho",
+                     std::fabs(vStat.getAverage(0)-sStat.getAverage(0)), (T)1.e-13 ) && success;
+    success = check( name+" average uSqr",
+                     std::fabs(vStat.getAverage(1)-sStat.getAverage(1)), (T)1.e-13 ) && success;
+    success = check( name+" maximum uSqr",
+                     std::fabs(vStat.getMax(0)-sStat.getMax(0)), (T)1.e-13 ) && success;
+    return success;
+}
+
+template<template<typename U> class Descriptor>
+void computeMoments(BlockLattice3D<T,Descriptor>& lattice, ScalarField3D<T>& rhoBar, TensorField3D<T,3>& j) {
+    for (plint iX=0; iX<lattice.getNx(); ++iX) {
+        for (plint iY=0; iY<lattice.getNy(); ++iY) {
+            for (plint iZ=0; iZ<lattice.getNz(); ++iZ) {
+                momentTemplates<T,Descriptor>::get_rhoBar_j (
+                        lattice.get(iX,iY,iZ), rhoBar.get(iX,iY,iZ), j.get(iX,iY,iZ) );
+            }
+        }
+    }
+}
+
+template<template<typename U> class Descriptor, class BaseDynamics>
+bool testExternalRhoJ(std::string const& name, T omega, T otherOmega=T()) {
+    const plint n = 19;
+    BlockLattice3D<T,Descriptor> vectorized(n,n,n, new BaseDynamics(omega));
+    BlockLattice3D<T,Descriptor> scalar(n,n,n, new ScalarReference<BaseDynamics>(omega));
+    initialize(vectorized, new BaseDynamics(omega), otherOmega);
+    initialize(scalar, new ScalarReference<BaseDynamics>(omega), otherOmega);
+    ScalarField3D<T> rhoBar(n,n,n);
+    TensorField3D<T,3> j(n,n,n);
+    Box3D bulk(1,n-2, 1,n-2, 1,n-2);
+    for (plint iT=0; iT<10; ++iT) {
+        BlockLattice3D<T,Descriptor>* lattices[2] = { &vectorized, &scalar };
+        for (plint iLattice=0; iLattice<2; ++iLattice) {
+            computeMoments(*lattices[iLattice], rhoBar, j);
+            std::vector<AtomicBlock3D*> blocks;
+            blocks.push_back(lattices[iLattice]);
+            blocks.push_back(&rhoBar);
+            blocks.push_back(&j);
+            ExternalRhoJcollideAndStream3D<T,Descriptor,DynamicsList<BaseDynamics> > processor;
+            processor.processGenericBlocks(bulk, blocks);
+        }
+    }
+    return check(name+" external moments", maxDifference(vectorized, scalar), (T)1.e-13);
+}
+
+int main(int argc, char* argv[]) {
+    plbInit(&argc, &argv);
+    std::cout << "SIMD kernels " << (SimdPack<T>::vectorized ? "enabled" : "disabled") << std::endl;
+
+    bool success = true;
+    success = testCollideAndStream<descriptors::D3Q19Descriptor, BGKdynamics<T,descriptors::D3Q19Descriptor> >(
+                  "D3Q19 BGK", (T)1.7 ) && success;
+    success = testCollideAndStream<descriptors::D3Q19Descriptor, IncBGKdynamics<T,descriptors::D3Q19Descriptor> >(
+                  "D3Q19 IncBGK", (T)1.7 ) && success;
+    success = testCollideAndStream<descriptors::D3Q27Descriptor, BGKdynamics<T,descriptors::D3Q27Descriptor> >(
+                  "D3Q27 BGK", (T)1.2 ) && success;
+    success = testCollideAndStream<descriptors::D3Q19Descriptor, BGKdynamics<T,descriptors::D3Q19Descriptor> >(
+                  "D3Q19 BGK with two omegas", (T)1.7, (T)1.1 ) && success;
+    success = testExternalRhoJ<descriptors::D3Q19Descriptor, BGKdynamics<T,descriptors::D3Q19Descriptor> >(
+                  "D3Q19 BGK", (T)1.7 ) && success;
+    success = testExternalRhoJ<descriptors::D3Q19Descriptor, BGKdynamics<T,descriptors::D3Q19Descriptor> >(
+                  "D3Q19 BGK with two omegas", (T)1.7, (T)1.1 ) && success;
+    success = testExternalRhoJ<descriptors::D3Q19Descriptor, IncBGKdynamics<T,descriptors::D3Q19Descriptor> >(
+                  "D3Q19 IncBGK", (T)1.7 ) && success;
+    return success ? EXIT_SUCCESS : EXIT_FAILURE;
+}
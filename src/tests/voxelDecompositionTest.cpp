@@ -0,0 +1,161 @@
+/* This file is part of the Palabos library.
+ *
+ * Copyright (C) 2011-2015 FlowKit Sarl
+ * Route d'Oron 2
+ * 1010 Lausanne, Switzerland
+ * E-mail contact: contact@flowkit.com
+ *
+ * The most recent release of Palabos can be downloaded at 
+ * <http://www.palabos.org/>
+ *
+ * The library Palabos is free software: you can redistribute it and/or
+ * modify it under the terms of the GNU Affero General Public License as
+ * published by the Free Software Foundation, either version 3 of the
+ * License, or (at your option) any later version.
+ *
+ * The library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+/** \file
+ * Regression test: computeVoxelManagement covers every fluid cell of the wall,
+ * and realigning the voxelized domains onto it keeps their voxel flags.
+ */
+
+typedef double T;
+
+#include "palabos3D.h"
+#include "palabos3D.hh"
+#include "testUtil3D.h"
+
+#include <cstdlib>
+#include <iostream>
+#include <map>
+
+using namespace plb;
+
+/// Number of cells of the bulk of a in which a and b differ.
+plint countDifferences(MultiScalarField3D<int>& a, MultiScalarField3D<int>& b) {
+    plint differences = 0;
+    std::vector<plint> const& localBlocks = a.getLocalInfo().getBlocks();
+    for (pluint iBlock=0; iBlock<localBlocks.size(); ++iBlock) {
+        SmartBulk3D bulkA(a.getMultiBlockManagement(), localBlocks[iBlock]);
+        SmartBulk3D bulkB(b.getMultiBlockManagement(), localBlocks[iBlock]);
+        Box3D bulk = bulkA.getBulk();
+        ScalarField3D<int>& fieldA = a.getComponent(localBlocks[iBlock]);
+        ScalarField3D<int>& fieldB = b.getComponent(localBlocks[iBlock]);
+        for (plint iX=bulk.x0; iX<=bulk.x1; ++iX) {
+            for (plint iY=bulk.y0; iY<=bulk.y1; ++iY) {
+                for (plint iZ=bulk.z0; iZ<=bulk.z1; ++iZ) {
+                    if ( fieldA.get(bulkA.toLocalX(iX), bulkA.toLocalY(iY), bulkA.toLocalZ(iZ)) !=
+                         fieldB.get(bulkB.toLocalX(iX), bulkB.toLocalY(iY), bulkB.toLocalZ(iZ)) )
+                    {
+                        ++differences;
+                    }
+                }
+            }
+        }
+    }
+    return sumOverProcesses(differences);
+}
+
+/// Number of cells which are not solid for the voxel-matrix, but are not
+///   covered by any block of the management.
+plint countUncovered(MultiScalarField3D<int>& voxelMatrix, int solidFlag,
+                     MultiBlockManagement3D const& management)
+{
+    Box3D boundingBox = voxelMatrix.getBoundingBox();
+    ScalarField3D<int> covered(boundingBox.getNx(), boundingBox.getNy(), boundingBox.getNz(), 0);
+    std::map<plint,Box3D> const& bulks = management.getSparseBlockStructure().getBulks();
+    for (std::map<plint,Box3D>::const_iterator it = bulks.begin(); it != bulks.end(); ++it) {
+        Box3D bulk;
+        if (intersect(it->second, boundingBox, bulk)) {
+            setToConstant(covered, bulk.shift(-boundingBox.x0, -boundingBox.y0, -boundingBox.z0), 1);
+        }
+    }
+    plint uncovered = 0;
+    std::vector<plint> const& localBlocks = voxelMatrix.getLocalInfo().getBlocks();
+    for (pluint iBlock=0; iBlock<localBlocks.size(); ++iBlock) {
+        SmartBulk3D smartBulk(voxelMatrix.getMultiBlockManagement(), localBlocks[iBlock]);
+        Box3D bulk = smartBulk.getBulk();
+        ScalarField3D<int>& field = voxelMatrix.getComponent(localBlocks[iBlock]);
+        for (plint iX=bulk.x0; iX<=bulk.x1; ++iX) {
+            for (plint iY=bulk.y0; iY<=bulk.y1; ++iY) {
+                for (plint iZ=bulk.z0; iZ<=bulk.z1; ++iZ) {
+                    int flag = field.get(smartBulk.toLocalX(iX), smartBulk.toLocalY(iY), smartBulk.toLocalZ(iZ));
+                    if ( flag != solidFlag &&
+                         !covered.get(iX-boundingBox.x0, iY-boundingBox.y0, iZ-boundingBox.z0) )
+                    {
+                        ++uncovered;
+                    }
+                }
+            }
+        }
+    }
+    return sumOverProcesses(uncovered);
+}
+
+/// Number of cells on which the voxel-matrix of the domain, once realigned
+///   onto management and copied back onto its original blocks, differs from
+///   the original voxel-matrix.
+plint countRealignmentDifferences(VoxelizedDomain3D<T>& voxelizedDomain,
+                                  MultiBlockManagement3D const& management)
+{
+    MultiScalarField3D<int> original(voxelizedDomain.getVoxelMatrix());
+    MultiScalarField3D<int> copiedBack(voxelizedDomain.getVoxelMatrix());
+    voxelizedDomain.reparallelize(management);
+    MultiScalarField3D<int>& realigned = voxelizedDomain.getVoxelMatrix();
+    copyNonLocal(realigned, copiedBack, realigned.getBoundingBox());
+    return countDifferences(original, copiedBack);
+}
+
+bool report(std::string const& name, plint differences) {
+    pcout << (differences==0 ? "passed" : "FAILED") << ": " << name
+          << ", " << differences << " cells" << std::endl;
+    return differences==0;
+}
+
+int main(int argc, char* argv[]) {
+    plbInit(&argc, &argv);
+
+    // The flow is inside a spherical wall, and around a spherical obstacle.
+    const plint n = 48;
+    const plint borderWidth = 1;
+    const plint envelopeWidth = 3;
+    TriangleSet<T> wallSet = constructSphere<T>(Array<T,3>(n/2., n/2., n/2.), n/2.-4., 1000);
+    TriangleSet<T> obstacleSet = constructSphere<T>(Array<T,3>(n/2.-6., n/2., n/2.), 6., 400);
+    TriangleBoundary3D<T> wallBoundary(wallSet);
+    TriangleBoundary3D<T> obstacleBoundary(obstacleSet);
+    wallBoundary.getMesh().inflate();
+    obstacleBoundary.getMesh().inflate();
+    VoxelizedDomain3D<T> wall (
+            wallBoundary, voxelFlag::inside, Box3D(0,n-1, 0,n-1, 0,n-1), borderWidth, envelopeWidth, 8 );
+    VoxelizedDomain3D<T> obstacle (
+            obstacleBoundary, voxelFlag::outside, Box3D(8,n-9, 8,n-9, 8,n-9), borderWidth, envelopeWidth, 0 );
+
+    MultiBlockManagement3D management = computeVoxelManagement (
+            wall.getVoxelMatrix(), voxelFlag::inside,
+            obstacle.getVoxelMatrix(), voxelFlag::outside, 8, envelopeWidth );
+
+    bool success = true;
+    success = report("fluid cells outside of the blocks",
+                     countUncovered(wall.getVoxelMatrix(), voxelFlag::outside, management)) && success;
+    success = report("wall flags changed by the realignment",
+                     countRealignmentDifferences(wall, management)) && success;
+    success = report("obstacle flags changed by the realignment",
+                     countRealignmentDifferences(obstacle, management)) && success;
+
+    // Entirely solid cubes are dropped.
+    plint numCells = management.getSparseBlockStructure().getNumBulkCells();
+    bool dropped = numCells < n*n*n;
+    pcout << (dropped ? "passed" : "FAILED") << ": the blocks hold "
+          << numCells << " of " << n*n*n << " cells" << std::endl;
+    success = success && dropped;
+
+    return success ? EXIT_SUCCESS : EXIT_FAILURE;
+}
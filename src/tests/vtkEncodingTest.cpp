@@ -0,0 +1,203 @@
+/* This file is part of the Palabos library.
+ *
+ * Copyright (C) 2011-2015 FlowKit Sarl
+ * Route d'Oron 2
+ * 1010 Lausanne, Switzerland
+ * E-mail contact: contact@flowkit.com
+ *
+ * The most recent release of Palabos can be downloaded at 
+ * <http://www.palabos.org/>
+ *
+ * The library Palabos is free software: you can redistribute it and/or
+ * modify it under the terms of the GNU Affero General Public License as
+ * published by the Free Software Foundation, either version 3 of the
+ * License, or (at your option) any later version.
+ *
+ * The library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+/** \file
+ * Regression test: the raw and zlib appended encodings of the vtk writers hold
+ * the same bytes as the inline base64 encoding, namely the data gathered by the
+ * serializer of the field, with one length header per frame of a time series.
+ */
+
+typedef double T;
+
+#include "palabos3D.h"
+#include "palabos3D.hh"
+
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <iterator>
+#include <memory>
+#include <sstream>
+#include <string>
+#ifdef PLB_USE_ZLIB
+#include <zlib.h>
+#endif
+
+using namespace plb;
+
+/// A field which changes from one frame to the next.
+struct FrameDensity {
+    FrameDensity(plint frame_) : frame(frame_) { }
+    T operator()(plint iX, plint iY, plint iZ) const {
+        return (T)1 + (T)0.001*(T)(iX*iY - 3*iZ + frame);
+    }
+    plint frame;
+};
+
+struct FrameVelocity {
+    FrameVelocity(plint frame_) : frame(frame_) { }
+    void operator()(plint iX, plint iY, plint iZ, Array<T,3>& u) const {
+        u = Array<T,3>((T)0.01*(T)iX, (T)-0.02*(T)(iY+frame), (T)0.003*(T)(iX*iZ));
+    }
+    plint frame;
+};
+
+std::string readFile(std::string const& fileName) {
+    std::ifstream file(fileName.c_str(), std::ios::binary);
+    return std::string(std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>());
+}
+
+/// Read an integer header of the appended section.
+pluint readHeader(std::string const& file, pluint& pos) {
+    unsigned long long value = 0;
+    std::memcpy(&value, file.data()+pos, sizeof(value));
+    pos += sizeof(value);
+    return (pluint)value;
+}
+
+/// Decode the frames of the data array called name, in any of the encodings.
+bool decodeFrames(std::string const& file, std::string const& name, plint numFrames,
+                  std::vector<std::string>& frames)
+{
+    frames.clear();
+    std::string::size_type tag = file.find("Name=\""+name+"\"");
+    if (tag == std::string::npos) return false;
+    std::string::size_type tagEnd = file.find('>', tag);
+    std::string::size_type offsetPos = file.find("offset=\"", tag);
+    if (offsetPos == std::string::npos || offsetPos > tagEnd) {
+        // Inline base64: a separately encoded UInt32 length, then the data, per frame.
+        std::istringstream istr(file.substr(tagEnd+1));
+        for (plint iFrame=0; iFrame<numFrames; ++iFrame) {
+            unsigned int size = 0;
+            Base64Decoder<unsigned int> sizeDecoder(istr, 1);
+            sizeDecoder.decode(&size, 1);
+            std::string data(size, '\0');
+            Base64Decoder<char> dataDecoder(istr, size);
+            if (size > 0) dataDecoder.decode(&data[0], size);
+            frames.push_back(data);
+        }
+        return true;
+    }
+    pluint offset = (pluint)std::atol(file.c_str()+offsetPos+8);
+    std::string::size_type section = file.find("<AppendedData encoding=\"raw\">");
+    if (section == std::string::npos) return false;
+    pluint pos = file.find('_', section) + 1 + offset;
+    bool compressed = file.find("compressor=\"vtkZLibDataCompressor\"") != std::string::npos;
+    for (plint iFrame=0; iFrame<numFrames; ++iFrame) {
+        if (!compressed) {
+            pluint size = readHeader(file, pos);
+            frames.push_back(file.substr(pos, size));
+            pos += size;
+            continue;
+        }
+#ifdef PLB_USE_ZLIB
+        // Number of blocks, block size, size of the last block, compressed sizes.
+        pluint numBlocks = readHeader(file, pos);
+        pluint blockSize = readHeader(file, pos);
+        pluint lastBlockSize = readHeader(file, pos);
+        std::vector<pluint> compressedSizes(numBlocks);
+        for (pluint iBlock=0; iBlock<numBlocks; ++iBlock) {
+            compressedSizes[iBlock] = readHeader(file, pos);
+        }
+        std::string data;
+        for (pluint iBlock=0; iBlock<numBlocks; ++iBlock) {
+            uLongf size = (iBlock+1==numBlocks && lastBlockSize>0) ? lastBlockSize : blockSize;
+            std::string block(size, '\0');
+            if ( uncompress((Bytef*)&block[0], &size, (Bytef const*)file.data()+pos,
+                            (uLong)compressedSizes[iBlock]) != Z_OK )
+            {
+                return false;
+            }
+            data += block.substr(0, size);
+            pos += compressedSizes[iBlock];
+        }
+        frames.push_back(data);
+#else
+        return false;
+#endif
+    }
+    return true;
+}
+
+int main(int argc, char* argv[]) {
+    plbInit(&argc, &argv);
+    global::directories().setOutputDir("./");
+
+    const plint nx = 13, ny = 11, nz = 9;
+    const plint numFrames = 3;
+    MultiScalarField3D<T> density(nx, ny, nz);
+    MultiTensorField3D<T,3> velocity(nx, ny, nz);
+
+    // The bytes which each frame must hold.
+    std::vector<std::string> expectedDensity, expectedVelocity;
+    for (plint iFrame=0; iFrame<numFrames; ++iFrame) {
+        setToFunction(density, density.getBoundingBox(), FrameDensity(iFrame));
+        setToFunction(velocity, velocity.getBoundingBox(), FrameVelocity(iFrame));
+        std::vector<char> buffer;
+        std::unique_ptr<MultiScalarField3D<float> > densityField(copyConvert<T,float>(density).release());
+        serializerToBuffer(densityField->getBlockSerializer(densityField->getBoundingBox(), IndexOrdering::backward), buffer);
+        expectedDensity.push_back(std::string(buffer.begin(), buffer.end()));
+        std::unique_ptr<MultiTensorField3D<float,3> > velocityField(copyConvert<T,float,3>(velocity).release());
+        serializerToBuffer(velocityField->getBlockSerializer(velocityField->getBoundingBox(), IndexOrdering::backward), buffer);
+        expectedVelocity.push_back(std::string(buffer.begin(), buffer.end()));
+    }
+
+    bool success = true;
+    const vtkEncoding::EncodingT encodings[] = { vtkEncoding::base64, vtkEncoding::raw, vtkEncoding::zlib };
+    const std::string names[] = { "base64", "raw", "zlib" };
+    for (plint iEncoding=0; iEncoding<3; ++iEncoding) {
+        global::IOpolicy().setVtkEncoding(encodings[iEncoding]);
+        std::string suffix = "_" + names[iEncoding];
+        {
+            VtkStructuredImageOutput3D<T> densityOut("encodingDensity"+suffix, (T)0.5);
+            VtkStructuredImageOutput3D<T> velocityOut("encodingVelocity"+suffix, (T)0.5);
+            for (plint iFrame=0; iFrame<numFrames; ++iFrame) {
+                setToFunction(density, density.getBoundingBox(), FrameDensity(iFrame));
+                setToFunction(velocity, velocity.getBoundingBox(), FrameVelocity(iFrame));
+                bool first = iFrame==0;
+                bool last = iFrame==numFrames-1;
+                densityOut.writeData<float>(density, "density", (float)1, (float)0, first, last);
+                velocityOut.writeData<float>(velocity, "velocity", (float)1, first, last);
+            }
+        }
+
+        bool same = true;
+        if (global::mpi().isMainProcessor()) {
+            std::string dir = global::directories().getVtkOutDir();
+            std::vector<std::string> densityFrames, velocityFrames;
+            same = decodeFrames(readFile(dir+"encodingDensity"+suffix+".vts"), "density", numFrames, densityFrames) &&
+                   decodeFrames(readFile(dir+"encodingVelocity"+suffix+".vts"), "velocity", numFrames, velocityFrames) &&
+                   densityFrames == expectedDensity && velocityFrames == expectedVelocity;
+        }
+        global::mpi().bCast(&same, 1);
+        pcout << (same ? "passed" : "FAILED") << ": " << names[iEncoding]
+              << " encoding, the decoded frames are "
+              << (same ? "the serialized data" : "different") << std::endl;
+        success = success && same;
+    }
+    global::IOpolicy().setVtkEncoding(vtkEncoding::base64);
+
+    return success ? EXIT_SUCCESS : EXIT_FAILURE;
+}
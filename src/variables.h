@@ -22,7 +22,7 @@ public:
 
 	bool checkConvergence();
 
-	T getRho(const T& temp);
+	static T getRho(const T& temp);
 
 	std::unique_ptr<DEFscaledMesh<T> > createMesh(ConnectedTriangleSet<T>& triangleSet, const plint& referenceDirection,
 		const int& flowType);
@@ -39,7 +39,11 @@ public:
 	std::unique_ptr<GuoOffLatticeModel3D<T,Descriptor> > createModel(TriangleFlowShape3D<T,SurfaceData>* flowShape,
 		const int& flowType);
 
-	void createLattice(const VoxelizedDomain3D<T>& wallVoxels, const VoxelizedDomain3D<T>& obstacleVoxels);
+	void createLattice(VoxelizedDomain3D<T>& wallVoxels, VoxelizedDomain3D<T>& obstacleVoxels);
+
+	void setParameters();
+
+	void integrateProcessors();
 
 	std::unique_ptr<OffLatticeBoundaryCondition3D<T,Descriptor,BoundaryType> > createBC(
 		GuoOffLatticeModel3D<T,Descriptor>* model,
@@ -49,12 +53,32 @@ public:
 
 	void initializeLattice();
 
-	void makeParallel();
+	void balanceLoad(const bool& initial);
 
 	void setLattice();
 
+	// Reuse the lattice of the current grid level for another Reynolds number.
+	void reparameterize(const plint& _reynolds);
+
+	// Write a checkpoint of the lattice, the auxiliary fields and the obstacle.
 	void save();
 
+	// Restore the checkpoint Constants::restartFile if it was written for the current Reynolds number
+	// and grid level; returns true if the simulation was restored.
+	bool load();
+
+	// Reynolds number and grid level at which the simulation restarts (unchanged without restart file).
+	static void getRestartLevel(plint& _reynolds, plint& _gridLevel);
+
+	// Write the state of the current grid level at Constants::warmStartTime for the next finer one.
+	void saveWarmStart();
+
+	// Initialize the lattice and the obstacle from the solution of the next coarser grid level;
+	// returns true if that solution was found.
+	bool warmStart();
+
+	static std::string getWarmStartFile(const plint& _reynolds, const plint& _gridLevel);
+
 	void updateLattice();
 
 	MultiContainerBlock3D* getContainer(){ return container;}
@@ -62,7 +86,7 @@ public:
 // Attributes
 	static MultiContainerBlock3D* container;
 	static T time, dx, dt, resolution, gridLevel, reynolds, scaled_u0lb;
-	static plint iter;
+	static plint iter, restartIter;
 	static Array<T,3> location;
 	static plint nx, ny, nz;
 	static Box3D boundingBox;
@@ -75,9 +99,11 @@ public:
 	static std::unique_ptr<MultiScalarField3D<T> > rhoBar;
 	static std::unique_ptr<MultiTensorField3D<T,3> > j;
 	static std::unique_ptr<IncBGKdynamics<T,Descriptor> > dynamics;
+	static std::unique_ptr<LoadBalancer3D> balancer;
 	static std::unique_ptr<Variables<T,BoundaryType,SurfaceData,Descriptor> > v;
+	static parallelIO::CheckpointRecord obstacleStart;
 private:
-	static int nprocs, nprocs_side;
+	static int nprocs;
 	static bool master;
 };
 
@@ -108,6 +134,9 @@ T Variables<T,BoundaryType,SurfaceData,Descriptor>::scaled_u0lb= 0;
 template<typename T, class BoundaryType, class SurfaceData, template<class U> class Descriptor>
 plint Variables<T,BoundaryType,SurfaceData,Descriptor>::iter= 0;
 
+template<typename T, class BoundaryType, class SurfaceData, template<class U> class Descriptor>
+plint Variables<T,BoundaryType,SurfaceData,Descriptor>::restartIter= 0;
+
 template<typename T, class BoundaryType, class SurfaceData, template<class U> class Descriptor>
 plint Variables<T,BoundaryType,SurfaceData,Descriptor>::nx= 0;
 
@@ -129,9 +158,6 @@ double Variables<T,BoundaryType,SurfaceData,Descriptor>::scalingFactor= 0;
 template<typename T, class BoundaryType, class SurfaceData, template<class U> class Descriptor>
 int Variables<T,BoundaryType,SurfaceData,Descriptor>::nprocs= 0;
 
-template<typename T, class BoundaryType, class SurfaceData, template<class U> class Descriptor>
-int Variables<T,BoundaryType,SurfaceData,Descriptor>::nprocs_side= 0;
-
 template<typename T, class BoundaryType, class SurfaceData, template<class U> class Descriptor>
 std::vector<MultiBlock3D*> Variables<T,BoundaryType,SurfaceData,Descriptor>::rhoBarJarg;
 
@@ -162,9 +188,15 @@ std::unique_ptr<MultiTensorField3D<T,3> > Variables<T,BoundaryType,SurfaceData,D
 template<typename T, class BoundaryType, class SurfaceData, template<class U> class Descriptor>
 std::unique_ptr<IncBGKdynamics<T,Descriptor> > Variables<T,BoundaryType,SurfaceData,Descriptor>::dynamics(nullptr);
 
+template<typename T, class BoundaryType, class SurfaceData, template<class U> class Descriptor>
+std::unique_ptr<LoadBalancer3D> Variables<T,BoundaryType,SurfaceData,Descriptor>::balancer(nullptr);
+
 template<typename T, class BoundaryType, class SurfaceData, template<class U> class Descriptor>
 MultiContainerBlock3D* Variables<T,BoundaryType,SurfaceData,Descriptor>::container = nullptr;
 
+template<typename T, class BoundaryType, class SurfaceData, template<class U> class Descriptor>
+parallelIO::CheckpointRecord Variables<T,BoundaryType,SurfaceData,Descriptor>::obstacleStart;
+
 template<typename T, class BoundaryType, class SurfaceData, template<class U> class Descriptor>
 std::unique_ptr<Variables<T,BoundaryType,SurfaceData,Descriptor> >	Variables<T,BoundaryType,SurfaceData,Descriptor>::v(nullptr);
 
@@ -55,10 +55,8 @@ namespace plb{
 			dt = 1;
 			iter = 0;
 			nprocs = 0;
-			nprocs_side = 0;
 			master = global::mpi().isMainProcessor();
 			nprocs = global::mpi().getSize();
-			nprocs_side = (int)cbrt(nprocs);
 		}
 		catch(const std::exception& e){exHandler(e,__FILE__,__FUNCTION__,__LINE__);}
 	}
@@ -77,6 +75,7 @@ namespace plb{
 			resolution = Constants<T>::physical.resolution * util::twoToThePowerPlint(_gridLevel);
 			scaled_u0lb = Constants<T>::lb.u * util::twoToThePowerPlint(_gridLevel);
 			reynolds = _reynolds;
+			restartIter = 0;
 			p = IncomprFlowParam<T>(Constants<T>::physical.u,scaled_u0lb,reynolds,Constants<T>::physical.length,
 				Constants<T>::physical.resolution,Constants<T>::lb.lx,Constants<T>::lb.ly,Constants<T>::lb.lz);
 			dynamics.reset(new IncBGKdynamics<T,Descriptor>(p.getOmega()));
@@ -413,9 +412,11 @@ namespace plb{
 				global::timer("boundary").restart();
 			#endif
 
+			// The model takes ownership of its flow shape, the boundary condition of its model:
+			// both get a copy, so that the shape and the model can be rebuilt independently.
 			model.reset(
 				new GuoOffLatticeModel3D<T,Descriptor>(
-					flowShape,
+					flowShape->clone(),
 					flowType)
 			);
 
@@ -438,8 +439,8 @@ namespace plb{
 	}
 
 	template<typename T, class BoundaryType, class SurfaceData, template<class U> class Descriptor>
-	void Variables<T,BoundaryType,SurfaceData,Descriptor>::createLattice(const VoxelizedDomain3D<T>& wallVoxels,
-		const VoxelizedDomain3D<T>& obstacleVoxels)
+	void Variables<T,BoundaryType,SurfaceData,Descriptor>::createLattice(VoxelizedDomain3D<T>& wallVoxels,
+		VoxelizedDomain3D<T>& obstacleVoxels)
 	{
 		try{
 			#ifdef PLB_DEBUG
@@ -448,6 +449,19 @@ namespace plb{
 				global::log(mesg);
 				global::timer("join").start();
 			#endif
+				PLB_TRACE_SCOPE("Variables::join");
+
+			// Only the blocks which contain fluid are allocated, and they are distributed by their number of active cells.
+			MultiBlockManagement3D management = computeVoxelManagement(
+				wallVoxels.getVoxelMatrix(), Wall<T,BoundaryType,SurfaceData,Descriptor>::flowType,
+				obstacleVoxels.getVoxelMatrix(), Obstacle<T,BoundaryType,SurfaceData,Descriptor>::flowType,
+				Constants<T>::blockSize, Constants<T>::envelopeWidth);
+
+			lattice.reset(generateMultiBlockLattice<T,Descriptor>(management, dynamics->clone()).release());
+
+			// The boundary conditions couple the lattice with the voxel matrices, which must have the same blocks.
+			wallVoxels.reparallelize(lattice->getMultiBlockManagement());
+			obstacleVoxels.reparallelize(lattice->getMultiBlockManagement());
 
 			MultiScalarField3D<int> wallMatrix = wallVoxels.getVoxelMatrix();
 			MultiScalarField3D<int> obstacleMatrix = obstacleVoxels.getVoxelMatrix();
@@ -457,14 +471,7 @@ namespace plb{
 
 			wallMatrix.copyReceive(obstacleMatrix,fromDomain,toDomain,modif::allVariables);
 
-			lattice.reset(generateMultiBlockLattice<T,Descriptor>(wallMatrix, Constants<T>::envelopeWidth, dynamics->clone()).release());
-
-			T resolution = Constants<T>::physical.resolution * util::twoToThePowerPlint(gridLevel);
-			T scaled_u0lb = Constants<T>::lb.u / util::twoToThePowerPlint(gridLevel);
-			p = IncomprFlowParam<T>(Constants<T>::physical.u, scaled_u0lb, reynolds, Constants<T>::physical.length,
-									resolution, lattice->getNx(), lattice->getNy(), lattice->getNz());
-			std::string fileName = "parameters_Re="+std::to_string((int)reynolds)+"_GridLvL="+std::to_string((int)gridLevel);
-			writeLogFile(p, fileName);
+			setParameters();
 
 			defineDynamics(*lattice, lattice->getBoundingBox(), dynamics->clone());
 			lattice->toggleInternalStatistics(false);
@@ -482,9 +489,6 @@ namespace plb{
 			rhoBarJarg.push_back(dynamic_cast<MultiBlock3D*>(rhoBar.get()));
 			rhoBarJarg.push_back(dynamic_cast<MultiBlock3D*>(j.get()));
 
-			integrateProcessingFunctional(new ExternalRhoJcollideAndStream3D<T,Descriptor>(),lattice->getBoundingBox(), rhoBarJarg, 0);
-			integrateProcessingFunctional(new BoxRhoBarJfunctional3D<T,Descriptor>(), lattice->getBoundingBox(), rhoBarJarg, 3);
-
 			lattice->periodicity().toggleAll(false);
 			rhoBar->periodicity().toggleAll(false);
 			j->periodicity().toggleAll(false);
@@ -497,72 +501,19 @@ namespace plb{
 
 			Box3D domain = lattice->getBoundingBox();
 
-			TriangularSurfaceMesh<T> mesh = Obstacle<T,BoundaryType,SurfaceData,Descriptor>::tb->getMesh();
-			//ConnectedTriangleSet<T> triangles = ConnectedTriangleSet<T>(mesh.toTriangleSet(Constants<T>::precision));
-
-			T numVertices = Obstacle<T,BoundaryType,SurfaceData,Descriptor>::tb->getMesh().getNumVertices();
-			//T numVertices = triangles.getNumVertices();
-			Obstacle<T,BoundaryType,SurfaceData,Descriptor>::numVertices = numVertices;
-
-			Obstacle<T,BoundaryType,SurfaceData,Descriptor>::vertices.clear();
-			Obstacle<T,BoundaryType,SurfaceData,Descriptor>::vertices.resize(numVertices);
-			Obstacle<T,BoundaryType,SurfaceData,Descriptor>::vertices.reserve(numVertices);
-
-			Obstacle<T,BoundaryType,SurfaceData,Descriptor>::unitNormals.clear();
-			Obstacle<T,BoundaryType,SurfaceData,Descriptor>::unitNormals.resize(numVertices);
-			Obstacle<T,BoundaryType,SurfaceData,Descriptor>::unitNormals.reserve(numVertices);
-
-			Obstacle<T,BoundaryType,SurfaceData,Descriptor>::areas.clear();
-			Obstacle<T,BoundaryType,SurfaceData,Descriptor>::areas.resize(numVertices);
-			Obstacle<T,BoundaryType,SurfaceData,Descriptor>::areas.reserve(numVertices);
-
-			const bool weightedArea = false;
-
-			for(int i = 0; i < numVertices; i++){
-				Obstacle<T,BoundaryType,SurfaceData,Descriptor>::vertices[i] = mesh.getVertex(i);
-				Obstacle<T,BoundaryType,SurfaceData,Descriptor>::areas[i] = mesh.computeVertexArea(i);
-				Obstacle<T,BoundaryType,SurfaceData,Descriptor>::unitNormals[i] = mesh.computeVertexNormal(i,weightedArea);
-				/*
-				Array<T,3> v = Array<T,3>(0,0,0);
-				v = triangles.getVertex(i);
-				Array<T,3> n = Array<T,3>(0,0,0);
-				T a = 0;
-				triangles.computeVertexAreaAndUnitNormal(i, a, n);
-				vertices[i] = v;
-				areas[i] = a;
-				unitNormals[i] = n;
-				*/
-			}
-
-			// Integrate the immersed boundary processors in the lattice multi-block.
-			std::vector<MultiBlock3D*> args;
-			plint pl = 4;
-
-			args.resize(0);
-			args.push_back(container);
-			integrateProcessingFunctional(new InstantiateImmersedWallData3D<T>(Obstacle<T,BoundaryType,SurfaceData,Descriptor>::vertices,
-											Obstacle<T,BoundaryType,SurfaceData,Descriptor>::areas,
-											Obstacle<T,BoundaryType,SurfaceData,Descriptor>::unitNormals),
-											container->getBoundingBox(), *lattice, args, pl);
-			//lattice->executeInternalProcessors(pl);
-			//instantiateImmersedWallData(vertices, areas, *container);
+			// The obstacle moves as a rigid body: its vertices, areas and normals are computed once in the
+			// body frame, and the immersed wall data are integrated only once, the obstacle then updates
+			// the pose of the body in the vertex buffer every time it moves.
+			Obstacle<T,BoundaryType,SurfaceData,Descriptor>::createBody();
+			Obstacle<T,BoundaryType,SurfaceData,Descriptor>::wallBuffer = std::make_shared<ImmersedWallVertexBuffer3D<T> >();
+			Obstacle<T,BoundaryType,SurfaceData,Descriptor>::wallBuffer->setRigidBody(*Obstacle<T,BoundaryType,SurfaceData,Descriptor>::body);
 
-			pl++;
 			// Update the Velocity Function once
 			Obstacle<T,BoundaryType,SurfaceData,Descriptor>::velocityFunc.update(p,(T)0,Array<T,3>(0,0,0),Array<T,3>(0,0,0),
 					Obstacle<T,BoundaryType,SurfaceData,Descriptor>::tb.get(), lattice->getBoundingBox());
 
-			for (plint i = 0; i < Constants<T>::ibIter; i++) {
-				args.resize(0);
-				args.push_back(rhoBar.get());
-				args.push_back(j.get());
-				args.push_back(container);
-				integrateProcessingFunctional(
-					new IndexedInamuroIteration3D<T,SurfaceVelocity<T> >(
-						Obstacle<T,BoundaryType,SurfaceData,Descriptor>::velocityFunc, p.getTau(), true),
-						rhoBar->getBoundingBox(), *lattice, args, pl);
-				pl++;
-			}
+			integrateProcessors();
+
 			Box3D newDomain = lattice->getBoundingBox();
 
 			if(newDomain.x0 > fromDomain.x0 || newDomain.x1 < fromDomain.x1
@@ -585,6 +536,11 @@ namespace plb{
 				mesg = "[DEBUG] Domain= "+ box_string(domain)+" Nx= "+std::to_string(lx)+" Ny= "+std::to_string(ly)+" Nz= "+std::to_string(lz);
 				if(master){std::cout << mesg << std::endl;}
 				global::log(mesg);
+				std::vector<plint> numBlocks = countBlockActivity(*lattice);
+				mesg = "[DEBUG] Blocks inactive= "+std::to_string(numBlocks[activity::inactive])+" uniform= "
+					+std::to_string(numBlocks[activity::uniform])+" mixed= "+std::to_string(numBlocks[activity::mixed]);
+				if(master){std::cout << mesg << std::endl;}
+				global::log(mesg);
 				mesg = "[DEBUG] Done Joining Lattices time="+std::to_string(global::timer("join").getTime());
 				if(master){std::cout << mesg << std::endl;}
 				global::log(mesg);
@@ -594,6 +550,63 @@ namespace plb{
 		catch(const std::exception& e){exHandler(e,__FILE__,__FUNCTION__,__LINE__);}
 	}
 
+	template<typename T, class BoundaryType, class SurfaceData, template<class U> class Descriptor>
+	void Variables<T,BoundaryType,SurfaceData,Descriptor>::setParameters()
+	{
+		try{
+			T resolution = Constants<T>::physical.resolution * util::twoToThePowerPlint(gridLevel);
+			T scaled_u0lb = Constants<T>::lb.u / util::twoToThePowerPlint(gridLevel);
+			p = IncomprFlowParam<T>(Constants<T>::physical.u, scaled_u0lb, reynolds, Constants<T>::physical.length,
+									resolution, lattice->getNx(), lattice->getNy(), lattice->getNz());
+			// Each case has its own file, the cases of a sweep may run concurrently.
+			std::string fileName = "parameters_Re="+std::to_string((int)reynolds)+"_GridLvL="+std::to_string((int)gridLevel);
+			plb_ofstream ofile((global::directories().getLogOutDir()+fileName+".dat").c_str());
+			ofile << fileName << "\n\n";
+			ofile << "Velocity in lattice units: u=" << p.getLatticeU() << "\n";
+			ofile << "Reynolds number:           Re=" << p.getRe() << "\n";
+			ofile << "Lattice resolution:        N=" << p.getResolution() << "\n";
+			ofile << "Relaxation frequency:      omega=" << p.getOmega() << "\n";
+			ofile << "Extent of the system:      lx=" << p.getLx() << "\n";
+			ofile << "Extent of the system:      ly=" << p.getLy() << "\n";
+			ofile << "Extent of the system:      lz=" << p.getLz() << "\n";
+			ofile << "Grid spacing deltaX:       dx=" << p.getDeltaX() << "\n";
+			ofile << "Time step deltaT:          dt=" << p.getDeltaT() << "\n";
+		}
+		catch(const std::exception& e){exHandler(e,__FILE__,__FUNCTION__,__LINE__);}
+	}
+
+	// Integrate the collision, the rhoBar-j computation and the immersed boundary processors in the lattice
+	// multi-block. The processors of the boundary conditions are integrated by createBC.
+	template<typename T, class BoundaryType, class SurfaceData, template<class U> class Descriptor>
+	void Variables<T,BoundaryType,SurfaceData,Descriptor>::integrateProcessors()
+	{
+		try{
+			// The fluid cells have IncBGK dynamics and the solid cells NoDynamics: their collision is
+			// dispatched at compile time, without virtual call.
+			typedef DynamicsList<IncBGKdynamics<T,Descriptor>, NoDynamics<T,Descriptor> > LatticeDynamics;
+			integrateProcessingFunctional(new ExternalRhoJcollideAndStream3D<T,Descriptor,LatticeDynamics>(),lattice->getBoundingBox(), rhoBarJarg, 0);
+			integrateProcessingFunctional(new BoxRhoBarJfunctional3D<T,Descriptor>(), lattice->getBoundingBox(), rhoBarJarg, 3);
+
+			std::vector<MultiBlock3D*> args;
+			plint pl = 4;
+			integrateUpdateImmersedWallData<T>(Obstacle<T,BoundaryType,SurfaceData,Descriptor>::wallBuffer, *lattice, *container, pl);
+			pl++;
+
+			for (plint i = 0; i < Constants<T>::ibIter; i++) {
+				args.resize(0);
+				args.push_back(rhoBar.get());
+				args.push_back(j.get());
+				args.push_back(container);
+				integrateProcessingFunctional(
+					new CachedInamuroIteration3D<T,SurfaceVelocity<T> >(
+						Obstacle<T,BoundaryType,SurfaceData,Descriptor>::velocityFunc, p.getTau(), true),
+						rhoBar->getBoundingBox(), *lattice, args, pl);
+				pl++;
+			}
+		}
+		catch(const std::exception& e){exHandler(e,__FILE__,__FUNCTION__,__LINE__);}
+	}
+
 	template<typename T, class BoundaryType, class SurfaceData, template<class U> class Descriptor>
 	std::unique_ptr<OffLatticeBoundaryCondition3D<T,Descriptor,BoundaryType> > Variables<T,BoundaryType,SurfaceData,Descriptor>::createBC(
 		GuoOffLatticeModel3D<T,Descriptor>* model, VoxelizedDomain3D<T>& voxelizedDomain)
@@ -609,7 +622,7 @@ namespace plb{
 
 			boundaryCondition.reset(
 					new OffLatticeBoundaryCondition3D<T,Descriptor,BoundaryType>(
-					model,
+					model->clone(),
 					voxelizedDomain,
 					*lattice)
 			);
@@ -640,6 +653,7 @@ namespace plb{
 				global::log(mesg);
 				global::timer("ini").start();
 			#endif
+				PLB_TRACE_SCOPE("Variables::initializeLattice");
 
 			T iniT = Constants<T>::initialTemperature;
 			T rho_lb = getRho(iniT);
@@ -662,44 +676,70 @@ namespace plb{
 		catch(const std::exception& e){exHandler(e,__FILE__,__FUNCTION__,__LINE__);}
 	}
 
+	// Redistribute the blocks of the lattice over the processes, when the cost of the processes
+	// differs too much. The first call, right after the creation of the lattice, weighs the blocks
+	// by their number of fluid cells. The later calls use the time spent in the processors of each
+	// block of the lattice, including the collision-streaming step, since the previous call.
 	template<typename T, class BoundaryType, class SurfaceData, template<class U> class Descriptor>
-	void Variables<T,BoundaryType,SurfaceData,Descriptor>::makeParallel()
+	void Variables<T,BoundaryType,SurfaceData,Descriptor>::balanceLoad(const bool& initial)
 	{
 		try{
+			std::map<plint,double> weights = computeBlockWeights(*lattice);
+			if(initial){
+				balancer.reset(new LoadBalancer3D(Constants<T>::maxImbalance));
+				balancer->estimate(*lattice, weights);
+			}
+			else{ balancer->measure(*lattice, weights); }
+
 			#ifdef PLB_DEBUG
-				std::string mesg = "[DEBUG] Parallelizing Lattice ";
-				if(master){std::cout << mesg << std::endl;}
-				global::log(mesg);
-				global::timer("parallel").start();
-			#endif
-			Box3D box = lattice->getBoundingBox();
-			std::map<plint, BlockLattice3D< T, Descriptor > * > blockMap = lattice->getBlockLattices();
-			plint size = blockMap.size();
-			std::vector< std::vector<Box3D> > domains;
-			domains.resize(size);
-
-			for(int i=0; i<size; i++){
-				std::vector<Box3D> block;
-				plint nx = blockMap[i]->getNx()-1;
-				plint ny = blockMap[i]->getNy()-1;
-				plint nz = blockMap[i]->getNz()-1;
-				for(int x = 0; x<nx; x++){
-					for(int y = 0; y<nx; y++){
-						for(int z=0; z<nz; z++){
-							Box3D cell(x,x+1,y,y+1,z,z+1);
-							block.push_back(cell);
-						}
-					}
-				}
-				domains.push_back(block);
+				std::string mesg = "[DEBUG] Load Imbalance= "+std::to_string(balancer->getImbalance())
+					+" Predicted= "+std::to_string(balancer->getPredictedImbalance());
+				if(master){std::cout << mesg << std::endl;}
+				global::log(mesg);
+				global::timer("balance").restart();
+			#endif
+				PLB_TRACE_SCOPE("Variables::balanceLoad");
+
+			if(!balancer->needsRebalancing()){ return; }
+
+			WeightedHilbertRedistribute3D redistribution = balancer->getRedistribution();
+
+			// The off-lattice boundary conditions hold data which cannot be transferred to
+			// another process. They are discarded, and rebuilt on the new distribution.
+			if(!initial){
+				Wall<T,BoundaryType,SurfaceData,Descriptor>::bc.reset();
+				Obstacle<T,BoundaryType,SurfaceData,Descriptor>::bc.reset();
+			}
+
+			std::vector<MultiBlock3D*> blocks(rhoBarJarg);
+			blocks.push_back(container);
+			redistribute(blocks, redistribution);
+
+			// The voxel matrices follow the blocks of the lattice.
+			Wall<T,BoundaryType,SurfaceData,Descriptor>::vd->reparallelize(lattice->getMultiBlockManagement());
+			Obstacle<T,BoundaryType,SurfaceData,Descriptor>::vd->reparallelize(lattice->getMultiBlockManagement());
+
+			if(!initial){
+				Wall<T,BoundaryType,SurfaceData,Descriptor>::fs = createFS(*Wall<T,BoundaryType,SurfaceData,Descriptor>::vd,
+					Wall<T,BoundaryType,SurfaceData,Descriptor>::bp.get());
+				Wall<T,BoundaryType,SurfaceData,Descriptor>::model = createModel(Wall<T,BoundaryType,SurfaceData,Descriptor>::fs.get(),
+					Wall<T,BoundaryType,SurfaceData,Descriptor>::flowType);
+				Wall<T,BoundaryType,SurfaceData,Descriptor>::bc = createBC(Wall<T,BoundaryType,SurfaceData,Descriptor>::model.get(),
+					*Wall<T,BoundaryType,SurfaceData,Descriptor>::vd);
+
+				Obstacle<T,BoundaryType,SurfaceData,Descriptor>::fs = createFS(*Obstacle<T,BoundaryType,SurfaceData,Descriptor>::vd,
+					Obstacle<T,BoundaryType,SurfaceData,Descriptor>::bp.get());
+				Obstacle<T,BoundaryType,SurfaceData,Descriptor>::model = createModel(Obstacle<T,BoundaryType,SurfaceData,Descriptor>::fs.get(),
+					Obstacle<T,BoundaryType,SurfaceData,Descriptor>::flowType);
+				Obstacle<T,BoundaryType,SurfaceData,Descriptor>::bc = createBC(Obstacle<T,BoundaryType,SurfaceData,Descriptor>::model.get(),
+					*Obstacle<T,BoundaryType,SurfaceData,Descriptor>::vd);
 			}
-			ParallellizeByCubes3D parallel(domains, box, nprocs_side, nprocs_side, nprocs_side);
-			parallel.parallelize();
+
 			#ifdef PLB_DEBUG
-				mesg = "[DEBUG] Done Parallelizing Lattice time="+std::to_string(global::timer("parallel").getTime());
+				mesg = "[DEBUG] Done Balancing Load time="+std::to_string(global::timer("balance").getTime());
 				if(master){std::cout << mesg << std::endl;}
 				global::log(mesg);
-				global::timer("parallel").stop();
+				global::timer("balance").stop();
 			#endif
 		}
 		catch(const std::exception& e){exHandler(e,__FILE__,__FUNCTION__,__LINE__);}
@@ -737,6 +777,8 @@ namespace plb{
 
 			createLattice(*Wall<T,BoundaryType,SurfaceData,Descriptor>::vd, *Obstacle<T,BoundaryType,SurfaceData,Descriptor>::vd);
 
+			balanceLoad(true);
+
 			Wall<T,BoundaryType,SurfaceData,Descriptor>::bp = createBP(*Wall<T,BoundaryType,SurfaceData,Descriptor>::tb);
 
 			Wall<T,BoundaryType,SurfaceData,Descriptor>::fs = createFS(*Wall<T,BoundaryType,SurfaceData,Descriptor>::vd,
@@ -761,7 +803,9 @@ namespace plb{
 
 			initializeLattice();
 
-			//makeParallel();
+			// The start position of the obstacle is kept, so that the next Reynolds number of a sweep reuses the lattice.
+			obstacleStart = parallelIO::CheckpointRecord();
+			Obstacle<T,BoundaryType,SurfaceData,Descriptor>::save(obstacleStart);
 
 			#ifdef PLB_DEBUG
 				mesg = "[DEBUG] Done Constructing Main Lattice";
@@ -772,32 +816,260 @@ namespace plb{
 		catch(const std::exception& e){exHandler(e,__FILE__,__FUNCTION__,__LINE__);}
 	}
 
+	// Set up the lattice of setLattice() for another Reynolds number on the same grid level. The voxelization,
+	// the block structure and the boundary conditions do not depend on the Reynolds number and are kept:
+	// the obstacle returns to its start position, the relaxation frequency of the dynamics and of the
+	// immersed boundary is changed, and the populations are initialized again.
+	template<typename T, class BoundaryType, class SurfaceData, template<class U> class Descriptor>
+	void Variables<T,BoundaryType,SurfaceData,Descriptor>::reparameterize(const plint& _reynolds)
+	{
+		try{
+			#ifdef PLB_DEBUG
+				std::string mesg = "[DEBUG] Reparameterizing Main Lattice Reynolds="+std::to_string(_reynolds);
+				if(master){std::cout << mesg << std::endl;}
+				global::log(mesg);
+				global::timer("reparameterize").restart();
+			#endif
+				PLB_TRACE_SCOPE("Variables::reparameterize");
+			if(!lattice){ throw std::runtime_error("Lattice not created, call Variables::setLattice first"); }
+
+			reynolds = _reynolds;
+			restartIter = 0;
+			lattice->completeStream();
+			setParameters();
+			dynamics.reset(new IncBGKdynamics<T,Descriptor>(p.getOmega()));
+
+			parallelIO::CheckpointRecord record(obstacleStart.getData());
+			Obstacle<T,BoundaryType,SurfaceData,Descriptor>::load(record);
+			setOmega(*lattice, lattice->getBoundingBox(), p.getOmega());
+
+			// The immersed boundary processors hold the relaxation time, all processors are integrated again.
+			std::vector<MultiBlock3D::ProcessorStorage3D> processors;
+			lattice->releaseProcessors(processors);
+			std::vector<plint> const& blocks = lattice->getLocalInfo().getBlocks();
+			for(pluint i = 0; i < blocks.size(); i++){ lattice->getComponent(blocks[i]).clearDataProcessors(); }
+			integrateProcessors();
+			Wall<T,BoundaryType,SurfaceData,Descriptor>::bc->insert(rhoBarJarg);
+			Obstacle<T,BoundaryType,SurfaceData,Descriptor>::bc->insert(rhoBarJarg);
+
+			initializeLattice();
+
+			#ifdef PLB_DEBUG
+				mesg = "[DEBUG] Done Reparameterizing Main Lattice time="+std::to_string(global::timer("reparameterize").getTime());
+				if(master){std::cout << mesg << std::endl;}
+				global::log(mesg);
+			#endif
+		}
+		catch(const std::exception& e){exHandler(e,__FILE__,__FUNCTION__,__LINE__);}
+	}
+
 	template<typename T, class BoundaryType, class SurfaceData, template<class U> class Descriptor>
 	void Variables<T,BoundaryType,SurfaceData,Descriptor>::save()
 	{
 		try{
 			#ifdef PLB_DEBUG
-				std::string mesg = "[DEBUG] Saving Data";
+				std::string mesg = "[DEBUG] Saving Checkpoint";
 				if(master){std::cout << mesg << std::endl;}
 				global::log(mesg);
+				global::timer("checkpoint").restart();
 			#endif
+				PLB_TRACE_SCOPE("Variables::save");
+
+			// A pending streaming step of the AA pattern is concluded, so that the populations are in natural order.
+			lattice->completeStream();
+
+			std::string fileName = "checkpoint_Re"+std::to_string((plint)reynolds)+"_Lvl"+std::to_string((plint)gridLevel);
+			parallelIO::CheckpointWriter checkpoint(fileName);
+			parallelIO::CheckpointRecord record;
+			record.add(iter);
+			record.add(time);
+			record.add(reynolds);
+			record.add(gridLevel);
+			checkpoint.write("variables", record);
+			checkpoint.write("lattice", *lattice, true);
+			checkpoint.write("rhoBar", *rhoBar);
+			checkpoint.write("j", *j);
+			Obstacle<T,BoundaryType,SurfaceData,Descriptor>::save(checkpoint);
+			checkpoint.close();
 
-			lattice->toggleInternalStatistics(false);
+			#ifdef PLB_DEBUG
+				mesg = "[DEBUG] Done Saving Checkpoint time="+std::to_string(global::timer("checkpoint").getTime());
+				if(master){std::cout << mesg << std::endl;}
+				global::log(mesg);
+			#endif
+		}
+		catch(const std::exception& e){exHandler(e,__FILE__,__FUNCTION__,__LINE__);}
+	}
+
+	template<typename T, class BoundaryType, class SurfaceData, template<class U> class Descriptor>
+	bool Variables<T,BoundaryType,SurfaceData,Descriptor>::load()
+	{
+		try{
+			if(Constants<T>::restartFile == ""){ return false; }
+			#ifdef PLB_DEBUG
+				std::string mesg = "[DEBUG] Loading Checkpoint "+Constants<T>::restartFile;
+				if(master){std::cout << mesg << std::endl;}
+				global::log(mesg);
+			#endif
+
+			parallelIO::CheckpointReader checkpoint(Constants<T>::restartFile);
+			parallelIO::CheckpointRecord record;
+			checkpoint.read("variables", record);
+			plint savedIter = 0;
+			T savedTime = 0, savedReynolds = 0, savedGridLevel = 0;
+			record.get(savedIter);
+			record.get(savedTime);
+			record.get(savedReynolds);
+			record.get(savedGridLevel);
+			if(savedReynolds != reynolds || savedGridLevel != gridLevel){ return false; }
+
+			// The lattice is restored after the obstacle, so that the populations and dynamics of the
+			// checkpoint replace the ones set up by the re-voxelization.
+			Obstacle<T,BoundaryType,SurfaceData,Descriptor>::load(checkpoint);
+			checkpoint.read("lattice", *lattice);
+			checkpoint.read("rhoBar", *rhoBar);
+			checkpoint.read("j", *j);
+			iter = savedIter;
+			time = savedTime;
+			restartIter = savedIter;
+			// The simulation is restarted only once.
+			Constants<T>::restartFile = "";
+
+			#ifdef PLB_DEBUG
+				mesg = "[DEBUG] Done Loading Checkpoint at iteration "+std::to_string(iter);
+				if(master){std::cout << mesg << std::endl;}
+				global::log(mesg);
+			#endif
+			return true;
+		}
+		catch(const std::exception& e){exHandler(e,__FILE__,__FUNCTION__,__LINE__);}
+		return false;
+	}
+
+	template<typename T, class BoundaryType, class SurfaceData, template<class U> class Descriptor>
+	std::string Variables<T,BoundaryType,SurfaceData,Descriptor>::getWarmStartFile(const plint& _reynolds, const plint& _gridLevel)
+	{
+		return global::directories().getOutputDir()+"warmstart_Re"+std::to_string(_reynolds)+"_Lvl"+std::to_string(_gridLevel)+".chk";
+	}
 
-			//MultiTensorField3D<T, 3> v = *computeVelocity(*lattice);
-			//velocity.push_back(v);
+	// Keep the state of the lattice and of the obstacle at Constants::warmStartTime, as the initial
+	// condition of the same case on the next finer grid level.
+	template<typename T, class BoundaryType, class SurfaceData, template<class U> class Descriptor>
+	void Variables<T,BoundaryType,SurfaceData,Descriptor>::saveWarmStart()
+	{
+		try{
+			#ifdef PLB_DEBUG
+				std::string mesg = "[DEBUG] Saving Warm Start time="+std::to_string(time);
+				if(master){std::cout << mesg << std::endl;}
+				global::log(mesg);
+			#endif
+			lattice->completeStream();
+			parallelIO::CheckpointWriter checkpoint(getWarmStartFile((plint)reynolds, (plint)gridLevel));
+			parallelIO::CheckpointRecord record;
+			record.add(time);
+			record.add(p.getDeltaT());
+			record.add(Wall<T,BoundaryType,SurfaceData,Descriptor>::location);
+			record.add(Wall<T,BoundaryType,SurfaceData,Descriptor>::tb->getDx());
+			checkpoint.write("variables", record);
+			checkpoint.write("lattice", *lattice, true);
+			Obstacle<T,BoundaryType,SurfaceData,Descriptor>::save(checkpoint);
+			checkpoint.close();
+		}
+		catch(const std::exception& e){exHandler(e,__FILE__,__FUNCTION__,__LINE__);}
+	}
 
-			//MultiTensorField3D<T, 3> w = *computeVorticity(v);
-			//vorticity.push_back(w);
+	// Start the case from the solution of the next coarser grid level, if saveWarmStart() wrote one. The
+	// populations are interpolated onto the fine grid, and rescaled from the coarse to the fine lattice units
+	// (the lattice velocity is halved and the time step divided by four between two levels). The obstacle
+	// is moved to the same physical position, with the same physical velocity.
+	template<typename T, class BoundaryType, class SurfaceData, template<class U> class Descriptor>
+	bool Variables<T,BoundaryType,SurfaceData,Descriptor>::warmStart()
+	{
+		try{
+			if(Constants<T>::warmStartTime <= 0 || gridLevel < 1){ return false; }
+			const std::string fileName = getWarmStartFile((plint)reynolds, (plint)gridLevel-1);
+			int found = 0;
+			if(master){ found = std::ifstream(fileName.c_str()).good() ? 1 : 0; }
+			global::mpi().bCast(&found, 1);
+			if(found == 0){ return false; }
+			#ifdef PLB_DEBUG
+				std::string mesg = "[DEBUG] Warm Starting from "+fileName;
+				if(master){std::cout << mesg << std::endl;}
+				global::log(mesg);
+				global::timer("warmStart").restart();
+			#endif
+				PLB_TRACE_SCOPE("Variables::warmStart");
+
+			parallelIO::CheckpointReader checkpoint(fileName);
+			parallelIO::CheckpointRecord record;
+			checkpoint.read("variables", record);
+			T coarseTime = 0, coarseDt = 0, coarseDx = 0;
+			Array<T,3> coarseLocation;
+			record.get(coarseTime);
+			record.get(coarseDt);
+			record.get(coarseLocation);
+			record.get(coarseDx);
+
+			// Position of the coarse origin in fine lattice units.
+			const T fineDx = Wall<T,BoundaryType,SurfaceData,Descriptor>::tb->getDx();
+			const Array<T,3> offset = (coarseLocation - Wall<T,BoundaryType,SurfaceData,Descriptor>::location) / fineDx;
+			const T dxRatio = fineDx / coarseDx;
+			const T dtRatio = p.getDeltaT() / coarseDt;
+
+			parallelIO::CheckpointRecord obstacleRecord;
+			checkpoint.read("obstacle", obstacleRecord);
+			Obstacle<T,BoundaryType,SurfaceData,Descriptor>::load(obstacleRecord, dxRatio, dtRatio, offset);
+
+			std::unique_ptr<MultiBlock3D> coarseBlock(checkpoint.read("lattice"));
+			MultiBlockLattice3D<T,Descriptor>* coarse = dynamic_cast<MultiBlockLattice3D<T,Descriptor>*>(coarseBlock.get());
+			if(!coarse){ throw std::runtime_error("The warm start file "+fileName+" holds no lattice"); }
+			const plint dxScale = -1, dtScale = -2;
+			std::unique_ptr<MultiBlockLattice3D<T,Descriptor> > refined(
+				refine(*coarse, dxScale, dtScale, dynamics->clone()).release());
+			coarseBlock.reset();
+
+			// The refined lattice has the coarse origin, it is shifted onto the fine lattice.
+			const Dot3D shift((plint)util::roundToInt(offset[0]), (plint)util::roundToInt(offset[1]),
+				(plint)util::roundToInt(offset[2]));
+			Box3D toDomain;
+			lattice->completeStream();
+			if(intersect(refined->getBoundingBox().shift(shift.x, shift.y, shift.z), lattice->getBoundingBox(), toDomain)){
+				copy_generic(*refined, toDomain.shift(-shift.x, -shift.y, -shift.z), *lattice, toDomain, modif::staticVariables);
+			}
+			applyProcessingFunctional(new BoxRhoBarJfunctional3D<T,Descriptor>(), lattice->getBoundingBox(), rhoBarJarg);
+			Wall<T,BoundaryType,SurfaceData,Descriptor>::bc->apply(rhoBarJarg);
+			Obstacle<T,BoundaryType,SurfaceData,Descriptor>::bc->apply(rhoBarJarg);
 
-			//MultiScalarField3D<T> r = *computeDensity(*lattice);
-			//density.push_back(r);
+			time = (T)util::roundToInt(coarseTime * coarseDt / p.getDeltaT());
 
 			#ifdef PLB_DEBUG
-				mesg = "[DEBUG] Done Saving Data";
+				mesg = "[DEBUG] Done Warm Starting at time="+std::to_string(time)+" in "
+					+std::to_string(global::timer("warmStart").getTime());
 				if(master){std::cout << mesg << std::endl;}
 				global::log(mesg);
 			#endif
+			return true;
+		}
+		catch(const std::exception& e){exHandler(e,__FILE__,__FUNCTION__,__LINE__);}
+		return false;
+	}
+
+	template<typename T, class BoundaryType, class SurfaceData, template<class U> class Descriptor>
+	void Variables<T,BoundaryType,SurfaceData,Descriptor>::getRestartLevel(plint& _reynolds, plint& _gridLevel)
+	{
+		try{
+			if(Constants<T>::restartFile == ""){ return; }
+			parallelIO::CheckpointReader checkpoint(Constants<T>::restartFile);
+			parallelIO::CheckpointRecord record;
+			checkpoint.read("variables", record);
+			plint savedIter = 0;
+			T savedTime = 0, savedReynolds = 0, savedGridLevel = 0;
+			record.get(savedIter);
+			record.get(savedTime);
+			record.get(savedReynolds);
+			record.get(savedGridLevel);
+			_reynolds = (plint)savedReynolds;
+			_gridLevel = (plint)savedGridLevel;
 		}
 		catch(const std::exception& e){exHandler(e,__FILE__,__FUNCTION__,__LINE__);}
 	}
@@ -811,10 +1083,17 @@ namespace plb{
 				if(master){std::cout << mesg << std::endl;}
 				global::log(mesg);
 			#endif
+			PLB_TRACE_SCOPE("Variables::updateLattice");
 
 			lattice->toggleInternalStatistics(false);
 
-			//save();
+			// At the first iteration, possibly after a restart, the blocks have just been balanced by setLattice().
+			if(Constants<T>::balanceInterval > 0 && iter > restartIter && iter % Constants<T>::balanceInterval == 0){ balanceLoad(false); }
+
+			if(Constants<T>::checkpointInterval > 0 && iter % Constants<T>::checkpointInterval == 0){ save(); }
+
+			if(Constants<T>::warmStartTime > 0 && gridLevel < Constants<T>::maxGridLevel
+				&& (plint)time == p.nStep(Constants<T>::warmStartTime)){ saveWarmStart(); }
 
 			#ifdef PLB_DEBUG
 				mesg = "[DEBUG] Done Updating Main Lattice";
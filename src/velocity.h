@@ -27,29 +27,33 @@ public:
 
 	Box3D getDomain(const TriangleBoundary3D<T>* tb);
 
-	Array<T,3> getCG(std::vector<Array<T,3> > vertexList);
-
 	Array<T,3> getArm(const Array<T,3>& p1, const Array<T,3>& p2);
 
-	Array<T,6> getMomentOfInertia(const Array<T,3>& cg, const TriangleBoundary3D<T>* tb, const T& rho_lb);
-
 	Array<T,3> getAlpha(const Array<T,3>& M, const Array<T,6>& I);
 
-	Array<T,3> getRotation(const Array<T,3>& vertex, const Array<T,3>& cg, const Array<T,3>& dtheta);
-
-	Array<T,3> getTotalVelocity(const Array<T,3>& vertex, const Array<T,3>& cg, const Array<T,3>& omega_lb, const Array<T,3>& v_lb);
-
 	bool outOfBounds(const Box3D& domain, const Array<T,3> vertex);
 
+	// The vertex velocities are those of the rigid body, which update() moves together with the mesh of tb.
+	void setBody(RigidBody3D<T>* body);
+
 	bool update(const IncomprFlowParam<T>& p, const T& timeLB, const Array<T,3>& force, const Array<T,3>& torque,
 						TriangleBoundary3D<T>* tb, const Box3D& domain);
+
+	// Store and restore the kinematic state and its history in a checkpoint record.
+	void save(parallelIO::CheckpointRecord& record);
+
+	void load(parallelIO::CheckpointRecord& record);
+
+	// Convert the state to the lattice units of another grid level, dxRatio and dtRatio being the ratios
+	// of the new to the old lattice spacing and time step.
+	void rescale(const T& dxRatio, const T& dtRatio);
 // Attributes
 private:
 	static bool master;
 	static bool rotation;
 	static plint moves;
 	static Kinematics<T> previous;
-	static std::vector<Array<T,3> > verticesVelocity;
+	static RigidBody3D<T>* body;
 	static std::vector<Array<T,3> > forceList;
 	static std::vector<Array<T,3> > torque;
 	static std::vector<Array<T,3> > location;
@@ -75,7 +79,7 @@ template<typename T>
 Kinematics<T> SurfaceVelocity<T>::previous;
 
 template<typename T>
-std::vector<Array<T,3> > SurfaceVelocity<T>::verticesVelocity;
+RigidBody3D<T>* SurfaceVelocity<T>::body = nullptr;
 
 template<typename T>
 std::vector<Array<T,3> > SurfaceVelocity<T>::forceList;
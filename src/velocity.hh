@@ -31,7 +31,14 @@ namespace plb{
 	template<typename T>
 	Array<T,3> SurfaceVelocity<T>::operator()(pluint id)
 	{
-		return verticesVelocity[id];
+		return body->getVertexVelocity(id);
+	}
+
+	template<typename T>
+	void SurfaceVelocity<T>::setBody(RigidBody3D<T>* _body)
+	{
+		body = _body;
+		if(body){ body->setVelocity(previous.v_lb, previous.omega_lb); }
 	}
 
 	template<typename T>
@@ -97,30 +104,6 @@ namespace plb{
 		return d;
 	}
 
-	template<typename T>
-	Array<T,3> SurfaceVelocity<T>::getCG(std::vector<Array<T,3> > vertexList)
-	{
-		// Compute the center of gravity
-		Array<T,3> cg = Array<T,3>(0,0,0);
-		try{
-			T x = 0;
-			T y = 0;
-			T z = 0;
-			int size = vertexList.size();
-
-			for(int i = 0; i<size; i++){
-				Array<T,3> iVertex = vertexList[i];
-				x += iVertex[0];
-				y += iVertex[1];
-				z += iVertex[2];
-			}
-
-			cg = Array<T,3>(x/size, y/size, z/size);
-		}
-		catch(const std::exception& e){exHandler(e,__FILE__,__FUNCTION__,__LINE__);}
-		return cg;
-	}
-
 	template<typename T>
 	Array<T,3> SurfaceVelocity<T>::getArm(const Array<T,3>& p1, const Array<T,3>& p2)
 	{
@@ -155,66 +138,6 @@ namespace plb{
 		return arm;
 	}
 
-	template<typename T>
-	Array<T,6> SurfaceVelocity<T>::getMomentOfInertia(const Array<T,3>& cg, const TriangleBoundary3D<T>* tb,
-		const T& rho_lb )
-	{
-		// Compute the moment of Inertia
-		Array<T,6> I = Array<T,6>(0,0,0,0,0,0);
-		try{
-			T Ixx = 0;
-			T Iyy = 0;
-			T Izz = 0;
-			T Ixy = 0;
-			T Ixz = 0;
-			T Iyz = 0;
-			T numTriangles = tb->getMesh().getNumTriangles();
-			for(int i = 0; i<numTriangles; i++){
-				Array<T,3> a =  tb->getMesh().getVertex(i,0);
-				Array<T,3> b =  tb->getMesh().getVertex(i,1);
-				Array<T,3> c =  tb->getMesh().getVertex(i,2);
-				Array<T,3> d = cg;
-				T iVolume = computeTetrahedronSignedVolume(a,b,c,d);
-				if(iVolume<0){iVolume *= -1; }
-				T iMass = iVolume * rho_lb;
-				Array<T,3> iCG = Array<T,3>(0,0,0);
-				for(int i = 0; i<3; i++){
-					T temp = a[i]+b[i]+c[i]+d[i];
-					iCG[i] = temp/4;
-				}
-				T x = iCG[0] - cg[0];
-				T y = iCG[1] - cg[1];
-				T z = iCG[2] - cg[2];
-				T temp = y*y + z*z;
-				Ixx += iMass * temp;
-				temp = x*x + z*z;
-				Iyy += iMass * temp;
-				temp = x*x + y*y;
-				Izz += iMass * temp;
-				Ixy += iMass * x * y;
-				Ixz += iMass * x * z;
-				Iyz += iMass * y * z;
-			}
-			Ixy *= -1;
-			Ixz *= -1;
-			Iyz *= -1;
-			I[0] = Ixx;
-			I[1] = Iyy;
-			I[2] = Izz;
-			I[3] = Ixy;
-			I[4] = Ixz;
-			I[5] = Iyz;
-			#ifdef PLB_DEBUG
-				pcout << "[DEBUG]: Moment of Inertia =" <<std::endl;
-				pcout << "| "<< Ixx <<" "<<Ixy<<" "<<Ixz<<" |"<<std::endl;
-				pcout << "| "<< Ixy <<" "<<Iyy<<" "<<Ixy<<" |"<<std::endl;
-				pcout << "| "<< Ixz <<" "<<Ixy<<" "<<Izz<<" |"<<std::endl;
-			#endif
-		}
-		catch(const std::exception& e){exHandler(e,__FILE__,__FUNCTION__,__LINE__);}
-		return I;
-	}
-
 	template<typename T>
 	Array<T,3> SurfaceVelocity<T>::getAlpha(const Array<T,3>& M, const Array<T,6>& I)
 	{
@@ -240,66 +163,6 @@ namespace plb{
 		return alpha;
 	}
 
-	template<typename T>
-	Array<T,3> SurfaceVelocity<T>::getRotation(const Array<T,3>& vertex, const Array<T,3>& cg, const Array<T,3>& dtheta)
-	{
-		Array<T,3> newVertex = Array<T,3>(0,0,0);
-		try{
-			if(dtheta[0] != 0 || dtheta[1] != 0 || dtheta[2] != 0){
-				// X, Y, Z Rotation
-				const T PI = std::acos(-1);
-				// 1. Translate c.g. to origin
-				newVertex = vertex - cg;
-				// 2. Rotation about the X-axis
-				T dx = newVertex[0];
-				T dy = newVertex[1]*std::cos(dtheta[0]) - newVertex[2]*std::sin(dtheta[0]);
-				T dz = newVertex[1]*std::sin(dtheta[0]) + newVertex[2]*std::cos(dtheta[0]);
-				newVertex = Array<T,3>(dx,dy,dz);
-				// 3. Rotation about the Y-axis
-				dx = newVertex[2]*std::sin(dtheta[1]) + newVertex[0]*std::cos(dtheta[1]);
-				dy = newVertex[1];
-				dz = newVertex[2]*std::cos(dtheta[1]) - newVertex[0]*std::sin(dtheta[1]);
-				newVertex = Array<T,3>(dx,dy,dz);
-				// 4. Rotation about the Z-axis
-				dx = newVertex[0]*std::cos(dtheta[2]) - newVertex[1]*std::sin(dtheta[2]);
-				dy = newVertex[0]*std::sin(dtheta[2]) + newVertex[1]*std::cos(dtheta[2]);
-				dz = newVertex[2];
-				newVertex = Array<T,3>(dx,dy,dz);
-				// 5. Translate c.g. back to position
-				newVertex += cg;
-			}
-			else{return vertex; }
-		}
-		catch(const std::exception& e){exHandler(e,__FILE__,__FUNCTION__,__LINE__);}
-		return newVertex;
-	}
-
-	template<typename T>
-	Array<T,3> SurfaceVelocity<T>::getTotalVelocity(const Array<T,3>& vertex, const Array<T,3>& cg, const Array<T,3>& omega_lb,
-		const Array<T,3>& v_lb)
-	{
-		Array<T,3> v = Array<T,3>(0,0,0);
-		try{
-			if(omega_lb[0] != 0 || omega_lb[1] != 0 || omega_lb[2] !=0){
-				// X, Y, Z Rotational Velocity to Linear
-				T base = std::pow(vertex[0],2) - 2*cg[0]*vertex[0] + std::pow(cg[0],2);
-				T dx = std::pow(base,0.5);
-				base = std::pow(vertex[1],2) - 2*cg[1]*vertex[1] + std::pow(cg[1],2);
-				T dy= std::pow(base,0.5);
-				base = std::pow(vertex[2],2) - 2*cg[2]*vertex[2] + std::pow(cg[2],2);
-				T dz = std::pow(base,0.5);
-				// Cross Product of r X omega
-				v[0] = omega_lb[1]*dz - omega_lb[2]*dy;
-				v[1] = omega_lb[2]*dx - omega_lb[0]*dz;
-				v[2] = omega_lb[0]*dz - omega_lb[2]*dx;
-				v += v_lb;
-			}
-			else{ return v_lb; }
-		}
-		catch(const std::exception& e){exHandler(e,__FILE__,__FUNCTION__,__LINE__);}
-		return v;
-	}
-
 	template<typename T>
 	bool SurfaceVelocity<T>::outOfBounds(const Box3D& domain, const Array<T,3> vertex)
 	{
@@ -332,15 +195,8 @@ namespace plb{
 			const T dt = p.getDeltaT();
 			const T dx = p.getDeltaX();
 
-			plint n = tb->getMesh().getNumVertices();
-			std::vector<Array<T,3> > oldVertices;
-			oldVertices.resize(n);
-			oldVertices.reserve(n);
-
-			for(plint i = 0; i<n; i++){oldVertices[i] = tb->getMesh().getVertex(i);}
-
-			Array<T,3> cg_lb = getCG(oldVertices);
-
+			// The centre of the body is the mean of its vertices.
+			Array<T,3> cg_lb = body->getPosition();
 
 			T dx3 = dx*dx*dx;
 			T dt2 = dt * dt;
@@ -359,7 +215,7 @@ namespace plb{
 			torque_lb = torque; // * dt*dt / (dx * dx * dx * dx * dx);
 
 			Array<T,6> I_lb = Array<T,6>(0,0,0,0,0,0);
-			I_lb = getMomentOfInertia(cg_lb, tb, rho_lb);
+			I_lb = body->getInertia(rho_lb);
 
 			Array<T,3> a_lb = Array<T,3>(0,0,0);
 			a_lb = previous.a_lb + f_lb / mass_lb;
@@ -381,53 +237,23 @@ namespace plb{
 			Array<T,3> dtheta_lb = Array<T,3>(0,0,0);
 			//dtheta_lb = previous.omega_lb * (T)1.0 + (T)0.5 * alpha_lb * (T)1.0 * (T)1.0;
 
-			std::vector<Array<T,3> > newVertices;
-			newVertices.resize(n);
-			newVertices.reserve(n);
-
-			verticesVelocity.clear();
-			verticesVelocity.resize(n);
-			verticesVelocity.reserve(n);
-/*
-			TriangleSet<T> simple = *triangleSet.toTriangleSet(Constants<T>::precision);
-			Array<T,3> axis = Array<T,3>(1,0,0);
-			simple.rotateAtOrigin(axis, dtheta_lb[0]);
-			axis = Array<T,3>(0,1,0);
-			simple.rotateAtOrigin(axis, dtheta_lb[1]);
-			axis = Array<T,3>(0,0,1);
-			simple.rotateAtOrigin(axis, dtheta_lb[2]);
-
-			simple.translate(ds_lb);
-
-			triangleSet = ConnectedTriangleSet<T>(simple);
-*/
-			T vv = 0;
-			Array<T,3> maxVV_lb = Array<T,3>(0,0,0);
-			for(plint i = 0; i < n; i++){
-				//pcout << "old Vertex= " << array_string(oldVertices[i]);
-				newVertices[i] = Array<T,3>(0,0,0);
-				newVertices[i] = getRotation(oldVertices[i],cg_lb,dtheta_lb);
-				newVertices[i] += ds_lb;
-				//newVertices[i] = triangleSet.getVertex(i);
-				if(moves > 2){if(outOfBounds(domain, newVertices[i])){ stop = true; }}
-				//pcout << " new Vertex= " << array_string(newVertices[i]);
-				verticesVelocity[i] = Array<T,3>(0,0,0);
-				verticesVelocity[i] = getTotalVelocity(oldVertices[i],cg_lb,omega_lb,v_lb);
-				T abs = std::pow(std::pow(verticesVelocity[i][0],2)
-						+std::pow(verticesVelocity[i][0],2)
-						+std::pow(verticesVelocity[i][0],2),0.5);
-				if(abs > vv){ maxVV_lb = verticesVelocity[i]; vv = abs; }
-				//pcout << " Vertex velocity=  "<< array_string(verticesVelocity[i]) << std::endl;
+			// Only the pose of the body changes, the vertices, normals and velocities are derived from it on demand.
+			body->translate(ds_lb);
+			body->rotate(dtheta_lb);
+			body->setVelocity(v_lb, omega_lb);
+			Cuboid<T> bounds = body->getBoundingCuboid();
+			if(moves > 2){
+				if(outOfBounds(domain, bounds.lowerLeftCorner) || outOfBounds(domain, bounds.upperRightCorner)){ stop = true; }
 			}
 
+			// The voxelization and the off-lattice boundary condition still use the mesh of tb.
 			tb->getMesh().translate(ds_lb);
+			if(dtheta_lb[0] != 0 || dtheta_lb[1] != 0 || dtheta_lb[2] != 0){
+				plint n = tb->getMesh().getNumVertices();
+				for(plint i = 0; i < n; i++){ tb->getMesh().replaceVertex(i, body->getVertex(i)); }
+			}
 
-			const T PI = std::acos(-1);
-			if(dtheta_lb[1]<0 && dtheta_lb[1] > -PI){ dtheta_lb[1] += PI; }
-			if(dtheta_lb[1]>PI && dtheta_lb[1]< 2*PI){ dtheta_lb[1] -= PI; }
-			tb->getMesh().rotate(dtheta_lb[2], dtheta_lb[1], dtheta_lb[0]);
-
-			cg_lb = getCG(newVertices);
+			cg_lb = body->getPosition();
 
 			previous.v_lb = v_lb;
 			previous.a_lb = a_lb;
@@ -441,7 +267,6 @@ namespace plb{
 			T v_conv = dx/dt;
 			Array<T,3> v = v_lb*v_conv;
 			Array<T,3> omega = omega_lb*v_conv;
-			Array<T,3> maxVV = maxVV_lb *v_conv;
 
 			T a_conv = dx / dt2;
 			Array<T,3> a = a_lb*a_conv;
@@ -472,8 +297,6 @@ namespace plb{
 				pcout << "[DEBUG] ------------------------------------------------"<<std::endl;
 				pcout << "[DEBUG] Force= "<< array_string(f_lb) <<std::endl;
 				pcout << "[DEBUG] Torque= "<< array_string(torque_lb) <<std::endl;
-				pcout << "[DEBUG] ------------------------------------------------"<<std::endl;
-				pcout << "[DEBUG] Max Vertex Total Velocity= "<< array_string(maxVV_lb) <<std::endl;
 				pcout << " " << std::endl;
 				pcout << "[DEBUG] Kinematics in Physical Units" << std::endl;
 				pcout << "[DEBUG] ------------------------------------------------"<<std::endl;
@@ -491,8 +314,6 @@ namespace plb{
 				pcout << "[DEBUG] ------------------------------------------------"<<std::endl;
 				pcout << "[DEBUG] Force= "<< array_string(f) <<std::endl;
 				pcout << "[DEBUG] Torque= "<< array_string(t) <<std::endl;
-				pcout << "[DEBUG] ------------------------------------------------"<<std::endl;
-				pcout << "[DEBUG] Max Vertex Total Velocity= "<< array_string(maxVV) <<std::endl;
 				mesg = "[DEBUG] DONE Updating SurfaceVelocity";
 				if(master){std::cout << mesg << std::endl;}
 				global::log(mesg);
@@ -511,6 +332,57 @@ namespace plb{
 	}
 
 
+	template<typename T>
+	void SurfaceVelocity<T>::save(parallelIO::CheckpointRecord& record)
+	{
+		try{
+			record.add(previous);
+			record.add(moves);
+			record.add(forceList);
+			record.add(torque);
+			record.add(location);
+			record.add(acceleration);
+			record.add(velocity);
+			record.add(angular_acceleration);
+			record.add(angular_velocity);
+			record.add(time);
+		}
+		catch(const std::exception& e){exHandler(e,__FILE__,__FUNCTION__,__LINE__);}
+	}
+
+	template<typename T>
+	void SurfaceVelocity<T>::load(parallelIO::CheckpointRecord& record)
+	{
+		try{
+			record.get(previous);
+			record.get(moves);
+			record.get(forceList);
+			record.get(torque);
+			record.get(location);
+			record.get(acceleration);
+			record.get(velocity);
+			record.get(angular_acceleration);
+			record.get(angular_velocity);
+			record.get(time);
+		}
+		catch(const std::exception& e){exHandler(e,__FILE__,__FUNCTION__,__LINE__);}
+	}
+
+	template<typename T>
+	void SurfaceVelocity<T>::rescale(const T& dxRatio, const T& dtRatio)
+	{
+		try{
+			// The histories are kept in physical units, only the state in lattice units changes.
+			const T vScale = dtRatio / dxRatio;
+			const T aScale = dtRatio * dtRatio / dxRatio;
+			previous.v_lb *= vScale;
+			previous.a_lb *= aScale;
+			previous.omega_lb *= dtRatio;
+			previous.alpha_lb *= dtRatio * dtRatio;
+			if(body){ body->setVelocity(previous.v_lb, previous.omega_lb); }
+		}
+		catch(const std::exception& e){exHandler(e,__FILE__,__FUNCTION__,__LINE__);}
+	}
 
 } // NAMESPACE PLB
 
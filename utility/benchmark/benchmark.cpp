@@ -0,0 +1,446 @@
+/* This file is part of the Palabos library.
+ *
+ * Copyright (C) 2011-2015 FlowKit Sarl
+ * Route d'Oron 2
+ * 1010 Lausanne, Switzerland
+ * E-mail contact: contact@flowkit.com
+ *
+ * The most recent release of Palabos can be downloaded at 
+ * <http://www.palabos.org/>
+ *
+ * The library Palabos is free software: you can redistribute it and/or
+ * modify it under the terms of the GNU Affero General Public License as
+ * published by the Free Software Foundation, either version 3 of the
+ * License, or (at your option) any later version.
+ *
+ * The library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+/* Standing performance benchmark of the lattice engine.
+ *
+ * Three suites measure the number of cell updates per second (MLUPS) and
+ * estimate the memory traffic per cell update:
+ *   kernel    Collision-streaming of a single atomic block, on one core, for
+ *             every combination of descriptor (D3Q19, D3Q27), dynamics (BGK,
+ *             IncBGK, MRT, Smagorinsky) and cache block size.
+ *   scaling   Multi-block lattice with the default block communicator, for a
+ *             fixed total domain (strong scaling) and a fixed domain per process
+ *             (weak scaling); collision-streaming with the three communication
+ *             schemes, a reductive data processor and the envelope update alone.
+ *   immersed  Immersed-boundary step of the viscosityTest driver (external
+ *             rhoBar-j collision-streaming and Inamuro iterations) around an STL
+ *             surface, for a fixed and a moving body, and voxelization time.
+ *
+ * Every measurement is repeated, after warm-up steps, and the median, minimum
+ * and maximum MLUPS are written as JSON, one result per line. The compare mode
+ * reads two such files and reports the relative change of every result,
+ * exiting with a non-zero status if one of them slowed down by more than the
+ * tolerance.
+ *
+ * Usage:
+ *   benchmark kernel   result.json [size=64] [steps=20]
+ *   benchmark scaling  result.json [size=64] [steps=20]
+ *   benchmark immersed result.json [size=32] [steps=20] [stl=../../viscosityTest/stl/ball.stl]
+ *   benchmark compare  baseline.json result.json [tolerance=0.05]
+ *
+ * The program is the "benchmark" target of the CMake build of src/. The
+ * default STL file is relative to utility/benchmark; when running from
+ * elsewhere, give its path explicitly.
+ */
+
+typedef double T;
+
+#include "palabos3D.h"
+#include "palabos3D.hh"
+
+#include <fstream>
+#include <sstream>
+#include <iomanip>
+#include <algorithm>
+#include <cmath>
+
+using namespace plb;
+using namespace std;
+
+const plint numRepeats = 5;
+const plint numWarmUpSteps = 3;
+
+struct BenchmarkResult {
+    string name;
+    plint cells;
+    plint steps;
+    double mlups, mlupsMin, mlupsMax;
+    double bytesPerCell;
+};
+
+/// Time a number of steps, numRepeats times after a warm-up, and convert the
+///   times into million lattice updates per second over the whole communicator.
+template<class Step>
+BenchmarkResult measure(string const& name, plint cells, plint steps, double bytesPerCell, Step step)
+{
+    for (plint iStep=0; iStep<numWarmUpSteps; ++iStep) {
+        step();
+    }
+    vector<double> mlups(numRepeats);
+    for (plint iRepeat=0; iRepeat<numRepeats; ++iRepeat) {
+        global::mpi().barrier();
+        global::PlbTimer stopwatch;
+        stopwatch.start();
+        for (plint iStep=0; iStep<steps; ++iStep) {
+            step();
+        }
+        global::mpi().barrier();
+        double elapsed = stopwatch.stop();
+        double maxElapsed = elapsed;
+#ifdef PLB_MPI_PARALLEL
+        global::mpi().reduceAndBcast(maxElapsed, MPI_MAX);
+#endif
+        mlups[iRepeat] = (double)cells*(double)steps / maxElapsed * 1.e-6;
+    }
+    sort(mlups.begin(), mlups.end());
+    BenchmarkResult result;
+    result.name = name;
+    result.cells = cells;
+    result.steps = steps;
+    result.mlups = mlups[numRepeats/2];
+    result.mlupsMin = mlups.front();
+    result.mlupsMax = mlups.back();
+    result.bytesPerCell = bytesPerCell;
+    pcout << setw(48) << left << name << right << fixed << setprecision(2)
+          << setw(10) << result.mlups << " MLUPS  [" << result.mlupsMin << ", " << result.mlupsMax << "]" << endl;
+    return result;
+}
+
+/// Populations read and written by one collision-streaming step of one cell.
+template<template<typename U> class Descriptor>
+double populationBytes() {
+    return 2.*(double)Descriptor<T>::q*(double)sizeof(T);
+}
+
+void writeResults(string const& fileName, string const& suite, vector<BenchmarkResult> const& results)
+{
+    if (!global::mpi().isMainProcessor()) return;
+    ofstream file(fileName.c_str());
+    file << "{\n";
+    file << "\"suite\": \"" << suite << "\",\n";
+    file << "\"processes\": " << global::mpi().getSize() << ",\n";
+    file << "\"threads\": " << global::threadPool().getNumThreads() << ",\n";
+    file << "\"precision\": \"" << (sizeof(T)==sizeof(double) ? "double" : "float") << "\",\n";
+    file << "\"repeats\": " << numRepeats << ",\n";
+    file << "\"results\": [\n";
+    file << setprecision(6);
+    for (pluint i=0; i<results.size(); ++i) {
+        BenchmarkResult const& r = results[i];
+        file << "{\"name\": \"" << r.name << "\", \"cells\": " << r.cells << ", \"steps\": " << r.steps
+             << ", \"mlups\": " << r.mlups << ", \"mlupsMin\": " << r.mlupsMin << ", \"mlupsMax\": " << r.mlupsMax
+             << ", \"bytesPerCell\": " << r.bytesPerCell << "}" << (i+1<results.size() ? "," : "") << "\n";
+    }
+    file << "]\n}\n";
+}
+
+/* ******** Kernel suite ***************************************************** */
+
+template<template<typename U> class Descriptor>
+void kernelCase(string const& name, Dynamics<T,Descriptor>* dynamics, plint n, plint steps,
+                vector<BenchmarkResult>& results)
+{
+    plint blockSizes[] = {8, 16, 30, 64};
+    for (plint iSize=0; iSize<4; ++iSize) {
+        BlockLattice3D<T,Descriptor> lattice(n, n, n, dynamics->clone());
+        BlockLattice3D<T,Descriptor>::cachePolicy().setBlockSize(blockSizes[iSize]);
+        applyProcessingFunctional (
+                new IniConstEquilibriumFunctional3D<T,Descriptor>((T)1, Array<T,3>((T)0.02,(T)0.01,(T)0), (T)1),
+                lattice.getBoundingBox(), lattice );
+        lattice.initialize();
+        stringstream caseName;
+        caseName << "kernel/" << name << "/block" << blockSizes[iSize];
+        results.push_back(measure(caseName.str(), n*n*n, steps, populationBytes<Descriptor>(),
+                                  [&lattice]() { lattice.collideAndStream(); }));
+    }
+    BlockLattice3D<T,Descriptor>::cachePolicy().setBlockSize(30);
+    delete dynamics;
+}
+
+/// The kernels are measured on the main process only, the others wait.
+void kernelSuite(plint n, plint steps, vector<BenchmarkResult>& results)
+{
+    if (!global::mpi().isMainProcessor()) return;
+    using namespace descriptors;
+    T omega = (T)1.6;
+    kernelCase<D3Q19Descriptor>("D3Q19/BGK", new BGKdynamics<T,D3Q19Descriptor>(omega), n, steps, results);
+    kernelCase<D3Q19Descriptor>("D3Q19/IncBGK", new IncBGKdynamics<T,D3Q19Descriptor>(omega), n, steps, results);
+    kernelCase<MRTD3Q19Descriptor>("D3Q19/MRT", new MRTdynamics<T,MRTD3Q19Descriptor>(omega), n, steps, results);
+    kernelCase<D3Q19Descriptor>("D3Q19/Smagorinsky", new SmagorinskyBGKdynamics<T,D3Q19Descriptor>(omega, (T)0.14), n, steps, results);
+    kernelCase<D3Q27Descriptor>("D3Q27/BGK", new BGKdynamics<T,D3Q27Descriptor>(omega), n, steps, results);
+    kernelCase<D3Q27Descriptor>("D3Q27/IncBGK", new IncBGKdynamics<T,D3Q27Descriptor>(omega), n, steps, results);
+    kernelCase<D3Q27Descriptor>("D3Q27/Smagorinsky", new SmagorinskyBGKdynamics<T,D3Q27Descriptor>(omega, (T)0.14), n, steps, results);
+}
+
+/* ******** Scaling suite **************************************************** */
+
+void scalingCase(string const& name, plint n, plint steps, vector<BenchmarkResult>& results)
+{
+    typedef descriptors::D3Q19Descriptor<T> D;
+    // The AA-pattern needs an envelope of width 2; the same lattice serves all schemes.
+    std::unique_ptr<MultiBlockLattice3D<T,descriptors::D3Q19Descriptor> > lattice (
+            new MultiBlockLattice3D<T,descriptors::D3Q19Descriptor> (
+                    defaultMultiBlockPolicy3D().getMultiBlockManagement(n, n, n, 2*D::vicinity),
+                    defaultMultiBlockPolicy3D().getBlockCommunicator(),
+                    defaultMultiBlockPolicy3D().getCombinedStatistics(),
+                    defaultMultiBlockPolicy3D().getMultiCellAccess<T,descriptors::D3Q19Descriptor>(),
+                    new BGKdynamics<T,descriptors::D3Q19Descriptor>((T)1.6)) );
+    lattice->periodicity().toggleAll(true);
+    lattice->toggleInternalStatistics(false);
+    initializeAtEquilibrium(*lattice, lattice->getBoundingBox(), (T)1, Array<T,3>((T)0.02,(T)0.01,(T)0));
+    lattice->initialize();
+    plint cells = n*n*n;
+    double bytes = populationBytes<descriptors::D3Q19Descriptor>();
+    MultiBlockLattice3D<T,descriptors::D3Q19Descriptor>* l = lattice.get();
+
+    results.push_back(measure(name+"/collideAndStream", cells, steps, bytes,
+                              [l]() { l->collideAndStream(); }));
+    l->toggleCommunicationOverlap(true);
+    results.push_back(measure(name+"/collideAndStream.overlap", cells, steps, bytes,
+                              [l]() { l->collideAndStream(); }));
+    l->toggleCommunicationOverlap(false);
+    l->setPropagationScheme(propagation::aa);
+    // The AA-pattern needs an even number of steps to return to the natural order.
+    results.push_back(measure(name+"/collideAndStream.aa", cells, 2*((steps+1)/2), bytes,
+                              [l]() { l->collideAndStream(); }));
+    l->setPropagationScheme(propagation::swap);
+    results.push_back(measure(name+"/dataProcessor.averageDensity", cells, steps, (double)D::q*sizeof(T),
+                              [l]() { computeAverageDensity(*l); }));
+    results.push_back(measure(name+"/envelopeUpdate", cells, steps, 0.,
+                              [l]() { l->duplicateOverlaps(modif::staticVariables); }));
+}
+
+/// Strong scaling keeps the domain size^3, weak scaling keeps size^3 cells per process.
+void scalingSuite(plint n, plint steps, vector<BenchmarkResult>& results)
+{
+    plint numProcs = global::mpi().getSize();
+    plint nWeak = util::roundToInt((T)n*std::cbrt((T)numProcs));
+    stringstream strongName, weakName;
+    strongName << "scaling/strong/" << n;
+    weakName << "scaling/weak/" << n;
+    scalingCase(strongName.str(), n, steps, results);
+    scalingCase(weakName.str(), nWeak, steps, results);
+}
+
+/* ******** Immersed-boundary suite ****************************************** */
+
+/// Velocity of the wall vertices, read from the rigid body.
+struct BodyVelocity {
+    BodyVelocity(RigidBody3D<T> const* body_) : body(body_) { }
+    Array<T,3> operator()(pluint id) const { return body->getVertexVelocity(id); }
+    RigidBody3D<T> const* body;
+};
+
+void immersedSuite(plint n, plint steps, string const& stlFile, vector<BenchmarkResult>& results)
+{
+    typedef descriptors::D3Q19Descriptor<T> D;
+    const plint ibIter = 4;
+    const plint envelopeWidth = 4;
+    const T tau = (T)0.8;
+    TriangleSet<T> triangleSet(stlFile, DBL);
+    // The obstacle spans n cells along x, with a margin of n cells on every side.
+    DEFscaledMesh<T> mesh(triangleSet, n, 0, n, 0);
+    TriangleBoundary3D<T> boundary(mesh);
+
+    global::PlbTimer stopwatch;
+    stopwatch.start();
+    VoxelizedDomain3D<T> voxelizedDomain(boundary, voxelFlag::outside, 0, 1, envelopeWidth, 20);
+    double elapsed = stopwatch.stop();
+    pcout << setw(48) << left << "immersed/voxelize" << right << fixed << setprecision(3)
+          << setw(10) << elapsed << " s" << endl;
+    Box3D domain = voxelizedDomain.getVoxelMatrix().getBoundingBox();
+    plint cells = domain.nCells();
+    BenchmarkResult voxelize;
+    voxelize.name = "immersed/voxelize";
+    voxelize.cells = cells;
+    voxelize.steps = 1;
+    voxelize.mlups = voxelize.mlupsMin = voxelize.mlupsMax = (double)cells/elapsed*1.e-6;
+    voxelize.bytesPerCell = 0.;
+    results.push_back(voxelize);
+
+    RigidBody3D<T> body(boundary.getMesh());
+    std::shared_ptr<ImmersedWallVertexBuffer3D<T> > wallBuffer(new ImmersedWallVertexBuffer3D<T>());
+    wallBuffer->setRigidBody(body);
+
+    std::unique_ptr<MultiBlockLattice3D<T,descriptors::D3Q19Descriptor> > lattice (
+            new MultiBlockLattice3D<T,descriptors::D3Q19Descriptor>(domain.getNx(), domain.getNy(), domain.getNz(),
+                    new IncBGKdynamics<T,descriptors::D3Q19Descriptor>((T)1/tau)) );
+    lattice->toggleInternalStatistics(false);
+    std::unique_ptr<MultiScalarField3D<T> > rhoBar (
+            generateMultiScalarField<T>((MultiBlock3D&)*lattice, envelopeWidth) );
+    std::unique_ptr<MultiTensorField3D<T,3> > j (
+            generateMultiTensorField<T,3>((MultiBlock3D&)*lattice, envelopeWidth) );
+    rhoBar->toggleInternalStatistics(false);
+    j->toggleInternalStatistics(false);
+    MultiContainerBlock3D container(*rhoBar);
+    std::vector<MultiBlock3D*> rhoBarJarg;
+    rhoBarJarg.push_back(lattice.get());
+    rhoBarJarg.push_back(rhoBar.get());
+    rhoBarJarg.push_back(j.get());
+    initializeAtEquilibrium(*lattice, lattice->getBoundingBox(), (T)1, Array<T,3>((T)0.02,(T)0,(T)0));
+    lattice->initialize();
+    applyProcessingFunctional(new BoxRhoBarJfunctional3D<T,descriptors::D3Q19Descriptor>(),
+                              lattice->getBoundingBox(), rhoBarJarg);
+
+    typedef DynamicsList<IncBGKdynamics<T,descriptors::D3Q19Descriptor>,
+                         NoDynamics<T,descriptors::D3Q19Descriptor> > LatticeDynamics;
+    integrateProcessingFunctional(new ExternalRhoJcollideAndStream3D<T,descriptors::D3Q19Descriptor,LatticeDynamics>(),
+                                  lattice->getBoundingBox(), rhoBarJarg, 0);
+    integrateProcessingFunctional(new BoxRhoBarJfunctional3D<T,descriptors::D3Q19Descriptor>(),
+                                  lattice->getBoundingBox(), rhoBarJarg, 3);
+    integrateUpdateImmersedWallData<T>(wallBuffer, *lattice, container, 4);
+    for (plint i=0; i<ibIter; ++i) {
+        std::vector<MultiBlock3D*> args;
+        args.push_back(rhoBar.get());
+        args.push_back(j.get());
+        args.push_back(&container);
+        integrateProcessingFunctional (
+            new CachedInamuroIteration3D<T,BodyVelocity>(BodyVelocity(&body), tau, true),
+            rhoBar->getBoundingBox(), *lattice, args, 5+i );
+    }
+
+    // Populations, plus rhoBar and j written once and read by every Inamuro iteration.
+    double bytes = populationBytes<descriptors::D3Q19Descriptor>() + (double)(1+D::d)*sizeof(T)*(1+ibIter);
+    MultiBlockLattice3D<T,descriptors::D3Q19Descriptor>* l = lattice.get();
+    stringstream name;
+    name << "immersed/" << n;
+    results.push_back(measure(name.str()+"/static", cells, steps, bytes,
+                              [l]() { l->executeInternalProcessors(); l->incrementTime(); }));
+    // A translation of a tenth of a cell per step, which triggers the in-place
+    //   update of the wall data on every step and a rebuild when vertices change block.
+    body.setVelocity(Array<T,3>((T)0.1,(T)0,(T)0), Array<T,3>((T)0,(T)0,(T)0));
+    RigidBody3D<T>* b = &body;
+    ImmersedWallVertexBuffer3D<T>* buffer = wallBuffer.get();
+    T direction = (T)1;
+    plint numMoves = 0;
+    results.push_back(measure(name.str()+"/moving", cells, steps, bytes,
+                              [l,b,buffer,&direction,&numMoves]() {
+                                  // Oscillate, so that the body stays in the domain for any number of steps.
+                                  if (++numMoves % 40 == 0) direction = -direction;
+                                  b->translate(Array<T,3>(direction*(T)0.1,(T)0,(T)0));
+                                  buffer->setRigidBody(*b);
+                                  l->executeInternalProcessors();
+                                  l->incrementTime(); }));
+}
+
+/* ******** Comparison ******************************************************* */
+
+/// Read the name and median MLUPS of every result, in a file written by writeResults.
+bool readResults(string const& fileName, vector<pair<string,double> >& results)
+{
+    ifstream file(fileName.c_str());
+    if (!file) return false;
+    string line;
+    while (getline(file, line)) {
+        string::size_type namePos = line.find("{\"name\": \"");
+        string::size_type mlupsPos = line.find("\"mlups\": ");
+        if (namePos==string::npos || mlupsPos==string::npos) continue;
+        namePos += 10;
+        string name = line.substr(namePos, line.find('"', namePos)-namePos);
+        double mlups = atof(line.c_str()+mlupsPos+9);
+        results.push_back(make_pair(name, mlups));
+    }
+    return true;
+}
+
+int compare(string const& baselineFile, string const& resultFile, double tolerance)
+{
+    vector<pair<string,double> > baseline, current;
+    if (!readResults(baselineFile, baseline) || !readResults(resultFile, current)) {
+        pcout << "Cannot read " << baselineFile << " or " << resultFile << endl;
+        return -1;
+    }
+    map<string,double> baselineMap(baseline.begin(), baseline.end());
+    plint numRegressions = 0;
+    pcout << setw(48) << left << "result" << right << setw(12) << "baseline" << setw(12) << "current"
+          << setw(10) << "change" << endl;
+    for (pluint i=0; i<current.size(); ++i) {
+        map<string,double>::const_iterator it = baselineMap.find(current[i].first);
+        if (it==baselineMap.end()) {
+            pcout << setw(48) << left << current[i].first << right << setw(12) << "-"
+                  << setw(12) << fixed << setprecision(2) << current[i].second << endl;
+            continue;
+        }
+        double change = it->second>0. ? current[i].second/it->second-1. : 0.;
+        bool regression = change < -tolerance;
+        if (regression) ++numRegressions;
+        pcout << setw(48) << left << current[i].first << right << fixed << setprecision(2)
+              << setw(12) << it->second << setw(12) << current[i].second
+              << setw(9) << showpos << 100.*change << noshowpos << "%"
+              << (regression ? "  REGRESSION" : "") << endl;
+    }
+    pcout << numRegressions << " regression(s) beyond " << 100.*tolerance << "%" << endl;
+    return numRegressions>0 ? 1 : 0;
+}
+
+int main(int argc, char* argv[])
+{
+    plbInit(&argc, &argv);
+    global::directories().setOutputDir("./");
+    global::IOpolicy().activateParallelIO(false);
+
+    string suite, outFileName;
+    try {
+        global::argv(1).read(suite);
+        global::argv(2).read(outFileName);
+    }
+    catch (PlbIOException& exception) {
+        pcout << "Wrong parameters; the syntax is: " << (std::string)global::argv(0)
+              << " kernel|scaling|immersed result.json [size] [steps] [stl]" << std::endl
+              << "                              or: " << (std::string)global::argv(0)
+              << " compare baseline.json result.json [tolerance]" << std::endl;
+        exit(-1);
+    }
+
+    if (suite=="compare") {
+        string resultFile;
+        double tolerance = 0.05;
+        try {
+            global::argv(3).read(resultFile);
+        }
+        catch (PlbIOException& exception) {
+            pcout << "The compare mode needs a baseline and a result file." << std::endl;
+            exit(-1);
+        }
+        try { global::argv(4).read(tolerance); }
+        catch (PlbIOException& exception) { }
+        return compare(outFileName, resultFile, tolerance);
+    }
+
+    plint size = suite=="immersed" ? 32 : 64;
+    plint steps = 20;
+    string stlFile = "../../viscosityTest/stl/ball.stl";
+    try { global::argv(3).read(size); }
+    catch (PlbIOException& exception) { }
+    try { global::argv(4).read(steps); }
+    catch (PlbIOException& exception) { }
+    try { global::argv(5).read(stlFile); }
+    catch (PlbIOException& exception) { }
+
+    vector<BenchmarkResult> results;
+    if (suite=="kernel") {
+        kernelSuite(size, steps, results);
+    }
+    else if (suite=="scaling") {
+        scalingSuite(size, steps, results);
+    }
+    else if (suite=="immersed") {
+        immersedSuite(size, steps, stlFile, results);
+    }
+    else {
+        pcout << "Unknown suite " << suite << "; choose kernel, scaling, immersed or compare." << std::endl;
+        exit(-1);
+    }
+    writeResults(outFileName, suite, results);
+    return 0;
+}
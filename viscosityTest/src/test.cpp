@@ -32,9 +32,10 @@ int main(int argc, char* argv[])
 	try{
 		//plb::installSigHandler();
 		plb::plbInit(&argc, &argv, true); // Initialize Palabos
-		bool master = plb::global::mpi().isMainProcessor();
 		std::string fileName = "";
 		plb::global::argv(argc-1).read(fileName);
+		plb::Sweep<T,BoundaryType,SurfaceData,Descriptor>::split(fileName);	// Groups of processes run different cases
+		bool master = plb::global::mpi().isMainProcessor();
 		plb::Helper<T,BoundaryType,SurfaceData,Descriptor> h;
 		h.initialize(fileName);
 		plb::Constants<T>* constants = plb::Constants<T>::c.get();
@@ -48,43 +49,52 @@ int main(int argc, char* argv[])
 			plb::pcout << "Min Reynolds = "<<constants->minRe<<" Max Reynolds = "<<constants->maxRe << std::endl;
 			plb::pcout << "Min Grid Level = 0 Max Grid Level = "<<constants->maxGridLevel << std::endl;
 			plb::global::profiler().turnOn();
+			plb::global::profiler().turnOnHardwareCounters();
 		#endif
-		for(plb::plint reynolds = constants->minRe; reynolds <= constants->maxRe; reynolds++){
-			for(plb::plint gridLevel = 0; gridLevel<= constants->maxGridLevel; gridLevel++){
-				variables->update(gridLevel,reynolds);
-				variables->setLattice();
-				bool converged = false;
-				bool stop = false;
-				for(int i=0; converged == false; i++)
-				{
-					variables->iter++;
-					variables->time = i + 1.0;
-					//variables->lattice->toggleInternalStatistics(true);
-					//obstacle->updateImmersedWall();
-					variables->lattice->executeInternalProcessors(); // Execute all processors and communicate appropriately.
-					variables->lattice->incrementTime();
-					//variables->lattice->collideAndStream();
-					stop = obstacle->move();
-					variables->updateLattice();
-					//if(variables->checkConvergence()){ converged = true; break; }
-					#ifdef PLB_DEBUG
-						std::string mesg="N collisions="+std::to_string(variables->iter);
-						if(master){std::cout << mesg << std::endl;}
-						plb::global::log(mesg);
-						if(master){std::cout<<"Grid Level="+std::to_string(gridLevel);}
-						if(master){std::cout << mesg << std::endl;}
-						plb::global::log(mesg);
-						plb::global::profiler().writeReport();
-					#endif
-					output->writeImages(reynolds,gridLevel,stop);
-					if(stop){break;}
-					if(constants->test){ if(variables->iter > constants->testIter){ output->writeImages(reynolds,gridLevel,true); break; }}
-				}
+		if(constants->traceBuffer > 0){ plb::global::tracer().turnOn(constants->traceBuffer); }
+		plb::Sweep<T,BoundaryType,SurfaceData,Descriptor>::initialize();
+		plb::plint reynolds = 0, gridLevel = 0;
+		while(plb::Sweep<T,BoundaryType,SurfaceData,Descriptor>::next(reynolds,gridLevel)){
+			int start = (variables->load() || variables->warmStart()) ? (int)variables->time : 0;
+			bool converged = false;
+			bool stop = false;
+			for(int i=start; converged == false; i++)
+			{
+				PLB_TRACE_SCOPE("iteration");
+				variables->iter++;
+				variables->time = i + 1.0;
+				//variables->lattice->toggleInternalStatistics(true);
+				//obstacle->updateImmersedWall();
+				variables->lattice->executeInternalProcessors(); // Execute all processors and communicate appropriately.
+				variables->lattice->incrementTime();
+				//variables->lattice->collideAndStream();
+				stop = obstacle->move();
+				variables->updateLattice();
+				//if(variables->checkConvergence()){ converged = true; break; }
+				#ifdef PLB_DEBUG
+					std::string mesg="N collisions="+std::to_string(variables->iter);
+					if(master){std::cout << mesg << std::endl;}
+					plb::global::log(mesg);
+					if(master){std::cout<<"Grid Level="+std::to_string(gridLevel);}
+					if(master){std::cout << mesg << std::endl;}
+					plb::global::log(mesg);
+					plb::global::profiler().writeReport();
+				#endif
+				output->writeImages(reynolds,gridLevel,stop);
+				if(stop){break;}
+				if(constants->test){ if(variables->iter > constants->testIter){ output->writeImages(reynolds,gridLevel,true); break; }}
 			}
-		if(constants->test){ break; }
 		}
 		plb::global::profiler().turnOff();
+		if(constants->traceBuffer > 0){
+			plb::global::tracer().turnOff();
+			// Each group writes its own files, named after the group.
+			std::string suffix = plb::Sweep<T,BoundaryType,SurfaceData,Descriptor>::groupSuffix();
+			plb::global::tracer().writeTrace("trace"+suffix);
+			plb::global::tracer().writeSummary("traceSummary"+suffix);
+		}
 		output->stopMessage();
+		plb::Sweep<T,BoundaryType,SurfaceData,Descriptor>::finalize();
 		return 0;																	// Return Process Completed
 	}
 	catch(const std::exception& e){plb::exHandler(e,__FILE__,__FUNCTION__,__LINE__);	return -1;	}